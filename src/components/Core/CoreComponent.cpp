@@ -31,6 +31,7 @@
 #include "HostMaskerManager.h"
 #include "HostMaskerSettingsPage.h"
 #include "HostMaskingRibbonGroup.h"
+#include "HostNameResolver.h"
 #include "IRibbonPage.h"
 #include "MainWindow.h"
 #include "RibbonBarManager.h"
@@ -46,7 +47,8 @@ CoreComponent::CoreComponent() :
         m_ribbonBarManager(nullptr),
         m_hostMaskerSettingsPage(nullptr),
         m_themeSettingsPage(nullptr),
-        m_hostMaskerManager(nullptr) {
+        m_hostMaskerManager(nullptr),
+        m_hostNameResolver(nullptr) {
 
 }
 
@@ -79,6 +81,9 @@ auto CoreComponent::initialiseEvent() -> void {
     m_hostMaskerManager = new Nedrysoft::Core::HostMaskerManager();
     Nedrysoft::ComponentSystem::addObject(m_hostMaskerManager);
 
+    m_hostNameResolver = new Nedrysoft::Core::HostNameResolver();
+    Nedrysoft::ComponentSystem::addObject(m_hostNameResolver);
+
     m_ribbonBarManager = new Nedrysoft::Core::RibbonBarManager();
     Nedrysoft::ComponentSystem::addObject(m_ribbonBarManager);
 
@@ -113,6 +118,10 @@ auto CoreComponent::finaliseEvent() -> void {
         delete m_hostMaskerManager;
     }
 
+    if (m_hostNameResolver) {
+        delete m_hostNameResolver;
+    }
+
     if (m_hostMaskerSettingsPage) {
         delete m_hostMaskerSettingsPage;
     }
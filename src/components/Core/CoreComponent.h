@@ -35,6 +35,7 @@ namespace Nedrysoft { namespace Core {
     class HostMaskerManager;
     class HostMaskingRibbonGroup;
     class HostMaskerSettingsPage;
+    class HostNameResolver;
     class RibbonBarManager;
     class SystemTrayIconManager;
     class ThemeSettingsPage;
@@ -112,6 +113,7 @@ class NEDRYSOFT_CORE_DLLSPEC CoreComponent :
         Nedrysoft::Core::HostMaskingRibbonGroup *m_hostMaskingRibbonGroupWidget;
         Nedrysoft::Core::ClipboardRibbonGroup *m_clipboardRibbonGroupWidget;
         Nedrysoft::Core::HostMaskerManager *m_hostMaskerManager;
+        Nedrysoft::Core::HostNameResolver *m_hostNameResolver;
 
         //! @endcond
 };
@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 18/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PINGNOO_COMPONENTS_CORE_HOSTNAMECACHE_H
+#define PINGNOO_COMPONENTS_CORE_HOSTNAMECACHE_H
+
+#include <QHash>
+#include <QHostAddress>
+#include <QString>
+#include <cstdint>
+#include <list>
+
+namespace Nedrysoft { namespace Core {
+    /**
+     * @brief       The HostNameCache class is a bounded least recently used cache of reverse lookup results.
+     *
+     * @details     Each entry has its own expiry time, an entry that has expired is removed when it is next found.
+     *              When the cache is full the least recently used entry is removed to make room.  An address that
+     *              has no name is stored with an empty host name so that failed lookups are cached as well.
+     *
+     *              Times are supplied by the caller in milliseconds from any monotonic clock.
+     */
+    class HostNameCache {
+        public:
+            /**
+             * @brief       The default number of entries held by the cache.
+             */
+            static constexpr int DefaultCapacity = 4096;
+
+        public:
+            /**
+             * @brief       Constructs an empty HostNameCache.
+             *
+             * @param[in]   capacity the maximum number of entries.
+             */
+            explicit HostNameCache(int capacity = DefaultCapacity) :
+                    m_capacity(capacity) {
+
+            }
+
+            /**
+             * @brief       Adds or replaces the entry for an address.
+             *
+             * @param[in]   hostAddress the address that was looked up.
+             * @param[in]   hostName the name of the address, or an empty string if the address has no name.
+             * @param[in]   expiryTime the time in milliseconds after which the entry is no longer valid.
+             */
+            auto insert(const QHostAddress &hostAddress, const QString &hostName, int64_t expiryTime) -> void {
+                remove(hostAddress);
+
+                while (( !m_entries.empty() ) && ( static_cast<int>(m_entries.size())>=m_capacity )) {
+                    m_index.remove(m_entries.back().hostAddress);
+
+                    m_entries.pop_back();
+                }
+
+                if (m_capacity<=0) {
+                    return;
+                }
+
+                m_entries.push_front(Entry{hostAddress, hostName, expiryTime});
+
+                m_index.insert(hostAddress, m_entries.begin());
+            }
+
+            /**
+             * @brief       Finds the entry for an address.
+             *
+             * @details     A found entry becomes the most recently used, an expired entry is removed.
+             *
+             * @param[in]   hostAddress the address to find.
+             * @param[in]   currentTime the current time in milliseconds.
+             * @param[out]  hostName the cached name, empty if the address is known to have no name.
+             *
+             * @returns     true if a valid entry was found; otherwise false.
+             */
+            auto find(const QHostAddress &hostAddress, int64_t currentTime, QString &hostName) -> bool {
+                auto indexIterator = m_index.find(hostAddress);
+
+                if (indexIterator==m_index.end()) {
+                    return false;
+                }
+
+                auto entry = indexIterator.value();
+
+                if (currentTime>=entry->expiryTime) {
+                    m_entries.erase(entry);
+                    m_index.erase(indexIterator);
+
+                    return false;
+                }
+
+                m_entries.splice(m_entries.begin(), m_entries, entry);
+
+                hostName = entry->hostName;
+
+                return true;
+            }
+
+            /**
+             * @brief       Removes the entry for an address.
+             *
+             * @param[in]   hostAddress the address to remove.
+             */
+            auto remove(const QHostAddress &hostAddress) -> void {
+                auto indexIterator = m_index.find(hostAddress);
+
+                if (indexIterator==m_index.end()) {
+                    return;
+                }
+
+                m_entries.erase(indexIterator.value());
+                m_index.erase(indexIterator);
+            }
+
+            /**
+             * @brief       Returns the number of entries in the cache, including any that have expired.
+             *
+             * @returns     the number of entries.
+             */
+            auto count() const -> int {
+                return static_cast<int>(m_entries.size());
+            }
+
+        private:
+            //! @cond
+
+            struct Entry {
+                QHostAddress hostAddress;
+                QString hostName;
+                int64_t expiryTime;
+            };
+
+            std::list<Entry> m_entries;
+            QHash<QHostAddress, std::list<Entry>::iterator> m_index;
+            int m_capacity;
+
+            //! @endcond
+    };
+}}
+
+#endif // PINGNOO_COMPONENTS_CORE_HOSTNAMECACHE_H
@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 18/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "HostNameResolver.h"
+
+#include <chrono>
+
+constexpr auto HostNameTimeToLive = 60*60*1000;
+constexpr auto NoHostNameTimeToLive = 5*60*1000;
+
+Nedrysoft::Core::HostNameResolver::HostNameResolver() = default;
+
+Nedrysoft::Core::HostNameResolver::~HostNameResolver() {
+    for (auto lookupId : m_lookupIds) {
+        QHostInfo::abortHostLookup(lookupId);
+    }
+}
+
+auto Nedrysoft::Core::HostNameResolver::currentTime() -> int64_t {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch() ).count();
+}
+
+auto Nedrysoft::Core::HostNameResolver::lookup(
+        const QHostAddress &hostAddress,
+        QObject *context,
+        Nedrysoft::Core::HostNameFunction function ) -> void {
+
+    QString hostName;
+
+    if (m_cache.find(hostAddress, currentTime(), hostName)) {
+        function(hostAddress, hostName.isEmpty() ? hostAddress.toString() : hostName);
+
+        return;
+    }
+
+    // requests for an address that is already being looked up wait for the answer of the first request.
+
+    auto isPending = m_pendingRequests.contains(hostAddress);
+
+    m_pendingRequests[hostAddress].append(PendingRequest{QPointer<QObject>(context), context!=nullptr, function});
+
+    if (isPending) {
+        return;
+    }
+
+    auto lookupId = QHostInfo::lookupHost(hostAddress.toString(), this, [this, hostAddress](const QHostInfo &hostInfo) {
+        lookupFinished(hostAddress, hostInfo);
+    });
+
+    m_lookupIds.insert(hostAddress, lookupId);
+}
+
+auto Nedrysoft::Core::HostNameResolver::lookupFinished(
+        const QHostAddress &hostAddress,
+        const QHostInfo &hostInfo ) -> void {
+
+    auto hostName = QString();
+
+    // when an address has no name QHostInfo returns the address itself, this is cached as a negative answer.
+
+    if (( hostInfo.error()==QHostInfo::NoError ) && ( hostInfo.hostName()!=hostAddress.toString() )) {
+        hostName = hostInfo.hostName();
+    }
+
+    m_cache.insert(
+        hostAddress,
+        hostName,
+        currentTime() + ( hostName.isEmpty() ? NoHostNameTimeToLive : HostNameTimeToLive ) );
+
+    m_lookupIds.remove(hostAddress);
+
+    auto pendingRequests = m_pendingRequests.take(hostAddress);
+
+    for (const auto &pendingRequest : pendingRequests) {
+        if (( pendingRequest.hasContext ) && ( pendingRequest.context.isNull() )) {
+            continue;
+        }
+
+        pendingRequest.function(hostAddress, hostName.isEmpty() ? hostAddress.toString() : hostName);
+    }
+}
@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 18/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PINGNOO_COMPONENTS_CORE_HOSTNAMERESOLVER_H
+#define PINGNOO_COMPONENTS_CORE_HOSTNAMERESOLVER_H
+
+#include "CoreSpec.h"
+#include "HostNameCache.h"
+#include "IHostNameResolver.h"
+
+#include <QHash>
+#include <QHostInfo>
+#include <QList>
+#include <QPointer>
+
+namespace Nedrysoft { namespace Core {
+    /**
+     * @brief       The HostNameResolver class looks up the names of addresses using QHostInfo.
+     *
+     * @details     Answers are kept in a bounded least recently used cache, names are kept for an hour and addresses
+     *              without a name for five minutes as the time to live of the PTR record is not available from
+     *              QHostInfo.  Requests for an address that is already being looked up wait for the same answer.
+     */
+    class NEDRYSOFT_CORE_DLLSPEC HostNameResolver :
+            public Nedrysoft::Core::IHostNameResolver {
+
+        private:
+            Q_OBJECT
+
+            Q_INTERFACES(Nedrysoft::Core::IHostNameResolver)
+
+        public:
+            /**
+             * @brief       Constructs a new HostNameResolver.
+             */
+            HostNameResolver();
+
+            /**
+             * @brief       Destroys the HostNameResolver.
+             */
+            ~HostNameResolver() override;
+
+            /**
+             * @brief       Looks up the name of an address.
+             *
+             * @see         Nedrysoft::Core::IHostNameResolver::lookup
+             *
+             * @param[in]   hostAddress the address to look up.
+             * @param[in]   context if set, the function is not called if this object has been destroyed.
+             * @param[in]   function the function called with the address and its name.
+             */
+            auto lookup(
+                const QHostAddress &hostAddress,
+                QObject *context,
+                Nedrysoft::Core::HostNameFunction function ) -> void override;
+
+        private:
+            /**
+             * @brief       Stores the answer to a lookup and passes it to the waiting requests.
+             *
+             * @param[in]   hostAddress the address that was looked up.
+             * @param[in]   hostInfo the result of the lookup.
+             */
+            auto lookupFinished(const QHostAddress &hostAddress, const QHostInfo &hostInfo) -> void;
+
+            /**
+             * @brief       Returns the current time of the cache clock.
+             *
+             * @returns     the time in milliseconds.
+             */
+            static auto currentTime() -> int64_t;
+
+        private:
+            //! @cond
+
+            struct PendingRequest {
+                QPointer<QObject> context;
+                bool hasContext;
+                Nedrysoft::Core::HostNameFunction function;
+            };
+
+            Nedrysoft::Core::HostNameCache m_cache;
+            QHash<QHostAddress, QList<PendingRequest> > m_pendingRequests;
+            QHash<QHostAddress, int> m_lookupIds;
+
+            //! @endcond
+    };
+}}
+
+#endif // PINGNOO_COMPONENTS_CORE_HOSTNAMERESOLVER_H
@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 18/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PINGNOO_COMPONENTS_CORE_IHOSTNAMERESOLVER_H
+#define PINGNOO_COMPONENTS_CORE_IHOSTNAMERESOLVER_H
+
+#include "CoreSpec.h"
+#include "IComponentManager.h"
+
+#include <IInterface>
+#include <QHostAddress>
+#include <QObject>
+#include <functional>
+
+namespace Nedrysoft { namespace Core {
+    using HostNameFunction = std::function<void(const QHostAddress &, const QString &)>;
+
+    /**
+     * @brief       The IHostNameResolver interface describes a service that finds the names of addresses.
+     *
+     * @details     Lookups are asynchronous and results are cached, so that the same address is not looked up
+     *              again for every hop and every editor that shows it.
+     *
+     * @class       Nedrysoft::Core::IHostNameResolver IHostNameResolver.h <IHostNameResolver>
+     */
+    class NEDRYSOFT_CORE_DLLSPEC IHostNameResolver :
+            public Nedrysoft::ComponentSystem::IInterface {
+
+        private:
+            Q_OBJECT
+
+            Q_INTERFACES(Nedrysoft::ComponentSystem::IInterface)
+
+        public:
+            /**
+             * @brief       Returns the Nedrysoft::Core::IHostNameResolver instance.
+             */
+            static auto getInstance() -> IHostNameResolver * {
+                return ComponentSystem::getObject<IHostNameResolver>();
+            }
+
+            /**
+             * @brief       Destroys the IHostNameResolver.
+             */
+            virtual ~IHostNameResolver() = default;
+
+            /**
+             * @brief       Looks up the name of an address.
+             *
+             * @details     If the name is cached then the function is called before lookup returns, otherwise it is
+             *              called from the event loop when the answer arrives.  If the address has no name then the
+             *              function is called with the address as a string.
+             *
+             * @note        Must be called from the thread of the resolver.
+             *
+             * @param[in]   hostAddress the address to look up.
+             * @param[in]   context if set, the function is not called if this object has been destroyed.
+             * @param[in]   function the function called with the address and its name.
+             */
+            virtual auto lookup(
+                const QHostAddress &hostAddress,
+                QObject *context,
+                Nedrysoft::Core::HostNameFunction function ) -> void = 0;
+    };
+}}
+
+Q_DECLARE_INTERFACE(Nedrysoft::Core::IHostNameResolver, "com.nedrysoft.core.IHostNameResolver/1.0.0")
+
+#endif // PINGNOO_COMPONENTS_CORE_IHOSTNAMERESOLVER_H
@@ -26,6 +26,7 @@
 #include "ICMPAPIPingTarget.h"
 #include "ICMPAPIPingTransmitter.h"
 
+#include <PingResultBatcher>
 #include <QMutex>
 #include <QThread>
 #include <WS2tcpip.h>
@@ -54,6 +55,7 @@ class Nedrysoft::ICMPAPIPingEngine::ICMPAPIPingEngineData {
                 m_pingEngine(parent),
                 m_transmitter(nullptr),
                 m_transmitterThread(nullptr),
+                m_resultBatcher(nullptr),
                 m_timeout(DefaultReplyTimeout),
                 m_ipVersion(Nedrysoft::Core::IPVersion::V4) {
 
@@ -68,18 +70,30 @@ class Nedrysoft::ICMPAPIPingEngine::ICMPAPIPingEngineData {
 
         QThread *m_transmitterThread;
 
+        Nedrysoft::RouteAnalyser::PingResultBatcher *m_resultBatcher;
+
         Nedrysoft::Core::IPVersion m_ipVersion;
 
         QList<Nedrysoft::ICMPAPIPingEngine::ICMPAPIPingTarget *> m_targetList;
 
         int m_timeout;
         int m_interval;
+
+        Nedrysoft::RouteAnalyser::PingEngineCounters m_counters;
 };
 
 Nedrysoft::ICMPAPIPingEngine::ICMPAPIPingEngine::ICMPAPIPingEngine(Nedrysoft::Core::IPVersion version) :
         d(std::make_shared<Nedrysoft::ICMPAPIPingEngine::ICMPAPIPingEngineData>(this)) {
 
     d->m_ipVersion = version;
+
+    d->m_resultBatcher = new Nedrysoft::RouteAnalyser::PingResultBatcher(this);
+
+    connect(this, &Nedrysoft::RouteAnalyser::IPingEngine::result, d->m_resultBatcher,
+            &Nedrysoft::RouteAnalyser::PingResultBatcher::addResult, Qt::DirectConnection);
+
+    connect(d->m_resultBatcher, &Nedrysoft::RouteAnalyser::PingResultBatcher::resultsReady, this,
+            &Nedrysoft::RouteAnalyser::IPingEngine::resultsReady);
 }
 
 Nedrysoft::ICMPAPIPingEngine::ICMPAPIPingEngine::~ICMPAPIPingEngine() {
@@ -161,6 +175,21 @@ auto Nedrysoft::ICMPAPIPingEngine::ICMPAPIPingEngine::setTimeout(int timeout) ->
     return true;
 }
 
+auto Nedrysoft::ICMPAPIPingEngine::ICMPAPIPingEngine::metrics() -> Nedrysoft::RouteAnalyser::PingEngineMetrics {
+    return d->m_counters.snapshot();
+}
+
+auto Nedrysoft::ICMPAPIPingEngine::ICMPAPIPingEngine::counters() -> Nedrysoft::RouteAnalyser::PingEngineCounters & {
+    return d->m_counters;
+}
+
+auto Nedrysoft::ICMPAPIPingEngine::ICMPAPIPingEngine::setResultBatching(int interval, int batchSize) -> bool {
+    d->m_resultBatcher->setInterval(interval);
+    d->m_resultBatcher->setBatchSize(batchSize);
+
+    return true;
+}
+
 auto Nedrysoft::ICMPAPIPingEngine::ICMPAPIPingEngine::saveConfiguration() -> QJsonObject {
     return QJsonObject();
 }
@@ -85,6 +85,30 @@ namespace Nedrysoft { namespace ICMPAPIPingEngine {
              */
             auto setTimeout(int timeout) -> bool override;
 
+            /**
+             * @brief       Sets when a batch of results is delivered.
+             *
+             * @see         Nedrysoft::RouteAnalyser::IPingEngine::setResultBatching
+             *
+             * @param[in]   interval the longest time in milliseconds that a result waits for its batch.
+             * @param[in]   batchSize the number of results after which a batch is delivered without waiting.
+             *
+             * @returns     true on success; otherwise false.
+             */
+            auto setResultBatching(int interval, int batchSize) -> bool override;
+
+            /**
+             * @brief       Returns a snapshot of the engine counters.
+             *
+             * @details     Replies are matched by the ICMP API, so unmatched, foreign and late packets and receive
+             *              drops are not available.
+             *
+             * @see         Nedrysoft::RouteAnalyser::IPingEngine::metrics
+             *
+             * @returns     the metrics of the engine.
+             */
+            auto metrics() -> Nedrysoft::RouteAnalyser::PingEngineMetrics override;
+
             /**
              * @brief       Starts ping operations for this engine instance.
              *
@@ -175,6 +199,16 @@ namespace Nedrysoft { namespace ICMPAPIPingEngine {
              */
             auto doStop() -> void;
 
+            /**
+             * @brief       Returns the counters that the transmitter and workers update.
+             *
+             * @returns     the counters.
+             */
+            auto counters() -> Nedrysoft::RouteAnalyser::PingEngineCounters &;
+
+            friend class ICMPAPIPingTransmitter;
+            friend class ICMPAPIPingWorker;
+
         public:
             /**
              * @brief       Saves the configuration to a JSON object.
@@ -29,7 +29,7 @@ Nedrysoft::ICMPAPIPingEngine::ICMPAPIPingResult::ICMPAPIPingResult(Nedrysoft::Ro
     m_code = result.code();
     m_target = result.target();
     m_hostAddress = result.hostAddress();
-    m_requestTime = result.requestTime();
+    m_requestTime = result.requestTimeNanoseconds();
     m_roundTripTime = result.roundTripTime();
 }
 
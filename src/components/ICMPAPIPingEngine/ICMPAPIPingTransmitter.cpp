@@ -28,7 +28,9 @@
 #include "ICMPAPIPingWorker.h"
 
 #include <QThread>
+#include <chrono>
 #include <cstdint>
+#include <thread>
 
 constexpr auto DefaultTransmitInterval = 1000;
 constexpr auto DefaultReplyTimeout = 3000;
@@ -56,16 +58,24 @@ void Nedrysoft::ICMPAPIPingEngine::ICMPAPIPingTransmitter::addTarget(
 
 auto Nedrysoft::ICMPAPIPingEngine::ICMPAPIPingTransmitter::doWork() -> void {
     unsigned long sampleNumber = 0;
-    QElapsedTimer timer;
 
     m_isRunning = true;
 
-    while (m_isRunning) {
-        timer.restart();
+    auto roundStart = std::chrono::steady_clock::now();
 
+    while (m_isRunning) {
         m_targetsMutex.lock();
 
+        // every probe of the round is started together, so they are all as late as the start of the round.
+
+        auto lateness = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - roundStart );
+
         for (auto target : m_targets) {
+            m_engine->counters().addLateness(lateness.count());
+            m_engine->counters().addProbesSent();
+            m_engine->counters().addRequest();
+
             auto pingWorker = new Nedrysoft::ICMPAPIPingEngine::ICMPAPIPingWorker(m_engine, sampleNumber, target);
 
             auto pingThread = new QThread();
@@ -92,12 +102,22 @@ auto Nedrysoft::ICMPAPIPingEngine::ICMPAPIPingTransmitter::doWork() -> void {
 
         m_targetsMutex.unlock();
 
-        auto duration = timer.elapsed();
+        // rounds start on a fixed grid rather than sleeping for the remainder of the interval, so that the error of
+        // each sleep does not accumulate.  If the transmitter has fallen more than a round behind then the grid is
+        // restarted from now.
 
-        if (duration < m_interval) {
-            QThread::msleep(m_interval - duration);
+        auto interval = std::chrono::milliseconds(m_interval);
+
+        roundStart += interval;
+
+        auto currentTime = std::chrono::steady_clock::now();
+
+        if (roundStart + interval < currentTime) {
+            roundStart = currentTime;
         }
 
+        std::this_thread::sleep_until(roundStart);
+
         sampleNumber++;
     }
 }
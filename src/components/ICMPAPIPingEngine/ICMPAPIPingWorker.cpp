@@ -53,6 +53,12 @@ void Nedrysoft::ICMPAPIPingEngine::ICMPAPIPingWorker::doWork() {
     pingResult.setSampleNumber(m_sampleNumber);
     pingResult.setTarget(m_target);
 
+    if (pingResult.code() == Nedrysoft::RouteAnalyser::PingResult::ResultCode::NoReply) {
+        m_engine->counters().addTimeout(0);
+    } else {
+        m_engine->counters().addReply();
+    }
+
     Q_EMIT result(pingResult);
 
     deleteLater();
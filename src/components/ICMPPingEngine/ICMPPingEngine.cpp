@@ -24,23 +24,41 @@
 #include "ICMPPingEngine.h"
 
 #include "ICMPPingItem.h"
+#include "ICMPPingItemPool.h"
 #include "ICMPPingReceiverWorker.h"
+#include "ICMPPingRequestTable.h"
 #include "ICMPPingTarget.h"
 #include "ICMPPingTimeout.h"
+#include "ICMPPingTimingWheel.h"
 #include "ICMPPingTransmitter.h"
 #include "ICMPSocket/ICMPSocket.h"
 #include "ICMPPacket/ICMPPacket.h"
+#include "ICMPPacket/ICMPReplyView.h"
 #include "Utils.h"
 
+#include <ICore>
+#include <PingResultBatcher>
+#include <PingResultRecord>
 #include <QElapsedTimer>
-#include <QMap>
-#include <QMutex>
+#include <QHash>
 #include <QThread>
+#include <algorithm>
 #include <cstdint>
+#include <memory>
+#include <spdlog/spdlog.h>
+#include <vector>
 
 constexpr auto DefaultReceiveTimeout = 1000;
+constexpr auto DefaultMinimumTimeout = 100;
+constexpr auto DefaultMaximumTimeout = 5000;
 constexpr auto DefaultTerminateThreadTimeout = 5000;
 constexpr auto DefaultTransmitInterval = 2500;
+constexpr auto RequestTableCapacity = 8192;
+constexpr auto NanosecondsInMillisecond = 1000000;
+constexpr auto TimingWheelResolution = NanosecondsInMillisecond;
+constexpr auto MaximumIdAttempts = 16;
+
+constexpr auto SingleShotSequenceId = 5555;
 
 constexpr auto SecondsToMs(double seconds) {
     return seconds*1000;
@@ -62,10 +80,17 @@ class Nedrysoft::ICMPPingEngine::ICMPPingEngineData {
                 m_timeoutWorker(nullptr),
                 m_transmitterThread(nullptr),
                 m_timeoutThread(nullptr),
+                m_resultBatcher(nullptr),
+                m_timingWheel(TimingWheelResolution),
                 m_timeout(DefaultReceiveTimeout),
+                m_minimumTimeout(DefaultMinimumTimeout),
+                m_maximumTimeout(DefaultMaximumTimeout),
                 m_epoch(QDateTime::currentDateTime()),
                 m_receiverWorker(nullptr),
-                m_interval(DefaultTransmitInterval) {
+                m_socket(nullptr),
+                m_interval(DefaultTransmitInterval),
+                m_pacingMode(Nedrysoft::ICMPPingEngine::PacingMode::Burst),
+                m_timeoutMode(Nedrysoft::ICMPPingEngine::TimeoutMode::Fixed) {
 
         }
 
@@ -81,12 +106,29 @@ class Nedrysoft::ICMPPingEngine::ICMPPingEngineData {
         QThread *m_transmitterThread;
         QThread *m_timeoutThread;
 
-        QMap<uint32_t, Nedrysoft::ICMPPingEngine::ICMPPingItem *> m_pingRequests;
-        QMutex m_requestsMutex;
+        Nedrysoft::RouteAnalyser::PingResultBatcher *m_resultBatcher;
+
+        Nedrysoft::ICMPPingEngine::ICMPPingRequestTable<
+            Nedrysoft::ICMPPingEngine::ICMPPingItem,
+            RequestTableCapacity
+        > m_pingRequests;
+
+        Nedrysoft::ICMPPingEngine::ICMPPingItemPool<
+            Nedrysoft::ICMPPingEngine::ICMPPingItem,
+            RequestTableCapacity
+        > m_itemPool;
+
+        Nedrysoft::ICMPPingEngine::ICMPPingPacing m_pacing;
+
+        Nedrysoft::RouteAnalyser::PingEngineCounters m_counters;
+
+        Nedrysoft::ICMPPingEngine::ICMPPingTimingWheel m_timingWheel;
 
         QList<Nedrysoft::ICMPPingEngine::ICMPPingTarget *> m_targetList;
 
         int m_timeout;
+        int m_minimumTimeout;
+        int m_maximumTimeout;
 
         int m_interval;
 
@@ -95,6 +137,12 @@ class Nedrysoft::ICMPPingEngine::ICMPPingEngineData {
         Nedrysoft::Core::IPVersion m_version;
 
         Nedrysoft::ICMPPingEngine::ICMPPingReceiverWorker *m_receiverWorker;
+
+        Nedrysoft::ICMPSocket::ICMPSocket *m_socket;
+
+        Nedrysoft::ICMPPingEngine::PacingMode m_pacingMode;
+
+        Nedrysoft::ICMPPingEngine::TimeoutMode m_timeoutMode;
 };
 
 Nedrysoft::ICMPPingEngine::ICMPPingEngine::ICMPPingEngine(Nedrysoft::Core::IPVersion version) :
@@ -103,6 +151,16 @@ Nedrysoft::ICMPPingEngine::ICMPPingEngine::ICMPPingEngine(Nedrysoft::Core::IPVer
     d->m_version = version;
 
     qRegisterMetaType<QElapsedTimer>("QElapsedTimer");
+
+    // results are added to the batch on the thread that produced them and delivered on the thread of the engine.
+
+    d->m_resultBatcher = new Nedrysoft::RouteAnalyser::PingResultBatcher(this);
+
+    connect(this, &Nedrysoft::RouteAnalyser::IPingEngine::result, d->m_resultBatcher,
+            &Nedrysoft::RouteAnalyser::PingResultBatcher::addResult, Qt::DirectConnection);
+
+    connect(d->m_resultBatcher, &Nedrysoft::RouteAnalyser::PingResultBatcher::resultsReady, this,
+            &Nedrysoft::RouteAnalyser::IPingEngine::resultsReady);
 }
 
 Nedrysoft::ICMPPingEngine::ICMPPingEngine::~ICMPPingEngine() {
@@ -116,6 +174,10 @@ auto Nedrysoft::ICMPPingEngine::ICMPPingEngine::addTarget(
 
     auto target = new Nedrysoft::ICMPPingEngine::ICMPPingTarget(this, hostAddress);
 
+    target->setResultIndex(d->m_resultBatcher->registerTarget(target));
+
+    registerTarget(target);
+
     d->m_transmitterWorker->addTarget(target);
 
     return target;
@@ -127,20 +189,88 @@ auto Nedrysoft::ICMPPingEngine::ICMPPingEngine::addTarget(
 
     auto target = new Nedrysoft::ICMPPingEngine::ICMPPingTarget(this, hostAddress, ttl);
 
+    target->setResultIndex(d->m_resultBatcher->registerTarget(target));
+
     d->m_targetList.append(target);
 
+    // targets added once the engine is running (for example when a cached route is corrected) are handed
+    // straight to the receiver and transmitter.
+
+    if (d->m_transmitterWorker) {
+        registerTarget(target);
+
+        d->m_transmitterWorker->addTarget(target);
+    }
+
     return target;
 }
 
 auto Nedrysoft::ICMPPingEngine::ICMPPingEngine::removeTarget(Nedrysoft::RouteAnalyser::IPingTarget *target) -> bool {
-    Q_UNUSED(target)
+    auto icmpTarget = static_cast<Nedrysoft::ICMPPingEngine::ICMPPingTarget *>(target);
+
+    if (!d->m_targetList.removeAll(icmpTarget)) {
+        return false;
+    }
+
+    // the transmitter keeps ownership of the target, replies that are still in flight are ignored.
+
+    if (d->m_transmitterWorker) {
+        d->m_transmitterWorker->removeTarget(icmpTarget);
+    }
+
+    // on the raw socket path each target registered its own id with the receiver, the id is released unless
+    // another target of this engine happens to share it.
+
+    if (( d->m_receiverWorker ) && ( !d->m_socket )) {
+        auto idInUse = std::any_of(
+            d->m_targetList.constBegin(),
+            d->m_targetList.constEnd(),
+            [icmpTarget](Nedrysoft::ICMPPingEngine::ICMPPingTarget *remainingTarget) {
+                return remainingTarget->id() == icmpTarget->id();
+            }
+        );
+
+        if (!idInUse) {
+            d->m_receiverWorker->unregisterId(icmpTarget->id(), this);
+        }
+    }
 
     return true;
 }
 
 auto Nedrysoft::ICMPPingEngine::ICMPPingEngine::start() -> bool {
+    d->m_receiverWorker = Nedrysoft::ICMPPingEngine::ICMPPingReceiverWorker::getInstance();
+
+    // if the process is allowed to create datagram sockets then the engine sends and receives on its own socket,
+    // the id of the socket is registered before any targets so they can share it.  The receiver does not open raw
+    // read sockets in this case, so the engine cannot fall back to a raw socket and fails to start instead.
+
+    auto socketVersion = static_cast<Nedrysoft::ICMPSocket::IPVersion>(d->m_version);
+
+    if (Nedrysoft::ICMPSocket::ICMPSocket::isDatagramSupported(socketVersion)) {
+        d->m_socket = createDatagramSocket(socketVersion);
+
+        if (!d->m_socket) {
+            SPDLOG_ERROR("Unable to create a datagram socket for the engine.");
+
+            return false;
+        }
+
+        if (!d->m_receiverWorker->addSocket(d->m_socket)) {
+            d->m_receiverWorker->unregisterEngine(this);
+
+            delete d->m_socket;
+
+            d->m_socket = nullptr;
+
+            return false;
+        }
+    }
+
     // timeout thread
 
+    d->m_timingWheel.start();
+
     d->m_timeoutWorker = new Nedrysoft::ICMPPingEngine::ICMPPingTimeout(this);
 
     d->m_timeoutThread = new QThread();
@@ -155,16 +285,11 @@ auto Nedrysoft::ICMPPingEngine::ICMPPingEngine::start() -> bool {
 
     d->m_timeoutThread->start();
 
-    // connect to the receiver thread
-
-    d->m_receiverWorker = Nedrysoft::ICMPPingEngine::ICMPPingReceiverWorker::getInstance();
+    // register the ids of our targets with the receiver thread so that replies are routed to this engine
 
-    connect(d->m_receiverWorker,
-            &Nedrysoft::ICMPPingEngine::ICMPPingReceiverWorker::packetReceived,
-            this,
-            &Nedrysoft::ICMPPingEngine::ICMPPingEngine::onPacketReceived,
-            Qt::DirectConnection
-    );
+    for (auto target : d->m_targetList) {
+        registerTarget(target);
+    }
 
     // transmitter thread
 
@@ -175,6 +300,11 @@ auto Nedrysoft::ICMPPingEngine::ICMPPingEngine::start() -> bool {
     d->m_transmitterWorker->moveToThread(d->m_transmitterThread);
 
     d->m_transmitterWorker->setInterval(d->m_interval);
+    d->m_transmitterWorker->setPacingMode(d->m_pacingMode);
+
+    if (d->m_socket) {
+        d->m_transmitterWorker->setSocket(d->m_socket);
+    }
 
     for (auto target : d->m_targetList) {
         d->m_transmitterWorker->addTarget(target);
@@ -204,10 +334,22 @@ auto Nedrysoft::ICMPPingEngine::ICMPPingEngine::doStop() -> bool {
         d->m_timeoutWorker->m_isRunning = false;
     }
 
+    d->m_timingWheel.stop();
+
     if (d->m_timeoutThread) {
         d->m_timeoutThread->quit();
     }
 
+    if (d->m_receiverWorker) {
+        d->m_receiverWorker->unregisterEngine(this);
+
+        if (d->m_socket) {
+            d->m_receiverWorker->removeSocket(d->m_socket);
+        }
+
+        d->m_receiverWorker = nullptr;
+    }
+
     if (d->m_transmitterThread) {
         d->m_transmitterThread->wait(DefaultTerminateThreadTimeout);
 
@@ -238,11 +380,17 @@ auto Nedrysoft::ICMPPingEngine::ICMPPingEngine::doStop() -> bool {
     d->m_transmitterWorker = nullptr;
     d->m_timeoutWorker = nullptr;
 
-    for (auto request : d->m_pingRequests) {
-        delete request;
-    }
+    // the socket is shared with the transmitter, so it is deleted once the transmitter has been destroyed.
 
-    d->m_pingRequests.clear();
+    delete d->m_socket;
+
+    d->m_socket = nullptr;
+
+    d->m_pingRequests.forEach([this](uint32_t id, int64_t) {
+        d->m_itemPool.release(d->m_pingRequests.take(id));
+
+        d->m_counters.cancelRequests(1);
+    });
 
     return true;
 }
@@ -251,36 +399,118 @@ auto Nedrysoft::ICMPPingEngine::ICMPPingEngine::stop() -> bool {
     return doStop();
 }
 
-auto Nedrysoft::ICMPPingEngine::ICMPPingEngine::addRequest(Nedrysoft::ICMPPingEngine::ICMPPingItem *pingItem) -> void {
-    QMutexLocker locker(&d->m_requestsMutex);
-
+auto Nedrysoft::ICMPPingEngine::ICMPPingEngine::addRequest(Nedrysoft::ICMPPingEngine::ICMPPingItem *pingItem) -> bool {
     auto id = Nedrysoft::Utils::fzMake32(pingItem->id(), pingItem->sequenceId());
+    auto timeout = static_cast<int64_t>(d->m_timeout) * NanosecondsInMillisecond;
+
+    if (( d->m_timeoutMode == Nedrysoft::ICMPPingEngine::TimeoutMode::Adaptive ) && ( pingItem->target() )) {
+        timeout = pingItem->target()->timeoutEstimator().timeout(
+            static_cast<int64_t>(d->m_minimumTimeout) * NanosecondsInMillisecond,
+            static_cast<int64_t>(d->m_maximumTimeout) * NanosecondsInMillisecond );
+    }
+
+    auto deadline = Nedrysoft::Utils::monotonicNanoseconds() + timeout;
+
+    if (!d->m_pingRequests.insert(id, pingItem, deadline)) {
+        d->m_counters.addSendErrors();
 
-    d->m_pingRequests[id] = pingItem;
+        return false;
+    }
+
+    d->m_counters.addRequest();
+
+    d->m_timingWheel.schedule(id, deadline);
+
+    return true;
 }
 
-auto Nedrysoft::ICMPPingEngine::ICMPPingEngine::removeRequest(
-        Nedrysoft::ICMPPingEngine::ICMPPingItem *pingItem ) -> void {
+auto Nedrysoft::ICMPPingEngine::ICMPPingEngine::acquireItem() -> Nedrysoft::ICMPPingEngine::ICMPPingItem * {
+    auto pingItem = d->m_itemPool.acquire();
 
-    QMutexLocker locker(&d->m_requestsMutex);
+    pingItem->reset();
 
-    auto id = Nedrysoft::Utils::fzMake32(pingItem->id(), pingItem->sequenceId());
+    return pingItem;
+}
+
+auto Nedrysoft::ICMPPingEngine::ICMPPingEngine::cancelRequest(uint32_t id) -> void {
+    auto pingItem = d->m_pingRequests.take(id);
 
-    if (d->m_pingRequests.contains(id)) {
-        d->m_pingRequests.remove(id);
+    if (pingItem) {
+        d->m_counters.cancelRequests(1);
 
-        delete pingItem;
+        d->m_itemPool.release(pingItem);
     }
+
+    d->m_counters.addSendErrors();
+}
+
+auto Nedrysoft::ICMPPingEngine::ICMPPingEngine::releaseItem(Nedrysoft::ICMPPingEngine::ICMPPingItem *pingItem) -> void {
+    d->m_itemPool.release(pingItem);
 }
 
-auto Nedrysoft::ICMPPingEngine::ICMPPingEngine::getRequest(uint32_t id) -> Nedrysoft::ICMPPingEngine::ICMPPingItem * {
-    QMutexLocker locker(&d->m_requestsMutex);
+auto Nedrysoft::ICMPPingEngine::ICMPPingEngine::itemPoolStatistics() -> Nedrysoft::ICMPPingEngine::ICMPPingItemPoolStatistics {
+    return d->m_itemPool.statistics();
+}
+
+auto Nedrysoft::ICMPPingEngine::ICMPPingEngine::setPacingMode(Nedrysoft::ICMPPingEngine::PacingMode mode) -> void {
+    d->m_pacingMode = mode;
 
-    if (d->m_pingRequests.contains(id)) {
-        return d->m_pingRequests[id];
+    if (d->m_transmitterWorker) {
+        d->m_transmitterWorker->setPacingMode(mode);
     }
+}
 
-    return nullptr;
+auto Nedrysoft::ICMPPingEngine::ICMPPingEngine::pacingMode() -> Nedrysoft::ICMPPingEngine::PacingMode {
+    return d->m_pacingMode;
+}
+
+auto Nedrysoft::ICMPPingEngine::ICMPPingEngine::schedulingStatistics() -> Nedrysoft::ICMPPingEngine::ICMPPingSchedulingStatistics {
+    return d->m_pacing.statistics();
+}
+
+auto Nedrysoft::ICMPPingEngine::ICMPPingEngine::setTimeoutMode(Nedrysoft::ICMPPingEngine::TimeoutMode mode) -> void {
+    d->m_timeoutMode = mode;
+}
+
+auto Nedrysoft::ICMPPingEngine::ICMPPingEngine::timeoutMode() -> Nedrysoft::ICMPPingEngine::TimeoutMode {
+    return d->m_timeoutMode;
+}
+
+auto Nedrysoft::ICMPPingEngine::ICMPPingEngine::setTimeoutBounds(int minimum, int maximum) -> void {
+    d->m_minimumTimeout = minimum;
+    d->m_maximumTimeout = std::max(minimum, maximum);
+}
+
+auto Nedrysoft::ICMPPingEngine::ICMPPingEngine::minimumTimeout() -> int {
+    return d->m_minimumTimeout;
+}
+
+auto Nedrysoft::ICMPPingEngine::ICMPPingEngine::maximumTimeout() -> int {
+    return d->m_maximumTimeout;
+}
+
+auto Nedrysoft::ICMPPingEngine::ICMPPingEngine::recordTransmitLateness(int64_t lateness) -> void {
+    d->m_pacing.record(lateness);
+    d->m_counters.addLateness(lateness);
+}
+
+auto Nedrysoft::ICMPPingEngine::ICMPPingEngine::recordTransmitted(int sentPackets, int queuedPackets) -> void {
+    d->m_counters.addProbesSent(static_cast<uint64_t>(sentPackets));
+
+    if (queuedPackets > sentPackets) {
+        d->m_counters.addSendErrors(static_cast<uint64_t>(queuedPackets - sentPackets));
+    }
+}
+
+auto Nedrysoft::ICMPPingEngine::ICMPPingEngine::takeRequest(
+        uint32_t id,
+        int64_t *transmitTimestamp) -> Nedrysoft::ICMPPingEngine::ICMPPingItem * {
+
+    return d->m_pingRequests.take(id, transmitTimestamp);
+}
+
+auto Nedrysoft::ICMPPingEngine::ICMPPingEngine::setTransmitTimestamp(uint32_t id, int64_t timestamp) -> void {
+    d->m_pingRequests.setTimestamp(id, timestamp);
 }
 
 auto Nedrysoft::ICMPPingEngine::ICMPPingEngine::setInterval(int interval) -> bool {
@@ -295,42 +525,70 @@ auto Nedrysoft::ICMPPingEngine::ICMPPingEngine::setTimeout(int timeout) -> bool
     return true;
 }
 
-auto Nedrysoft::ICMPPingEngine::ICMPPingEngine::timeoutRequests() -> void {
-    QMutexLocker locker(&d->m_requestsMutex);
-    QMutableMapIterator<uint32_t, Nedrysoft::ICMPPingEngine::ICMPPingItem *> i(d->m_pingRequests);
+auto Nedrysoft::ICMPPingEngine::ICMPPingEngine::setResultBatching(int interval, int batchSize) -> bool {
+    d->m_resultBatcher->setInterval(interval);
+    d->m_resultBatcher->setBatchSize(batchSize);
 
-    while (i.hasNext()) {
-        i.next();
+    return true;
+}
+
+auto Nedrysoft::ICMPPingEngine::ICMPPingEngine::metrics() -> Nedrysoft::RouteAnalyser::PingEngineMetrics {
+    auto metrics = d->m_counters.snapshot();
+
+    // the receiver is shared by all engines, so packets that are not for any engine and receive queue drops are
+    // reported for the receiver as a whole.
 
-        auto pingItem = i.value();
+    auto receiverWorker = Nedrysoft::ICMPPingEngine::ICMPPingReceiverWorker::getInstance(true);
 
-        auto elapsedTime = pingItem->elapsedTime();
+    if (receiverWorker) {
+        metrics.foreignPackets = receiverWorker->foreignPackets();
+        metrics.receiveDrops = receiverWorker->receiveDrops();
+    }
 
-        if (elapsedTime > d->m_timeout/1000.0) {
-            if (pingItem->lock()) {
-                if (!pingItem->serviced()) {
-                    QHostAddress hostAddress;
+    return metrics;
+}
 
-                    pingItem->setServiced(true);
+auto Nedrysoft::ICMPPingEngine::ICMPPingEngine::timeoutRequests() -> bool {
+    std::vector<Nedrysoft::ICMPPingEngine::ICMPPingTimingWheel::Entry> expiredRequests;
 
-                    Nedrysoft::RouteAnalyser::PingResult pingResult(
-                            pingItem->sampleNumber(),
-                            Nedrysoft::RouteAnalyser::PingResult::ResultCode::NoReply,
-                            hostAddress,
-                            pingItem->transmitEpoch(),
-                            pingItem->elapsedTime()/1e9,
-                            pingItem->target(),
-                            -1);
+    if (!d->m_timingWheel.wait(expiredRequests)) {
+        return false;
+    }
 
-                    Q_EMIT result(pingResult);
-                }
+    for (const auto &expiredRequest : expiredRequests) {
+        // requests that have already been serviced by a reply are no longer in the table.
 
-                i.remove();
+        auto pingItem = d->m_pingRequests.take(expiredRequest.key);
 
-                pingItem->unlock();
-            }
+        if (!pingItem) {
+            continue;
         }
+
+        d->m_counters.addTimeout(expiredRequest.key);
+
+        auto targetIndex = Nedrysoft::RouteAnalyser::PingResultRecord::NoTarget;
+
+        if (pingItem->target()) {
+            pingItem->target()->timeoutEstimator().addLoss();
+
+            targetIndex = pingItem->target()->resultIndex();
+        }
+
+        auto record = Nedrysoft::RouteAnalyser::PingResultRecord::create(
+            static_cast<uint32_t>(pingItem->sampleNumber()),
+            Nedrysoft::RouteAnalyser::PingResult::ResultCode::NoReply,
+            QHostAddress(),
+            pingItem->transmitTick(),
+            Nedrysoft::Utils::monotonicNanoseconds() - pingItem->transmitTick(),
+            targetIndex
+        );
+
+        d->m_itemPool.release(pingItem);
+
+        d->m_resultBatcher->addRecord(record);
     }
+
+    return true;
 }
 
 auto Nedrysoft::ICMPPingEngine::ICMPPingEngine::saveConfiguration() -> QJsonObject {
@@ -355,23 +613,68 @@ auto Nedrysoft::ICMPPingEngine::ICMPPingEngine::version() -> Nedrysoft::Core::IP
     return d->m_version;
 }
 
-void Nedrysoft::ICMPPingEngine::ICMPPingEngine::onPacketReceived(
-        QElapsedTimer receiveTimer,
-        QByteArray receiveBuffer,
-        QHostAddress receiveAddress ) {
+auto Nedrysoft::ICMPPingEngine::ICMPPingEngine::registerTarget(
+        Nedrysoft::ICMPPingEngine::ICMPPingTarget *target) -> bool {
 
-    Nedrysoft::RouteAnalyser::PingResult::ResultCode resultCode =
-        Nedrysoft::RouteAnalyser::PingResult::ResultCode::NoReply;
+    if (!d->m_receiverWorker) {
+        return false;
+    }
 
-    auto responsePacket = Nedrysoft::ICMPPacket::ICMPPacket::fromData(
-        receiveBuffer,
-        static_cast<Nedrysoft::ICMPPacket::IPVersion>(this->version())
-    );
+    if (d->m_socket) {
+        target->setId(d->m_socket->id());
 
-    if (responsePacket.resultCode() == Nedrysoft::ICMPPacket::Invalid) {
-        return;
+        return true;
+    }
+
+    for (auto attempt = 0; attempt < MaximumIdAttempts; attempt++) {
+        if (d->m_receiverWorker->registerId(target->id(), this)) {
+            return true;
+        }
+
+        target->setId(static_cast<uint16_t>(Nedrysoft::Core::ICore::getInstance()->random(1, UINT16_MAX-1)));
+    }
+
+    SPDLOG_ERROR("Unable to find a free ICMP id for target.");
+
+    return false;
+}
+
+auto Nedrysoft::ICMPPingEngine::ICMPPingEngine::createDatagramSocket(
+        Nedrysoft::ICMPSocket::IPVersion version) -> Nedrysoft::ICMPSocket::ICMPSocket * {
+
+    // rejected sockets are kept open until a free id is found, otherwise the kernel could hand out the same id again.
+
+    std::vector<std::unique_ptr<Nedrysoft::ICMPSocket::ICMPSocket>> rejectedSockets;
+
+    for (auto attempt = 0; attempt < MaximumIdAttempts; attempt++) {
+        auto socket = Nedrysoft::ICMPSocket::ICMPSocket::createDatagramSocket(version);
+
+        if (!socket) {
+            return nullptr;
+        }
+
+        // the kernel chooses the id of a datagram socket, ids outside of 1 to 0xFFFE are rejected as the keys of
+        // their requests would collide with the reserved keys of the request table.
+
+        auto isValidId = ( socket->id()!=0 ) && ( socket->id()!=UINT16_MAX );
+
+        if (( isValidId ) && ( d->m_receiverWorker->registerId(socket->id(), this) )) {
+            return socket;
+        }
+
+        rejectedSockets.emplace_back(socket);
     }
 
+    return nullptr;
+}
+
+auto Nedrysoft::ICMPPingEngine::ICMPPingEngine::processPacket(
+        const Nedrysoft::ICMPPacket::ICMPReplyView &responsePacket,
+        const Nedrysoft::ICMPSocket::ReceivedPacket &packet) -> void {
+
+    Nedrysoft::RouteAnalyser::PingResult::ResultCode resultCode =
+        Nedrysoft::RouteAnalyser::PingResult::ResultCode::NoReply;
+
     if (responsePacket.resultCode() == Nedrysoft::ICMPPacket::EchoReply) {
         resultCode = Nedrysoft::RouteAnalyser::PingResult::ResultCode::Ok;
     }
@@ -380,36 +683,69 @@ void Nedrysoft::ICMPPingEngine::ICMPPingEngine::onPacketReceived(
         resultCode = Nedrysoft::RouteAnalyser::PingResult::ResultCode::TimeExceeded;
     }
 
-    auto pingItem = this->getRequest(Nedrysoft::Utils::fzMake32(responsePacket.id(), responsePacket.sequence()));
+    int64_t transmitTimestamp = 0;
 
-    if (pingItem) {
-        auto elapsedTime = pingItem->elapsedTime();
+    auto requestId = Nedrysoft::Utils::fzMake32(responsePacket.id(), responsePacket.sequence());
+    auto pingItem = takeRequest(requestId, &transmitTimestamp);
 
-        pingItem->lock();
+    if (!pingItem) {
+        d->m_counters.addUnmatchedReply(requestId);
 
-        if (!pingItem->serviced()) {
+        return;
+    }
 
-            auto pingResult = Nedrysoft::RouteAnalyser::PingResult(
-                pingItem->sampleNumber(),
-                resultCode,
-                receiveAddress,
-                pingItem->transmitEpoch(),
-                elapsedTime,
-                pingItem->target(),
-                -1
-            );
+    d->m_counters.addReply();
 
-            pingItem->setServiced(true);
+    auto roundTripTime = Nedrysoft::Utils::monotonicNanoseconds() - pingItem->transmitTick();
+    auto timestampSource = Nedrysoft::RouteAnalyser::PingResult::TimestampSource::User;
 
-            pingItem->unlock();
+    if (packet.timestampSource == Nedrysoft::ICMPSocket::TimestampSource::Kernel) {
+        auto transmitTime = pingItem->transmitTime();
 
-            Q_EMIT Nedrysoft::ICMPPingEngine::ICMPPingEngine::result(pingResult);
+        timestampSource = Nedrysoft::RouteAnalyser::PingResult::TimestampSource::KernelReceive;
 
-            removeRequest(pingItem);
+        // the kernel transmit time must lie between the application transmit time and the receive time,
+        // anything else belongs to a different request.
+
+        if (( transmitTimestamp >= transmitTime ) && ( transmitTimestamp <= packet.timestamp )) {
+            transmitTime = transmitTimestamp;
+
+            timestampSource = Nedrysoft::RouteAnalyser::PingResult::TimestampSource::Kernel;
+        }
+
+        // kernel timestamps use the wall clock, if the clock was stepped then fall back to the monotonic timer.
+
+        if (packet.timestamp > transmitTime) {
+            roundTripTime = packet.timestamp - transmitTime;
         } else {
-            pingItem->unlock();
+            timestampSource = Nedrysoft::RouteAnalyser::PingResult::TimestampSource::User;
         }
     }
+
+    auto targetIndex = Nedrysoft::RouteAnalyser::PingResultRecord::NoTarget;
+
+    if (pingItem->target()) {
+        pingItem->target()->timeoutEstimator().addSample(roundTripTime);
+
+        targetIndex = pingItem->target()->resultIndex();
+    }
+
+    // the result is recorded without constructing any Qt types, it is converted when the batch is delivered.
+
+    auto record = Nedrysoft::RouteAnalyser::PingResultRecord::create(
+        static_cast<uint32_t>(pingItem->sampleNumber()),
+        resultCode,
+        packet.receiveAddress,
+        pingItem->transmitTick(),
+        roundTripTime,
+        targetIndex,
+        -1,
+        timestampSource
+    );
+
+    d->m_itemPool.release(pingItem);
+
+    d->m_resultBatcher->addRecord(record);
 }
 
 auto Nedrysoft::ICMPPingEngine::ICMPPingEngine::interval() -> int {
@@ -431,108 +767,251 @@ auto Nedrysoft::ICMPPingEngine::ICMPPingEngine::singleShot(
         int ttl,
         double timeout ) -> Nedrysoft::RouteAnalyser::PingResult {
 
-    Nedrysoft::ICMPSocket::ICMPSocket *writeSocket;
-    Nedrysoft::ICMPSocket::ICMPSocket *readSocket;
+    return multiShot(hostAddress, QVector<int>() << ttl, timeout).at(0);
+}
+
+auto Nedrysoft::ICMPPingEngine::ICMPPingEngine::multiShot(
+        QHostAddress hostAddress,
+        QVector<int> ttls,
+        double timeout,
+        std::function<void(int, const Nedrysoft::RouteAnalyser::PingResult &)> resultFunction ) ->
+            QVector<Nedrysoft::RouteAnalyser::PingResult> {
 
-    Nedrysoft::RouteAnalyser::PingResult pingResult;
+    Nedrysoft::ICMPSocket::ICMPSocket *writeSocket = nullptr;
+    Nedrysoft::ICMPSocket::ICMPSocket *readSocket = nullptr;
 
-    if (hostAddress.protocol() == QAbstractSocket::IPv4Protocol) {
-        writeSocket = Nedrysoft::ICMPSocket::ICMPSocket::createWriteSocket(ttl, Nedrysoft::ICMPSocket::V4);
-    } else if (hostAddress.protocol() == QAbstractSocket::IPv6Protocol) {
-        writeSocket = Nedrysoft::ICMPSocket::ICMPSocket::createWriteSocket(ttl, Nedrysoft::ICMPSocket::V6);
+    QVector<Nedrysoft::RouteAnalyser::PingResult> pingResults(ttls.count());
+
+    auto socketVersion = Nedrysoft::ICMPSocket::V4;
+
+    if (hostAddress.protocol() == QAbstractSocket::IPv6Protocol) {
+        socketVersion = Nedrysoft::ICMPSocket::V6;
     }
 
-    if (hostAddress.protocol() == QAbstractSocket::IPv4Protocol) {
-        readSocket = Nedrysoft::ICMPSocket::ICMPSocket::createReadSocket(Nedrysoft::ICMPSocket::V4);
-    } else if (hostAddress.protocol() == QAbstractSocket::IPv6Protocol) {
-        readSocket = Nedrysoft::ICMPSocket::ICMPSocket::createReadSocket(Nedrysoft::ICMPSocket::V6);
+    uint16_t id = 0;
+    bool isReservedId = false;
+
+    auto receiverWorker = Nedrysoft::ICMPPingEngine::ICMPPingReceiverWorker::getInstance();
+
+    // a datagram socket both sends the requests and receives the replies, the kernel replaces the id of the requests
+    // with the id of the socket.  The ttl is attached to each packet, so a single socket sends every ttl.
+
+    if (Nedrysoft::ICMPSocket::ICMPSocket::isDatagramSupported(socketVersion)) {
+        writeSocket = Nedrysoft::ICMPSocket::ICMPSocket::createDatagramSocket(socketVersion);
     }
 
-    QByteArray receiveBuffer;
+    if (writeSocket) {
+        id = writeSocket->id();
+    } else {
+        // every raw read socket sees every reply, so the id is reserved to keep it unique between the discoveries
+        // that run at the same time and the read socket is filtered to it.
 
-    // TODO: fix
+        for (auto attempt = 0; attempt < MaximumIdAttempts; attempt++) {
+            id = static_cast<uint16_t>(Nedrysoft::Core::ICore::getInstance()->random(1, UINT16_MAX-1));
 
-    int id = 6666;
-    int sequenceId = 5555 + ttl;
+            if (receiverWorker->reserveId(id)) {
+                isReservedId = true;
 
-    auto buffer = Nedrysoft::ICMPPacket::ICMPPacket::pingPacket(
-        id,
-        sequenceId,
-        52,
-        hostAddress,
-        static_cast<Nedrysoft::ICMPPacket::IPVersion>(version())
-    );
+                break;
+            }
+        }
+
+        if (isReservedId) {
+            writeSocket = Nedrysoft::ICMPSocket::ICMPSocket::createWriteSocket(0, socketVersion);
+            readSocket = Nedrysoft::ICMPSocket::ICMPSocket::createReadSocket(socketVersion);
+        } else {
+            SPDLOG_ERROR("Unable to find a free ICMP id for the request.");
+        }
+
+        if (readSocket) {
+            readSocket->setFilter(QVector<uint16_t>() << id);
+        }
+    }
+
+    auto receiveSocket = readSocket ? readSocket : writeSocket;
+
+    if (( !writeSocket ) || ( !receiveSocket )) {
+        delete writeSocket;
+        delete readSocket;
+
+        if (isReservedId) {
+            receiverWorker->releaseId(id);
+        }
+
+        // the caller is still given a result for every ttl, so that it does not wait for replies that cannot arrive.
+
+        if (resultFunction) {
+            for (auto index = 0; index < ttls.count(); index++) {
+                resultFunction(index, pingResults.at(index));
+            }
+        }
+
+        return pingResults;
+    }
+
+    auto ipVersion = static_cast<Nedrysoft::ICMPPacket::IPVersion>(socketVersion);
+    auto format = Nedrysoft::ICMPPacket::PacketFormat::Raw;
+
+    if (receiveSocket->isDatagram()) {
+        format = Nedrysoft::ICMPPacket::PacketFormat::Datagram;
+    }
+
+    // each request is sent with its own sequence id, which is used to find the request that a reply belongs to.  A
+    // ttl may be requested more than once, as the sequence id is part of the checksum each of the requests is
+    // hashed to its own flow by routers that balance load on the ICMP header.
+
+    QHash<uint16_t, int> sequenceIndexes;
+
+    // the round trip time of each reply is measured from the time that its request was flushed to the receive
+    // timestamp of the reply, so replies that are read in the same batch still have their own round trip time.
+
+    QVector<int64_t> transmitTimes(ttls.count());
+    auto unsentIndex = 0;
+
+    auto flushRequests = [&](int endIndex) {
+        auto transmitTime = Nedrysoft::ICMPSocket::realtimeNanoseconds();
+
+        writeSocket->flush();
+
+        for (;unsentIndex<endIndex;unsentIndex++) {
+            transmitTimes[unsentIndex] = transmitTime;
+        }
+    };
+
+    for (auto index = 0; index < ttls.count(); index++) {
+        auto sequenceId = static_cast<uint16_t>(SingleShotSequenceId + index);
+
+        auto buffer = Nedrysoft::ICMPPacket::ICMPPacket::pingPacket(
+            id,
+            sequenceId,
+            52,
+            hostAddress,
+            ipVersion
+        );
+
+        auto queueResult = writeSocket->queue(buffer, hostAddress, ttls.at(index));
+
+        if (queueResult == Nedrysoft::ICMPSocket::QueueResult::Full) {
+            flushRequests(index);
+
+            queueResult = writeSocket->queue(buffer, hostAddress, ttls.at(index));
+        }
+
+        // a request that the socket rejected is reported straight away rather than waiting for the timeout.
+
+        if (queueResult != Nedrysoft::ICMPSocket::QueueResult::Queued) {
+            if (resultFunction) {
+                resultFunction(index, pingResults.at(index));
+            }
+
+            continue;
+        }
+
+        sequenceIndexes.insert(sequenceId, index);
+    }
 
     auto transmitEpoch = QDateTime::currentDateTime();
 
-    writeSocket->sendto(buffer, hostAddress);
+    flushRequests(ttls.count());
 
-    QHostAddress receiveAddress;
+    QVector<Nedrysoft::ICMPSocket::ReceivedPacket> receivedPackets;
 
     QElapsedTimer timer;
 
     timer.start();
 
-    while(timer.elapsed()<(SecondsToMs(timeout))) {
-        auto remaining = DefaultReceiveTimeout-timer.elapsed();
+    while (( !sequenceIndexes.isEmpty() ) && ( timer.elapsed() < SecondsToMs(timeout) )) {
+        auto remaining = SecondsToMs(timeout)-timer.elapsed();
 
         if (remaining<=0) {
-            return pingResult;
+            break;
         }
 
-        if (readSocket->recvfrom(receiveBuffer, receiveAddress, remaining)) {
-            auto responseTime = QDateTime::currentDateTime();
-            auto roundTripTime = timer.nsecsElapsed();
+        if (receiveSocket->recvmmsg(receivedPackets, static_cast<int>(remaining)) <= 0) {
+            continue;
+        }
 
-            Nedrysoft::RouteAnalyser::PingResult::ResultCode resultCode;
+        for (const auto &receivedPacket : receivedPackets) {
+            auto packetData = gsl::span<const uint8_t>(
+                reinterpret_cast<const uint8_t *>(receivedPacket.buffer.constData()),
+                receivedPacket.buffer.length() );
 
-            if (!receiveBuffer.length()) {
-                continue;
-            }
+            // errors reported on the error queue of a datagram socket carry the echo request that was sent.
 
-            auto responsePacket = Nedrysoft::ICMPPacket::ICMPPacket::fromData(
-                receiveBuffer,
-                static_cast<Nedrysoft::ICMPPacket::IPVersion>(this->version())
-            );
+            auto responsePacket = ( receivedPacket.errorType != -1 ) ?
+                Nedrysoft::ICMPPacket::ICMPReplyView::fromError(
+                    packetData,
+                    ipVersion,
+                    receivedPacket.errorType,
+                    receivedPacket.errorCode ) :
+                Nedrysoft::ICMPPacket::ICMPReplyView(packetData, ipVersion, format);
 
-            if ((responsePacket.id()!=id) || (responsePacket.sequence()!=sequenceId)) {
+            if (!responsePacket.isValid()) {
                 continue;
             }
 
-            if (responsePacket.resultCode() == Nedrysoft::ICMPPacket::Invalid) {
+            if (( responsePacket.id() != id ) || ( !sequenceIndexes.contains(responsePacket.sequence()) )) {
                 continue;
             }
 
-            if (responsePacket.resultCode() == Nedrysoft::ICMPPacket::EchoReply) {
-                resultCode = Nedrysoft::RouteAnalyser::PingResult::ResultCode::Ok;
-            }
+            auto index = sequenceIndexes.take(responsePacket.sequence());
+            auto ttl = ttls.at(index);
+            auto roundTripTime = std::max<int64_t>(receivedPacket.timestamp-transmitTimes.at(index), 0);
+
+            auto resultCode = Nedrysoft::RouteAnalyser::PingResult::ResultCode::Ok;
 
             if (responsePacket.resultCode() == Nedrysoft::ICMPPacket::TimeExceeded) {
                 resultCode = Nedrysoft::RouteAnalyser::PingResult::ResultCode::TimeExceeded;
             }
 
+            // a datagram socket does not return the IP header, the ttl is reported as ancillary data instead.
+
+            auto replyTtl = responsePacket.ttl();
+
+            if (replyTtl == -1) {
+                replyTtl = receivedPacket.ttl;
+            }
+
             int hopsToTarget = -1;
 
-            if (responsePacket.ttl()!=-1) {
-                hopsToTarget = ttl-responsePacket.ttl();
+            if (replyTtl!=-1) {
+                hopsToTarget = ttl-replyTtl;
             }
 
-            pingResult = Nedrysoft::RouteAnalyser::PingResult(
+            pingResults[index] = Nedrysoft::RouteAnalyser::PingResult(
                 0,
                 resultCode,
-                receiveAddress,
+                receivedPacket.receiveAddress,
                 transmitEpoch,
-                roundTripTime/1e9,
+                static_cast<double>(roundTripTime)/1e9,
                 nullptr,
                 hopsToTarget
             );
 
-            break;
+            if (resultFunction) {
+                resultFunction(index, pingResults.at(index));
+            }
         }
     }
 
     delete writeSocket;
     delete readSocket;
 
-    return pingResult;
+    if (isReservedId) {
+        receiverWorker->releaseId(id);
+    }
+
+    // the requests that were not answered are reported once the timeout has expired.
+
+    if (resultFunction) {
+        for (auto index : sequenceIndexes) {
+            resultFunction(index, pingResults.at(index));
+        }
+    }
+
+    return pingResults;
+}
+
+auto Nedrysoft::ICMPPingEngine::ICMPPingEngine::hasParallelMultiShot() -> bool {
+    return true;
 }
\ No newline at end of file
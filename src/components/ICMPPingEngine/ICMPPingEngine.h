@@ -24,17 +24,26 @@
 #ifndef PINGNOO_COMPONENTS_ICMPPINGENGINE_ICMPPINGENGINE_H
 #define PINGNOO_COMPONENTS_ICMPPINGENGINE_ICMPPINGENGINE_H
 
+#include "ICMPPingItemPool.h"
+#include "ICMPPingPacing.h"
+#include "ICMPPingTimeoutEstimator.h"
+#include "ICMPSocket/ICMPSocket.h"
+
 #include <IInterface>
 #include <IPingEngine>
 #include <IPingEngineFactory>
-#include <QElapsedTimer>
 #include <QDateTime>
 #include <memory>
 
+namespace Nedrysoft { namespace ICMPPacket {
+    class ICMPReplyView;
+}}
+
 namespace Nedrysoft { namespace ICMPPingEngine {
     class ICMPPingEngineData;
     class ICMPPingTransitter;
     class ICMPPingItem;
+    class ICMPPingTarget;
 
     /**
      * @brief       THe ICMPPingEngine provides a ICMP socket ping engine implementation.
@@ -89,6 +98,30 @@ namespace Nedrysoft { namespace ICMPPingEngine {
              */
             auto setTimeout(int timeout) -> bool override;
 
+            /**
+             * @brief       Sets when a batch of results is delivered.
+             *
+             * @see         Nedrysoft::RouteAnalyser::IPingEngine::setResultBatching
+             *
+             * @param[in]   interval the longest time in milliseconds that a result waits for its batch.
+             * @param[in]   batchSize the number of results after which a batch is delivered without waiting.
+             *
+             * @returns     true on success; otherwise false.
+             */
+            auto setResultBatching(int interval, int batchSize) -> bool override;
+
+            /**
+             * @brief       Returns a snapshot of the engine counters.
+             *
+             * @details     Foreign packets and receive queue drops are counted by the receiver that is shared by all
+             *              ICMP engines, so they are totals for the process rather than for this engine.
+             *
+             * @see         Nedrysoft::RouteAnalyser::IPingEngine::metrics
+             *
+             * @returns     the metrics of the engine.
+             */
+            auto metrics() -> Nedrysoft::RouteAnalyser::PingEngineMetrics override;
+
             /**
              * @brief       Starts ping operations for this engine instance.
              *
@@ -147,6 +180,38 @@ namespace Nedrysoft { namespace ICMPPingEngine {
                 double timeout
             ) -> Nedrysoft::RouteAnalyser::PingResult override;
 
+            /**
+             * @brief       Transmits a single ping for each of a list of TTL's.
+             *
+             * @details     The pings are sent together from one socket, the TTL is attached to each packet, and
+             *              the replies are collected until every TTL has been answered or the timeout expires.
+             *
+             * @see         Nedrysoft::RouteAnalyser::IPingEngine::multiShot
+             *
+             * @param[in]   hostAddress the target host address.
+             * @param[in]   ttls the time to live of each ping.
+             * @param[in]   timeout time in seconds to wait for the responses.
+             * @param[in]   resultFunction if set, called with the index of the TTL and its result as each reply
+             *              is received.
+             *
+             * @returns     the result for each TTL, in the order of ttls.
+             */
+            auto multiShot(
+                QHostAddress hostAddress,
+                QVector<int> ttls,
+                double timeout,
+                std::function<void(int, const Nedrysoft::RouteAnalyser::PingResult &)> resultFunction = nullptr
+            ) -> QVector<Nedrysoft::RouteAnalyser::PingResult> override;
+
+            /**
+             * @brief       Returns whether multiShot() sends the pings together.
+             *
+             * @see         Nedrysoft::RouteAnalyser::IPingEngine::hasParallelMultiShot
+             *
+             * @returns     true.
+             */
+            auto hasParallelMultiShot() -> bool override;
+
             /**
              * @brief       Removes a ping target from this engine instance.
              *
@@ -195,50 +260,202 @@ namespace Nedrysoft { namespace ICMPPingEngine {
              */
             auto loadConfiguration(QJsonObject configuration) -> bool override;
 
-        private:
             /**
-             * @brief       Called when a ICMP packet is available for processing.
+             * @brief       Returns the allocation counters of the ping item pool.
+             *
+             * @details     Ping items are taken from a pool that is allocated when the engine is created, once
+             *              running the engine should not allocate items, which can be confirmed by the
+             *              heapAllocations counter remaining at zero.
+             *
+             * @returns     the pool statistics.
+             */
+            auto itemPoolStatistics() -> Nedrysoft::ICMPPingEngine::ICMPPingItemPoolStatistics;
+
+            /**
+             * @brief       Sets how the probes of each round are spread across the interval.
+             *
+             * @details     Spreading the probes avoids sending every TTL of a route as a burst, which can be
+             *              dropped by routers that rate limit ICMP and reported as loss on the deeper hops.  The
+             *              default is Burst, which sends each round with a single batched call, the paced modes
+             *              send each probe separately and must be selected by the caller.
+             *
+             * @param[in]   mode the pacing mode.
+             */
+            auto setPacingMode(Nedrysoft::ICMPPingEngine::PacingMode mode) -> void;
+
+            /**
+             * @brief       Returns the pacing mode.
+             *
+             * @returns     the pacing mode.
+             */
+            auto pacingMode() -> Nedrysoft::ICMPPingEngine::PacingMode;
+
+            /**
+             * @brief       Returns how late probes were sent compared to their scheduled transmit time.
+             *
+             * @returns     the scheduling statistics.
+             */
+            auto schedulingStatistics() -> Nedrysoft::ICMPPingEngine::ICMPPingSchedulingStatistics;
+
+            /**
+             * @brief       Sets how the reply timeout of a request is chosen.
              *
-             * @param[in]   receiveTimer a timer started when the packet was received.
-             * @param[in]   receiveBuffer the actual packet data.
-             * @param[in]   receiveAddress the IP address that the response came from (may be different to target).
+             * @details     In fixed mode every request is given the timeout set by setTimeout().  In adaptive mode
+             *              each target is given a timeout estimated from its own round trip times, so nearby hops
+             *              release their requests sooner and distant hops are not reported as lost when their
+             *              replies take longer than the fixed timeout.  The mode takes effect from the next request.
+             *
+             * @param[in]   mode the timeout mode.
              */
-            Q_SLOT void onPacketReceived(
-                QElapsedTimer receiveTimer,
-                QByteArray receiveBuffer,
-                QHostAddress receiveAddress
-            );
+            auto setTimeoutMode(Nedrysoft::ICMPPingEngine::TimeoutMode mode) -> void;
+
+            /**
+             * @brief       Returns the timeout mode.
+             *
+             * @returns     the timeout mode.
+             */
+            auto timeoutMode() -> Nedrysoft::ICMPPingEngine::TimeoutMode;
+
+            /**
+             * @brief       Sets the bounds of the timeout in adaptive mode.
+             *
+             * @param[in]   minimum the smallest timeout in milliseconds.
+             * @param[in]   maximum the largest timeout in milliseconds, this is also used for a target until its
+             *              first reply is received.
+             */
+            auto setTimeoutBounds(int minimum, int maximum) -> void;
+
+            /**
+             * @brief       Returns the smallest timeout in adaptive mode.
+             *
+             * @returns     the timeout in milliseconds.
+             */
+            auto minimumTimeout() -> int;
+
+            /**
+             * @brief       Returns the largest timeout in adaptive mode.
+             *
+             * @returns     the timeout in milliseconds.
+             */
+            auto maximumTimeout() -> int;
 
         protected:
             /**
-             * @brief       Checks for any timed out requests and removes and signals that a timeout occurred.
+             * @brief       Processes a reply that the receiver has routed to this engine.
+             *
+             * @details     Called on the receiver thread for each packet whose ICMP id belongs to one of the
+             *              targets of this engine, the packet has already been parsed by the receiver.
+             *
+             * @see         Nedrysoft::ICMPPingEngine::ICMPPingReceiverWorker::registerId
+             *
+             * @param[in]   responsePacket the parsed view of the ICMP packet.
+             * @param[in]   packet the received packet, containing the address that the response came from (may
+             *              be different to target) and the receive timestamp.
+             */
+            auto processPacket(
+                const Nedrysoft::ICMPPacket::ICMPReplyView &responsePacket,
+                const Nedrysoft::ICMPSocket::ReceivedPacket &packet
+            ) -> void;
+
+            /**
+             * @brief       Registers the ICMP id of a target with the receiver.
+             *
+             * @details     Ids are chosen at random, if the id is already in use by another engine then a new id
+             *              is assigned to the target so that replies can always be routed to a single engine.
+             *
+             *              When the engine sends on a datagram socket the kernel replaces the id of every request
+             *              with the id of the socket, so the target is given the id of the socket instead.
+             *
+             * @param[in]   target the target to register.
+             *
+             * @returns     true if the id was registered; otherwise false.
+             */
+            auto registerTarget(Nedrysoft::ICMPPingEngine::ICMPPingTarget *target) -> bool;
+
+            /**
+             * @brief       Creates the datagram socket of the engine and registers its id with the receiver.
+             *
+             * @details     The kernel chooses the id of a datagram socket, if it is already in use by another
+             *              engine (i.e an engine using a raw socket or the other IP version) then further sockets
+             *              are created until a free id is found.
+             *
+             * @param[in]   version the IP version of the socket.
+             *
+             * @returns     the socket; nullptr if a socket could not be created.
+             */
+            auto createDatagramSocket(Nedrysoft::ICMPSocket::IPVersion version) -> Nedrysoft::ICMPSocket::ICMPSocket *;
+
+            /**
+             * @brief       Waits for the next request deadline, then removes and signals any timed out requests.
+             *
+             * @details     Requests are scheduled on a timing wheel when they are added, this blocks until the
+             *              earliest deadline has passed (or a new request with an earlier deadline is added), so
+             *              timeouts are reported at their deadline without polling the request table.
              *
              * @see         Nedrysoft::ICMPPingEngine::ICMPPingTimeout
+             *
+             * @returns     true if requests were processed; false if the engine is stopping.
              */
-            auto timeoutRequests(void) -> void;
+            auto timeoutRequests(void) -> bool;
 
             /**
              * @brief       Adds a ping request to the engine so it can be tracked.
              *
-             * @details     Adds a ping request to the list of requests, the engine maintains a list of currently
-             *              active requests and uses these to correlate responses and handle timeouts.
+             * @details     Adds a ping request to the table of requests, the engine maintains a table of currently
+             *              active requests and uses these to correlate responses and handle timeouts.  The
+             *              request table is lock-free, so this may be called from the transmitter thread while
+             *              the receiver and timeout threads are servicing requests.  The request is also scheduled
+             *              on the timing wheel so that the timeout thread is woken at its deadline.
              *
              * @param[in]   pingItem the item being tracked.
+             *
+             * @returns     true if the request was added; otherwise false if the request table is full.
+             */
+            auto addRequest(Nedrysoft::ICMPPingEngine::ICMPPingItem *pingItem) -> bool;
+
+            /**
+             * @brief       Takes a ping item from the pool of the engine.
+             *
+             * @details     The item is reset, the caller owns it until it is passed to releaseItem().
+             *
+             * @returns     the ping item.
              */
-            auto addRequest(Nedrysoft::ICMPPingEngine::ICMPPingItem *pingItem) -> void;
+            auto acquireItem() -> Nedrysoft::ICMPPingEngine::ICMPPingItem *;
 
             /**
-             * @brief       Removes a tracked request and deletes the item.
+             * @brief       Withdraws a request that was added but could not be sent.
              *
-             * @details     Removes a tracked request and deletes the item, when a ping response (either an echo reply
-             *              or ttl exceeded) is received the request can be removed from the engine.
+             * @details     The request is removed from the request table and its ping item returned to the pool,
+             *              the request is counted as a send error.
              *
-             * @param[in]   pingItem is the item to be removed.
+             * @param[in]   id the id of the request, constructed in the same manner as for takeRequest().
              */
-            auto removeRequest(Nedrysoft::ICMPPingEngine::ICMPPingItem *pingItem) -> void;
+            auto cancelRequest(uint32_t id) -> void;
 
             /**
-             * @brief       Returns a tracked request by id.
+             * @brief       Returns a ping item to the pool of the engine.
+             *
+             * @param[in]   pingItem the ping item, as returned by acquireItem().
+             */
+            auto releaseItem(Nedrysoft::ICMPPingEngine::ICMPPingItem *pingItem) -> void;
+
+            /**
+             * @brief       Records the lateness of a probe sent by the transmitter.
+             *
+             * @param[in]   lateness the time in nanoseconds between the scheduled and actual transmit time.
+             */
+            auto recordTransmitLateness(int64_t lateness) -> void;
+
+            /**
+             * @brief       Records the result of a flush of the transmit queue.
+             *
+             * @param[in]   sentPackets the number of packets that were sent.
+             * @param[in]   queuedPackets the number of packets that were queued.
+             */
+            auto recordTransmitted(int sentPackets, int queuedPackets) -> void;
+
+            /**
+             * @brief       Removes a tracked request by id and returns it.
              *
              * @details     Finds the request by the id that was received in the packet, as the engine needs to
              *              figure out which response relates to a request to figure out the round trip time it uses
@@ -246,11 +463,32 @@ namespace Nedrysoft { namespace ICMPPingEngine {
              *
              *                  (icmp_id<<16) | icmp_sequence_id
              *
+             *              A request can only be taken once, the caller becomes the owner of the returned item and
+             *              is responsible for returning it to the pool with releaseItem().  This ensures that a
+             *              request is either reported as a reply or a timeout, but never both.
+             *
              * @param[in]   id is the request to find.
+             * @param[out]  transmitTimestamp if not null, receives the kernel transmit timestamp of the request, or
+             *              0 if none was recorded.
              *
              * @returns     returns the request if found; nullptr otherwise.
              */
-            auto getRequest(uint32_t id) -> Nedrysoft::ICMPPingEngine::ICMPPingItem *;
+            auto takeRequest(
+                uint32_t id,
+                int64_t *transmitTimestamp = nullptr
+            ) -> Nedrysoft::ICMPPingEngine::ICMPPingItem *;
+
+            /**
+             * @brief       Records the kernel transmit timestamp of a tracked request.
+             *
+             * @details     Kernel transmit timestamps are read from the write socket after the packet has been sent,
+             *              at which point the request may already have been serviced, in which case the timestamp is
+             *              discarded.
+             *
+             * @param[in]   id the request id, constructed as described in takeRequest().
+             * @param[in]   timestamp the transmit time in nanoseconds since the unix epoch.
+             */
+            auto setTransmitTimestamp(uint32_t id, int64_t timestamp) -> void;
 
             /**
              * @brief       Sets the transmission epoch.
@@ -25,6 +25,8 @@
 #include "ICMPPingEngine.h"
 #include "ICMPPingReceiverWorker.h"
 
+constexpr auto LinuxPriority = 0.9;
+
 /**
  * @brief       Private class to store the ping engines instance data.
  */
@@ -91,12 +93,19 @@ auto Nedrysoft::ICMPPingEngine::ICMPPingEngineFactory::description() -> QString
 
 auto Nedrysoft::ICMPPingEngine::ICMPPingEngineFactory::priority() -> double {
 #if defined(Q_OS_LINUX)
+    // unprivileged datagram sockets are used when the group of the process is allowed to create them.  The io_uring
+    // engine uses the same sockets and is preferred where the kernel supports it.
+
+    if (Nedrysoft::ICMPSocket::ICMPSocket::isDatagramSupported(Nedrysoft::ICMPSocket::V4)) {
+        return LinuxPriority;
+    }
+
     auto socket = Nedrysoft::ICMPSocket::ICMPSocket::createReadSocket(Nedrysoft::ICMPSocket::V4);
 
     if (socket) {
         delete socket;
 
-        return 1;
+        return LinuxPriority;
     }
 
     return 0;
@@ -106,6 +115,10 @@ auto Nedrysoft::ICMPPingEngine::ICMPPingEngineFactory::priority() -> double {
 
 auto Nedrysoft::ICMPPingEngine::ICMPPingEngineFactory::available() -> bool {
 #if defined(Q_OS_LINUX)
+    if (Nedrysoft::ICMPSocket::ICMPSocket::isDatagramSupported(Nedrysoft::ICMPSocket::V4)) {
+        return true;
+    }
+
     auto socket = Nedrysoft::ICMPSocket::ICMPSocket::createReadSocket(Nedrysoft::ICMPSocket::V4);
 
     if (socket) {
@@ -23,20 +23,35 @@
 
 #include "ICMPPingItem.h"
 
-#include <QTimer>
+#include "ICMPSocket/ICMPSocket.h"
+#include "Utils.h"
+
+constexpr auto NanosecondsInMillisecond = 1000000;
+constexpr auto NanosecondsInSecond = 1e9;
 
 Nedrysoft::ICMPPingEngine::ICMPPingItem::ICMPPingItem() :
+        m_transmitTick(0),
+        m_transmitTime(0),
+        m_target(nullptr),
+        m_sampleNumber(0),
         m_id(0),
         m_sequenceId(0),
-        m_serviced(false),
-        m_target(nullptr),
-        m_sampleNumber(0) {
+        m_serviced(false) {
 
 }
 
-Nedrysoft::ICMPPingEngine::ICMPPingItem::~ICMPPingItem() {
-    //m_mutex.unlock();
-};
+Nedrysoft::ICMPPingEngine::ICMPPingItem::~ICMPPingItem() = default;
+
+auto Nedrysoft::ICMPPingEngine::ICMPPingItem::reset() -> void {
+    m_transmitTick = 0;
+    m_transmitTime = 0;
+    m_target = nullptr;
+    m_sampleNumber = 0;
+    m_id = 0;
+    m_sequenceId = 0;
+
+    m_serviced.store(false, std::memory_order_relaxed);
+}
 
 auto Nedrysoft::ICMPPingEngine::ICMPPingItem::setId(uint16_t id) -> void {
     m_id = id;
@@ -51,20 +66,16 @@ auto Nedrysoft::ICMPPingEngine::ICMPPingItem::sequenceId() -> uint16_t {
 }
 
 auto Nedrysoft::ICMPPingEngine::ICMPPingItem::startTimer() -> void {
-    m_elapsedTimer.restart();
-    m_transmitEpoch = QDateTime::currentDateTime();
-}
-
-auto Nedrysoft::ICMPPingEngine::ICMPPingItem::stopTimer() -> void {
-    m_elapsedTime = m_elapsedTimer.nsecsElapsed();
+    m_transmitTick = Nedrysoft::Utils::monotonicNanoseconds();
+    m_transmitTime = Nedrysoft::ICMPSocket::realtimeNanoseconds();
 }
 
 auto Nedrysoft::ICMPPingEngine::ICMPPingItem::setServiced(bool serviced) -> void {
-    m_serviced = serviced;
+    m_serviced.store(serviced, std::memory_order_release);
 }
 
 auto Nedrysoft::ICMPPingEngine::ICMPPingItem::serviced() -> bool {
-    return m_serviced;
+    return m_serviced.load(std::memory_order_acquire);
 }
 
 auto Nedrysoft::ICMPPingEngine::ICMPPingItem::id() -> uint16_t {
@@ -80,11 +91,19 @@ auto Nedrysoft::ICMPPingEngine::ICMPPingItem::target() -> Nedrysoft::ICMPPingEng
 }
 
 auto Nedrysoft::ICMPPingEngine::ICMPPingItem::elapsedTime() -> double {
-    return static_cast<double>(m_elapsedTimer.nsecsElapsed())/static_cast<double>(1e9);
+    return static_cast<double>(Nedrysoft::Utils::monotonicNanoseconds() - m_transmitTick) / NanosecondsInSecond;
+}
+
+auto Nedrysoft::ICMPPingEngine::ICMPPingItem::transmitTime() -> int64_t {
+    return m_transmitTime;
+}
+
+auto Nedrysoft::ICMPPingEngine::ICMPPingItem::transmitTick() -> int64_t {
+    return m_transmitTick;
 }
 
 auto Nedrysoft::ICMPPingEngine::ICMPPingItem::transmitEpoch() -> QDateTime {
-    return m_transmitEpoch;
+    return QDateTime::fromMSecsSinceEpoch(m_transmitTime / NanosecondsInMillisecond);
 }
 
 auto Nedrysoft::ICMPPingEngine::ICMPPingItem::setSampleNumber(unsigned long sampleNumber) -> void {
@@ -94,11 +113,3 @@ auto Nedrysoft::ICMPPingEngine::ICMPPingItem::setSampleNumber(unsigned long samp
 auto Nedrysoft::ICMPPingEngine::ICMPPingItem::sampleNumber() -> unsigned long {
     return m_sampleNumber;
 }
-
-auto Nedrysoft::ICMPPingEngine::ICMPPingItem::lock() -> bool {
-    return m_mutex.tryLock();
-}
-
-auto Nedrysoft::ICMPPingEngine::ICMPPingItem::unlock() -> void {
-    m_mutex.unlock();
-}
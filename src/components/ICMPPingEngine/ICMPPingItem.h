@@ -25,9 +25,8 @@
 #define PINGNOO_COMPONENTS_ICMPPINGENGINE_ICMPPINGITEM_H
 
 #include <QDateTime>
-#include <QElapsedTimer>
-#include <QMutex>
-#include <QObject>
+#include <atomic>
+#include <cstdint>
 
 namespace Nedrysoft { namespace ICMPPingEngine {
     class ICMPPingTarget;
@@ -38,13 +37,12 @@ namespace Nedrysoft { namespace ICMPPingEngine {
      * @details     The ICMPPingTransmitter instance registers each ping request with the engine, this class holds the
      *              required information to allow replies to be matched to requests (and timed) and also to allow
      *              timeouts to be discovered.
+     *
+     *              Items are allocated from the ICMPPingItemPool of the engine and reused, so the class is kept
+     *              small and free of heap allocated members, the transmission time is stored as clock ticks and
+     *              only converted to a QDateTime when a result is reported.
      */
-    class ICMPPingItem :
-            public QObject {
-
-        private:
-            Q_OBJECT
-
+    class ICMPPingItem {
         public:
             /**
              * @brief       Constructs an ICMPPingItem.
@@ -56,6 +54,11 @@ namespace Nedrysoft { namespace ICMPPingEngine {
              */
             ~ICMPPingItem();
 
+            /**
+             * @brief       Clears the item so that it can be reused for a new request.
+             */
+            auto reset() -> void;
+
             /**
              * @brief       Sets the id used in the ping request.
              *
@@ -135,26 +138,28 @@ namespace Nedrysoft { namespace ICMPPingEngine {
             auto startTimer() -> void;
 
             /**
-             * @brief       Records the current elapsed time.
+             * @brief       Returns the current time elapsed from transmission.
              *
-             * @note        This doesn't actually stop the timer, that is not possible with QElapsedTimer, instead
-             *              it just records the current elapsed time in a variable.
+             * @returns     the time in seconds.
              */
-            auto stopTimer()-> void;
+            auto elapsedTime(void) -> double;
 
             /**
-             * @brief       Returns the current time elapsed from transmission.
+             * @brief       Returns the wall clock time at which the request was transmitted.
+             *
+             * @details     This is taken from the same clock as kernel packet timestamps so that the round trip
+             *              time can be calculated from a kernel receive timestamp.
              *
-             * @returns     the time in milliseconds.
+             * @returns     the time in nanoseconds since the unix epoch.
              */
-            auto elapsedTime(void) -> double;
+            auto transmitTime() -> int64_t;
 
             /**
-             * @brief       Returns the the round trip time from the request to response.
+             * @brief       Returns the monotonic clock time at which the request was transmitted.
              *
-             * @returns     the time in seconds.
+             * @returns     the time in nanoseconds, as returned by Nedrysoft::Utils::monotonicNanoseconds().
              */
-            auto roundTripTime() -> double;
+            auto transmitTick() -> int64_t;
 
             /**
              * @brief       Returns the epoch at which the request was transmitted.
@@ -163,36 +168,20 @@ namespace Nedrysoft { namespace ICMPPingEngine {
              */
             auto transmitEpoch() -> QDateTime;
 
-            /**
-             * @brief       Locks the item for exclusive access.
-             *
-             * @returns     returns true if the item was locked; otherwise false.
-             */
-            auto lock(void) -> bool;
-
-            /**
-             * @brief       Unlocks the item that was previous locked.
-             */
-            auto unlock(void) -> void;
-
         private:
             //! @cond
 
-            QElapsedTimer m_elapsedTimer;
-            QDateTime m_transmitEpoch;
-
-            int64_t m_elapsedTime;
-
-            uint16_t m_id;
-            uint16_t m_sequenceId;
-
-            bool m_serviced;
+            int64_t m_transmitTick;
+            int64_t m_transmitTime;
 
             Nedrysoft::ICMPPingEngine::ICMPPingTarget *m_target;
 
             unsigned long m_sampleNumber;
 
-            QMutex m_mutex;
+            uint16_t m_id;
+            uint16_t m_sequenceId;
+
+            std::atomic<bool> m_serviced;
 
             //! @endcond
     };
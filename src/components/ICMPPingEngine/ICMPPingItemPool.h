@@ -0,0 +1,227 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 18/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PINGNOO_COMPONENTS_ICMPPINGENGINE_ICMPPINGITEMPOOL_H
+#define PINGNOO_COMPONENTS_ICMPPINGENGINE_ICMPPINGITEMPOOL_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+namespace Nedrysoft { namespace ICMPPingEngine {
+    /**
+     * @brief       The ICMPPingItemPoolStatistics structure holds a snapshot of the counters of a pool.
+     */
+    struct ICMPPingItemPoolStatistics {
+        uint64_t acquired;                  /**< the number of items handed out by the pool. */
+        uint64_t released;                  /**< the number of items returned to the pool. */
+        uint64_t heapAllocations;           /**< the number of items that were allocated because the slab was empty. */
+        size_t capacity;                    /**< the number of items in the slab. */
+    };
+
+    /**
+     * @brief       The ICMPPingItemPool class is a fixed capacity lock-free pool of objects.
+     *
+     * @details     All objects are allocated in a single slab when the pool is constructed, acquire() and
+     *              release() then move objects on and off a free list without allocating memory, so the
+     *              transmitter, receiver and timeout threads can exchange objects without contending on a mutex
+     *              or the heap.
+     *
+     *              The free list is a stack of slab indexes, the head is a 64 bit word made up of a version
+     *              (high 32 bits) and the index of the first free object (low 32 bits).  The version is
+     *              incremented on every push and pop, so a thread that read the head can detect that the stack
+     *              was modified in the meantime (the ABA problem).
+     *
+     *              If the slab is exhausted, acquire() falls back to allocating an object on the heap, release()
+     *              deletes these rather than returning them to the free list.  The heapAllocations counter
+     *              therefore stays at zero while the number of objects in use fits in the slab.
+     *
+     * @note        Objects are not reconstructed when they are reused, the caller is responsible for resetting
+     *              the state of an acquired object.
+     *
+     * @tparam      T the type of the object, must be default constructible.
+     * @tparam      Capacity the number of objects in the slab.
+     */
+    template<typename T, size_t Capacity>
+    class ICMPPingItemPool {
+        private:
+            static_assert(( Capacity > 0 ) && ( Capacity < UINT32_MAX ), "Capacity must fit in 32 bits");
+
+            static constexpr uint32_t EndOfList = UINT32_MAX;
+
+        public:
+            /**
+             * @brief       Constructs an ICMPPingItemPool with every object in the slab free.
+             */
+            ICMPPingItemPool() :
+                    m_items(std::make_unique<T[]>(Capacity)),
+                    m_next(std::make_unique<std::atomic<uint32_t>[]>(Capacity)),
+                    m_head(makeHead(0, 0)),
+                    m_acquired(0),
+                    m_released(0),
+                    m_heapAllocations(0) {
+
+                for (size_t index = 0; index < Capacity; index++) {
+                    m_next[index].store(
+                        ( index + 1 < Capacity ) ? static_cast<uint32_t>(index + 1) : EndOfList,
+                        std::memory_order_relaxed );
+                }
+            }
+
+            ICMPPingItemPool(const ICMPPingItemPool &) = delete;
+            ICMPPingItemPool &operator=(const ICMPPingItemPool &) = delete;
+
+            /**
+             * @brief       Takes an object from the pool.
+             *
+             * @returns     the object, the caller owns it until it is passed to release().
+             */
+            auto acquire() -> T * {
+                auto head = m_head.load(std::memory_order_acquire);
+
+                m_acquired.fetch_add(1, std::memory_order_relaxed);
+
+                while (headIndex(head) != EndOfList) {
+                    auto index = headIndex(head);
+
+                    // the link may be stale if another thread pops this object first, in which case the version
+                    // of the head will have changed and the exchange fails.
+
+                    auto next = m_next[index].load(std::memory_order_relaxed);
+
+                    if (m_head.compare_exchange_weak(
+                            head,
+                            makeHead(headVersion(head) + 1, next),
+                            std::memory_order_acquire,
+                            std::memory_order_acquire )) {
+
+                        return &m_items[index];
+                    }
+                }
+
+                m_heapAllocations.fetch_add(1, std::memory_order_relaxed);
+
+                return new T;
+            }
+
+            /**
+             * @brief       Returns an object to the pool.
+             *
+             * @param[in]   item the object, as returned by acquire().
+             */
+            auto release(T *item) -> void {
+                if (!item) {
+                    return;
+                }
+
+                m_released.fetch_add(1, std::memory_order_relaxed);
+
+                if (!contains(item)) {
+                    delete item;
+
+                    return;
+                }
+
+                auto index = static_cast<uint32_t>(item - m_items.get());
+                auto head = m_head.load(std::memory_order_relaxed);
+
+                do {
+                    m_next[index].store(headIndex(head), std::memory_order_relaxed);
+                } while (!m_head.compare_exchange_weak(
+                        head,
+                        makeHead(headVersion(head) + 1, index),
+                        std::memory_order_release,
+                        std::memory_order_relaxed ));
+            }
+
+            /**
+             * @brief       Returns the counters of the pool.
+             *
+             * @note        The values are approximate when other threads are using the pool.
+             *
+             * @returns     the statistics.
+             */
+            auto statistics() const -> Nedrysoft::ICMPPingEngine::ICMPPingItemPoolStatistics {
+                return Nedrysoft::ICMPPingEngine::ICMPPingItemPoolStatistics {
+                    m_acquired.load(std::memory_order_relaxed),
+                    m_released.load(std::memory_order_relaxed),
+                    m_heapAllocations.load(std::memory_order_relaxed),
+                    Capacity
+                };
+            }
+
+            /**
+             * @brief       Returns the capacity of the slab.
+             *
+             * @returns     the number of objects.
+             */
+            static constexpr auto capacity() -> size_t {
+                return Capacity;
+            }
+
+        private:
+            /**
+             * @brief       Returns whether an object belongs to the slab.
+             *
+             * @param[in]   item the object.
+             *
+             * @returns     true if the object is in the slab; otherwise false if it was allocated on the heap.
+             */
+            auto contains(const T *item) const -> bool {
+                std::less_equal<const T *> lessEqual;
+                std::less<const T *> less;
+
+                return lessEqual(m_items.get(), item) && less(item, m_items.get() + Capacity);
+            }
+
+            static constexpr auto makeHead(uint32_t version, uint32_t index) -> uint64_t {
+                return ( static_cast<uint64_t>(version) << 32 ) | index;
+            }
+
+            static constexpr auto headVersion(uint64_t head) -> uint32_t {
+                return static_cast<uint32_t>(head >> 32);
+            }
+
+            static constexpr auto headIndex(uint64_t head) -> uint32_t {
+                return static_cast<uint32_t>(head & UINT32_MAX);
+            }
+
+        private:
+            //! @cond
+
+            std::unique_ptr<T[]> m_items;
+            std::unique_ptr<std::atomic<uint32_t>[]> m_next;
+
+            std::atomic<uint64_t> m_head;
+
+            std::atomic<uint64_t> m_acquired;
+            std::atomic<uint64_t> m_released;
+            std::atomic<uint64_t> m_heapAllocations;
+
+            //! @endcond
+    };
+}}
+
+#endif // PINGNOO_COMPONENTS_ICMPPINGENGINE_ICMPPINGITEMPOOL_H
@@ -0,0 +1,187 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 18/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PINGNOO_COMPONENTS_ICMPPINGENGINE_ICMPPINGPACING_H
+#define PINGNOO_COMPONENTS_ICMPPINGENGINE_ICMPPINGPACING_H
+
+#include <atomic>
+#include <cstdint>
+
+namespace Nedrysoft { namespace ICMPPingEngine {
+    /**
+     * @brief       The PacingMode enum specifies how the probes of a round are spread across the interval.
+     */
+    enum class PacingMode {
+        Burst,                              /**< all probes are sent together at the start of the interval. */
+        Even,                               /**< probes are spaced evenly across the interval in target order. */
+        Random                              /**< each target is given a pseudo random offset in the interval. */
+    };
+
+    /**
+     * @brief       The ICMPPingSchedulingStatistics structure holds a snapshot of the transmit lateness counters.
+     *
+     * @details     The lateness of a probe is the time between its scheduled transmit time and the time at which
+     *              the transmitter actually started to send it.
+     */
+    struct ICMPPingSchedulingStatistics {
+        uint64_t probes;                    /**< the number of probes that were scheduled. */
+        uint64_t lateProbes;                /**< the number of probes later than the late threshold. */
+        int64_t totalLateness;              /**< the sum of the lateness of all probes in nanoseconds. */
+        int64_t maximumLateness;            /**< the largest lateness of a probe in nanoseconds. */
+    };
+
+    /**
+     * @brief       The ICMPPingPacing class calculates the transmit offsets of targets and records how late
+     *              probes were sent.
+     *
+     * @details     A target is sent at the same offset from the start of every round so that the time between
+     *              its probes stays equal to the interval.  In Random mode the offset is derived from a key that
+     *              is fixed for the target (i.e its ICMP id and TTL) rather than drawn each round.
+     *
+     *              The lateness counters are updated by the transmitter thread and may be read from any thread.
+     */
+    class ICMPPingPacing {
+        public:
+            /**
+             * @brief       Lateness above which a probe is counted as late, in nanoseconds.
+             */
+            static constexpr int64_t LateThreshold = 1000000;
+
+        public:
+            /**
+             * @brief       Constructs an ICMPPingPacing with cleared counters.
+             */
+            ICMPPingPacing() :
+                    m_probes(0),
+                    m_lateProbes(0),
+                    m_totalLateness(0),
+                    m_maximumLateness(0) {
+
+            }
+
+            ICMPPingPacing(const ICMPPingPacing &) = delete;
+            ICMPPingPacing &operator=(const ICMPPingPacing &) = delete;
+
+            /**
+             * @brief       Returns the offset from the start of the round at which a target is sent.
+             *
+             * @param[in]   mode the pacing mode.
+             * @param[in]   index the position of the target in the round.
+             * @param[in]   count the number of targets in the round.
+             * @param[in]   key a value that is fixed for the target, used in Random mode.
+             * @param[in]   interval the length of the round in nanoseconds.
+             *
+             * @returns     the offset in nanoseconds, in the range 0 to interval-1.
+             */
+            static constexpr auto offset(
+                    PacingMode mode,
+                    int index,
+                    int count,
+                    uint32_t key,
+                    int64_t interval) -> int64_t {
+
+                if (( interval <= 0 ) || ( count <= 0 )) {
+                    return 0;
+                }
+
+                switch (mode) {
+                    case PacingMode::Even: {
+                        return ( interval * index ) / count;
+                    }
+
+                    case PacingMode::Random: {
+                        // fibonacci hashing spreads consecutive keys (i.e the hops of a route) across the range, the
+                        // hash is used as a 32 bit fixed point fraction of the interval.
+
+                        auto fraction = ( static_cast<uint64_t>(key) * UINT64_C(0x9E3779B97F4A7C15) ) >> 32;
+                        auto length = static_cast<uint64_t>(interval);
+
+                        return static_cast<int64_t>(
+                            ( length >> 32 ) * fraction + ( ( ( length & UINT32_MAX ) * fraction ) >> 32 ) );
+                    }
+
+                    default: {
+                        return 0;
+                    }
+                }
+            }
+
+            /**
+             * @brief       Records the lateness of a probe.
+             *
+             * @param[in]   lateness the time in nanoseconds between the scheduled and actual transmit time.
+             */
+            auto record(int64_t lateness) -> void {
+                if (lateness < 0) {
+                    lateness = 0;
+                }
+
+                m_probes.fetch_add(1, std::memory_order_relaxed);
+                m_totalLateness.fetch_add(lateness, std::memory_order_relaxed);
+
+                if (lateness > LateThreshold) {
+                    m_lateProbes.fetch_add(1, std::memory_order_relaxed);
+                }
+
+                auto maximumLateness = m_maximumLateness.load(std::memory_order_relaxed);
+
+                while (lateness > maximumLateness) {
+                    if (m_maximumLateness.compare_exchange_weak(
+                            maximumLateness,
+                            lateness,
+                            std::memory_order_relaxed )) {
+
+                        break;
+                    }
+                }
+            }
+
+            /**
+             * @brief       Returns the lateness counters.
+             *
+             * @note        The values are approximate when a probe is being recorded.
+             *
+             * @returns     the statistics.
+             */
+            auto statistics() const -> Nedrysoft::ICMPPingEngine::ICMPPingSchedulingStatistics {
+                return Nedrysoft::ICMPPingEngine::ICMPPingSchedulingStatistics {
+                    m_probes.load(std::memory_order_relaxed),
+                    m_lateProbes.load(std::memory_order_relaxed),
+                    m_totalLateness.load(std::memory_order_relaxed),
+                    m_maximumLateness.load(std::memory_order_relaxed)
+                };
+            }
+
+        private:
+            //! @cond
+
+            std::atomic<uint64_t> m_probes;
+            std::atomic<uint64_t> m_lateProbes;
+            std::atomic<int64_t> m_totalLateness;
+            std::atomic<int64_t> m_maximumLateness;
+
+            //! @endcond
+    };
+}}
+
+#endif // PINGNOO_COMPONENTS_ICMPPINGENGINE_ICMPPINGPACING_H
@@ -24,6 +24,7 @@
 #include "ICMPPingReceiverWorker.h"
 
 #include "ICMPPacket/ICMPPacket.h"
+#include "ICMPPacket/ICMPReplyView.h"
 #include "ICMPPingEngine.h"
 #include "ICMPPingItem.h"
 #include "ICMPPingTarget.h"
@@ -32,17 +33,48 @@
 #include <QHostAddress>
 #include <QThread>
 #include <QtEndian>
+#include <algorithm>
+#include <array>
 #include <spdlog/spdlog.h>
 
+#if defined(Q_OS_LINUX)
+#include <cerrno>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#elif defined(Q_OS_UNIX)
+#include <poll.h>
+#elif defined(Q_OS_WIN)
+#include <WinSock2.h>
+#endif
+
 constexpr auto DefaultReplyTimeout = 1000;
+constexpr auto MaximumEvents = 8;
 
 Nedrysoft::ICMPPingEngine::ICMPPingReceiverWorker::ICMPPingReceiverWorker() :
         m_engine(nullptr),
         m_receiveWorker(nullptr),
         m_receiverThread(nullptr),
-        m_socket(nullptr),
+#if defined(Q_OS_LINUX)
+        m_pollDescriptor(epoll_create1(EPOLL_CLOEXEC)),
+        m_eventDescriptor(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)),
+#endif
+        m_foreignPackets(0),
+        m_receiveDrops(0),
         m_isRunning(false) {
 
+#if defined(Q_OS_LINUX)
+    if (( m_pollDescriptor < 0 ) || ( m_eventDescriptor < 0 )) {
+        SPDLOG_ERROR("Unable to create the receiver epoll and event descriptors.");
+    } else {
+        epoll_event event = {};
+
+        event.events = EPOLLIN;
+        event.data.ptr = nullptr;
+
+        epoll_ctl(m_pollDescriptor, EPOLL_CTL_ADD, m_eventDescriptor, &event);
+    }
+#endif
 }
 
 Nedrysoft::ICMPPingEngine::ICMPPingReceiverWorker::~ICMPPingReceiverWorker() {
@@ -51,7 +83,7 @@ Nedrysoft::ICMPPingEngine::ICMPPingReceiverWorker::~ICMPPingReceiverWorker() {
     }
 
     if (m_receiveWorker) {
-        m_receiveWorker->m_isRunning = false;
+        m_receiveWorker->stop();
 
         m_receiverThread->quit();
         m_receiverThread->wait();
@@ -59,9 +91,17 @@ Nedrysoft::ICMPPingEngine::ICMPPingReceiverWorker::~ICMPPingReceiverWorker() {
         delete m_receiverThread;
     }
 
-    if (m_socket) {
-        delete m_socket;
+    qDeleteAll(m_sockets);
+
+#if defined(Q_OS_LINUX)
+    if (m_eventDescriptor >= 0) {
+        close(m_eventDescriptor);
     }
+
+    if (m_pollDescriptor >= 0) {
+        close(m_pollDescriptor);
+    }
+#endif
 }
 
 auto Nedrysoft::ICMPPingEngine::ICMPPingReceiverWorker::getInstance(bool returnNull) -> Nedrysoft::ICMPPingEngine::ICMPPingReceiverWorker * {
@@ -81,6 +121,10 @@ auto Nedrysoft::ICMPPingEngine::ICMPPingReceiverWorker::getInstance(bool returnN
 
     instance->moveToThread(instance->m_receiverThread);
 
+    // set before the thread starts so that a stop request cannot be lost.
+
+    instance->m_isRunning = true;
+
     connect(instance->m_receiverThread, &QThread::started, instance, &Nedrysoft::ICMPPingEngine::ICMPPingReceiverWorker::doWork);
 
     instance->m_receiverThread->start();
@@ -90,28 +134,339 @@ auto Nedrysoft::ICMPPingEngine::ICMPPingReceiverWorker::getInstance(bool returnN
     return instance;
 }
 
+auto Nedrysoft::ICMPPingEngine::ICMPPingReceiverWorker::registerId(
+        uint16_t id,
+        Nedrysoft::ICMPPingEngine::ICMPPingEngine *engine) -> bool {
+
+    QWriteLocker locker(&m_enginesLock);
+
+    auto registeredEngine = m_engines.value(id, nullptr);
+
+    if (( registeredEngine ) && ( registeredEngine != engine )) {
+        return false;
+    }
+
+    if (m_reservedIds.contains(id)) {
+        return false;
+    }
+
+    if (!registeredEngine) {
+        m_engines[id] = engine;
+
+        updateFilters();
+    }
+
+    return true;
+}
+
+auto Nedrysoft::ICMPPingEngine::ICMPPingReceiverWorker::unregisterId(
+        uint16_t id,
+        Nedrysoft::ICMPPingEngine::ICMPPingEngine *engine) -> void {
+
+    QWriteLocker locker(&m_enginesLock);
+
+    if (m_engines.value(id, nullptr) != engine) {
+        return;
+    }
+
+    m_engines.remove(id);
+
+    updateFilters();
+}
+
+auto Nedrysoft::ICMPPingEngine::ICMPPingReceiverWorker::unregisterEngine(
+        Nedrysoft::ICMPPingEngine::ICMPPingEngine *engine) -> void {
+
+    QWriteLocker locker(&m_enginesLock);
+
+    auto iterator = m_engines.begin();
+
+    while (iterator != m_engines.end()) {
+        if (iterator.value() == engine) {
+            iterator = m_engines.erase(iterator);
+        } else {
+            ++iterator;
+        }
+    }
+
+    updateFilters();
+}
+
+auto Nedrysoft::ICMPPingEngine::ICMPPingReceiverWorker::reserveId(uint16_t id) -> bool {
+    QWriteLocker locker(&m_enginesLock);
+
+    if (( m_engines.contains(id) ) || ( m_reservedIds.contains(id) )) {
+        return false;
+    }
+
+    m_reservedIds.insert(id);
+
+    return true;
+}
+
+auto Nedrysoft::ICMPPingEngine::ICMPPingReceiverWorker::releaseId(uint16_t id) -> void {
+    QWriteLocker locker(&m_enginesLock);
+
+    m_reservedIds.remove(id);
+}
+
+auto Nedrysoft::ICMPPingEngine::ICMPPingReceiverWorker::updateFilters() -> void {
+    QVector<uint16_t> ids;
+
+    ids.reserve(m_engines.count());
+
+    for (auto iterator = m_engines.constBegin(); iterator != m_engines.constEnd(); ++iterator) {
+        ids.append(iterator.key());
+    }
+
+    for (auto socket : m_sockets) {
+        socket->setFilter(ids);
+    }
+}
+
+auto Nedrysoft::ICMPPingEngine::ICMPPingReceiverWorker::addSocket(Nedrysoft::ICMPSocket::ICMPSocket *socket) -> bool {
+#if defined(Q_OS_LINUX)
+    QWriteLocker locker(&m_enginesLock);
+
+    epoll_event event = {};
+
+    event.events = EPOLLIN;
+    event.data.ptr = socket;
+
+    if (epoll_ctl(m_pollDescriptor, EPOLL_CTL_ADD, socket->descriptor(), &event) < 0) {
+        SPDLOG_ERROR("Unable to wait on the datagram socket.");
+
+        return false;
+    }
+
+    m_datagramSockets.append(socket);
+
+    return true;
+#else
+    Q_UNUSED(socket)
+
+    return false;
+#endif
+}
+
+auto Nedrysoft::ICMPPingEngine::ICMPPingReceiverWorker::removeSocket(Nedrysoft::ICMPSocket::ICMPSocket *socket) -> void {
+#if defined(Q_OS_LINUX)
+    QWriteLocker locker(&m_enginesLock);
+
+    if (!m_datagramSockets.removeOne(socket)) {
+        return;
+    }
+
+    m_socketDrops.remove(socket);
+
+    epoll_ctl(m_pollDescriptor, EPOLL_CTL_DEL, socket->descriptor(), nullptr);
+#else
+    Q_UNUSED(socket)
+#endif
+}
+
 void Nedrysoft::ICMPPingEngine::ICMPPingReceiverWorker::doWork() {
-    QByteArray receiveBuffer;
+    QVector<Nedrysoft::ICMPSocket::ReceivedPacket> receivedPackets;
 
-    m_socket =  Nedrysoft::ICMPSocket::ICMPSocket::createReadSocket(
-        static_cast<Nedrysoft::ICMPSocket::IPVersion>(Nedrysoft::ICMPSocket::V4)
-    );
+    for (auto version : {Nedrysoft::ICMPSocket::V4, Nedrysoft::ICMPSocket::V6}) {
+        // replies to datagram sockets are read from the socket of each engine.
 
-    QHostAddress receiveAddress;
+        if (Nedrysoft::ICMPSocket::ICMPSocket::isDatagramSupported(version)) {
+            continue;
+        }
+
+        auto socket = Nedrysoft::ICMPSocket::ICMPSocket::createReadSocket(version);
 
-    m_isRunning = true;
+        if (!socket) {
+            SPDLOG_ERROR(QString("Unable to create the IPv%1 read socket.").arg(version).toStdString());
+
+            continue;
+        }
+
+#if defined(Q_OS_LINUX)
+        epoll_event event = {};
+
+        event.events = EPOLLIN;
+        event.data.ptr = socket;
+
+        if (epoll_ctl(m_pollDescriptor, EPOLL_CTL_ADD, socket->descriptor(), &event) < 0) {
+            SPDLOG_ERROR(QString("Unable to wait on the IPv%1 read socket.").arg(version).toStdString());
+
+            delete socket;
+
+            continue;
+        }
+#endif
+
+        QWriteLocker locker(&m_enginesLock);
+
+        m_sockets.append(socket);
+
+        // ids may have been registered before the socket was created.
+
+        updateFilters();
+    }
+
+#if defined(Q_OS_LINUX)
+    std::array<epoll_event, MaximumEvents> events = {};
 
     while (QThread::currentThread()->isRunning() && (m_isRunning)) {
-        QElapsedTimer receiveTimer;
+        auto eventCount = epoll_wait(m_pollDescriptor, events.data(), MaximumEvents, -1);
+
+        if (eventCount < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            SPDLOG_ERROR("Error waiting for ICMP packets.");
+
+            break;
+        }
+
+        for (auto eventIndex = 0; eventIndex < eventCount; eventIndex++) {
+            auto socket = static_cast<Nedrysoft::ICMPSocket::ICMPSocket *>(events[eventIndex].data.ptr);
+
+            if (!socket) {
+                uint64_t value;
 
-        auto result = m_socket->recvfrom(receiveBuffer, receiveAddress, DefaultReplyTimeout);
+                // the eventfd has been signalled by stop(), the loop condition will end the thread.
 
-        receiveTimer.restart();
+                if (read(m_eventDescriptor, &value, sizeof(value)) < 0) {
+                    SPDLOG_TRACE("Error reading the receiver event descriptor.");
+                }
 
-        if (result!=-1) {
-            SPDLOG_TRACE("ICMP Packet Received");
+                continue;
+            }
 
-            Q_EMIT packetReceived(receiveTimer, receiveBuffer, receiveAddress);
+            // a datagram socket may have been removed after the event was returned, it must not be read.
+
+            QReadLocker locker(&m_enginesLock);
+
+            if (( !m_sockets.contains(socket) ) && ( !m_datagramSockets.contains(socket) )) {
+                continue;
+            }
+
+            processSocket(socket, receivedPackets);
+        }
+    }
+#else
+#if defined(Q_OS_WIN)
+    int (WSAAPI *poll)(struct pollfd *, ulong , int ) = WSAPoll;
+#endif
+    QVector<struct pollfd> descriptorSet(m_sockets.count());
+
+    for (auto socketIndex = 0; socketIndex < m_sockets.count(); socketIndex++) {
+        descriptorSet[socketIndex].fd = m_sockets[socketIndex]->descriptor();
+        descriptorSet[socketIndex].events = POLLIN;
+    }
+
+    while (QThread::currentThread()->isRunning() && (m_isRunning)) {
+        if (poll(descriptorSet.data(), descriptorSet.count(), DefaultReplyTimeout) <= 0) {
+            continue;
+        }
+
+        for (auto socketIndex = 0; socketIndex < m_sockets.count(); socketIndex++) {
+            if (descriptorSet[socketIndex].revents & POLLIN) {
+                QReadLocker locker(&m_enginesLock);
+
+                processSocket(m_sockets[socketIndex], receivedPackets);
+            }
         }
     }
-}
\ No newline at end of file
+#endif
+}
+
+auto Nedrysoft::ICMPPingEngine::ICMPPingReceiverWorker::processSocket(
+        Nedrysoft::ICMPSocket::ICMPSocket *socket,
+        QVector<Nedrysoft::ICMPSocket::ReceivedPacket> &receivedPackets) -> void {
+
+    auto result = socket->recvmmsg(receivedPackets, 0);
+
+    if (result <= 0) {
+        return;
+    }
+
+    SPDLOG_TRACE(QString("%1 ICMP Packet(s) Received").arg(result).toStdString());
+
+    auto version = static_cast<Nedrysoft::ICMPPacket::IPVersion>(socket->version());
+    auto format = Nedrysoft::ICMPPacket::PacketFormat::Raw;
+
+    if (socket->isDatagram()) {
+        format = Nedrysoft::ICMPPacket::PacketFormat::Datagram;
+    }
+
+    int64_t dropCount = -1;
+
+    for (const auto &receivedPacket : receivedPackets) {
+        dropCount = std::max(dropCount, receivedPacket.dropCount);
+
+        // the view parses the packet in place in the receive ring of the socket.
+
+        auto packetData = gsl::span<const uint8_t>(
+            reinterpret_cast<const uint8_t *>(receivedPacket.buffer.constData()),
+            receivedPacket.buffer.length() );
+
+        // the kernel verifies the checksum of packets delivered to a datagram socket, errors from the error queue
+        // carry the echo request that was sent rather than the received message.
+
+        if (( format == Nedrysoft::ICMPPacket::PacketFormat::Raw ) &&
+            ( !Nedrysoft::ICMPPacket::ICMPPacket::isChecksumValid(receivedPacket.buffer, version) )) {
+
+            continue;
+        }
+
+        auto replyView = ( receivedPacket.errorType != -1 ) ?
+            Nedrysoft::ICMPPacket::ICMPReplyView::fromError(
+                packetData,
+                version,
+                receivedPacket.errorType,
+                receivedPacket.errorCode ) :
+            Nedrysoft::ICMPPacket::ICMPReplyView(packetData, version, format);
+
+        if (!replyView.isValid()) {
+            continue;
+        }
+
+        auto engine = m_engines.value(replyView.id(), nullptr);
+
+        if (!engine) {
+            m_foreignPackets.fetch_add(1, std::memory_order_relaxed);
+
+            continue;
+        }
+
+        engine->processPacket(replyView, receivedPacket);
+    }
+
+    // the kernel reports the total number of packets that the socket has dropped, only the increase since the
+    // previous read of the socket is added.
+
+    if (dropCount >= 0) {
+        auto &previousDrops = m_socketDrops[socket];
+        auto currentDrops = static_cast<uint32_t>(dropCount);
+
+        m_receiveDrops.fetch_add(static_cast<uint32_t>(currentDrops - previousDrops), std::memory_order_relaxed);
+
+        previousDrops = currentDrops;
+    }
+}
+
+auto Nedrysoft::ICMPPingEngine::ICMPPingReceiverWorker::foreignPackets() const -> uint64_t {
+    return m_foreignPackets.load(std::memory_order_relaxed);
+}
+
+auto Nedrysoft::ICMPPingEngine::ICMPPingReceiverWorker::receiveDrops() const -> uint64_t {
+    return m_receiveDrops.load(std::memory_order_relaxed);
+}
+
+auto Nedrysoft::ICMPPingEngine::ICMPPingReceiverWorker::stop() -> void {
+    m_isRunning = false;
+
+#if defined(Q_OS_LINUX)
+    uint64_t value = 1;
+
+    if (write(m_eventDescriptor, &value, sizeof(value)) < 0) {
+        SPDLOG_ERROR("Unable to wake the receiver thread.");
+    }
+#endif
+}
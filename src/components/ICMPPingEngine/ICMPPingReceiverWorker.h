@@ -24,15 +24,18 @@
 #ifndef PINGNOO_COMPONENTS_ICMPPINGENGINE_ICMPPINGRECEIVERWORKER_H
 #define PINGNOO_COMPONENTS_ICMPPINGENGINE_ICMPPINGRECEIVERWORKER_H
 
+#include "ICMPSocket/ICMPSocket.h"
+
 #include <QObject>
 #include <QByteArray>
 #include <QElapsedTimer>
+#include <QHash>
 #include <QHostAddress>
+#include <QReadWriteLock>
+#include <QSet>
 #include <QThread>
-
-namespace Nedrysoft { namespace ICMPSocket {
-    class ICMPSocket;
-}}
+#include <QVector>
+#include <atomic>
 
 namespace Nedrysoft { namespace ICMPPingEngine {
     class ICMPPingEngine;
@@ -42,7 +45,21 @@ namespace Nedrysoft { namespace ICMPPingEngine {
      * @brief       The ICMP packet receiver class.
      *
      * @details     This is a singleton class, there is a single receive thread which reads packets as they arrive
-     *              and then signals that a packet is available, other objects can then process the packet.
+     *              and delivers them to the engine that sent the request.  All packets that are waiting when the
+     *              thread wakes are read in one go, each packet is parsed once and routed by its ICMP id using a
+     *              table of ids registered by the engines, so the cost of a packet does not depend on the number
+     *              of engines.
+     *
+     *              The thread owns an ICMPv4 and an ICMPv6 read socket.  On Linux both sockets are waited on with
+     *              a single epoll descriptor alongside an eventfd, so that a stop request wakes the thread
+     *              immediately, other platforms poll both sockets with a timeout.
+     *
+     *              When unprivileged datagram sockets are available on Linux the raw read socket for that IP
+     *              version is not created, instead each engine adds its own datagram socket with addSocket().  The
+     *              kernel only delivers the replies to a datagram socket that match its id, so packets are not
+     *              copied to every reader.  On Linux the raw read sockets have a kernel filter attached which is
+     *              regenerated as ids are registered, so only replies to the registered ids are copied to the
+     *              receiver.
      */
     class ICMPPingReceiverWorker :
             public QObject {
@@ -74,17 +91,93 @@ namespace Nedrysoft { namespace ICMPPingEngine {
             static auto getInstance(bool returnNull=false) -> Nedrysoft::ICMPPingEngine::ICMPPingReceiverWorker *;
 
             /**
-             * @brief       This signal is emitted when an ICMP packet has been received.
+             * @brief       Registers an ICMP id so that replies with the id are delivered to the engine.
+             *
+             * @param[in]   id the ICMP id.
+             * @param[in]   engine the engine that sends requests with the id.
+             *
+             * @returns     true if the id was registered; false if the id is in use by another engine.
+             */
+            auto registerId(uint16_t id, Nedrysoft::ICMPPingEngine::ICMPPingEngine *engine) -> bool;
+
+            /**
+             * @brief       Removes an ICMP id registered by an engine.
+             *
+             * @details     The id is only removed if it is registered to the given engine, replies with the id are
+             *              no longer delivered once this returns.
+             *
+             * @param[in]   id the ICMP id.
+             * @param[in]   engine the engine that registered the id.
+             */
+            auto unregisterId(uint16_t id, Nedrysoft::ICMPPingEngine::ICMPPingEngine *engine) -> void;
+
+            /**
+             * @brief       Removes all ICMP ids registered by an engine.
+             *
+             * @note        This blocks while packets are being delivered, once it returns the engine will not
+             *              receive any further packets and may be safely destroyed.
+             *
+             * @param[in]   engine the engine.
+             */
+            auto unregisterEngine(Nedrysoft::ICMPPingEngine::ICMPPingEngine *engine) -> void;
+
+            /**
+             * @brief       Reserves an ICMP id that is read on a private socket.
+             *
+             * @details     A reserved id cannot be registered by any engine and replies to it are not delivered by
+             *              the receiver, the owner reads them on its own socket.
+             *
+             * @param[in]   id the ICMP id.
+             *
+             * @returns     true if the id was reserved; false if the id is already in use.
+             */
+            auto reserveId(uint16_t id) -> bool;
+
+            /**
+             * @brief       Releases an ICMP id that was reserved with reserveId().
+             *
+             * @param[in]   id the ICMP id.
+             */
+            auto releaseId(uint16_t id) -> void;
+
+            /**
+             * @brief       Adds a datagram socket to the sockets that are read by the receiver thread.
+             *
+             * @note        The socket is not owned by the receiver, it must be removed with removeSocket() before
+             *              it is destroyed.
+             *
+             * @param[in]   socket the socket.
              *
-             * @param[in]   receiveTimer a timer started from when the packet was received.
-             * @param[in]   receiveBuffer the packet data.
-             * @param[in]   receiveAddress the address the packet was received from (this may differ from the target).
+             * @returns     true if the socket was added; otherwise false.
              */
-            Q_SIGNAL void packetReceived(
-                QElapsedTimer receiveTimer,
-                QByteArray receiveBuffer,
-                QHostAddress receiveAddress
-            );
+            auto addSocket(Nedrysoft::ICMPSocket::ICMPSocket *socket) -> bool;
+
+            /**
+             * @brief       Removes a socket that was added with addSocket().
+             *
+             * @note        This blocks while packets are being delivered, once it returns the socket will not be
+             *              read again and may be safely destroyed.
+             *
+             * @param[in]   socket the socket.
+             */
+            auto removeSocket(Nedrysoft::ICMPSocket::ICMPSocket *socket) -> void;
+
+            /**
+             * @brief       Returns the number of valid ICMP packets received that were not for any engine.
+             *
+             * @returns     the number of packets.
+             */
+            auto foreignPackets() const -> uint64_t;
+
+            /**
+             * @brief       Returns the number of packets that the kernel dropped from the receive queues.
+             *
+             * @details     The count is only available on Linux, it is taken from the drop counter that the kernel
+             *              returns with each packet and so is updated when the next packet is read.
+             *
+             * @returns     the number of packets.
+             */
+            auto receiveDrops() const -> uint64_t;
 
             friend class ICMPPingEngine;
             friend class ICMPPingEngineFactory;
@@ -95,13 +188,56 @@ namespace Nedrysoft { namespace ICMPPingEngine {
              */
             auto doWork() -> void;
 
+            /**
+             * @brief       Reads the waiting packets from a socket and delivers them to the registered engines.
+             *
+             * @note        The caller must hold the read lock on the engines.
+             *
+             * @param[in]   socket the socket that is ready to read.
+             * @param[in]   receivedPackets the list used to hold the received packets.
+             */
+            auto processSocket(
+                Nedrysoft::ICMPSocket::ICMPSocket *socket,
+                QVector<Nedrysoft::ICMPSocket::ReceivedPacket> &receivedPackets
+            ) -> void;
+
+            /**
+             * @brief       Attaches a kernel filter for the registered ids to the raw read sockets.
+             *
+             * @details     Without a filter a raw socket receives a copy of every ICMP packet that arrives at the
+             *              host, the filter drops packets that are not replies to this process in the kernel.
+             *
+             * @note        The caller must hold the write lock on the engines.
+             */
+            auto updateFilters() -> void;
+
+            /**
+             * @brief       Requests that the worker thread stops and wakes it if it is waiting for packets.
+             */
+            auto stop() -> void;
+
         private:
             //! @cond
 
             Nedrysoft::ICMPPingEngine::ICMPPingEngine *m_engine;
             Nedrysoft::ICMPPingEngine::ICMPPingReceiverWorker *m_receiveWorker;
             QThread *m_receiverThread;
-            Nedrysoft::ICMPSocket::ICMPSocket *m_socket;
+            QVector<Nedrysoft::ICMPSocket::ICMPSocket *> m_sockets;
+            QVector<Nedrysoft::ICMPSocket::ICMPSocket *> m_datagramSockets;
+
+#if defined(Q_OS_LINUX)
+            int m_pollDescriptor;
+            int m_eventDescriptor;
+#endif
+
+            QHash<uint16_t, Nedrysoft::ICMPPingEngine::ICMPPingEngine *> m_engines;
+            QSet<uint16_t> m_reservedIds;
+            QReadWriteLock m_enginesLock;
+
+            QHash<Nedrysoft::ICMPSocket::ICMPSocket *, uint32_t> m_socketDrops;
+
+            std::atomic<uint64_t> m_foreignPackets;
+            std::atomic<uint64_t> m_receiveDrops;
 
             bool m_isRunning;
 
@@ -0,0 +1,399 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 18/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PINGNOO_COMPONENTS_ICMPPINGENGINE_ICMPPINGREQUESTTABLE_H
+#define PINGNOO_COMPONENTS_ICMPPINGENGINE_ICMPPINGREQUESTTABLE_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace Nedrysoft { namespace ICMPPingEngine {
+    /**
+     * @brief       The ICMPPingRequestTable class is a fixed capacity lock-free table of in-flight requests.
+     *
+     * @details     Requests are keyed on the 32 bit value constructed from the ICMP header, (icmp_id<<16) |
+     *              icmp_sequence_id, and stored in an open-addressed table using linear probing.  Insertion,
+     *              removal and iteration are lock-free so that the transmitter, receiver and timeout threads
+     *              never contend on a mutex.
+     *
+     *              Each slot holds a 64 bit state word made up of the key (high 32 bits) and a version (low 32
+     *              bits).  The version is incremented on every transition of the slot, so a thread that read the
+     *              slot can detect that it was removed and reused in the meantime.  Ownership of a value is
+     *              transferred to whichever thread successfully calls take() for its key, this guarantees that
+     *              a request is serviced exactly once, either by a reply or a timeout.
+     *
+     *              A slot that is removed from the end of a probe chain is returned to empty rather than left as a
+     *              tombstone, so that lookups of keys that are not in the table stop at the end of the chain
+     *              instead of scanning the maximum probe length once every slot has been used.
+     *
+     * @note        The keys 0x00000000, 0xFFFFFFFE and 0xFFFFFFFF are reserved.  As ICMP ids are allocated in
+     *              the range 1 to 0xFFFE the keys generated by the engine never collide with them, the engine
+     *              rejects datagram sockets that the kernel gives an id outside of this range.
+     *
+     * @tparam      T the type of the value stored in the table, the table stores pointers to T.
+     * @tparam      Capacity the number of slots in the table, must be a power of 2.
+     */
+    template<typename T, size_t Capacity>
+    class ICMPPingRequestTable {
+        private:
+            static_assert(Capacity && ((Capacity & (Capacity-1)) == 0), "Capacity must be a power of 2");
+
+            static constexpr uint32_t EmptyKey = 0x00000000;
+            static constexpr uint32_t ReservedKey = 0xFFFFFFFE;
+            static constexpr uint32_t TombstoneKey = 0xFFFFFFFF;
+
+            static constexpr size_t MaximumProbeLength = Capacity < 64 ? Capacity : 64;
+
+            /**
+             * @brief       A single slot in the table.
+             */
+            struct Slot {
+                std::atomic<uint64_t> m_state = {0};
+                std::atomic<T *> m_value = {nullptr};
+                std::atomic<int64_t> m_deadline = {0};
+                std::atomic<int64_t> m_timestamp = {0};
+            };
+
+        public:
+            /**
+             * @brief       Constructs an empty ICMPPingRequestTable.
+             */
+            ICMPPingRequestTable() :
+                    m_count(0) {
+
+            }
+
+            ICMPPingRequestTable(const ICMPPingRequestTable &) = delete;
+            ICMPPingRequestTable &operator=(const ICMPPingRequestTable &) = delete;
+
+            /**
+             * @brief       Inserts a request into the table.
+             *
+             * @param[in]   key the request key.
+             * @param[in]   value the request, the table does not take ownership.
+             * @param[in]   deadline the time (in monotonic nanoseconds) at which the request times out.
+             *
+             * @returns     true if the request was inserted; false if no free slot could be found.
+             */
+            auto insert(uint32_t key, T *value, int64_t deadline) -> bool {
+                auto index = hash(key);
+                size_t probe = 0;
+
+                while (probe < MaximumProbeLength) {
+                    auto slotIndex = ( index + probe ) & ( Capacity - 1 );
+                    auto &slot = m_slots[slotIndex];
+                    auto state = slot.m_state.load(std::memory_order_acquire);
+
+                    if (( stateKey(state) != EmptyKey ) && ( stateKey(state) != TombstoneKey )) {
+                        probe++;
+
+                        continue;
+                    }
+
+                    if (!slot.m_state.compare_exchange_weak(state, makeState(ReservedKey, stateVersion(state) + 1))) {
+                        continue;
+                    }
+
+                    // a take() may have emptied a slot earlier in the chain after it was probed, a lookup would stop
+                    // at that slot and not find the key, so the slot is given up and the chain is probed again.
+
+                    if (hasEmptySlot(index, probe)) {
+                        slot.m_state.store(makeState(TombstoneKey, stateVersion(state) + 2));
+
+                        reclaim(slotIndex);
+
+                        probe = 0;
+
+                        continue;
+                    }
+
+                    slot.m_value.store(value, std::memory_order_relaxed);
+                    slot.m_deadline.store(deadline, std::memory_order_relaxed);
+                    slot.m_timestamp.store(0, std::memory_order_relaxed);
+                    slot.m_state.store(makeState(key, stateVersion(state) + 2), std::memory_order_release);
+
+                    m_count.fetch_add(1, std::memory_order_relaxed);
+
+                    return true;
+                }
+
+                return false;
+            }
+
+            /**
+             * @brief       Removes a request from the table and returns it.
+             *
+             * @details     If multiple threads attempt to take the same key, only one will receive the request, the
+             *              caller that receives the request becomes the owner.
+             *
+             * @param[in]   key the request key.
+             * @param[out]  timestamp if not null, receives the timestamp set by setTimestamp(), or 0 if none was set.
+             *
+             * @returns     the request if found; otherwise nullptr.
+             */
+            auto take(uint32_t key, int64_t *timestamp = nullptr) -> T * {
+                auto index = hash(key);
+
+                for (size_t probe = 0; probe < MaximumProbeLength; probe++) {
+                    auto slotIndex = ( index + probe ) & ( Capacity - 1 );
+                    auto &slot = m_slots[slotIndex];
+                    auto state = slot.m_state.load(std::memory_order_acquire);
+
+                    if (stateKey(state) == EmptyKey) {
+                        return nullptr;
+                    }
+
+                    if (stateKey(state) != key) {
+                        continue;
+                    }
+
+                    auto value = slot.m_value.load(std::memory_order_relaxed);
+                    auto valueTimestamp = slot.m_timestamp.load(std::memory_order_acquire);
+
+                    if (slot.m_state.compare_exchange_strong(state, makeState(TombstoneKey, stateVersion(state) + 1))) {
+                        m_count.fetch_sub(1, std::memory_order_relaxed);
+
+                        reclaim(slotIndex);
+
+                        if (timestamp) {
+                            *timestamp = valueTimestamp;
+                        }
+
+                        return value;
+                    }
+
+                    return nullptr;
+                }
+
+                return nullptr;
+            }
+
+            /**
+             * @brief       Attaches a timestamp to a request that is in the table.
+             *
+             * @details     This is used to record information that only becomes available after the request was
+             *              inserted (i.e the kernel transmit time), it is returned by take().
+             *
+             * @note        If the request is taken while the timestamp is being set, the timestamp may be lost, or
+             *              in the worst case land on a request that reuses the slot, callers should validate the
+             *              timestamp against the request.
+             *
+             * @param[in]   key the request key.
+             * @param[in]   timestamp the timestamp.
+             *
+             * @returns     true if the request was found; otherwise false.
+             */
+            auto setTimestamp(uint32_t key, int64_t timestamp) -> bool {
+                auto index = hash(key);
+
+                for (size_t probe = 0; probe < MaximumProbeLength; probe++) {
+                    auto &slot = m_slots[( index + probe ) & ( Capacity - 1 )];
+                    auto state = slot.m_state.load(std::memory_order_acquire);
+
+                    if (stateKey(state) == EmptyKey) {
+                        return false;
+                    }
+
+                    if (stateKey(state) == key) {
+                        slot.m_timestamp.store(timestamp, std::memory_order_release);
+
+                        return true;
+                    }
+                }
+
+                return false;
+            }
+
+            /**
+             * @brief       Calls a function for each request currently in the table.
+             *
+             * @details     The function is called with the key and deadline of each request, the request itself
+             *              is not passed as it may be removed (and deleted) by another thread at any time.  To
+             *              claim a request, the function should call take() with the key.
+             *
+             * @param[in]   function the function to call, with the signature void(uint32_t key, int64_t deadline).
+             */
+            template<typename F>
+            auto forEach(F function) -> void {
+                for (auto &slot : m_slots) {
+                    auto state = slot.m_state.load(std::memory_order_acquire);
+                    auto key = stateKey(state);
+
+                    if (( key == EmptyKey ) || ( key == ReservedKey ) || ( key == TombstoneKey )) {
+                        continue;
+                    }
+
+                    auto deadline = slot.m_deadline.load(std::memory_order_relaxed);
+
+                    std::atomic_thread_fence(std::memory_order_acquire);
+
+                    if (slot.m_state.load(std::memory_order_relaxed) != state) {
+                        continue;
+                    }
+
+                    function(key, deadline);
+                }
+            }
+
+            /**
+             * @brief       Returns the number of slots that a lookup of a key examines.
+             *
+             * @note        The value is approximate when other threads are modifying the table.
+             *
+             * @param[in]   key the request key.
+             *
+             * @returns     the number of slots examined.
+             */
+            auto probeLength(uint32_t key) const -> size_t {
+                auto index = hash(key);
+
+                for (size_t probe = 0; probe < MaximumProbeLength; probe++) {
+                    auto state = m_slots[( index + probe ) & ( Capacity - 1 )].m_state.load(std::memory_order_acquire);
+
+                    if (( stateKey(state) == EmptyKey ) || ( stateKey(state) == key )) {
+                        return probe + 1;
+                    }
+                }
+
+                return MaximumProbeLength;
+            }
+
+            /**
+             * @brief       Returns the number of requests in the table.
+             *
+             * @note        The value is approximate when other threads are modifying the table.
+             *
+             * @returns     the number of requests.
+             */
+            auto count() const -> size_t {
+                return m_count.load(std::memory_order_relaxed);
+            }
+
+            /**
+             * @brief       Returns the capacity of the table.
+             *
+             * @returns     the number of slots.
+             */
+            static constexpr auto capacity() -> size_t {
+                return Capacity;
+            }
+
+        private:
+            /**
+             * @brief       Returns tombstones at the end of a probe chain to empty.
+             *
+             * @details     A tombstone can only be emptied if the slot after it is empty, as otherwise a key
+             *              further along the chain could no longer be found.  The slots before it are then emptied
+             *              in turn for as long as they are tombstones.  If an insert claims the following slot while
+             *              a slot is being emptied then the tombstone is restored.
+             *
+             * @param[in]   slotIndex the index of the slot that was removed.
+             */
+            auto reclaim(size_t slotIndex) -> void {
+                for (size_t count = 0; count < MaximumProbeLength; count++) {
+                    auto &slot = m_slots[slotIndex];
+                    auto &nextSlot = m_slots[( slotIndex + 1 ) & ( Capacity - 1 )];
+                    auto state = slot.m_state.load();
+
+                    if (( stateKey(state) != TombstoneKey ) || ( stateKey(nextSlot.m_state.load()) != EmptyKey )) {
+                        return;
+                    }
+
+                    auto emptyState = makeState(EmptyKey, stateVersion(state) + 1);
+
+                    if (!slot.m_state.compare_exchange_strong(state, emptyState)) {
+                        return;
+                    }
+
+                    if (stateKey(nextSlot.m_state.load()) != EmptyKey) {
+                        slot.m_state.compare_exchange_strong(
+                            emptyState,
+                            makeState(TombstoneKey, stateVersion(emptyState) + 1) );
+
+                        return;
+                    }
+
+                    slotIndex = ( slotIndex - 1 ) & ( Capacity - 1 );
+                }
+            }
+
+            /**
+             * @brief       Returns whether there is an empty slot in the first part of a probe chain.
+             *
+             * @param[in]   index the first slot of the chain.
+             * @param[in]   length the number of slots to check.
+             *
+             * @returns     true if an empty slot was found; otherwise false.
+             */
+            auto hasEmptySlot(size_t index, size_t length) const -> bool {
+                for (size_t probe = 0; probe < length; probe++) {
+                    if (stateKey(m_slots[( index + probe ) & ( Capacity - 1 )].m_state.load()) == EmptyKey) {
+                        return true;
+                    }
+                }
+
+                return false;
+            }
+
+            /**
+             * @brief       Returns the initial slot for a key.
+             *
+             * @details     Uses fibonacci hashing after folding the id into the sequence, the sequence part of
+             *              the key increments by one for each request so this spreads consecutive requests
+             *              across the table.
+             *
+             * @param[in]   key the request key.
+             *
+             * @returns     the slot index.
+             */
+            static constexpr auto hash(uint32_t key) -> size_t {
+                return static_cast<size_t>(
+                    ( ( static_cast<uint64_t>(key ^ ( key >> 16 )) * UINT64_C(0x9E3779B97F4A7C15) ) >> 32 ) &
+                    ( Capacity - 1 ) );
+            }
+
+            static constexpr auto makeState(uint32_t key, uint32_t version) -> uint64_t {
+                return ( static_cast<uint64_t>(key) << 32 ) | version;
+            }
+
+            static constexpr auto stateKey(uint64_t state) -> uint32_t {
+                return static_cast<uint32_t>(state >> 32);
+            }
+
+            static constexpr auto stateVersion(uint64_t state) -> uint32_t {
+                return static_cast<uint32_t>(state & UINT32_MAX);
+            }
+
+        private:
+            //! @cond
+
+            std::array<Slot, Capacity> m_slots;
+            std::atomic<size_t> m_count;
+
+            //! @endcond
+    };
+}}
+
+#endif // PINGNOO_COMPONENTS_ICMPPINGENGINE_ICMPPINGREQUESTTABLE_H
@@ -22,12 +22,17 @@
  */
 
 #include "ICMPPingTarget.h"
+#include "ICMPPacket/ICMPPacketTemplate.h"
 #include "ICMPPingEngine.h"
+#include "ICMPPingTimeoutEstimator.h"
 #include "ICMPSocket/ICMPSocket.h"
 
+#include <PingResultRecord>
 #include <QHostAddress>
 #include <cassert>
 
+constexpr auto DefaultPayloadLength = 52;
+
 /**
  * @brief       Private class to store the ping targets instance data.
  */
@@ -42,8 +47,10 @@ class Nedrysoft::ICMPPingEngine::ICMPPingTargetData {
                 m_pingTarget(parent),
                 m_engine(nullptr),
                 m_socket(nullptr),
+                m_packetTemplate(nullptr),
                 m_userData(nullptr),
                 m_ttl(0),
+                m_resultIndex(Nedrysoft::RouteAnalyser::PingResultRecord::NoTarget),
                 m_id(Nedrysoft::Core::ICore::getInstance()->random(1.0, UINT16_MAX-1)) {
 
         }
@@ -56,9 +63,12 @@ class Nedrysoft::ICMPPingEngine::ICMPPingTargetData {
         QHostAddress m_hostAddress;
         Nedrysoft::ICMPPingEngine::ICMPPingEngine *m_engine;
         Nedrysoft::ICMPSocket::ICMPSocket *m_socket;
+        Nedrysoft::ICMPPacket::ICMPPacketTemplate *m_packetTemplate;
         uint16_t m_id;
         void *m_userData;
         int m_ttl;
+        uint32_t m_resultIndex;
+        Nedrysoft::ICMPPingEngine::ICMPPingTimeoutEstimator m_timeoutEstimator;
 };
 
 Nedrysoft::ICMPPingEngine::ICMPPingTarget::ICMPPingTarget(
@@ -78,11 +88,17 @@ Nedrysoft::ICMPPingEngine::ICMPPingTarget::~ICMPPingTarget() {
         delete d->m_socket;
     }
 
+    delete d->m_packetTemplate;
+
     d.reset();
 }
 
 auto Nedrysoft::ICMPPingEngine::ICMPPingTarget::setHostAddress(QHostAddress hostAddress) -> void {
     d->m_hostAddress = hostAddress;
+
+    delete d->m_packetTemplate;
+
+    d->m_packetTemplate = nullptr;
 }
 
 auto Nedrysoft::ICMPPingEngine::ICMPPingTarget::hostAddress() -> QHostAddress {
@@ -113,6 +129,46 @@ auto Nedrysoft::ICMPPingEngine::ICMPPingTarget::id() -> uint16_t {
     return d->m_id;
 }
 
+auto Nedrysoft::ICMPPingEngine::ICMPPingTarget::setId(uint16_t id) -> void {
+    d->m_id = id;
+
+    delete d->m_packetTemplate;
+
+    d->m_packetTemplate = nullptr;
+}
+
+auto Nedrysoft::ICMPPingEngine::ICMPPingTarget::packetTemplate() -> const Nedrysoft::ICMPPacket::ICMPPacketTemplate * {
+    if (d->m_packetTemplate==nullptr) {
+        if (d->m_hostAddress.protocol() == QAbstractSocket::IPv4Protocol) {
+            d->m_packetTemplate = new Nedrysoft::ICMPPacket::ICMPPacketTemplate(
+                    d->m_id,
+                    DefaultPayloadLength,
+                    d->m_hostAddress,
+                    Nedrysoft::ICMPPacket::V4 );
+        } else if (d->m_hostAddress.protocol() == QAbstractSocket::IPv6Protocol) {
+            d->m_packetTemplate = new Nedrysoft::ICMPPacket::ICMPPacketTemplate(
+                    d->m_id,
+                    DefaultPayloadLength,
+                    d->m_hostAddress,
+                    Nedrysoft::ICMPPacket::V6 );
+        }
+    }
+
+    return d->m_packetTemplate;
+}
+
+auto Nedrysoft::ICMPPingEngine::ICMPPingTarget::timeoutEstimator() -> Nedrysoft::ICMPPingEngine::ICMPPingTimeoutEstimator & {
+    return d->m_timeoutEstimator;
+}
+
+auto Nedrysoft::ICMPPingEngine::ICMPPingTarget::resultIndex() -> uint32_t {
+    return d->m_resultIndex;
+}
+
+auto Nedrysoft::ICMPPingEngine::ICMPPingTarget::setResultIndex(uint32_t index) -> void {
+    d->m_resultIndex = index;
+}
+
 auto Nedrysoft::ICMPPingEngine::ICMPPingTarget::ttl() -> uint16_t {
     return d->m_ttl;
 }
@@ -36,10 +36,15 @@ namespace Nedrysoft { namespace ICMPSocket {
     class ICMPSocket;
 }}
 
+namespace Nedrysoft { namespace ICMPPacket {
+    class ICMPPacketTemplate;
+}}
+
 namespace Nedrysoft { namespace ICMPPingEngine {
     class ICMPPingTargetData;
 
     class ICMPPingEngine;
+    class ICMPPingTimeoutEstimator;
 
     /**
      * @brief       The ICMPPingTarget describes a ping target.
@@ -156,6 +161,51 @@ namespace Nedrysoft { namespace ICMPPingEngine {
              */
             auto id() -> uint16_t;
 
+            /**
+             * @brief       Sets the ICMP id used for this target.
+             *
+             * @details     The id is chosen at random when the target is created, the engine changes it if it is
+             *              already in use by another engine so that replies can be routed to the correct engine.
+             *
+             * @param[in]   id the id.
+             */
+            auto setId(uint16_t id) -> void;
+
+            /**
+             * @brief       Returns the echo request template for this target.
+             *
+             * @details     The template is created on first use and recreated if the id or address of the target
+             *              changes.
+             *
+             * @returns     the packet template; nullptr if the target address is not valid.
+             */
+            auto packetTemplate() -> const Nedrysoft::ICMPPacket::ICMPPacketTemplate *;
+
+            /**
+             * @brief       Returns the reply timeout estimator of this target.
+             *
+             * @details     The estimator is updated with every reply and loss of the target, it is used by the
+             *              engine when the timeout mode is adaptive.
+             *
+             * @returns     the estimator.
+             */
+            auto timeoutEstimator() -> Nedrysoft::ICMPPingEngine::ICMPPingTimeoutEstimator &;
+
+            /**
+             * @brief       Returns the index that results of this target are recorded with.
+             *
+             * @returns     the index assigned by the result batcher of the engine.
+             */
+            auto resultIndex() -> uint32_t;
+
+            /**
+             * @brief       Sets the index that results of this target are recorded with.
+             *
+             * @param[in]   index the index.
+             */
+            auto setResultIndex(uint32_t index) -> void;
+
+            friend class ICMPPingEngine;
             friend class ICMPPingTransmitter;
 
         protected:
@@ -25,10 +25,6 @@
 
 #include "ICMPPingEngine.h"
 
-#include <QThread>
-
-constexpr auto DefaultSleepTime = 1000;
-
 Nedrysoft::ICMPPingEngine::ICMPPingTimeout::ICMPPingTimeout(Nedrysoft::ICMPPingEngine::ICMPPingEngine *engine) :
         m_engine(engine),
         m_isRunning(false) {
@@ -39,8 +35,8 @@ void Nedrysoft::ICMPPingEngine::ICMPPingTimeout::doWork() {
     m_isRunning = true;
 
     while (m_isRunning) {
-        m_engine->timeoutRequests();
-
-        QThread::msleep(DefaultSleepTime);
+        if (!m_engine->timeoutRequests()) {
+            break;
+        }
     }
 }
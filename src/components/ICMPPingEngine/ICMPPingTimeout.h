@@ -52,6 +52,9 @@ namespace Nedrysoft { namespace ICMPPingEngine {
 
             /**
              * @brief       The timeout thread worker.
+             *
+             * @details     Blocks on the engine's timing wheel until the next request deadline, there is no
+             *              polling interval, so timeouts are signalled when they are due.
              */
             Q_SLOT void doWork();
 
@@ -0,0 +1,186 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 18/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef PINGNOO_COMPONENTS_ICMPPINGENGINE_ICMPPINGTIMEOUTESTIMATOR_H
+#define PINGNOO_COMPONENTS_ICMPPINGENGINE_ICMPPINGTIMEOUTESTIMATOR_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+
+namespace Nedrysoft { namespace ICMPPingEngine {
+    /**
+     * @brief       The TimeoutMode enum specifies how the time after which a request is reported as lost is chosen.
+     */
+    enum class TimeoutMode {
+        Fixed,                              /**< every request is given the timeout set on the engine. */
+        Adaptive                            /**< each target is given a timeout derived from its round trip times. */
+    };
+
+    /**
+     * @brief       The ICMPPingTimeoutEstimator class estimates the reply timeout of a target from its round trip
+     *              times.
+     *
+     * @details     The estimate follows the TCP retransmission timer (RFC 6298), a smoothed round trip time
+     *              (SRTT) and round trip time variation (RTTVAR) are updated from every reply and the timeout is
+     *              SRTT + 4 * RTTVAR.  Each consecutive lost request doubles the timeout so that a hop whose
+     *              latency has increased is not reported as lost indefinitely, the next reply removes the backoff.
+     *
+     *              The timeout is always bounded by the minimum and maximum given by the caller, until the first
+     *              reply is received the maximum is used.
+     *
+     *              Samples must be added from a single thread (the receiver), losses may be added and the timeout
+     *              read from any thread.
+     */
+    class ICMPPingTimeoutEstimator {
+        public:
+            /**
+             * @brief       The smallest variation term of the timeout, in nanoseconds.
+             */
+            static constexpr int64_t Granularity = 1000000;
+
+            /**
+             * @brief       The largest number of times that the timeout is doubled after consecutive losses.
+             */
+            static constexpr int MaximumBackoff = 6;
+
+        public:
+            /**
+             * @brief       Constructs an ICMPPingTimeoutEstimator with no samples.
+             */
+            ICMPPingTimeoutEstimator() :
+                    m_smoothedRoundTripTime(0),
+                    m_roundTripTimeVariation(0),
+                    m_backoff(0) {
+
+            }
+
+            ICMPPingTimeoutEstimator(const ICMPPingTimeoutEstimator &) = delete;
+            ICMPPingTimeoutEstimator &operator=(const ICMPPingTimeoutEstimator &) = delete;
+
+            /**
+             * @brief       Updates the estimate with the round trip time of a reply.
+             *
+             * @param[in]   roundTripTime the round trip time in nanoseconds.
+             */
+            auto addSample(int64_t roundTripTime) -> void {
+                roundTripTime = std::max<int64_t>(roundTripTime, 1);
+
+                auto smoothedRoundTripTime = m_smoothedRoundTripTime.load(std::memory_order_relaxed);
+                auto roundTripTimeVariation = m_roundTripTimeVariation.load(std::memory_order_relaxed);
+
+                if (!smoothedRoundTripTime) {
+                    smoothedRoundTripTime = roundTripTime;
+                    roundTripTimeVariation = roundTripTime / 2;
+                } else {
+                    auto error = smoothedRoundTripTime - roundTripTime;
+
+                    if (error < 0) {
+                        error = -error;
+                    }
+
+                    // RTTVAR = 3/4 RTTVAR + 1/4 |SRTT - R|, SRTT = 7/8 SRTT + 1/8 R.
+
+                    roundTripTimeVariation = roundTripTimeVariation - ( roundTripTimeVariation / 4 ) + ( error / 4 );
+                    smoothedRoundTripTime = smoothedRoundTripTime - ( smoothedRoundTripTime / 8 ) + ( roundTripTime / 8 );
+                }
+
+                m_roundTripTimeVariation.store(roundTripTimeVariation, std::memory_order_relaxed);
+                m_smoothedRoundTripTime.store(std::max<int64_t>(smoothedRoundTripTime, 1), std::memory_order_relaxed);
+                m_backoff.store(0, std::memory_order_relaxed);
+            }
+
+            /**
+             * @brief       Records that a request was not answered before its timeout.
+             */
+            auto addLoss() -> void {
+                auto backoff = m_backoff.load(std::memory_order_relaxed);
+
+                while (backoff < MaximumBackoff) {
+                    if (m_backoff.compare_exchange_weak(backoff, backoff + 1, std::memory_order_relaxed)) {
+                        break;
+                    }
+                }
+            }
+
+            /**
+             * @brief       Returns the timeout for the next request.
+             *
+             * @param[in]   minimum the smallest timeout in nanoseconds.
+             * @param[in]   maximum the largest timeout in nanoseconds.
+             *
+             * @returns     the timeout in nanoseconds.
+             */
+            auto timeout(int64_t minimum, int64_t maximum) const -> int64_t {
+                auto smoothedRoundTripTime = m_smoothedRoundTripTime.load(std::memory_order_relaxed);
+
+                maximum = std::max(minimum, maximum);
+
+                if (!smoothedRoundTripTime) {
+                    return maximum;
+                }
+
+                auto variation = std::max(Granularity, 4 * m_roundTripTimeVariation.load(std::memory_order_relaxed));
+                auto timeout = smoothedRoundTripTime + variation;
+                auto backoff = m_backoff.load(std::memory_order_relaxed);
+
+                // the timeout is compared before each doubling so that it cannot overflow.
+
+                for (auto doubling = 0; ( doubling < backoff ) && ( timeout < maximum ); doubling++) {
+                    timeout *= 2;
+                }
+
+                return std::min(std::max(timeout, minimum), maximum);
+            }
+
+            /**
+             * @brief       Returns the smoothed round trip time.
+             *
+             * @returns     the smoothed round trip time in nanoseconds; 0 if no reply has been received.
+             */
+            auto smoothedRoundTripTime() const -> int64_t {
+                return m_smoothedRoundTripTime.load(std::memory_order_relaxed);
+            }
+
+            /**
+             * @brief       Returns the round trip time variation.
+             *
+             * @returns     the variation in nanoseconds; 0 if no reply has been received.
+             */
+            auto roundTripTimeVariation() const -> int64_t {
+                return m_roundTripTimeVariation.load(std::memory_order_relaxed);
+            }
+
+        private:
+            //! @cond
+
+            std::atomic<int64_t> m_smoothedRoundTripTime;
+            std::atomic<int64_t> m_roundTripTimeVariation;
+            std::atomic<int> m_backoff;
+
+            //! @endcond
+    };
+}}
+
+#endif // PINGNOO_COMPONENTS_ICMPPINGENGINE_ICMPPINGTIMEOUTESTIMATOR_H
@@ -0,0 +1,443 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 18/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PINGNOO_COMPONENTS_ICMPPINGENGINE_ICMPPINGTIMINGWHEEL_H
+#define PINGNOO_COMPONENTS_ICMPPINGENGINE_ICMPPINGTIMINGWHEEL_H
+
+#include "Utils.h"
+
+#include <array>
+#include <bitset>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <vector>
+
+namespace Nedrysoft { namespace ICMPPingEngine {
+    /**
+     * @brief       The ICMPPingTimingWheel class is a hierarchical timing wheel used to expire ping requests.
+     *
+     * @details     Requests are scheduled with their deadline (in monotonic nanoseconds) when they are
+     *              transmitted.  Deadlines are rounded up to the resolution of the wheel (a tick) and placed
+     *              into one of 4 levels of 256 slots, level 0 holds the requests due in the next 256 ticks, level
+     *              1 the next 65536 ticks and so on.  As the wheel turns, the slot of a higher level is cascaded
+     *              down into the lower levels, so each request is touched a small fixed number of times
+     *              regardless of how many requests are outstanding.
+     *
+     *              The wheel does not support cancellation, when a reply is received the request is removed from
+     *              the request table and the expired key is simply ignored when it cannot be taken.
+     *
+     *              wait() blocks until the next deadline rather than polling, so timeouts are reported at the
+     *              deadline (to within one tick) and the timeout thread is idle when there is nothing to expire.
+     */
+    class ICMPPingTimingWheel {
+        public:
+            /**
+             * @brief       An expired entry.
+             */
+            struct Entry {
+                uint32_t key;
+                int64_t deadline;
+            };
+
+        private:
+            static constexpr int LevelBits = 8;
+            static constexpr int Levels = 4;
+            static constexpr int SlotsPerLevel = 1 << LevelBits;
+            static constexpr int64_t SlotMask = SlotsPerLevel - 1;
+
+            static constexpr int64_t NotWaiting = std::numeric_limits<int64_t>::min();
+            static constexpr int64_t WaitingForever = std::numeric_limits<int64_t>::max();
+
+        public:
+            /**
+             * @brief       Constructs a new ICMPPingTimingWheel.
+             *
+             * @param[in]   resolution the length of a tick in nanoseconds.
+             */
+            explicit ICMPPingTimingWheel(int64_t resolution) :
+                    ICMPPingTimingWheel(resolution, Nedrysoft::Utils::monotonicNanoseconds()) {
+
+            }
+
+            /**
+             * @brief       Constructs a new ICMPPingTimingWheel with the given origin.
+             *
+             * @param[in]   resolution the length of a tick in nanoseconds.
+             * @param[in]   origin the time of the first tick in monotonic nanoseconds.
+             */
+            ICMPPingTimingWheel(int64_t resolution, int64_t origin) :
+                    m_resolution(resolution),
+                    m_origin(origin),
+                    m_currentTick(0),
+                    m_waitTick(NotWaiting),
+                    m_count(0),
+                    m_stopped(false) {
+
+            }
+
+            ICMPPingTimingWheel(const ICMPPingTimingWheel &) = delete;
+            ICMPPingTimingWheel &operator=(const ICMPPingTimingWheel &) = delete;
+
+            /**
+             * @brief       Schedules a key to expire at the given deadline.
+             *
+             * @param[in]   key the request key.
+             * @param[in]   deadline the deadline in monotonic nanoseconds.
+             */
+            auto schedule(uint32_t key, int64_t deadline) -> void {
+                std::unique_lock<std::mutex> lock(m_mutex);
+
+                auto tick = deadlineTick(deadline);
+
+                insert(Entry{key, deadline}, tick);
+
+                m_count++;
+
+                if (tick < m_waitTick) {
+                    lock.unlock();
+
+                    m_condition.notify_one();
+                }
+            }
+
+            /**
+             * @brief       Advances the wheel to the given time and returns the entries that have expired.
+             *
+             * @param[in]   currentTime the current time in monotonic nanoseconds.
+             * @param[out]  expired the list that expired entries are appended to.
+             */
+            auto expire(int64_t currentTime, std::vector<Entry> &expired) -> void {
+                std::lock_guard<std::mutex> lock(m_mutex);
+
+                advance(( currentTime - m_origin ) / m_resolution);
+
+                m_count -= m_expired.size();
+
+                expired.insert(expired.end(), m_expired.begin(), m_expired.end());
+
+                m_expired.clear();
+            }
+
+            /**
+             * @brief       Blocks until at least one entry has expired or the wheel is stopped.
+             *
+             * @param[out]  expired the list that expired entries are appended to.
+             *
+             * @returns     true if entries expired; false if the wheel was stopped.
+             */
+            auto wait(std::vector<Entry> &expired) -> bool {
+                std::unique_lock<std::mutex> lock(m_mutex);
+
+                while (!m_stopped) {
+                    advance(( Nedrysoft::Utils::monotonicNanoseconds() - m_origin ) / m_resolution);
+
+                    if (!m_expired.empty()) {
+                        m_count -= m_expired.size();
+
+                        expired.insert(expired.end(), m_expired.begin(), m_expired.end());
+
+                        m_expired.clear();
+
+                        return true;
+                    }
+
+                    auto tick = nextTick();
+
+                    if (tick < 0) {
+                        m_waitTick = WaitingForever;
+
+                        m_condition.wait(lock);
+                    } else {
+                        m_waitTick = tick;
+
+                        m_condition.wait_until(
+                            lock,
+                            std::chrono::steady_clock::time_point(
+                                std::chrono::nanoseconds(m_origin + tick * m_resolution) ) );
+                    }
+
+                    m_waitTick = NotWaiting;
+                }
+
+                return false;
+            }
+
+            /**
+             * @brief       Allows wait() to block, this is the initial state of the wheel.
+             */
+            auto start() -> void {
+                std::lock_guard<std::mutex> lock(m_mutex);
+
+                m_stopped = false;
+            }
+
+            /**
+             * @brief       Wakes any thread blocked in wait() and causes future calls to return immediately.
+             */
+            auto stop() -> void {
+                std::unique_lock<std::mutex> lock(m_mutex);
+
+                m_stopped = true;
+
+                for (auto &level : m_slots) {
+                    for (auto &slot : level) {
+                        slot.clear();
+                    }
+                }
+
+                for (auto &occupied : m_occupied) {
+                    occupied.reset();
+                }
+
+                m_expired.clear();
+
+                m_count = 0;
+
+                lock.unlock();
+
+                m_condition.notify_all();
+            }
+
+            /**
+             * @brief       Returns the number of scheduled entries.
+             *
+             * @returns     the number of entries.
+             */
+            auto count() -> size_t {
+                std::lock_guard<std::mutex> lock(m_mutex);
+
+                return m_count;
+            }
+
+            /**
+             * @brief       Returns the time at which the wheel next has work to do.
+             *
+             * @details     This is the deadline of the next entry to expire rounded up to a tick, or the start of
+             *              the next level 0 rotation if the next entries must first be cascaded.
+             *
+             * @returns     the time in monotonic nanoseconds; -1 if the wheel is empty.
+             */
+            auto nextTime() -> int64_t {
+                std::lock_guard<std::mutex> lock(m_mutex);
+
+                auto tick = nextTick();
+
+                if (tick < 0) {
+                    return -1;
+                }
+
+                return m_origin + tick * m_resolution;
+            }
+
+        private:
+            /**
+             * @brief       Converts a time to a tick, rounding up so that an entry never expires early.
+             *
+             * @param[in]   time the time in monotonic nanoseconds.
+             *
+             * @returns     the tick.
+             */
+            auto deadlineTick(int64_t time) const -> int64_t {
+                auto offset = time - m_origin;
+
+                if (offset <= 0) {
+                    return 0;
+                }
+
+                return ( offset + m_resolution - 1 ) / m_resolution;
+            }
+
+            /**
+             * @brief       Places an entry into the correct level and slot for the current tick.
+             *
+             * @note        The mutex must be held by the caller.
+             *
+             * @param[in]   entry the entry to insert.
+             * @param[in]   tick the tick that the entry expires at.
+             */
+            auto insert(const Entry &entry, int64_t tick) -> void {
+                auto delta = tick - m_currentTick;
+
+                if (delta <= 0) {
+                    m_expired.push_back(entry);
+
+                    return;
+                }
+
+                // entries beyond the range of the wheel are parked in the last level and re-evaluated when cascaded.
+
+                auto level = 0;
+
+                while (( level < Levels - 1 ) && ( delta >> ( LevelBits * ( level + 1 ) ) )) {
+                    level++;
+                }
+
+                if (delta >> ( LevelBits * Levels )) {
+                    tick = m_currentTick + ( static_cast<int64_t>(1) << ( LevelBits * Levels ) ) - 1;
+                }
+
+                auto slot = static_cast<int>(( tick >> ( LevelBits * level ) ) & SlotMask);
+
+                m_slots[level][slot].push_back(entry);
+                m_occupied[level].set(slot);
+            }
+
+            /**
+             * @brief       Moves the entries in a slot down to the lower levels.
+             *
+             * @note        The mutex must be held by the caller.
+             *
+             * @param[in]   level the level of the slot.
+             * @param[in]   slot the slot index.
+             */
+            auto cascade(int level, int slot) -> void {
+                if (!m_occupied[level].test(slot)) {
+                    return;
+                }
+
+                std::vector<Entry> entries;
+
+                entries.swap(m_slots[level][slot]);
+
+                m_occupied[level].reset(slot);
+
+                for (const auto &entry : entries) {
+                    insert(entry, deadlineTick(entry.deadline));
+                }
+            }
+
+            /**
+             * @brief       Advances the current tick, expiring and cascading slots as they are passed.
+             *
+             * @note        The mutex must be held by the caller.
+             *
+             * @param[in]   tick the tick to advance to.
+             */
+            auto advance(int64_t tick) -> void {
+                while (m_currentTick < tick) {
+                    auto boundary = ( m_currentTick | SlotMask ) + 1;
+                    auto next = boundary;
+
+                    // an empty level 0 is skipped a rotation at a time, only the higher levels need to be cascaded.
+
+                    if (m_occupied[0].any()) {
+                        for (auto candidate = m_currentTick + 1; candidate < boundary; candidate++) {
+                            if (m_occupied[0].test(static_cast<size_t>(candidate & SlotMask))) {
+                                next = candidate;
+
+                                break;
+                            }
+                        }
+                    }
+
+                    if (next > tick) {
+                        m_currentTick = tick;
+
+                        break;
+                    }
+
+                    m_currentTick = next;
+
+                    if (( next & SlotMask ) == 0) {
+                        for (auto level = 1; level < Levels; level++) {
+                            auto slot = static_cast<int>(( next >> ( LevelBits * level ) ) & SlotMask);
+
+                            cascade(level, slot);
+
+                            if (slot) {
+                                break;
+                            }
+                        }
+                    }
+
+                    auto slot = static_cast<int>(next & SlotMask);
+
+                    if (m_occupied[0].test(slot)) {
+                        auto &entries = m_slots[0][slot];
+
+                        m_expired.insert(m_expired.end(), entries.begin(), entries.end());
+
+                        entries.clear();
+
+                        m_occupied[0].reset(slot);
+                    }
+                }
+            }
+
+            /**
+             * @brief       Returns the tick at which the wheel next has work to do.
+             *
+             * @note        The mutex must be held by the caller.
+             *
+             * @returns     the next tick; -1 if the wheel is empty.
+             */
+            auto nextTick() const -> int64_t {
+                if (!m_expired.empty()) {
+                    return m_currentTick;
+                }
+
+                auto boundary = ( m_currentTick | SlotMask ) + 1;
+
+                for (auto candidate = m_currentTick + 1; candidate < boundary; candidate++) {
+                    if (m_occupied[0].test(static_cast<size_t>(candidate & SlotMask))) {
+                        return candidate;
+                    }
+                }
+
+                for (const auto &occupied : m_occupied) {
+                    if (occupied.any()) {
+                        return boundary;
+                    }
+                }
+
+                return -1;
+            }
+
+        private:
+            //! @cond
+
+            std::array<std::array<std::vector<Entry>, SlotsPerLevel>, Levels> m_slots;
+            std::array<std::bitset<SlotsPerLevel>, Levels> m_occupied;
+
+            std::vector<Entry> m_expired;
+
+            std::mutex m_mutex;
+            std::condition_variable m_condition;
+
+            int64_t m_resolution;
+            int64_t m_origin;
+            int64_t m_currentTick;
+            int64_t m_waitTick;
+
+            size_t m_count;
+
+            bool m_stopped;
+
+            //! @endcond
+    };
+}}
+
+#endif // PINGNOO_COMPONENTS_ICMPPINGENGINE_ICMPPINGTIMINGWHEEL_H
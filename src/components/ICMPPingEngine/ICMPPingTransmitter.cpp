@@ -23,18 +23,23 @@
 
 #include "ICMPPingTransmitter.h"
 
-#include "ICMPPacket/ICMPPacket.h"
+#include "ICMPPacket/ICMPPacketTemplate.h"
 #include "ICMPPingEngine.h"
 #include "ICMPPingItem.h"
 #include "ICMPPingTarget.h"
 #include "ICMPSocket/ICMPSocket.h"
+#include "Utils.h"
 
 #include <QThread>
 #include <QtEndian>
+#include <algorithm>
+#include <array>
 #include <cstdint>
 #include <spdlog/spdlog.h>
 
 constexpr auto DefaultTransmitInterval = 10000;
+constexpr auto PacketBufferSize = 1500;
+constexpr auto NanosecondsInMillisecond = INT64_C(1000000);
 
 //! @cond
 uint16_t Nedrysoft::ICMPPingEngine::ICMPPingTransmitter::m_sequenceId = 1;
@@ -44,35 +49,101 @@ QMutex Nedrysoft::ICMPPingEngine::ICMPPingTransmitter::m_sequenceMutex;
 Nedrysoft::ICMPPingEngine::ICMPPingTransmitter::ICMPPingTransmitter(Nedrysoft::ICMPPingEngine::ICMPPingEngine *engine) :
         m_interval(DefaultTransmitInterval),
         m_engine(engine),
+        m_socket(nullptr),
+        m_ownsSocket(true),
+        m_pacingMode(Nedrysoft::ICMPPingEngine::PacingMode::Burst),
         m_isRunning(false) {
 
 }
 
 Nedrysoft::ICMPPingEngine::ICMPPingTransmitter::~ICMPPingTransmitter() {
     qDeleteAll(m_targets);
+    qDeleteAll(m_removedTargets);
+
+    if (m_ownsSocket) {
+        delete m_socket;
+    }
 }
 
 void Nedrysoft::ICMPPingEngine::ICMPPingTransmitter::doWork() {
-    QElapsedTimer elapsedTimer;
+    QVector<ScheduledTarget> schedule;
+    std::array<char, PacketBufferSize> packetBuffer;
     unsigned long sampleNumber = 0;
 
     m_isRunning = true;
 
     m_engine->setEpoch(QDateTime::currentDateTime());
 
+    auto roundStart = Nedrysoft::Utils::monotonicNanoseconds();
+
     while (m_isRunning) {
-        if (!m_targets.isEmpty()) {
-            SPDLOG_TRACE("Preparing ping set to " + m_targets.last()->hostAddress().toString().toStdString());
-        }
+        auto interval = static_cast<int64_t>(m_interval) * NanosecondsInMillisecond;
+        auto pacingMode = m_pacingMode.load(std::memory_order_relaxed);
 
-        elapsedTimer.restart();
+        // the targets are copied so that the lock is not held while the round is paced across the interval,
+        // targets are only deleted when the transmitter is destroyed.
 
         m_targetsMutex.lock();
 
-        for (auto target : m_targets) {
-            auto socket = target->socket();
+        schedule.clear();
+
+        for (auto index = 0; index < m_targets.count(); index++) {
+            auto target = m_targets.at(index);
+
+            schedule.append(ScheduledTarget {
+                target,
+                Nedrysoft::ICMPPingEngine::ICMPPingPacing::offset(
+                    pacingMode,
+                    index,
+                    m_targets.count(),
+                    Nedrysoft::Utils::fzMake32(target->id(), static_cast<uint16_t>(target->ttl())),
+                    interval )
+            });
+        }
+
+        m_targetsMutex.unlock();
+
+        std::stable_sort(schedule.begin(), schedule.end(), [](const ScheduledTarget &a, const ScheduledTarget &b) {
+            return a.offset < b.offset;
+        });
+
+        if (!schedule.isEmpty()) {
+            SPDLOG_TRACE("Preparing ping set to " + schedule.last().target->hostAddress().toString().toStdString());
+        }
+
+        if (!m_socket) {
+            m_socket = Nedrysoft::ICMPSocket::ICMPSocket::createWriteSocket(
+                    0,
+                    static_cast<Nedrysoft::ICMPSocket::IPVersion>(m_engine->version()) );
+        }
+
+        auto queuedPackets = 0;
+        auto sentPackets = 0;
+
+        for (const auto &scheduledTarget : schedule) {
+            if (( !m_socket ) || ( !m_isRunning )) {
+                break;
+            }
+
+            auto target = scheduledTarget.target;
+            auto deadline = roundStart + scheduledTarget.offset;
+
+            // in burst mode the whole round is queued and sent together, otherwise each probe is sent on its own
+            // at its deadline.
 
-            auto pingItem = new Nedrysoft::ICMPPingEngine::ICMPPingItem();
+            if (pacingMode != Nedrysoft::ICMPPingEngine::PacingMode::Burst) {
+                Nedrysoft::Utils::sleepUntil(deadline);
+            }
+
+            m_engine->recordTransmitLateness(Nedrysoft::Utils::monotonicNanoseconds() - deadline);
+
+            auto packetTemplate = target->packetTemplate();
+
+            if (!packetTemplate) {
+                continue;
+            }
+
+            auto pingItem = m_engine->acquireItem();
 
             m_sequenceMutex.lock();
             uint16_t currentSequenceId = m_sequenceId++;
@@ -83,42 +154,141 @@ void Nedrysoft::ICMPPingEngine::ICMPPingTransmitter::doWork() {
             pingItem->setSequenceId(currentSequenceId);
             pingItem->setSampleNumber(sampleNumber);
 
-            m_engine->addRequest(pingItem);
+            pingItem->startTimer();
+
+            // the packet is created from the precomputed template of the target, only the sequence, the payload
+            // timestamp and the checksum are updated.
 
-            auto buffer = Nedrysoft::ICMPPacket::ICMPPacket::pingPacket(
-                    target->id(),
+            auto packetLength = packetTemplate->write(
+                    packetBuffer.data(),
+                    PacketBufferSize,
                     currentSequenceId,
-                    52,
+                    pingItem->transmitTime() );
+
+            if (!m_engine->addRequest(pingItem)) {
+                SPDLOG_ERROR("Request table full, unable to send packet to "+target->hostAddress().toString().toStdString());
+
+                m_engine->releaseItem(pingItem);
+
+                continue;
+            }
+
+            // the ttl is sent with each packet, so all targets share the same socket and the round is sent in as
+            // few system calls as possible.
+
+            auto requestId = Nedrysoft::Utils::fzMake32(target->id(), currentSequenceId);
+
+            auto queueResult = m_socket->queue(
+                packetBuffer.data(),
+                packetLength,
+                target->hostAddress(),
+                target->ttl(),
+                requestId );
+
+            if (queueResult == Nedrysoft::ICMPSocket::QueueResult::Full) {
+                sentPackets += flush();
+
+                queueResult = m_socket->queue(
+                    packetBuffer.data(),
+                    packetLength,
                     target->hostAddress(),
-                    static_cast<Nedrysoft::ICMPPacket::IPVersion>(m_engine->version()) );
+                    target->ttl(),
+                    requestId );
+            }
 
-            auto result = socket->sendto(buffer, target->hostAddress());
+            // a packet that the socket rejected is never sent, the request is withdrawn so that it is counted as a
+            // send error rather than reported as lost when it times out.
 
-            pingItem->startTimer();
+            if (queueResult != Nedrysoft::ICMPSocket::QueueResult::Queued) {
+                m_engine->cancelRequest(requestId);
 
-            SPDLOG_TRACE(
-                    QString("Sent ping to %1 (TTL=%2, Result=%3)")
-                    .arg(target->hostAddress().toString())
-                    .arg(socket->ttl()).arg(result)
-                    .toStdString() );
+                continue;
+            }
+
+            queuedPackets++;
 
-            if (result != buffer.length()) {
-                SPDLOG_ERROR("Unable to send packet to "+target->hostAddress().toString().toStdString());
+            if (pacingMode != Nedrysoft::ICMPPingEngine::PacingMode::Burst) {
+                sentPackets += flush();
             }
         }
 
-        m_targetsMutex.unlock();
+        if (m_socket) {
+            sentPackets += flush();
+        }
 
-        auto elapsedTime = elapsedTimer.elapsed();
+        m_engine->recordTransmitted(sentPackets, queuedPackets);
 
-        if (elapsedTime < m_interval) {
-            QThread::msleep(m_interval - elapsedTime);
+        SPDLOG_TRACE(
+                QString("Sent %1 of %2 pings")
+                .arg(sentPackets)
+                .arg(queuedPackets)
+                .toStdString() );
+
+        if (sentPackets != queuedPackets) {
+            SPDLOG_ERROR(
+                    QString("Unable to send %1 of %2 packets")
+                    .arg(queuedPackets - sentPackets)
+                    .arg(queuedPackets)
+                    .toStdString() );
+        }
+
+        // rounds start on a fixed grid so that the time between the probes of a target stays equal to the
+        // interval, if the transmitter has fallen more than a round behind then the grid is restarted from now.
+
+        roundStart += interval;
+
+        auto currentTime = Nedrysoft::Utils::monotonicNanoseconds();
+
+        if (roundStart + interval < currentTime) {
+            roundStart = currentTime;
+        }
+
+        if (m_isRunning) {
+            Nedrysoft::Utils::sleepUntil(roundStart);
         }
 
         sampleNumber++;
     }
 }
 
+auto Nedrysoft::ICMPPingEngine::ICMPPingTransmitter::flush() -> int {
+    if (!m_socket) {
+        return 0;
+    }
+
+    auto sentPackets = m_socket->flush();
+
+    // attach any kernel transmit timestamps that are available to the requests, these are used in preference to
+    // the application transmit time when calculating the round trip time.
+
+    m_transmitTimestamps.clear();
+
+    m_socket->transmitTimestamps(m_transmitTimestamps);
+
+    for (const auto &transmitTimestamp : m_transmitTimestamps) {
+        m_engine->setTransmitTimestamp(transmitTimestamp.tag, transmitTimestamp.timestamp);
+    }
+
+    return sentPackets;
+}
+
+auto Nedrysoft::ICMPPingEngine::ICMPPingTransmitter::setPacingMode(Nedrysoft::ICMPPingEngine::PacingMode mode) -> void {
+    m_pacingMode.store(mode, std::memory_order_relaxed);
+}
+
+auto Nedrysoft::ICMPPingEngine::ICMPPingTransmitter::pacingMode() -> Nedrysoft::ICMPPingEngine::PacingMode {
+    return m_pacingMode.load(std::memory_order_relaxed);
+}
+
+auto Nedrysoft::ICMPPingEngine::ICMPPingTransmitter::setSocket(Nedrysoft::ICMPSocket::ICMPSocket *socket) -> void {
+    if (m_ownsSocket) {
+        delete m_socket;
+    }
+
+    m_socket = socket;
+    m_ownsSocket = false;
+}
+
 auto Nedrysoft::ICMPPingEngine::ICMPPingTransmitter::setInterval(int interval) -> bool {
     m_interval = interval;
 
@@ -131,6 +301,16 @@ auto Nedrysoft::ICMPPingEngine::ICMPPingTransmitter::addTarget(Nedrysoft::ICMPPi
     m_targets.append(target);
 }
 
+auto Nedrysoft::ICMPPingEngine::ICMPPingTransmitter::removeTarget(
+        Nedrysoft::ICMPPingEngine::ICMPPingTarget *target) -> void {
+
+    QMutexLocker locker(&m_targetsMutex);
+
+    if (m_targets.removeAll(target)) {
+        m_removedTargets.append(target);
+    }
+}
+
 auto Nedrysoft::ICMPPingEngine::ICMPPingTransmitter::interval() -> int {
     return m_interval;
 }
\ No newline at end of file
@@ -24,10 +24,15 @@
 #ifndef PINGNOO_COMPONENTS_ICMPPINGENGINE_ICMPPINGTRANSMITTER_H
 #define PINGNOO_COMPONENTS_ICMPPINGENGINE_ICMPPINGTRANSMITTER_H
 
+#include "ICMPPingPacing.h"
+#include "ICMPSocket/ICMPSocket.h"
+
 #include <PingResult>
 
 #include <QMutex>
 #include <QObject>
+#include <QVector>
+#include <atomic>
 
 namespace Nedrysoft { namespace ICMPPingEngine {
     class ICMPPingEngine;
@@ -37,6 +42,11 @@ namespace Nedrysoft { namespace ICMPPingEngine {
     /**
      * @brief       The ICMPPingTransmitter class sends pings to the target (and intermediate nodes) at a prescribed
      *              interval.
+     *
+     * @details     All targets are sent from a single write socket with the TTL attached to each packet.  In Burst
+     *              mode the packets for each round are queued and flushed together so that on Linux a round costs a
+     *              single sendmmsg call, in the paced modes each probe is sent at its own absolute deadline within
+     *              the interval so that the round does not leave as a burst.
      */
     class ICMPPingTransmitter :
             public QObject {
@@ -80,7 +90,57 @@ namespace Nedrysoft { namespace ICMPPingEngine {
              */
             auto addTarget(Nedrysoft::ICMPPingEngine::ICMPPingTarget *target) -> void;
 
+            /**
+             * @brief       Removes a ping target from the transmitter.
+             *
+             * @details     the target is no longer pinged but is kept until the transmitter is destroyed, as
+             *              replies to requests that are in flight still refer to it.
+             *
+             * @param[in]   target the target to stop pinging.
+             */
+            auto removeTarget(Nedrysoft::ICMPPingEngine::ICMPPingTarget *target) -> void;
+
+            /**
+             * @brief       Sets how the probes of a round are spread across the interval.
+             *
+             * @details     The mode takes effect from the next round.
+             *
+             * @param[in]   mode the pacing mode.
+             */
+            auto setPacingMode(Nedrysoft::ICMPPingEngine::PacingMode mode) -> void;
+
+            /**
+             * @brief       Returns the pacing mode.
+             *
+             * @returns     the pacing mode.
+             */
+            auto pacingMode() -> Nedrysoft::ICMPPingEngine::PacingMode;
+
+            /**
+             * @brief       Sets the socket that the requests are sent on.
+             *
+             * @details     If no socket is set then the transmitter creates a raw write socket when it starts.  The
+             *              socket is not owned by the transmitter and must outlive it.
+             *
+             * @param[in]   socket the socket.
+             */
+            auto setSocket(Nedrysoft::ICMPSocket::ICMPSocket *socket) -> void;
+
         private:
+            /**
+             * @brief       A target and the offset into the round at which it is sent.
+             */
+            struct ScheduledTarget {
+                Nedrysoft::ICMPPingEngine::ICMPPingTarget *target;
+                int64_t offset;
+            };
+
+            /**
+             * @brief       Sends the queued packets and passes their kernel transmit timestamps to the engine.
+             *
+             * @returns     the number of packets sent.
+             */
+            auto flush() -> int;
 
             /**
              * @brief       The transmitter thread worker.
@@ -103,11 +163,19 @@ namespace Nedrysoft { namespace ICMPPingEngine {
             int m_interval;
             Nedrysoft::ICMPPingEngine::ICMPPingEngine *m_engine;
 
+            Nedrysoft::ICMPSocket::ICMPSocket *m_socket;
+            bool m_ownsSocket;
+
             QList<Nedrysoft::ICMPPingEngine::ICMPPingTarget *> m_targets;
+            QList<Nedrysoft::ICMPPingEngine::ICMPPingTarget *> m_removedTargets;
             QMutex m_targetsMutex;
 
             QDateTime m_epoch;
 
+            QVector<Nedrysoft::ICMPSocket::TransmitTimestamp> m_transmitTimestamps;
+
+            std::atomic<Nedrysoft::ICMPPingEngine::PacingMode> m_pacingMode;
+
             static QMutex m_sequenceMutex;
             static uint16_t m_sequenceId;
 
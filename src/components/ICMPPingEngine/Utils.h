@@ -24,9 +24,17 @@
 #ifndef PINGNOO_COMPONENTS_ICMPPINGENGINE_UTILS_H
 #define PINGNOO_COMPONENTS_ICMPPINGENGINE_UTILS_H
 
+#include <chrono>
 #include <limits.h>
 #include <stdint.h>
 
+#if defined(__linux__)
+#include <cerrno>
+#include <time.h>
+#else
+#include <thread>
+#endif
+
 // TODO: move the utils to a separate file, for the time being it's wrapped in a cond doxygen directive to
 //       stop doxygen emitting a warning.
 
@@ -47,6 +55,39 @@ namespace Nedrysoft { namespace Utils {
     constexpr auto fzMake32(uint16_t high, uint16_t low) -> uint32_t {
         return ( static_cast<uint32_t>(( high << ( sizeof(high) * CHAR_BIT ) | low )));
     }
+
+    /**
+     * @brief       Returns the current time of the monotonic clock.
+     *
+     * @returns     the time in nanoseconds.
+     */
+    inline auto monotonicNanoseconds() -> int64_t {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch() ).count();
+    }
+
+    /**
+     * @brief       Sleeps until the monotonic clock reaches a deadline.
+     *
+     * @details     The deadline is absolute, so time spent before the call (or a wake up that is delivered late)
+     *              does not accumulate into the next deadline.  On Linux clock_nanosleep is used with the same
+     *              clock as monotonicNanoseconds().
+     *
+     * @param[in]   deadline the time in nanoseconds, as returned by monotonicNanoseconds().
+     */
+    inline auto sleepUntil(int64_t deadline) -> void {
+#if defined(__linux__)
+        struct timespec deadlineTime = {
+            static_cast<time_t>(deadline / 1000000000),
+            static_cast<long>(deadline % 1000000000)
+        };
+
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadlineTime, nullptr) == EINTR) {
+        }
+#else
+        std::this_thread::sleep_until(std::chrono::steady_clock::time_point(std::chrono::nanoseconds(deadline)));
+#endif
+    }
 }}
 
 //! @endcond
@@ -0,0 +1,444 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 18/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PINGNOO_COMPONENTS_IOURINGPINGENGINE_IOURING_H
+#define PINGNOO_COMPONENTS_IOURINGPINGENGINE_IOURING_H
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace Nedrysoft { namespace IOUringPingEngine {
+    /**
+     * @brief       The IOUring class is a minimal io_uring instance driven with the raw system calls.
+     *
+     * @details     The submission and completion rings are mapped into the process, requests are written into the
+     *              submission ring and submitted together with a single io_uring_enter call, which can also wait
+     *              for completions.  Only the operations required by the ping engine are provided.
+     *
+     *              The class is not thread safe, it is intended to be used by a single thread.
+     */
+    class IOUring {
+        public:
+            /**
+             * @brief       Constructs an io_uring instance.
+             *
+             * @param[in]   entries the number of entries in the submission ring, rounded up to a power of 2 by
+             *              the kernel.
+             */
+            explicit IOUring(unsigned int entries) :
+                    m_ringDescriptor(-1),
+                    m_ring(MAP_FAILED),
+                    m_ringSize(0),
+                    m_submissions(static_cast<io_uring_sqe *>(MAP_FAILED)),
+                    m_submissionsSize(0),
+                    m_submissionHead(nullptr),
+                    m_submissionTail(nullptr),
+                    m_submissionArray(nullptr),
+                    m_submissionMask(0),
+                    m_submissionEntries(0),
+                    m_pendingSubmissions(0),
+                    m_completionHead(nullptr),
+                    m_completionTail(nullptr),
+                    m_completionMask(0),
+                    m_completions(nullptr) {
+
+                struct io_uring_params parameters = {};
+
+                m_ringDescriptor = static_cast<int>(syscall(__NR_io_uring_setup, entries, &parameters));
+
+                if (m_ringDescriptor < 0) {
+                    return;
+                }
+
+                // fast poll (Linux 5.7) lets a socket request wait for the socket to be ready without blocking a
+                // kernel worker thread, every kernel that provides it also maps both rings together.
+
+                if (( !( parameters.features & IORING_FEAT_SINGLE_MMAP ) ) ||
+                    ( !( parameters.features & IORING_FEAT_FAST_POLL ) )) {
+
+                    close(m_ringDescriptor);
+
+                    m_ringDescriptor = -1;
+
+                    return;
+                }
+
+                auto submissionRingSize = parameters.sq_off.array + parameters.sq_entries * sizeof(uint32_t);
+                auto completionRingSize = parameters.cq_off.cqes + parameters.cq_entries * sizeof(io_uring_cqe);
+
+                m_ringSize = ( submissionRingSize > completionRingSize ) ? submissionRingSize : completionRingSize;
+                m_submissionsSize = parameters.sq_entries * sizeof(io_uring_sqe);
+
+                m_ring = mmap(
+                    nullptr,
+                    m_ringSize,
+                    PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_POPULATE,
+                    m_ringDescriptor,
+                    IORING_OFF_SQ_RING );
+
+                m_submissions = static_cast<io_uring_sqe *>(mmap(
+                    nullptr,
+                    m_submissionsSize,
+                    PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_POPULATE,
+                    m_ringDescriptor,
+                    IORING_OFF_SQES ));
+
+                if (( m_ring == MAP_FAILED ) || ( m_submissions == MAP_FAILED )) {
+                    release();
+
+                    return;
+                }
+
+                auto ring = static_cast<char *>(m_ring);
+
+                m_submissionHead = reinterpret_cast<uint32_t *>(ring + parameters.sq_off.head);
+                m_submissionTail = reinterpret_cast<uint32_t *>(ring + parameters.sq_off.tail);
+                m_submissionMask = *reinterpret_cast<uint32_t *>(ring + parameters.sq_off.ring_mask);
+                m_submissionEntries = parameters.sq_entries;
+                m_submissionArray = reinterpret_cast<uint32_t *>(ring + parameters.sq_off.array);
+
+                m_completionHead = reinterpret_cast<uint32_t *>(ring + parameters.cq_off.head);
+                m_completionTail = reinterpret_cast<uint32_t *>(ring + parameters.cq_off.tail);
+                m_completionMask = *reinterpret_cast<uint32_t *>(ring + parameters.cq_off.ring_mask);
+                m_completions = reinterpret_cast<io_uring_cqe *>(ring + parameters.cq_off.cqes);
+            }
+
+            /**
+             * @brief       Destroys the io_uring instance, outstanding requests are cancelled by the kernel.
+             */
+            ~IOUring() {
+                release();
+            }
+
+            IOUring(const IOUring &) = delete;
+            IOUring &operator=(const IOUring &) = delete;
+
+            /**
+             * @brief       Returns whether the instance was created.
+             *
+             * @returns     true if the instance can be used; otherwise false.
+             */
+            auto isValid() const -> bool {
+                return m_ringDescriptor >= 0;
+            }
+
+            /**
+             * @brief       Returns whether the kernel supports io_uring and every operation used by the engine.
+             *
+             * @details     io_uring may be missing from the kernel or disabled by the administrator
+             *              (kernel.io_uring_disabled).
+             *
+             * @returns     true if supported; otherwise false.
+             */
+            static auto isSupported() -> bool {
+                IOUring ring(1);
+
+                if (!ring.isValid()) {
+                    return false;
+                }
+
+                constexpr auto ProbeOperations = 64;
+
+                // the probe is followed in memory by one entry per operation.
+
+                alignas(io_uring_probe) uint8_t buffer[sizeof(io_uring_probe) + ProbeOperations * sizeof(io_uring_probe_op)] = {};
+
+                auto probe = reinterpret_cast<io_uring_probe *>(buffer);
+
+                if (syscall(
+                        __NR_io_uring_register,
+                        ring.m_ringDescriptor,
+                        IORING_REGISTER_PROBE,
+                        probe,
+                        ProbeOperations ) < 0) {
+
+                    return false;
+                }
+
+                for (auto operation : {IORING_OP_SENDMSG, IORING_OP_RECVMSG, IORING_OP_TIMEOUT, IORING_OP_READ}) {
+                    if (( operation > probe->last_op ) || ( !( probe->ops[operation].flags & IO_URING_OP_SUPPORTED ) )) {
+
+                        return false;
+                    }
+                }
+
+                return true;
+            }
+
+            /**
+             * @brief       Returns the next free submission entry, cleared and tagged with the user data.
+             *
+             * @param[in]   userData the value returned with the completion of the request.
+             *
+             * @returns     the entry; nullptr if the submission ring is full.
+             */
+            auto submission(uint64_t userData) -> io_uring_sqe * {
+                auto head = __atomic_load_n(m_submissionHead, __ATOMIC_ACQUIRE);
+                auto tail = *m_submissionTail + m_pendingSubmissions;
+
+                if (tail - head >= m_submissionEntries) {
+                    return nullptr;
+                }
+
+                auto index = tail & m_submissionMask;
+                auto entry = &m_submissions[index];
+
+                memset(entry, 0, sizeof(io_uring_sqe));
+
+                entry->user_data = userData;
+
+                m_submissionArray[index] = index;
+                m_pendingSubmissions++;
+
+                return entry;
+            }
+
+            /**
+             * @brief       Prepares a sendmsg request.
+             */
+            auto sendMessage(int descriptor, const msghdr *message, uint64_t userData) -> bool {
+                auto entry = submission(userData);
+
+                if (!entry) {
+                    return false;
+                }
+
+                entry->opcode = IORING_OP_SENDMSG;
+                entry->fd = descriptor;
+                entry->addr = reinterpret_cast<uint64_t>(message);
+                entry->len = 1;
+
+                return true;
+            }
+
+            /**
+             * @brief       Prepares a recvmsg request.
+             */
+            auto receiveMessage(int descriptor, msghdr *message, unsigned int flags, uint64_t userData) -> bool {
+                auto entry = submission(userData);
+
+                if (!entry) {
+                    return false;
+                }
+
+                entry->opcode = IORING_OP_RECVMSG;
+                entry->fd = descriptor;
+                entry->addr = reinterpret_cast<uint64_t>(message);
+                entry->len = 1;
+                entry->msg_flags = flags;
+
+                return true;
+            }
+
+            /**
+             * @brief       Prepares a read request.
+             */
+            auto read(int descriptor, void *buffer, unsigned int length, uint64_t userData) -> bool {
+                auto entry = submission(userData);
+
+                if (!entry) {
+                    return false;
+                }
+
+                entry->opcode = IORING_OP_READ;
+                entry->fd = descriptor;
+                entry->addr = reinterpret_cast<uint64_t>(buffer);
+                entry->len = length;
+                entry->off = static_cast<uint64_t>(-1);
+
+                return true;
+            }
+
+            /**
+             * @brief       Prepares a timeout that completes with -ETIME when the monotonic clock reaches the
+             *              deadline.
+             *
+             * @note        The timespec must remain valid until the timeout completes.
+             */
+            auto timeout(const __kernel_timespec *deadline, uint64_t userData) -> bool {
+                auto entry = submission(userData);
+
+                if (!entry) {
+                    return false;
+                }
+
+                entry->opcode = IORING_OP_TIMEOUT;
+                entry->fd = -1;
+                entry->addr = reinterpret_cast<uint64_t>(deadline);
+                entry->len = 1;
+                entry->timeout_flags = IORING_TIMEOUT_ABS;
+
+                return true;
+            }
+
+            /**
+             * @brief       Submits the prepared requests and optionally waits for completions.
+             *
+             * @param[in]   waitCount the number of completions to wait for.
+             *
+             * @returns     the number of requests submitted; -errno on error.
+             */
+            auto submit(unsigned int waitCount = 0) -> int {
+                // the entries must be visible to the kernel before the tail is moved.
+
+                __atomic_store_n(m_submissionTail, *m_submissionTail + m_pendingSubmissions, __ATOMIC_RELEASE);
+
+                auto submitCount = m_pendingSubmissions;
+
+                m_pendingSubmissions = 0;
+
+                while (true) {
+                    auto result = syscall(
+                        __NR_io_uring_enter,
+                        m_ringDescriptor,
+                        submitCount,
+                        waitCount,
+                        waitCount ? IORING_ENTER_GETEVENTS : 0,
+                        nullptr,
+                        0 );
+
+                    if (( result < 0 ) && ( errno == EINTR )) {
+                        // the requests have been consumed by the kernel if the wait was interrupted.
+
+                        submitCount = 0;
+
+                        continue;
+                    }
+
+                    return ( result < 0 ) ? -errno : static_cast<int>(result);
+                }
+            }
+
+            /**
+             * @brief       Calls a function for every available completion and removes them from the ring.
+             *
+             * @param[in]   function called with the user data and result of each completion.
+             *
+             * @returns     the number of completions processed.
+             */
+            template<typename F>
+            auto forEachCompletion(F function) -> unsigned int {
+                auto head = *m_completionHead;
+                auto tail = __atomic_load_n(m_completionTail, __ATOMIC_ACQUIRE);
+                auto count = tail - head;
+
+                while (head != tail) {
+                    auto &completion = m_completions[head & m_completionMask];
+
+                    function(completion.user_data, completion.res);
+
+                    head++;
+                }
+
+                __atomic_store_n(m_completionHead, head, __ATOMIC_RELEASE);
+
+                return count;
+            }
+
+            /**
+             * @brief       Converts a monotonic time to the timespec used by timeout().
+             *
+             * @param[in]   nanoseconds the time in nanoseconds on CLOCK_MONOTONIC.
+             *
+             * @returns     the timespec.
+             */
+            static auto toTimespec(int64_t nanoseconds) -> __kernel_timespec {
+                return __kernel_timespec{nanoseconds / 1000000000, nanoseconds % 1000000000};
+            }
+
+            /**
+             * @brief       Returns the current time of the clock used by timeout().
+             *
+             * @returns     the time in nanoseconds.
+             */
+            static auto monotonicNanoseconds() -> int64_t {
+                struct timespec now = {};
+
+                clock_gettime(CLOCK_MONOTONIC, &now);
+
+                return static_cast<int64_t>(now.tv_sec) * 1000000000 + now.tv_nsec;
+            }
+
+        private:
+            /**
+             * @brief       Unmaps the rings and closes the descriptor.
+             */
+            auto release() -> void {
+                if (m_submissions != MAP_FAILED) {
+                    munmap(m_submissions, m_submissionsSize);
+
+                    m_submissions = static_cast<io_uring_sqe *>(MAP_FAILED);
+                }
+
+                if (m_ring != MAP_FAILED) {
+                    munmap(m_ring, m_ringSize);
+
+                    m_ring = MAP_FAILED;
+                }
+
+                if (m_ringDescriptor >= 0) {
+                    close(m_ringDescriptor);
+
+                    m_ringDescriptor = -1;
+                }
+            }
+
+        private:
+            //! @cond
+
+            int m_ringDescriptor;
+
+            void *m_ring;
+            size_t m_ringSize;
+
+            io_uring_sqe *m_submissions;
+            size_t m_submissionsSize;
+
+            uint32_t *m_submissionHead;
+            uint32_t *m_submissionTail;
+            uint32_t *m_submissionArray;
+            uint32_t m_submissionMask;
+            uint32_t m_submissionEntries;
+            uint32_t m_pendingSubmissions;
+
+            uint32_t *m_completionHead;
+            uint32_t *m_completionTail;
+            uint32_t m_completionMask;
+            io_uring_cqe *m_completions;
+
+            //! @endcond
+    };
+}}
+
+#endif // PINGNOO_COMPONENTS_IOURINGPINGENGINE_IOURING_H
@@ -0,0 +1,197 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 18/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef PINGNOO_COMPONENTS_IOURINGPINGENGINE_IOURINGMESSAGE_H
+#define PINGNOO_COMPONENTS_IOURINGPINGENGINE_IOURINGMESSAGE_H
+
+#include "ICMPSocket/ICMPSocket.h"
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+namespace Nedrysoft { namespace IOUringPingEngine {
+    /**
+     * @brief       The IOUringMessage class holds the buffers of a sendmsg or recvmsg request.
+     *
+     * @details     The kernel reads from (or writes to) the message after the request has been submitted, so the
+     *              message must not be reused or destroyed until the request completes.  The message refers to its
+     *              own members and cannot be copied or moved.
+     */
+    class IOUringMessage {
+        public:
+            /**
+             * @brief       The size of the data buffer, large enough for any ICMP error that embeds a probe.
+             */
+            static constexpr int BufferSize = 2048;
+
+            /**
+             * @brief       The size of the ancillary data buffer.
+             *
+             * @details     Large enough for a timestamp, the ttl and an extended error with the offender address.
+             */
+            static constexpr int ControlSize = 512;
+
+        public:
+            /**
+             * @brief       Constructs an IOUringMessage.
+             */
+            IOUringMessage() :
+                    m_buffer(),
+                    m_address(),
+                    m_control(),
+                    m_vector(),
+                    m_message() {
+
+            }
+
+            IOUringMessage(const IOUringMessage &) = delete;
+            IOUringMessage &operator=(const IOUringMessage &) = delete;
+
+            /**
+             * @brief       Returns the data buffer.
+             *
+             * @returns     the buffer of BufferSize bytes.
+             */
+            auto buffer() -> char * {
+                return m_buffer.data();
+            }
+
+            /**
+             * @brief       Resets the message so that it can receive a packet.
+             *
+             * @returns     the message header to pass to the recvmsg request.
+             */
+            auto prepareReceive() -> msghdr * {
+                m_vector.iov_base = m_buffer.data();
+                m_vector.iov_len = m_buffer.size();
+
+                memset(&m_message, 0, sizeof(m_message));
+
+                m_message.msg_name = &m_address;
+                m_message.msg_namelen = sizeof(m_address);
+                m_message.msg_iov = &m_vector;
+                m_message.msg_iovlen = 1;
+                m_message.msg_control = m_control.data();
+                m_message.msg_controllen = sizeof(m_control);
+
+                return &m_message;
+            }
+
+            /**
+             * @brief       Prepares the message to send the packet in the data buffer.
+             *
+             * @param[in]   length the length of the packet.
+             * @param[in]   address the destination address.
+             * @param[in]   addressLength the length of the destination address.
+             * @param[in]   ttl the ttl (or hop limit) of the packet; 0 to use the default of the socket.
+             * @param[in]   version the IP version of the socket.
+             *
+             * @returns     the message header to pass to the sendmsg request.
+             */
+            auto prepareSend(
+                    int length,
+                    const sockaddr_storage &address,
+                    socklen_t addressLength,
+                    int ttl,
+                    Nedrysoft::ICMPSocket::IPVersion version) -> msghdr * {
+
+                m_address = address;
+
+                m_vector.iov_base = m_buffer.data();
+                m_vector.iov_len = static_cast<size_t>(length);
+
+                memset(&m_message, 0, sizeof(m_message));
+
+                m_message.msg_name = &m_address;
+                m_message.msg_namelen = addressLength;
+                m_message.msg_iov = &m_vector;
+                m_message.msg_iovlen = 1;
+
+                if (ttl) {
+                    m_message.msg_control = m_control.data();
+                    m_message.msg_controllen = CMSG_SPACE(sizeof(int));
+
+                    auto controlMessage = CMSG_FIRSTHDR(&m_message);
+
+                    if (version == Nedrysoft::ICMPSocket::V4) {
+                        controlMessage->cmsg_level = IPPROTO_IP;
+                        controlMessage->cmsg_type = IP_TTL;
+                    } else {
+                        controlMessage->cmsg_level = IPPROTO_IPV6;
+                        controlMessage->cmsg_type = IPV6_HOPLIMIT;
+                    }
+
+                    controlMessage->cmsg_len = CMSG_LEN(sizeof(int));
+
+                    memcpy(CMSG_DATA(controlMessage), &ttl, sizeof(int));
+                }
+
+                return &m_message;
+            }
+
+            /**
+             * @brief       Returns the packet received by a completed recvmsg request.
+             *
+             * @note        The buffer of the packet refers to the message, so it is only valid until the message is
+             *              prepared again.
+             *
+             * @param[in]   length the result of the request.
+             *
+             * @returns     the received packet.
+             */
+            auto receivedPacket(int length) -> Nedrysoft::ICMPSocket::ReceivedPacket {
+                Nedrysoft::ICMPSocket::ReceivedPacket packet = {
+                    QByteArray::fromRawData(m_buffer.data(), length),
+                    QHostAddress(),
+                    Nedrysoft::ICMPSocket::realtimeNanoseconds(),
+                    Nedrysoft::ICMPSocket::TimestampSource::User
+                };
+
+                if (m_message.msg_namelen) {
+                    packet.receiveAddress = QHostAddress(reinterpret_cast<sockaddr *>(&m_address));
+                }
+
+                Nedrysoft::ICMPSocket::ICMPSocket::readControlMessages(m_message, packet);
+
+                return packet;
+            }
+
+        private:
+            //! @cond
+
+            std::array<char, BufferSize> m_buffer;
+            sockaddr_storage m_address;
+            std::array<uint64_t, ControlSize / sizeof(uint64_t)> m_control;
+            iovec m_vector;
+            msghdr m_message;
+
+            //! @endcond
+    };
+}}
+
+#endif // PINGNOO_COMPONENTS_IOURINGPINGENGINE_IOURINGMESSAGE_H
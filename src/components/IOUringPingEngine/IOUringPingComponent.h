@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 18/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef PINGNOO_COMPONENTS_IOURINGPINGENGINE_IOURINGPINGCOMPONENT_H
+#define PINGNOO_COMPONENTS_IOURINGPINGENGINE_IOURINGPINGCOMPONENT_H
+
+#include <IComponent>
+#include "IOUringPingEngineSpec.h"
+
+namespace Nedrysoft { namespace IOUringPingEngine {
+    class IOUringPingEngineFactory;
+}}
+
+/**
+ * @brief       The IOUringPingComponent class provides a Linux ping engine that performs all socket operations
+ *              and timeouts through a single io_uring instance.
+ */
+class NEDRYSOFT_IOURINGPINGENGINE_DLLSPEC IOUringPingComponent :
+        public QObject,
+        public Nedrysoft::ComponentSystem::IComponent {
+
+    private:
+        Q_OBJECT
+
+        Q_PLUGIN_METADATA(IID NedrysoftComponentInterfaceIID FILE "metadata.json")
+
+        Q_INTERFACES(Nedrysoft::ComponentSystem::IComponent)
+
+    public:
+        /**
+         * @brief       Constructs the IOUringPingComponent.
+         */
+        IOUringPingComponent();
+
+        /**
+         * @brief       Destroys the IOUringPingComponent.
+         */
+        ~IOUringPingComponent();
+
+    public:
+        /**
+         * @brief       The initialiseEvent is called by the component loader to initialise the component.
+         *
+         * @details     Called by the component loader after all components have been loaded, called in load order.
+         *
+         * @see         Nedrysoft::ComponentSystem::IComponent::initialiseEvent
+         */
+        auto initialiseEvent() -> void override;
+
+        /**
+         * @brief       The finaliseEvent is called by the component loader to de-initialise the component.
+         *
+         * @details     Called by the component loader in reverse load order to shutdown the component.
+         *
+         * @see         Nedrysoft::ComponentSystem::IComponent::finaliseEvent
+         */
+        auto finaliseEvent() -> void override;
+
+    private:
+        //! @cond
+
+        Nedrysoft::IOUringPingEngine::IOUringPingEngineFactory *m_engineFactory;
+
+        //! @endcond
+};
+
+#endif // PINGNOO_COMPONENTS_IOURINGPINGENGINE_IOURINGPINGCOMPONENT_H
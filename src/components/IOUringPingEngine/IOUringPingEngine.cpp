@@ -0,0 +1,615 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 18/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "IOUringPingEngine.h"
+
+#include "ICMPPacket/ICMPPacket.h"
+#include "ICMPPacket/ICMPReplyView.h"
+#include "ICMPSocket/ICMPSocket.h"
+#include "IOUring.h"
+#include "IOUringMessage.h"
+#include "IOUringPingTarget.h"
+#include "IOUringPingWorker.h"
+
+#include <ICore>
+#include <PingResultBatcher>
+#include <QHash>
+#include <QThread>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <spdlog/spdlog.h>
+#include <vector>
+
+constexpr auto DefaultReceiveTimeout = 1000;
+constexpr auto DefaultTerminateThreadTimeout = 5000;
+constexpr auto DefaultTransmitInterval = 2500;
+constexpr auto DefaultPayloadLength = 52;
+constexpr auto SingleShotRingEntries = 8;
+constexpr auto MultiShotSequenceId = 5555;
+constexpr auto NanosecondsInSecond = 1e9;
+
+/**
+ * @brief       Private class to store the ping engines instance data.
+ */
+class Nedrysoft::IOUringPingEngine::IOUringPingEngineData {
+    public:
+        /**
+         * @brief       Constructs a IOUringPingEngineData.
+         *
+         * @param[in]   parent the IOUringPingEngine instance that this data belongs to.
+         */
+        IOUringPingEngineData(Nedrysoft::IOUringPingEngine::IOUringPingEngine *parent) :
+                m_pingEngine(parent),
+                m_worker(nullptr),
+                m_workerThread(nullptr),
+                m_resultBatcher(nullptr),
+                m_socket(nullptr),
+                m_id(0),
+                m_timeout(DefaultReceiveTimeout),
+                m_interval(DefaultTransmitInterval),
+                m_epoch(QDateTime::currentDateTime()) {
+
+        }
+
+        friend class IOUringPingEngine;
+
+    private:
+        Nedrysoft::IOUringPingEngine::IOUringPingEngine *m_pingEngine;
+
+        Nedrysoft::IOUringPingEngine::IOUringPingWorker *m_worker;
+
+        QThread *m_workerThread;
+
+        Nedrysoft::RouteAnalyser::PingResultBatcher *m_resultBatcher;
+
+        Nedrysoft::ICMPSocket::ICMPSocket *m_socket;
+
+        uint16_t m_id;
+
+        QList<Nedrysoft::IOUringPingEngine::IOUringPingTarget *> m_targetList;
+        QList<Nedrysoft::IOUringPingEngine::IOUringPingTarget *> m_removedTargets;
+
+        int m_timeout;
+
+        int m_interval;
+
+        QDateTime m_epoch;
+
+        Nedrysoft::Core::IPVersion m_version;
+
+        Nedrysoft::RouteAnalyser::PingEngineCounters m_counters;
+};
+
+Nedrysoft::IOUringPingEngine::IOUringPingEngine::IOUringPingEngine(Nedrysoft::Core::IPVersion version) :
+        d(std::make_shared<Nedrysoft::IOUringPingEngine::IOUringPingEngineData>(this)) {
+
+    d->m_version = version;
+
+    d->m_resultBatcher = new Nedrysoft::RouteAnalyser::PingResultBatcher(this);
+
+    connect(this, &Nedrysoft::RouteAnalyser::IPingEngine::result, d->m_resultBatcher,
+            &Nedrysoft::RouteAnalyser::PingResultBatcher::addResult, Qt::DirectConnection);
+
+    connect(d->m_resultBatcher, &Nedrysoft::RouteAnalyser::PingResultBatcher::resultsReady, this,
+            &Nedrysoft::RouteAnalyser::IPingEngine::resultsReady);
+}
+
+Nedrysoft::IOUringPingEngine::IOUringPingEngine::~IOUringPingEngine() {
+    doStop();
+
+    qDeleteAll(d->m_targetList);
+    qDeleteAll(d->m_removedTargets);
+
+    d.reset();
+}
+
+auto Nedrysoft::IOUringPingEngine::IOUringPingEngine::addTarget(
+        QHostAddress hostAddress) -> Nedrysoft::RouteAnalyser::IPingTarget * {
+
+    return addTarget(hostAddress, 0);
+}
+
+auto Nedrysoft::IOUringPingEngine::IOUringPingEngine::addTarget(
+        QHostAddress hostAddress,
+        int ttl) -> Nedrysoft::RouteAnalyser::IPingTarget * {
+
+    auto target = new Nedrysoft::IOUringPingEngine::IOUringPingTarget(this, hostAddress, ttl);
+
+    target->setId(d->m_id);
+    target->setResultIndex(d->m_resultBatcher->registerTarget(target));
+
+    d->m_targetList.append(target);
+
+    if (d->m_worker) {
+        d->m_worker->addTarget(target);
+    }
+
+    return target;
+}
+
+auto Nedrysoft::IOUringPingEngine::IOUringPingEngine::removeTarget(Nedrysoft::RouteAnalyser::IPingTarget *target) -> bool {
+    auto ioUringTarget = static_cast<Nedrysoft::IOUringPingEngine::IOUringPingTarget *>(target);
+
+    if (!d->m_targetList.removeAll(ioUringTarget)) {
+        return false;
+    }
+
+    // requests to the target may still be outstanding, so the target is kept until the engine is destroyed, the
+    // replies are delivered and ignored.
+
+    d->m_removedTargets.append(ioUringTarget);
+
+    if (d->m_worker) {
+        d->m_worker->removeTarget(ioUringTarget);
+    }
+
+    return true;
+}
+
+auto Nedrysoft::IOUringPingEngine::IOUringPingEngine::createSocket(
+        Nedrysoft::ICMPSocket::IPVersion version,
+        uint16_t &id) -> Nedrysoft::ICMPSocket::ICMPSocket * {
+
+    if (Nedrysoft::ICMPSocket::ICMPSocket::isDatagramSupported(version)) {
+        auto socket = Nedrysoft::ICMPSocket::ICMPSocket::createDatagramSocket(version);
+
+        if (socket) {
+            id = socket->id();
+
+            return socket;
+        }
+    }
+
+    // a raw socket receives every ICMP packet that arrives at the host, the filter passes the replies to this id.  A
+    // raw socket that shares the id (i.e another engine) also receives the replies, but they are not matched to its
+    // requests unless the sequence is also outstanding.
+
+    auto socket = Nedrysoft::ICMPSocket::ICMPSocket::createReadSocket(version);
+
+    if (!socket) {
+        return nullptr;
+    }
+
+    id = static_cast<uint16_t>(Nedrysoft::Core::ICore::getInstance()->random(1, UINT16_MAX-1));
+
+    if (!socket->setFilter(QVector<uint16_t>() << id)) {
+        SPDLOG_ERROR("Unable to attach the reply filter to the socket.");
+    }
+
+    return socket;
+}
+
+auto Nedrysoft::IOUringPingEngine::IOUringPingEngine::start() -> bool {
+    if (d->m_worker) {
+        return true;
+    }
+
+    d->m_socket = createSocket(static_cast<Nedrysoft::ICMPSocket::IPVersion>(d->m_version), d->m_id);
+
+    if (!d->m_socket) {
+        SPDLOG_ERROR("Unable to create a socket for the engine.");
+
+        return false;
+    }
+
+    d->m_worker = new Nedrysoft::IOUringPingEngine::IOUringPingWorker(this, d->m_socket, d->m_id);
+
+    d->m_worker->setInterval(d->m_interval);
+    d->m_worker->setTimeout(d->m_timeout);
+
+    for (auto target : d->m_targetList) {
+        target->setId(d->m_id);
+
+        d->m_worker->addTarget(target);
+    }
+
+    d->m_workerThread = new QThread();
+
+    d->m_worker->moveToThread(d->m_workerThread);
+
+    connect(d->m_workerThread, &QThread::started, d->m_worker,
+            &Nedrysoft::IOUringPingEngine::IOUringPingWorker::doWork);
+
+    // the record is added to the batch on the worker thread, it is only converted to a result when the batch is
+    // delivered.
+
+    connect(d->m_worker, &Nedrysoft::IOUringPingEngine::IOUringPingWorker::result, d->m_resultBatcher,
+            &Nedrysoft::RouteAnalyser::PingResultBatcher::addRecord, Qt::DirectConnection);
+
+    d->m_workerThread->start();
+
+    return true;
+}
+
+auto Nedrysoft::IOUringPingEngine::IOUringPingEngine::doStop() -> bool {
+    if (d->m_worker) {
+        d->m_worker->stop();
+    }
+
+    if (d->m_workerThread) {
+        d->m_workerThread->quit();
+
+        d->m_workerThread->wait(DefaultTerminateThreadTimeout);
+
+        if (d->m_workerThread->isRunning()) {
+            d->m_workerThread->terminate();
+        }
+
+        delete d->m_workerThread;
+
+        d->m_workerThread = nullptr;
+    }
+
+    delete d->m_worker;
+
+    d->m_worker = nullptr;
+
+    // the socket is shared with the worker, so it is deleted once the worker has been destroyed.
+
+    delete d->m_socket;
+
+    d->m_socket = nullptr;
+
+    return true;
+}
+
+auto Nedrysoft::IOUringPingEngine::IOUringPingEngine::stop() -> bool {
+    return doStop();
+}
+
+auto Nedrysoft::IOUringPingEngine::IOUringPingEngine::setInterval(int interval) -> bool {
+    d->m_interval = interval;
+
+    if (d->m_worker) {
+        d->m_worker->setInterval(interval);
+    }
+
+    return true;
+}
+
+auto Nedrysoft::IOUringPingEngine::IOUringPingEngine::interval() -> int {
+    return d->m_interval;
+}
+
+auto Nedrysoft::IOUringPingEngine::IOUringPingEngine::setTimeout(int timeout) -> bool {
+    d->m_timeout = timeout;
+
+    if (d->m_worker) {
+        d->m_worker->setTimeout(timeout);
+    }
+
+    return true;
+}
+
+auto Nedrysoft::IOUringPingEngine::IOUringPingEngine::setResultBatching(int interval, int batchSize) -> bool {
+    d->m_resultBatcher->setInterval(interval);
+    d->m_resultBatcher->setBatchSize(batchSize);
+
+    return true;
+}
+
+auto Nedrysoft::IOUringPingEngine::IOUringPingEngine::saveConfiguration() -> QJsonObject {
+    return QJsonObject();
+}
+
+auto Nedrysoft::IOUringPingEngine::IOUringPingEngine::loadConfiguration(QJsonObject configuration) -> bool {
+    Q_UNUSED(configuration)
+
+    return false;
+}
+
+auto Nedrysoft::IOUringPingEngine::IOUringPingEngine::setEpoch(QDateTime epoch) -> void {
+    d->m_epoch = epoch;
+}
+
+auto Nedrysoft::IOUringPingEngine::IOUringPingEngine::counters() -> Nedrysoft::RouteAnalyser::PingEngineCounters & {
+    return d->m_counters;
+}
+
+auto Nedrysoft::IOUringPingEngine::IOUringPingEngine::metrics() -> Nedrysoft::RouteAnalyser::PingEngineMetrics {
+    return d->m_counters.snapshot();
+}
+
+auto Nedrysoft::IOUringPingEngine::IOUringPingEngine::epoch() -> QDateTime {
+    return d->m_epoch;
+}
+
+auto Nedrysoft::IOUringPingEngine::IOUringPingEngine::targets() -> QList<Nedrysoft::RouteAnalyser::IPingTarget *> {
+    QList<Nedrysoft::RouteAnalyser::IPingTarget *> list;
+
+    for (auto target : d->m_targetList) {
+        list.append(target);
+    }
+
+    return list;
+}
+
+auto Nedrysoft::IOUringPingEngine::IOUringPingEngine::singleShot(
+        QHostAddress hostAddress,
+        int ttl,
+        double timeout ) -> Nedrysoft::RouteAnalyser::PingResult {
+
+    return multiShot(hostAddress, QVector<int>() << ttl, timeout).at(0);
+}
+
+auto Nedrysoft::IOUringPingEngine::IOUringPingEngine::multiShot(
+        QHostAddress hostAddress,
+        QVector<int> ttls,
+        double timeout,
+        std::function<void(int, const Nedrysoft::RouteAnalyser::PingResult &)> resultFunction ) ->
+            QVector<Nedrysoft::RouteAnalyser::PingResult> {
+
+    using Operation = Nedrysoft::IOUringPingEngine::IOUringPingWorker::Operation;
+    using Nedrysoft::IOUringPingEngine::IOUringPingWorker;
+
+    QVector<Nedrysoft::RouteAnalyser::PingResult> pingResults(ttls.count());
+
+    // the requests that are still waiting for a reply, keyed on their sequence id.
+
+    QHash<uint16_t, int> sequenceIndexes;
+
+    auto reportPending = [&]() {
+        if (resultFunction) {
+            for (auto index : sequenceIndexes) {
+                resultFunction(index, pingResults.at(index));
+            }
+        }
+
+        sequenceIndexes.clear();
+    };
+
+    for (auto index = 0; index < ttls.count(); index++) {
+        sequenceIndexes.insert(static_cast<uint16_t>(MultiShotSequenceId + index), index);
+    }
+
+    auto socketVersion = Nedrysoft::ICMPSocket::V4;
+
+    if (hostAddress.protocol() == QAbstractSocket::IPv6Protocol) {
+        socketVersion = Nedrysoft::ICMPSocket::V6;
+    }
+
+    uint16_t id = 0;
+
+    auto socket = std::unique_ptr<Nedrysoft::ICMPSocket::ICMPSocket>(createSocket(socketVersion, id));
+
+    if (!socket) {
+        reportPending();
+
+        return pingResults;
+    }
+
+    // the messages are declared before the ring so that they outlive any request that is still outstanding when the
+    // ring is destroyed.
+
+    std::vector<Nedrysoft::IOUringPingEngine::IOUringMessage> transmitMessages(static_cast<size_t>(ttls.count()));
+    Nedrysoft::IOUringPingEngine::IOUringMessage receiveMessage;
+    Nedrysoft::IOUringPingEngine::IOUringMessage errorMessage;
+    __kernel_timespec timerDeadline = {};
+
+    // every request is queued before the ring is submitted, so there must be an entry for each ping as well as the
+    // receive requests and the timer.
+
+    Nedrysoft::IOUringPingEngine::IOUring ring(static_cast<unsigned int>(ttls.count()) + SingleShotRingEntries);
+
+    sockaddr_storage address = {};
+
+    auto addressLength = socket->toSocketAddress(hostAddress, address);
+
+    if (( !ring.isValid() ) || ( !addressLength )) {
+        reportPending();
+
+        return pingResults;
+    }
+
+    auto ipVersion = static_cast<Nedrysoft::ICMPPacket::IPVersion>(socketVersion);
+    auto descriptor = socket->descriptor();
+    auto isDatagram = socket->isDatagram();
+
+    // each request is sent with its own sequence id, which is used to find the request that a reply belongs to.  A
+    // ttl may be requested more than once, as the sequence id is part of the checksum each of the requests is
+    // hashed to its own flow by routers that balance load on the ICMP header.
+
+    for (auto index = 0; index < ttls.count(); index++) {
+        auto buffer = Nedrysoft::ICMPPacket::ICMPPacket::pingPacket(
+            id,
+            static_cast<uint16_t>(MultiShotSequenceId + index),
+            DefaultPayloadLength,
+            hostAddress,
+            ipVersion
+        );
+
+        if (buffer.length() > Nedrysoft::IOUringPingEngine::IOUringMessage::BufferSize) {
+            reportPending();
+
+            return pingResults;
+        }
+
+        auto &transmitMessage = transmitMessages[static_cast<size_t>(index)];
+
+        memcpy(transmitMessage.buffer(), buffer.constData(), static_cast<size_t>(buffer.length()));
+
+        ring.sendMessage(
+            descriptor,
+            transmitMessage.prepareSend(buffer.length(), address, addressLength, ttls.at(index), socketVersion),
+            IOUringPingWorker::userData(Operation::Transmit, static_cast<uint32_t>(index)) );
+    }
+
+    // the round trip time of each reply is measured from the time the requests were submitted to the receive
+    // timestamp of the reply, so replies that are read together still have their own round trip time.
+
+    auto transmitEpoch = QDateTime::currentDateTime();
+    auto transmitTime = Nedrysoft::ICMPSocket::realtimeNanoseconds();
+    auto transmitTick = Nedrysoft::IOUringPingEngine::IOUring::monotonicNanoseconds();
+
+    timerDeadline = Nedrysoft::IOUringPingEngine::IOUring::toTimespec(
+        transmitTick + static_cast<int64_t>(timeout * NanosecondsInSecond) );
+
+    ring.receiveMessage(
+        descriptor,
+        receiveMessage.prepareReceive(),
+        0,
+        IOUringPingWorker::userData(Operation::Receive) );
+
+    if (isDatagram) {
+        ring.receiveMessage(
+            descriptor,
+            errorMessage.prepareReceive(),
+            MSG_ERRQUEUE,
+            IOUringPingWorker::userData(Operation::ReceiveError) );
+    }
+
+    ring.timeout(&timerDeadline, IOUringPingWorker::userData(Operation::Timer));
+
+    auto format = isDatagram ? Nedrysoft::ICMPPacket::PacketFormat::Datagram :
+                               Nedrysoft::ICMPPacket::PacketFormat::Raw;
+
+    auto isComplete = false;
+
+    while (!isComplete) {
+        if (ring.submit(1) < 0) {
+            break;
+        }
+
+        ring.forEachCompletion([&](uint64_t completionData, int completionResult) {
+            auto requestOperation = IOUringPingWorker::operation(completionData);
+
+            if (isComplete) {
+                return;
+            }
+
+            if (requestOperation == Operation::Timer) {
+                isComplete = true;
+
+                return;
+            }
+
+            // a request that could not be sent is reported straight away rather than waiting for the timeout.
+
+            if (requestOperation == Operation::Transmit) {
+                if (completionResult < 0) {
+                    auto index = static_cast<int>(IOUringPingWorker::index(completionData));
+
+                    sequenceIndexes.remove(static_cast<uint16_t>(MultiShotSequenceId + index));
+
+                    if (resultFunction) {
+                        resultFunction(index, pingResults.at(index));
+                    }
+
+                    isComplete = sequenceIndexes.isEmpty();
+                }
+
+                return;
+            }
+
+            if (( requestOperation != Operation::Receive ) && ( requestOperation != Operation::ReceiveError )) {
+                return;
+            }
+
+            auto isError = ( requestOperation == Operation::ReceiveError );
+            auto &message = isError ? errorMessage : receiveMessage;
+
+            if (completionResult >= 0) {
+                auto receivedPacket = message.receivedPacket(completionResult);
+
+                auto packetData = gsl::span<const uint8_t>(
+                    reinterpret_cast<const uint8_t *>(receivedPacket.buffer.constData()),
+                    receivedPacket.buffer.length() );
+
+                // errors reported on the error queue of a datagram socket carry the echo request that was sent.
+
+                auto responsePacket = isError ?
+                    Nedrysoft::ICMPPacket::ICMPReplyView::fromError(
+                        packetData,
+                        ipVersion,
+                        receivedPacket.errorType,
+                        receivedPacket.errorCode ) :
+                    Nedrysoft::ICMPPacket::ICMPReplyView(packetData, ipVersion, format);
+
+                if (( responsePacket.isValid() ) &&
+                    ( responsePacket.id() == id ) &&
+                    ( sequenceIndexes.contains(responsePacket.sequence()) )) {
+
+                    auto index = sequenceIndexes.take(responsePacket.sequence());
+                    auto ttl = ttls.at(index);
+
+                    auto resultCode = Nedrysoft::RouteAnalyser::PingResult::ResultCode::Ok;
+
+                    if (responsePacket.resultCode() == Nedrysoft::ICMPPacket::TimeExceeded) {
+                        resultCode = Nedrysoft::RouteAnalyser::PingResult::ResultCode::TimeExceeded;
+                    }
+
+                    // a datagram socket does not return the IP header, the ttl is reported as ancillary data instead.
+
+                    auto replyTtl = responsePacket.ttl();
+
+                    if (replyTtl == -1) {
+                        replyTtl = receivedPacket.ttl;
+                    }
+
+                    int hopsToTarget = -1;
+
+                    if (replyTtl != -1) {
+                        hopsToTarget = ttl-replyTtl;
+                    }
+
+                    auto roundTripTime = std::max<int64_t>(receivedPacket.timestamp - transmitTime, 0);
+
+                    pingResults[index] = Nedrysoft::RouteAnalyser::PingResult(
+                        0,
+                        resultCode,
+                        receivedPacket.receiveAddress,
+                        transmitEpoch,
+                        static_cast<double>(roundTripTime) / NanosecondsInSecond,
+                        nullptr,
+                        hopsToTarget
+                    );
+
+                    if (resultFunction) {
+                        resultFunction(index, pingResults.at(index));
+                    }
+
+                    if (sequenceIndexes.isEmpty()) {
+                        isComplete = true;
+
+                        return;
+                    }
+                }
+            }
+
+            ring.receiveMessage(descriptor, message.prepareReceive(), isError ? MSG_ERRQUEUE : 0, completionData);
+        });
+    }
+
+    // the requests that were not answered are reported once the timeout has expired.
+
+    reportPending();
+
+    return pingResults;
+}
+
+auto Nedrysoft::IOUringPingEngine::IOUringPingEngine::hasParallelMultiShot() -> bool {
+    return true;
+}
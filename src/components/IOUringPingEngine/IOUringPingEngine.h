@@ -0,0 +1,315 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 18/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef PINGNOO_COMPONENTS_IOURINGPINGENGINE_IOURINGPINGENGINE_H
+#define PINGNOO_COMPONENTS_IOURINGPINGENGINE_IOURINGPINGENGINE_H
+
+#include "ICMPSocket/ICMPSocket.h"
+
+#include <IInterface>
+#include <IPingEngine>
+#include <IPingEngineFactory>
+#include <QDateTime>
+#include <memory>
+
+namespace Nedrysoft { namespace IOUringPingEngine {
+    class IOUringPingEngineData;
+
+    /**
+     * @brief       The IOUringPingEngine provides an ICMP ping engine that performs every socket operation and
+     *              timeout through a single io_uring instance.
+     *
+     * @details     Where the ICMP socket engine uses a transmitter, receiver and timeout thread that pass requests
+     *              between them, this engine sends, receives and times out its requests on one thread which only
+     *              wakes when there is work to do.  Probes are sent on an unprivileged datagram socket when the
+     *              process is allowed to create one, otherwise on a raw socket.
+     */
+    class IOUringPingEngine :
+            public Nedrysoft::RouteAnalyser::IPingEngine {
+
+        private:
+            Q_OBJECT
+
+            Q_INTERFACES(Nedrysoft::RouteAnalyser::IPingEngine)
+
+        public:
+            /**
+             * @brief       Constructs an IOUringPingEngine for the given IP version.
+             */
+            explicit IOUringPingEngine(Nedrysoft::Core::IPVersion version);
+
+            /**
+             * @brief       Destroys the IOUringPingEngine.
+             */
+            ~IOUringPingEngine();
+
+            /**
+             * @brief       Sets the measurement interval for this engine instance.
+             *
+             * @see         Nedrysoft::RouteAnalyser::IPingEngine::setInterval
+             *
+             * @param[in]   interval interval time in milliseconds.
+             *
+             * @returns     returns true on success; otherwise false.
+             */
+            auto setInterval(int interval) -> bool override;
+
+            /**
+             * @brief       Returns the interval set on the engine.
+             *
+             * @see         Nedrysoft::RouteAnalyser::IPingEngine::interval
+             *
+             * @returns     the interval time in milliseconds.
+             */
+            auto interval() -> int override;
+
+            /**
+             * @brief       Sets the reply timeout for this engine instance.
+             *
+             * @see         Nedrysoft::RouteAnalyser::IPingEngine::setTimeout
+             *
+             * @param[in]   timeout the number of milliseconds before we consider that the packet was lost.
+             *
+             * @returns     true on success; otherwise false.
+             */
+            auto setTimeout(int timeout) -> bool override;
+
+            /**
+             * @brief       Sets when a batch of results is delivered.
+             *
+             * @see         Nedrysoft::RouteAnalyser::IPingEngine::setResultBatching
+             *
+             * @param[in]   interval the longest time in milliseconds that a result waits for its batch.
+             * @param[in]   batchSize the number of results after which a batch is delivered without waiting.
+             *
+             * @returns     true on success; otherwise false.
+             */
+            auto setResultBatching(int interval, int batchSize) -> bool override;
+
+            /**
+             * @brief       Returns a snapshot of the engine counters.
+             *
+             * @see         Nedrysoft::RouteAnalyser::IPingEngine::metrics
+             *
+             * @returns     the metrics of the engine.
+             */
+            auto metrics() -> Nedrysoft::RouteAnalyser::PingEngineMetrics override;
+
+            /**
+             * @brief       Starts ping operations for this engine instance.
+             *
+             * @see         Nedrysoft::Core::IPingEngine::start
+             *
+             * @returns     true on success; otherwise false.
+             */
+            auto start() -> bool override;
+
+            /**
+             * @brief       Stops ping operations for this engine instance.
+             *
+             * @see         Nedrysoft::RouteAnalyser::IPingEngine::stop
+             *
+             * @returns     true on success; otherwise false.
+             */
+            auto stop() -> bool override;
+
+            /**
+             * @brief       Adds a ping target to this engine instance.
+             *
+             * @see         Nedrysoft::RouteAnalyser::IPingEngine::addTarget
+             *
+             * @param[in]   hostAddress the host address of the ping target.
+             *
+             * @returns     returns a pointer to the created ping target.
+             */
+            auto addTarget(QHostAddress hostAddress) -> Nedrysoft::RouteAnalyser::IPingTarget * override;
+
+            /**
+             * @brief       Adds a ping target to this engine instance.
+             *
+             * @see         Nedrysoft::RouteAnalyser::IPingEngine::addTarget
+             *
+             * @param[in]   hostAddress the host address of the ping target.
+             * @param[in]   ttl the time to live to use.
+             *
+             * @returns     returns a pointer to the created ping target.
+             */
+            auto addTarget(QHostAddress hostAddress, int ttl) -> Nedrysoft::RouteAnalyser::IPingTarget * override;
+
+            /**
+             * @brief       Transmits a single ping.
+             *
+             * @details     The request, the replies and the timeout are handled by a private io_uring instance, so
+             *              the calling thread sleeps until the reply arrives or the timeout expires.
+             *
+             * @note        This is a blocking function.
+             *
+             * @param[in]   hostAddress the target host address.
+             * @param[in]   ttl time to live for this packet.
+             * @param[in]   timeout time in seconds to wait for response.
+             *
+             * @returns     the result of the ping.
+             */
+            auto singleShot(
+                QHostAddress hostAddress,
+                int ttl,
+                double timeout
+            ) -> Nedrysoft::RouteAnalyser::PingResult override;
+
+            /**
+             * @brief       Transmits a single ping for each of a list of TTL's.
+             *
+             * @details     The pings are queued together on a private io_uring instance and sent from one socket,
+             *              the replies are collected until every TTL has been answered or the timeout expires.
+             *
+             * @see         Nedrysoft::RouteAnalyser::IPingEngine::multiShot
+             *
+             * @param[in]   hostAddress the target host address.
+             * @param[in]   ttls the time to live of each ping.
+             * @param[in]   timeout time in seconds to wait for the responses.
+             * @param[in]   resultFunction if set, called with the index of the TTL and its result as each reply
+             *              is received.
+             *
+             * @returns     the result for each TTL, in the order of ttls.
+             */
+            auto multiShot(
+                QHostAddress hostAddress,
+                QVector<int> ttls,
+                double timeout,
+                std::function<void(int, const Nedrysoft::RouteAnalyser::PingResult &)> resultFunction = nullptr
+            ) -> QVector<Nedrysoft::RouteAnalyser::PingResult> override;
+
+            /**
+             * @brief       Returns whether multiShot() sends the pings together.
+             *
+             * @see         Nedrysoft::RouteAnalyser::IPingEngine::hasParallelMultiShot
+             *
+             * @returns     true.
+             */
+            auto hasParallelMultiShot() -> bool override;
+
+            /**
+             * @brief       Removes a ping target from this engine instance.
+             *
+             * @see         Nedrysoft::RouteAnalyser::IPingEngine::addTarget
+             *
+             * @param[in]   target the ping target to remove.
+             *
+             * @returns     true on success; otherwise false.
+             */
+            auto removeTarget(Nedrysoft::RouteAnalyser::IPingTarget *target) -> bool override;
+
+            /**
+             * @brief       Gets the epoch for this engine instance.
+             *
+             * @see         Nedrysoft::RouteAnalyser::IPingEngine::epoch
+             *
+             * @returns     the time epoch.
+             */
+            auto epoch() -> QDateTime override;
+
+            /**
+             * @brief       Returns the list of ping targets for the engine.
+             *
+             * @returns     a QList containing the list of targets.
+             */
+            auto targets() -> QList<Nedrysoft::RouteAnalyser::IPingTarget *> override;
+
+        public:
+            /**
+             * @brief       Saves the configuration to a JSON object.
+             *
+             * @see         Nedrysoft::Core::IConfiguration::saveConfiguration
+             *
+             * @returns     the JSON configuration.
+             */
+            auto saveConfiguration() -> QJsonObject override;
+
+            /**
+             * @brief       Loads the configuration.
+             *
+             * @see         Nedrysoft::Core::IConfiguration::loadConfiguration
+             *
+             * @param[in]   configuration the configuration as JSON object.
+             *
+             * @returns     true if loaded; otherwise false.
+             */
+            auto loadConfiguration(QJsonObject configuration) -> bool override;
+
+        protected:
+            /**
+             * @brief       Creates the socket that the engine sends and receives on.
+             *
+             * @details     A datagram socket is used if the process is allowed to create one, the kernel assigns the
+             *              ICMP id of the socket and only delivers the replies to that id.  Otherwise a raw socket is
+             *              used with a random id, a kernel filter is attached so that only the replies to that id are
+             *              read from the socket.
+             *
+             * @param[in]   version the IP version of the socket.
+             * @param[out]  id the ICMP id that requests must be sent with.
+             *
+             * @returns     the socket; nullptr if a socket could not be created.
+             */
+            static auto createSocket(
+                Nedrysoft::ICMPSocket::IPVersion version,
+                uint16_t &id
+            ) -> Nedrysoft::ICMPSocket::ICMPSocket *;
+
+            /**
+             * @brief       Sets the transmission epoch.
+             *
+             * @param[in]   epoch is the epoch.
+             */
+            auto setEpoch(QDateTime epoch) -> void;
+
+            /**
+             * @brief       Returns the counters that the worker updates.
+             *
+             * @returns     the counters.
+             */
+            auto counters() -> Nedrysoft::RouteAnalyser::PingEngineCounters &;
+
+            /**
+             * @brief       Stops all ping transmissions for this instance.
+             *
+             * @note        This controls the actual logic for stopping transmissions, it is called by the
+             *              destructor and the stop() virtual function.  Virtual function should not be called
+             *              by a destructor, so this acts as a shim.
+             *
+             * @returns     true if transmissions could be stopped; otherwise false.
+             */
+            auto doStop() -> bool;
+
+            friend class IOUringPingWorker;
+
+        protected:
+            //! @cond
+
+            std::shared_ptr<IOUringPingEngineData> d;
+
+            //! @endcond
+    };
+}}
+
+#endif // PINGNOO_COMPONENTS_IOURINGPINGENGINE_IOURINGPINGENGINE_H
@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 18/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "IOUringPingEngineFactory.h"
+
+#include "ICMPSocket/ICMPSocket.h"
+#include "IOUring.h"
+#include "IOUringPingEngine.h"
+
+/**
+ * @brief       Private class to store the ping engines instance data.
+ */
+class Nedrysoft::IOUringPingEngine::IOUringPingEngineFactoryData {
+    public:
+        /**
+         * @brief       Constructs a IOUringPingEngineFactoryData.
+         *
+         * @param[in]   parent the IOUringPingEngineFactory instance that this data belongs to.
+         */
+        IOUringPingEngineFactoryData(Nedrysoft::IOUringPingEngine::IOUringPingEngineFactory *parent) :
+                m_factory(parent) {
+
+        }
+
+        friend class IOUringPingEngineFactory;
+
+    private:
+        Nedrysoft::IOUringPingEngine::IOUringPingEngineFactory *m_factory;
+
+        QList<Nedrysoft::IOUringPingEngine::IOUringPingEngine *> m_engineList;
+};
+
+Nedrysoft::IOUringPingEngine::IOUringPingEngineFactory::IOUringPingEngineFactory() :
+        d(std::make_shared<Nedrysoft::IOUringPingEngine::IOUringPingEngineFactoryData>(this)) {
+
+}
+
+Nedrysoft::IOUringPingEngine::IOUringPingEngineFactory::~IOUringPingEngineFactory() {
+    qDeleteAll(d->m_engineList);
+
+    d.reset();
+}
+
+auto Nedrysoft::IOUringPingEngine::IOUringPingEngineFactory::createEngine(
+        Nedrysoft::Core::IPVersion version ) -> Nedrysoft::RouteAnalyser::IPingEngine * {
+
+    auto engineInstance = new Nedrysoft::IOUringPingEngine::IOUringPingEngine(version);
+
+    d->m_engineList.append(engineInstance);
+
+    return engineInstance;
+}
+
+auto Nedrysoft::IOUringPingEngine::IOUringPingEngineFactory::saveConfiguration() -> QJsonObject {
+    return QJsonObject();
+}
+
+auto Nedrysoft::IOUringPingEngine::IOUringPingEngineFactory::loadConfiguration(QJsonObject configuration) -> bool {
+    Q_UNUSED(configuration)
+
+    return false;
+}
+
+auto Nedrysoft::IOUringPingEngine::IOUringPingEngineFactory::description() -> QString {
+    return tr("ICMP Socket (io_uring)");
+}
+
+auto Nedrysoft::IOUringPingEngine::IOUringPingEngineFactory::priority() -> double {
+    if (available()) {
+        return 1;
+    }
+
+    return 0;
+}
+
+auto Nedrysoft::IOUringPingEngine::IOUringPingEngineFactory::available() -> bool {
+    // the check creates an io_uring instance and possibly a raw socket, the result cannot change while the
+    // application is running so it is only checked once.
+
+    auto checkAvailable = []() {
+        if (!Nedrysoft::IOUringPingEngine::IOUring::isSupported()) {
+            return false;
+        }
+
+        if (Nedrysoft::ICMPSocket::ICMPSocket::isDatagramSupported(Nedrysoft::ICMPSocket::V4)) {
+            return true;
+        }
+
+        auto socket = Nedrysoft::ICMPSocket::ICMPSocket::createReadSocket(Nedrysoft::ICMPSocket::V4);
+
+        delete socket;
+
+        return socket != nullptr;
+    };
+
+    static const auto isAvailable = checkAvailable();
+
+    return isAvailable;
+}
+
+auto Nedrysoft::IOUringPingEngine::IOUringPingEngineFactory::deleteEngine(
+        Nedrysoft::RouteAnalyser::IPingEngine *engine) -> bool {
+
+    auto pingEngine = qobject_cast<Nedrysoft::IOUringPingEngine::IOUringPingEngine *>(engine);
+
+    if (d->m_engineList.contains(pingEngine)) {
+        engine->stop();
+        d->m_engineList.removeAll(pingEngine);
+        pingEngine->deleteLater();
+    }
+
+    return true;
+}
@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 18/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef PINGNOO_COMPONENTS_IOURINGPINGENGINE_IOURINGPINGENGINEFACTORY_H
+#define PINGNOO_COMPONENTS_IOURINGPINGENGINE_IOURINGPINGENGINEFACTORY_H
+
+#include <IInterface>
+#include <IPingEngineFactory>
+#include <memory>
+
+namespace Nedrysoft { namespace IOUringPingEngine {
+    class IOUringPingEngineFactoryData;
+    class IOUringPingEngine;
+
+    /**
+     * @brief       Factory class for IOUringPingEngine
+     *
+     * @details     The factory class for creating instances of the IOUringPingEngine type
+     */
+    class IOUringPingEngineFactory :
+            public Nedrysoft::RouteAnalyser::IPingEngineFactory {
+
+        private:
+            Q_OBJECT
+
+            Q_INTERFACES(Nedrysoft::RouteAnalyser::IPingEngineFactory)
+
+        public:
+            /**
+             * @brief       Constructs an IOUringPingEngineFactory.
+             */
+            IOUringPingEngineFactory();
+
+            /**
+             * @brief       Destroys the IOUringPingEngineFactory.
+             */
+            ~IOUringPingEngineFactory();
+
+        public:
+            /**
+             * @brief       Creates a IOUringPingEngine instance.
+             *
+             * @see         Nedrysoft::RouteAnalyser::IPingEngineFactory::createEngine
+             *
+             * @param[in]   version the IP version of the engine.
+             *
+             * @returns     the new IOUringPingEngine instance.
+             */
+            auto createEngine(Nedrysoft::Core::IPVersion version) -> Nedrysoft::RouteAnalyser::IPingEngine * override;
+
+            /**
+             * @brief       Returns the descriptive name of the factory.
+             *
+             * @returns     the descriptive name of the ping engine.
+             */
+            auto description() -> QString override;
+
+            /**
+             * @brief       Priority of the ping engine.  The priority is 0=lowest, 1=highest.  This allows
+             *              the application to provide a default engine per platform.
+             *
+             * @note        The engine has the highest priority when it is available, so it is preferred over the
+             *              ICMP socket engine on kernels that support io_uring.
+             *
+             * @returns     the priority.
+             */
+            auto priority() -> double override;
+
+            /**
+             * @brief      Returns whether the ping engine is available for use.
+             *
+             * @note       The engine is available if the kernel supports io_uring (and it has not been disabled by
+             *             the administrator) and either a datagram or raw ICMP socket can be created.
+             *
+             * @returns    true if available; otherwise false.
+             */
+            auto available() -> bool override;
+
+            /**
+             * @brief      Deletes a ping engine that was created by this instance.
+             *
+             * @note       If the ping engine is still running, this function will stop it.
+             *
+             * @param[in]  engine the ping engine to be removed.
+             *
+             * @returns    true if the engine was deleted; otherwise false.
+             */
+            auto deleteEngine(Nedrysoft::RouteAnalyser::IPingEngine *engine) -> bool override;
+
+        public:
+            /**
+             * @brief       Saves the configuration to a JSON object.
+             *
+             * @returns     the JSON configuration.
+             */
+            auto saveConfiguration() -> QJsonObject override;
+
+            /**
+             * @brief       Loads the configuration.
+             *
+             * @see         Nedrysoft::Core::IConfiguration::loadConfiguration
+             *
+             * @param[in]   configuration the configuration as JSON object.
+             *
+             * @returns     true if loaded; otherwise false.
+             */
+            auto loadConfiguration(QJsonObject configuration) -> bool override;
+
+        protected:
+            //! @cond
+
+            std::shared_ptr<IOUringPingEngineFactoryData> d;
+
+            //! @endcond
+    };
+}}
+
+#endif // PINGNOO_COMPONENTS_IOURINGPINGENGINE_IOURINGPINGENGINEFACTORY_H
@@ -0,0 +1,164 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 18/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "IOUringPingTarget.h"
+
+#include "ICMPPacket/ICMPPacketTemplate.h"
+#include "IOUringPingEngine.h"
+
+#include <PingResultRecord>
+#include <QHostAddress>
+
+constexpr auto DefaultPayloadLength = 52;
+
+/**
+ * @brief       Private class to store the ping targets instance data.
+ */
+class Nedrysoft::IOUringPingEngine::IOUringPingTargetData {
+    public:
+        /**
+         * @brief       Constructs a IOUringPingTargetData.
+         *
+         * @param[in]   parent the IOUringPingTarget instance that this data belongs to.
+         */
+        IOUringPingTargetData(Nedrysoft::IOUringPingEngine::IOUringPingTarget *parent) :
+                m_pingTarget(parent),
+                m_engine(nullptr),
+                m_packetTemplate(nullptr),
+                m_id(0),
+                m_userData(nullptr),
+                m_ttl(0),
+                m_resultIndex(Nedrysoft::RouteAnalyser::PingResultRecord::NoTarget) {
+
+        }
+
+        friend class IOUringPingTarget;
+
+    private:
+        Nedrysoft::IOUringPingEngine::IOUringPingTarget *m_pingTarget;
+
+        QHostAddress m_hostAddress;
+        Nedrysoft::IOUringPingEngine::IOUringPingEngine *m_engine;
+        Nedrysoft::ICMPPacket::ICMPPacketTemplate *m_packetTemplate;
+        uint16_t m_id;
+        void *m_userData;
+        int m_ttl;
+        uint32_t m_resultIndex;
+};
+
+Nedrysoft::IOUringPingEngine::IOUringPingTarget::IOUringPingTarget(
+        Nedrysoft::IOUringPingEngine::IOUringPingEngine *engine,
+        QHostAddress hostAddress,
+        int ttl) :
+
+            d(std::make_shared<Nedrysoft::IOUringPingEngine::IOUringPingTargetData>(this)) {
+
+    d->m_hostAddress = std::move(hostAddress);
+    d->m_engine = engine;
+    d->m_ttl = ttl;
+}
+
+Nedrysoft::IOUringPingEngine::IOUringPingTarget::~IOUringPingTarget() {
+    delete d->m_packetTemplate;
+
+    d.reset();
+}
+
+auto Nedrysoft::IOUringPingEngine::IOUringPingTarget::setHostAddress(QHostAddress hostAddress) -> void {
+    d->m_hostAddress = hostAddress;
+
+    delete d->m_packetTemplate;
+
+    d->m_packetTemplate = nullptr;
+}
+
+auto Nedrysoft::IOUringPingEngine::IOUringPingTarget::hostAddress() -> QHostAddress {
+    return d->m_hostAddress;
+}
+
+auto Nedrysoft::IOUringPingEngine::IOUringPingTarget::engine() -> Nedrysoft::RouteAnalyser::IPingEngine * {
+    return d->m_engine;
+}
+
+auto Nedrysoft::IOUringPingEngine::IOUringPingTarget::id() -> uint16_t {
+    return d->m_id;
+}
+
+auto Nedrysoft::IOUringPingEngine::IOUringPingTarget::setId(uint16_t id) -> void {
+    d->m_id = id;
+
+    delete d->m_packetTemplate;
+
+    d->m_packetTemplate = nullptr;
+}
+
+auto Nedrysoft::IOUringPingEngine::IOUringPingTarget::packetTemplate() -> const Nedrysoft::ICMPPacket::ICMPPacketTemplate * {
+    if (d->m_packetTemplate==nullptr) {
+        if (d->m_hostAddress.protocol() == QAbstractSocket::IPv4Protocol) {
+            d->m_packetTemplate = new Nedrysoft::ICMPPacket::ICMPPacketTemplate(
+                    d->m_id,
+                    DefaultPayloadLength,
+                    d->m_hostAddress,
+                    Nedrysoft::ICMPPacket::V4 );
+        } else if (d->m_hostAddress.protocol() == QAbstractSocket::IPv6Protocol) {
+            d->m_packetTemplate = new Nedrysoft::ICMPPacket::ICMPPacketTemplate(
+                    d->m_id,
+                    DefaultPayloadLength,
+                    d->m_hostAddress,
+                    Nedrysoft::ICMPPacket::V6 );
+        }
+    }
+
+    return d->m_packetTemplate;
+}
+
+auto Nedrysoft::IOUringPingEngine::IOUringPingTarget::ttl() -> uint16_t {
+    return d->m_ttl;
+}
+
+auto Nedrysoft::IOUringPingEngine::IOUringPingTarget::userData() -> void * {
+    return d->m_userData;
+}
+
+auto Nedrysoft::IOUringPingEngine::IOUringPingTarget::setUserData(void *data) -> void {
+    d->m_userData = data;
+}
+
+auto Nedrysoft::IOUringPingEngine::IOUringPingTarget::saveConfiguration() -> QJsonObject {
+    return QJsonObject();
+}
+
+auto Nedrysoft::IOUringPingEngine::IOUringPingTarget::loadConfiguration(QJsonObject configuration) -> bool {
+    Q_UNUSED(configuration)
+
+    return false;
+}
+
+auto Nedrysoft::IOUringPingEngine::IOUringPingTarget::resultIndex() -> uint32_t {
+    return d->m_resultIndex;
+}
+
+auto Nedrysoft::IOUringPingEngine::IOUringPingTarget::setResultIndex(uint32_t index) -> void {
+    d->m_resultIndex = index;
+}
@@ -0,0 +1,493 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 18/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "IOUringPingWorker.h"
+
+#include "ICMPPacket/ICMPPacketTemplate.h"
+#include "ICMPPacket/ICMPReplyView.h"
+#include "IOUring.h"
+#include "IOUringMessage.h"
+#include "IOUringPingEngine.h"
+#include "IOUringPingTarget.h"
+
+#include <QMutexLocker>
+#include <cerrno>
+#include <spdlog/spdlog.h>
+#include <string>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <vector>
+
+constexpr auto DefaultTransmitInterval = 2500;
+constexpr auto DefaultReceiveTimeout = 1000;
+constexpr auto RingEntries = 256;
+constexpr auto ReceiveRequests = 32;
+constexpr auto TransmitRequests = 64;
+constexpr auto NanosecondsInMillisecond = INT64_C(1000000);
+
+Nedrysoft::IOUringPingEngine::IOUringPingWorker::IOUringPingWorker(
+        Nedrysoft::IOUringPingEngine::IOUringPingEngine *engine,
+        Nedrysoft::ICMPSocket::ICMPSocket *socket,
+        uint16_t id) :
+
+            m_engine(engine),
+            m_socket(socket),
+            m_id(id),
+            m_sequenceId(1),
+            m_interval(DefaultTransmitInterval),
+            m_timeout(DefaultReceiveTimeout),
+            m_stopDescriptor(eventfd(0, EFD_CLOEXEC)),
+            m_socketDrops(0) {
+
+}
+
+Nedrysoft::IOUringPingEngine::IOUringPingWorker::~IOUringPingWorker() {
+    if (m_stopDescriptor >= 0) {
+        close(m_stopDescriptor);
+    }
+}
+
+void Nedrysoft::IOUringPingEngine::IOUringPingWorker::doWork() {
+    // the messages are declared before the ring so that the ring, and with it any outstanding request, is destroyed
+    // before the memory that the requests refer to.
+
+    std::vector<Nedrysoft::IOUringPingEngine::IOUringMessage> receiveMessages(ReceiveRequests);
+    std::vector<Nedrysoft::IOUringPingEngine::IOUringMessage> transmitMessages(TransmitRequests);
+    std::vector<uint32_t> freeTransmitMessages;
+    Nedrysoft::IOUringPingEngine::IOUringMessage errorMessage;
+    QVector<ScheduledTarget> schedule;
+    __kernel_timespec timerDeadline = {};
+    uint64_t stopValue = 0;
+
+    Nedrysoft::IOUringPingEngine::IOUring ring(RingEntries);
+
+    if (( !ring.isValid() ) || ( m_stopDescriptor < 0 )) {
+        SPDLOG_ERROR("Unable to create the io_uring instance.");
+
+        return;
+    }
+
+    auto descriptor = m_socket->descriptor();
+    auto version = m_socket->version();
+
+    for (uint32_t messageIndex = 0; messageIndex < TransmitRequests; messageIndex++) {
+        freeTransmitMessages.push_back(messageIndex);
+    }
+
+    // several receives are kept outstanding so that a burst of replies is read without waiting for each receive to
+    // be resubmitted.
+
+    for (uint32_t messageIndex = 0; messageIndex < ReceiveRequests; messageIndex++) {
+        ring.receiveMessage(
+            descriptor,
+            receiveMessages[messageIndex].prepareReceive(),
+            0,
+            userData(Operation::Receive, messageIndex) );
+    }
+
+    // a datagram socket reports ICMP errors (i.e time exceeded) on the error queue of the socket.
+
+    if (m_socket->isDatagram()) {
+        ring.receiveMessage(descriptor, errorMessage.prepareReceive(), MSG_ERRQUEUE, userData(Operation::ReceiveError));
+    }
+
+    ring.read(m_stopDescriptor, &stopValue, sizeof(stopValue), userData(Operation::Stop));
+
+    m_engine->setEpoch(QDateTime::currentDateTime());
+
+    auto interval = static_cast<int64_t>(m_interval) * NanosecondsInMillisecond;
+    auto roundStart = Nedrysoft::IOUringPingEngine::IOUring::monotonicNanoseconds();
+    auto scheduleIndex = 0;
+    unsigned long sampleNumber = 0;
+    auto isTimerPending = false;
+    auto isRunning = true;
+
+    createSchedule(schedule, interval);
+
+    while (isRunning) {
+        auto currentTime = Nedrysoft::IOUringPingEngine::IOUring::monotonicNanoseconds();
+
+        // send every probe that is due, rounds start on a fixed grid so that the time between the probes of a target
+        // stays equal to the interval, if the worker has fallen more than a round behind then the grid is restarted.
+
+        while (true) {
+            if (scheduleIndex == schedule.count()) {
+                if (roundStart + interval > currentTime) {
+                    break;
+                }
+
+                roundStart += interval;
+
+                if (roundStart + interval < currentTime) {
+                    roundStart = currentTime;
+                }
+
+                interval = static_cast<int64_t>(m_interval) * NanosecondsInMillisecond;
+                scheduleIndex = 0;
+                sampleNumber++;
+
+                createSchedule(schedule, interval);
+
+                continue;
+            }
+
+            // sends normally complete as soon as they are submitted, if every message is in use then the probe is
+            // sent once a send has completed.
+
+            if (( roundStart + schedule[scheduleIndex].offset > currentTime ) || ( freeTransmitMessages.empty() )) {
+                break;
+            }
+
+            m_engine->counters().addLateness(currentTime - ( roundStart + schedule[scheduleIndex].offset ));
+
+            auto target = schedule[scheduleIndex++].target;
+            auto messageIndex = freeTransmitMessages.back();
+            auto &message = transmitMessages[messageIndex];
+
+            sockaddr_storage address = {};
+
+            auto addressLength = m_socket->toSocketAddress(target->hostAddress(), address);
+
+            if (!addressLength) {
+                continue;
+            }
+
+            auto packetLength = createProbe(
+                target,
+                sampleNumber,
+                message.buffer(),
+                Nedrysoft::IOUringPingEngine::IOUringMessage::BufferSize );
+
+            if (!packetLength) {
+                continue;
+            }
+
+            freeTransmitMessages.pop_back();
+
+            ring.sendMessage(
+                descriptor,
+                message.prepareSend(packetLength, address, addressLength, target->ttl(), version),
+                userData(Operation::Transmit, messageIndex) );
+        }
+
+        expireRequests(currentTime);
+
+        // a single timer wakes the worker for the next probe or the next request deadline, whichever is first.  New
+        // deadlines are only created when a probe is sent, which is never before the pending timer, so the timer is
+        // only replaced once it has fired.
+
+        if (!isTimerPending) {
+            auto wakeTime = roundStart + interval;
+
+            if (scheduleIndex < schedule.count()) {
+                wakeTime = roundStart + schedule[scheduleIndex].offset;
+            }
+
+            if (( !m_deadlines.empty() ) && ( m_deadlines.front().deadline < wakeTime )) {
+                wakeTime = m_deadlines.front().deadline;
+            }
+
+            timerDeadline = Nedrysoft::IOUringPingEngine::IOUring::toTimespec(wakeTime);
+
+            isTimerPending = ring.timeout(&timerDeadline, userData(Operation::Timer));
+        }
+
+        auto submitResult = ring.submit(1);
+
+        if (submitResult < 0) {
+            SPDLOG_ERROR("Unable to submit io_uring requests, error " + std::to_string(-submitResult));
+
+            break;
+        }
+
+        ring.forEachCompletion([&](uint64_t completionData, int completionResult) {
+            auto messageIndex = index(completionData);
+
+            switch (operation(completionData)) {
+                case Operation::Transmit: {
+                    if (completionResult < 0) {
+                        SPDLOG_ERROR("Unable to send packet, error " + std::to_string(-completionResult));
+
+                        m_engine->counters().addSendErrors();
+                    } else {
+                        m_engine->counters().addProbesSent();
+                    }
+
+                    freeTransmitMessages.push_back(messageIndex);
+
+                    break;
+                }
+
+                case Operation::Receive:
+                case Operation::ReceiveError: {
+                    auto isError = ( operation(completionData) == Operation::ReceiveError );
+                    auto &message = isError ? errorMessage : receiveMessages[messageIndex];
+
+                    if (completionResult >= 0) {
+                        processPacket(message.receivedPacket(completionResult), isError);
+                    } else if (( completionResult == -EBADF ) || ( completionResult == -EINVAL )) {
+                        SPDLOG_ERROR("Unable to receive on socket, error " + std::to_string(-completionResult));
+
+                        break;
+                    }
+
+                    // other errors (i.e an ICMP error that was also reported as a pending socket error) are
+                    // transient, so the receive is always resubmitted.
+
+                    ring.receiveMessage(
+                        descriptor,
+                        message.prepareReceive(),
+                        isError ? MSG_ERRQUEUE : 0,
+                        completionData );
+
+                    break;
+                }
+
+                case Operation::Timer: {
+                    isTimerPending = false;
+
+                    break;
+                }
+
+                case Operation::Stop: {
+                    isRunning = false;
+
+                    break;
+                }
+            }
+        });
+    }
+
+    m_engine->counters().cancelRequests(m_requests.count());
+
+    m_requests.clear();
+    m_deadlines.clear();
+}
+
+auto Nedrysoft::IOUringPingEngine::IOUringPingWorker::createSchedule(
+        QVector<ScheduledTarget> &schedule,
+        int64_t interval) -> void {
+
+    QMutexLocker locker(&m_targetsMutex);
+
+    schedule.clear();
+
+    for (auto targetIndex = 0; targetIndex < m_targets.count(); targetIndex++) {
+        schedule.append(ScheduledTarget {
+            m_targets.at(targetIndex),
+            ( interval * targetIndex ) / m_targets.count()
+        });
+    }
+}
+
+auto Nedrysoft::IOUringPingEngine::IOUringPingWorker::createProbe(
+        Nedrysoft::IOUringPingEngine::IOUringPingTarget *target,
+        unsigned long sampleNumber,
+        char *buffer,
+        int bufferLength) -> int {
+
+    auto packetTemplate = target->packetTemplate();
+
+    if (!packetTemplate) {
+        return 0;
+    }
+
+    auto sequenceId = m_sequenceId++;
+    auto transmitTime = Nedrysoft::ICMPSocket::realtimeNanoseconds();
+    auto transmitTick = Nedrysoft::IOUringPingEngine::IOUring::monotonicNanoseconds();
+    auto deadline = transmitTick + static_cast<int64_t>(m_timeout) * NanosecondsInMillisecond;
+
+    // the packet is created from the precomputed template of the target, only the sequence, the payload timestamp
+    // and the checksum are updated.
+
+    auto packetLength = packetTemplate->write(buffer, bufferLength, sequenceId, transmitTime);
+
+    if (!packetLength) {
+        return 0;
+    }
+
+    m_requests.insert(sequenceId, Request {target, sampleNumber, transmitTime, transmitTick, deadline});
+
+    m_engine->counters().addRequest();
+
+    m_deadlines.push_back(Deadline {deadline, sequenceId});
+
+    return packetLength;
+}
+
+auto Nedrysoft::IOUringPingEngine::IOUringPingWorker::processPacket(
+        const Nedrysoft::ICMPSocket::ReceivedPacket &packet,
+        bool isError) -> void {
+
+    auto &counters = m_engine->counters();
+
+    // the kernel reports the total number of packets that the socket has dropped, only the increase since the
+    // previous packet is added.
+
+    if (packet.dropCount >= 0) {
+        auto socketDrops = static_cast<uint32_t>(packet.dropCount);
+
+        counters.addReceiveDrops(static_cast<uint32_t>(socketDrops - m_socketDrops));
+
+        m_socketDrops = socketDrops;
+    }
+
+    auto ipVersion = static_cast<Nedrysoft::ICMPPacket::IPVersion>(m_socket->version());
+    auto format = Nedrysoft::ICMPPacket::PacketFormat::Raw;
+
+    if (m_socket->isDatagram()) {
+        format = Nedrysoft::ICMPPacket::PacketFormat::Datagram;
+    }
+
+    auto packetData = gsl::span<const uint8_t>(
+        reinterpret_cast<const uint8_t *>(packet.buffer.constData()),
+        packet.buffer.length() );
+
+    // errors reported on the error queue of a datagram socket carry the echo request that was sent.
+
+    auto responsePacket = isError ?
+        Nedrysoft::ICMPPacket::ICMPReplyView::fromError(packetData, ipVersion, packet.errorType, packet.errorCode) :
+        Nedrysoft::ICMPPacket::ICMPReplyView(packetData, ipVersion, format);
+
+    if (!responsePacket.isValid()) {
+        return;
+    }
+
+    if (responsePacket.id() != m_id) {
+        counters.addForeignPacket();
+
+        return;
+    }
+
+    auto requestIterator = m_requests.find(responsePacket.sequence());
+
+    if (requestIterator == m_requests.end()) {
+        counters.addUnmatchedReply(requestKey(responsePacket.sequence()));
+
+        return;
+    }
+
+    counters.addReply();
+
+    auto request = requestIterator.value();
+
+    m_requests.erase(requestIterator);
+
+    auto resultCode = Nedrysoft::RouteAnalyser::PingResult::ResultCode::Ok;
+
+    if (responsePacket.resultCode() == Nedrysoft::ICMPPacket::TimeExceeded) {
+        resultCode = Nedrysoft::RouteAnalyser::PingResult::ResultCode::TimeExceeded;
+    }
+
+    auto roundTripTime = Nedrysoft::IOUringPingEngine::IOUring::monotonicNanoseconds() - request.transmitTick;
+
+    auto timestampSource = Nedrysoft::RouteAnalyser::PingResult::TimestampSource::User;
+
+    // kernel timestamps use the wall clock, if the clock was stepped then the monotonic timer is used instead.
+
+    if (( packet.timestampSource == Nedrysoft::ICMPSocket::TimestampSource::Kernel ) &&
+        ( packet.timestamp > request.transmitTime )) {
+
+        roundTripTime = packet.timestamp - request.transmitTime;
+        timestampSource = Nedrysoft::RouteAnalyser::PingResult::TimestampSource::KernelReceive;
+    }
+
+    Q_EMIT result(Nedrysoft::RouteAnalyser::PingResultRecord::create(
+        static_cast<uint32_t>(request.sampleNumber),
+        resultCode,
+        packet.receiveAddress,
+        request.transmitTick,
+        roundTripTime,
+        request.target->resultIndex(),
+        -1,
+        timestampSource
+    ));
+}
+
+auto Nedrysoft::IOUringPingEngine::IOUringPingWorker::expireRequests(int64_t now) -> void {
+    // every request is given the same timeout, so deadlines are queued in the order that they expire.  If the timeout
+    // is reduced while requests are outstanding then the requests sent after the change expire late, until the older
+    // requests have expired.
+
+    while (( !m_deadlines.empty() ) && ( m_deadlines.front().deadline <= now )) {
+        auto expiredRequest = m_deadlines.front();
+
+        m_deadlines.pop_front();
+
+        // requests that have already been serviced by a reply are no longer in the table.
+
+        auto requestIterator = m_requests.find(expiredRequest.sequence);
+
+        if (( requestIterator == m_requests.end() ) || ( requestIterator->deadline != expiredRequest.deadline )) {
+            continue;
+        }
+
+        auto request = requestIterator.value();
+
+        m_requests.erase(requestIterator);
+
+        m_engine->counters().addTimeout(requestKey(expiredRequest.sequence));
+
+        Q_EMIT result(Nedrysoft::RouteAnalyser::PingResultRecord::create(
+            static_cast<uint32_t>(request.sampleNumber),
+            Nedrysoft::RouteAnalyser::PingResult::ResultCode::NoReply,
+            QHostAddress(),
+            request.transmitTick,
+            now - request.transmitTick,
+            request.target->resultIndex()
+        ));
+    }
+}
+
+auto Nedrysoft::IOUringPingEngine::IOUringPingWorker::setInterval(int interval) -> void {
+    m_interval = interval;
+}
+
+auto Nedrysoft::IOUringPingEngine::IOUringPingWorker::setTimeout(int timeout) -> void {
+    m_timeout = timeout;
+}
+
+auto Nedrysoft::IOUringPingEngine::IOUringPingWorker::addTarget(
+        Nedrysoft::IOUringPingEngine::IOUringPingTarget *target) -> void {
+
+    QMutexLocker locker(&m_targetsMutex);
+
+    m_targets.append(target);
+}
+
+auto Nedrysoft::IOUringPingEngine::IOUringPingWorker::removeTarget(
+        Nedrysoft::IOUringPingEngine::IOUringPingTarget *target) -> void {
+
+    QMutexLocker locker(&m_targetsMutex);
+
+    m_targets.removeAll(target);
+}
+
+auto Nedrysoft::IOUringPingEngine::IOUringPingWorker::stop() -> void {
+    uint64_t value = 1;
+
+    if (write(m_stopDescriptor, &value, sizeof(value)) != sizeof(value)) {
+        SPDLOG_ERROR("Unable to wake the io_uring worker.");
+    }
+}
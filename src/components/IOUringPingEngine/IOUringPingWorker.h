@@ -0,0 +1,296 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 18/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef PINGNOO_COMPONENTS_IOURINGPINGENGINE_IOURINGPINGWORKER_H
+#define PINGNOO_COMPONENTS_IOURINGPINGENGINE_IOURINGPINGWORKER_H
+
+#include "ICMPSocket/ICMPSocket.h"
+
+#include <PingResult>
+#include <PingResultRecord>
+
+#include <QDateTime>
+#include <QHash>
+#include <QMutex>
+#include <QObject>
+#include <QVector>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+
+namespace Nedrysoft { namespace IOUringPingEngine {
+    class IOUringPingEngine;
+    class IOUringPingTarget;
+
+    /**
+     * @brief       The IOUringPingWorker class sends the probes of an engine, receives the replies and times out
+     *              the requests on a single thread.
+     *
+     * @details     Every socket operation and the wait for the next deadline is a request on one io_uring
+     *              instance, so the thread sleeps in a single io_uring_enter call until a reply arrives, the next
+     *              probe is due or a request times out.  Requests are only accessed by the worker thread so they
+     *              are tracked without locks, and replies and timeouts are reported directly from the thread
+     *              rather than being passed between a transmitter, receiver and timeout thread.
+     *
+     *              The probes of a round are spaced evenly across the interval.
+     */
+    class IOUringPingWorker :
+            public QObject {
+
+        private:
+            Q_OBJECT
+
+        public:
+            /**
+             * @brief       The operation of an io_uring request, stored in the upper 32 bits of its user data.
+             */
+            enum class Operation : uint64_t {
+                Transmit,
+                Receive,
+                ReceiveError,
+                Timer,
+                Stop
+            };
+
+            /**
+             * @brief       Returns the user data for a request.
+             *
+             * @param[in]   operation the operation.
+             * @param[in]   index the index of the message that the request uses.
+             *
+             * @returns     the user data.
+             */
+            static constexpr auto userData(Operation operation, uint32_t index = 0) -> uint64_t {
+                return ( static_cast<uint64_t>(operation) << 32 ) | index;
+            }
+
+            /**
+             * @brief       Returns the operation of a request from its user data.
+             *
+             * @param[in]   userData the user data of the completion.
+             *
+             * @returns     the operation.
+             */
+            static constexpr auto operation(uint64_t userData) -> Operation {
+                return static_cast<Operation>(userData >> 32);
+            }
+
+            /**
+             * @brief       Returns the message index of a request from its user data.
+             *
+             * @param[in]   userData the user data of the completion.
+             *
+             * @returns     the index.
+             */
+            static constexpr auto index(uint64_t userData) -> uint32_t {
+                return static_cast<uint32_t>(userData);
+            }
+
+        public:
+            /**
+             * @brief       Constructs a new IOUringPingWorker for the given engine.
+             *
+             * @param[in]   engine the owner engine.
+             * @param[in]   socket the socket that probes are sent and received on, the socket is not owned by the
+             *              worker and must outlive it.
+             * @param[in]   id the ICMP id of the probes, for a datagram socket this is the id of the socket.
+             */
+            IOUringPingWorker(
+                Nedrysoft::IOUringPingEngine::IOUringPingEngine *engine,
+                Nedrysoft::ICMPSocket::ICMPSocket *socket,
+                uint16_t id
+            );
+
+            /**
+             * @brief       Destroys the IOUringPingWorker.
+             */
+            ~IOUringPingWorker();
+
+            /**
+             * @brief       Sets the interval between a set of pings.
+             *
+             * @details     The interval takes effect from the next round.
+             *
+             * @param[in]   interval the interval in milliseconds.
+             */
+            auto setInterval(int interval) -> void;
+
+            /**
+             * @brief       Sets the time after which a request is reported as lost.
+             *
+             * @param[in]   timeout the timeout in milliseconds.
+             */
+            auto setTimeout(int timeout) -> void;
+
+            /**
+             * @brief       Adds a ping target to the worker.
+             *
+             * @details     The target is sent from the next round, targets are owned by the engine.
+             *
+             * @param[in]   target the target to ping.
+             */
+            auto addTarget(Nedrysoft::IOUringPingEngine::IOUringPingTarget *target) -> void;
+
+            /**
+             * @brief       Removes a ping target from the worker.
+             *
+             * @details     The target is no longer sent from the next round, the engine keeps the target until it
+             *              is destroyed as requests to it may still be outstanding.
+             *
+             * @param[in]   target the target to remove.
+             */
+            auto removeTarget(Nedrysoft::IOUringPingEngine::IOUringPingTarget *target) -> void;
+
+            /**
+             * @brief       Stops the worker.
+             *
+             * @details     May be called from any thread, the worker returns from doWork() once it has woken.
+             */
+            auto stop() -> void;
+
+            /**
+             * @brief       The worker thread function.
+             */
+            Q_SLOT void doWork();
+
+        public:
+            /**
+             * @brief       This signal is emitted when a reply is received or a request times out.
+             *
+             * @details     The request time of the record is taken from CLOCK_MONOTONIC, which is the clock used by
+             *              Nedrysoft::RouteAnalyser::PingResultRecord::monotonicNanoseconds on Linux.
+             *
+             * @param[in]   record the result.
+             */
+            Q_SIGNAL void result(const Nedrysoft::RouteAnalyser::PingResultRecord &record);
+
+        private:
+            /**
+             * @brief       A request that is waiting for a reply.
+             */
+            struct Request {
+                Nedrysoft::IOUringPingEngine::IOUringPingTarget *target;
+                unsigned long sampleNumber;
+                int64_t transmitTime;       /**< transmit time in nanoseconds since the unix epoch. */
+                int64_t transmitTick;       /**< transmit time of the monotonic clock in nanoseconds. */
+                int64_t deadline;           /**< time of the monotonic clock at which the request is lost. */
+            };
+
+            /**
+             * @brief       The time at which a request is timed out.
+             */
+            struct Deadline {
+                int64_t deadline;
+                uint16_t sequence;
+            };
+
+            /**
+             * @brief       A target and the offset into the round at which it is sent.
+             */
+            struct ScheduledTarget {
+                Nedrysoft::IOUringPingEngine::IOUringPingTarget *target;
+                int64_t offset;
+            };
+
+            /**
+             * @brief       Creates the schedule of a round from the current list of targets.
+             *
+             * @details     The targets are copied so that the lock is not held while the round is sent, targets are
+             *              only deleted when the engine is destroyed.
+             *
+             * @param[out]  schedule the targets and their offsets, in the order that they are sent.
+             * @param[in]   interval the length of the round in nanoseconds.
+             */
+            auto createSchedule(QVector<ScheduledTarget> &schedule, int64_t interval) -> void;
+
+            /**
+             * @brief       Writes the probe for a target into a message and tracks the request.
+             *
+             * @param[in]   target the target.
+             * @param[in]   sampleNumber the round that the probe belongs to.
+             * @param[in]   buffer the buffer to write the probe to.
+             * @param[in]   bufferLength the length of the buffer.
+             *
+             * @returns     the length of the probe; 0 if the probe could not be created.
+             */
+            auto createProbe(
+                Nedrysoft::IOUringPingEngine::IOUringPingTarget *target,
+                unsigned long sampleNumber,
+                char *buffer,
+                int bufferLength
+            ) -> int;
+
+            /**
+             * @brief       Matches a received packet to its request and reports the result.
+             *
+             * @param[in]   packet the received packet.
+             * @param[in]   isError true if the packet was read from the error queue of a datagram socket.
+             */
+            auto processPacket(const Nedrysoft::ICMPSocket::ReceivedPacket &packet, bool isError) -> void;
+
+            /**
+             * @brief       Reports every request whose deadline has passed as lost.
+             *
+             * @param[in]   now the time of the monotonic clock in nanoseconds.
+             */
+            auto expireRequests(int64_t now) -> void;
+
+            /**
+             * @brief       Returns the key that a request is counted with in the engine counters.
+             *
+             * @param[in]   sequence the sequence id of the request.
+             *
+             * @returns     the key.
+             */
+            auto requestKey(uint16_t sequence) const -> uint32_t {
+                return ( static_cast<uint32_t>(m_id) << 16 ) | sequence;
+            }
+
+        private:
+            //! @cond
+
+            Nedrysoft::IOUringPingEngine::IOUringPingEngine *m_engine;
+            Nedrysoft::ICMPSocket::ICMPSocket *m_socket;
+
+            uint16_t m_id;
+            uint16_t m_sequenceId;
+
+            std::atomic<int> m_interval;
+            std::atomic<int> m_timeout;
+
+            int m_stopDescriptor;
+
+            QList<Nedrysoft::IOUringPingEngine::IOUringPingTarget *> m_targets;
+            QMutex m_targetsMutex;
+
+            QHash<uint16_t, Request> m_requests;
+            std::deque<Deadline> m_deadlines;
+
+            uint32_t m_socketDrops;
+
+            //! @endcond
+    };
+}}
+
+#endif // PINGNOO_COMPONENTS_IOURINGPINGENGINE_IOURINGPINGWORKER_H
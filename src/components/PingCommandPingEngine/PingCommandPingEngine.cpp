@@ -25,6 +25,7 @@
 
 #include "PingCommandPingTarget.h"
 
+#include <PingResultBatcher>
 #include <QElapsedTimer>
 #include <QMutex>
 #include <QProcess>
@@ -38,9 +39,18 @@ constexpr auto DefaultTTL = 64;
 constexpr auto PacketLostRegularExpression = R"(100% packet loss)";
 constexpr auto TtlExceededRegularExpression = R"(From\ (?<ip>[\d\.]*)\ .*exceeded)";
 
-Nedrysoft::PingCommandPingEngine::PingCommandPingEngine::PingCommandPingEngine(Nedrysoft::Core::IPVersion version) {
+Nedrysoft::PingCommandPingEngine::PingCommandPingEngine::PingCommandPingEngine(Nedrysoft::Core::IPVersion version) :
+        m_resultBatcher(nullptr) {
+
     Q_UNUSED(version)
 
+    m_resultBatcher = new Nedrysoft::RouteAnalyser::PingResultBatcher(this);
+
+    connect(this, &Nedrysoft::RouteAnalyser::IPingEngine::result, m_resultBatcher,
+            &Nedrysoft::RouteAnalyser::PingResultBatcher::addResult, Qt::DirectConnection);
+
+    connect(m_resultBatcher, &Nedrysoft::RouteAnalyser::PingResultBatcher::resultsReady, this,
+            &Nedrysoft::RouteAnalyser::IPingEngine::resultsReady);
 }
 
 Nedrysoft::PingCommandPingEngine::PingCommandPingEngine::~PingCommandPingEngine() {
@@ -100,6 +110,17 @@ auto Nedrysoft::PingCommandPingEngine::PingCommandPingEngine::setTimeout(int tim
     return true;
 }
 
+auto Nedrysoft::PingCommandPingEngine::PingCommandPingEngine::setResultBatching(int interval, int batchSize) -> bool {
+    m_resultBatcher->setInterval(interval);
+    m_resultBatcher->setBatchSize(batchSize);
+
+    return true;
+}
+
+auto Nedrysoft::PingCommandPingEngine::PingCommandPingEngine::metrics() -> Nedrysoft::RouteAnalyser::PingEngineMetrics {
+    return m_counters.snapshot();
+}
+
 auto Nedrysoft::PingCommandPingEngine::PingCommandPingEngine::epoch() -> QDateTime {
     return QDateTime::currentDateTime();
 }
@@ -117,6 +138,14 @@ auto Nedrysoft::PingCommandPingEngine::PingCommandPingEngine::loadConfiguration(
 auto Nedrysoft::PingCommandPingEngine::PingCommandPingEngine::emitResult(
         Nedrysoft::RouteAnalyser::PingResult pingResult) -> void {
 
+    m_counters.addProbesSent();
+
+    if (pingResult.code() == Nedrysoft::RouteAnalyser::PingResult::ResultCode::NoReply) {
+        m_counters.addTimeout(0);
+    } else {
+        m_counters.addReply();
+    }
+
     Q_EMIT result(pingResult);
 }
 
@@ -28,6 +28,10 @@
 #include <IPingEngine>
 #include <IPingEngineFactory>
 
+namespace Nedrysoft { namespace RouteAnalyser {
+    class PingResultBatcher;
+}}
+
 namespace Nedrysoft { namespace PingCommandPingEngine {
     class PingCommandPingTarget;
 
@@ -84,6 +88,30 @@ namespace Nedrysoft { namespace PingCommandPingEngine {
              */
             auto setTimeout(int timeout) -> bool override;
 
+            /**
+             * @brief       Sets when a batch of results is delivered.
+             *
+             * @see         Nedrysoft::RouteAnalyser::IPingEngine::setResultBatching
+             *
+             * @param[in]   interval the longest time in milliseconds that a result waits for its batch.
+             * @param[in]   batchSize the number of results after which a batch is delivered without waiting.
+             *
+             * @returns     true on success; otherwise false.
+             */
+            auto setResultBatching(int interval, int batchSize) -> bool override;
+
+            /**
+             * @brief       Returns a snapshot of the engine counters.
+             *
+             * @details     Replies are matched by the ping command, so unmatched, foreign and late packets, receive
+             *              drops and send scheduling lateness are not available.
+             *
+             * @see         Nedrysoft::RouteAnalyser::IPingEngine::metrics
+             *
+             * @returns     the metrics of the engine.
+             */
+            auto metrics() -> Nedrysoft::RouteAnalyser::PingEngineMetrics override;
+
             /**
              * @brief       Starts ping operations for this engine instance.
              *
@@ -200,6 +228,10 @@ namespace Nedrysoft { namespace PingCommandPingEngine {
 
             QList<PingCommandPingTarget *> m_pingTargets;
 
+            Nedrysoft::RouteAnalyser::PingResultBatcher *m_resultBatcher;
+
+            Nedrysoft::RouteAnalyser::PingEngineCounters m_counters;
+
             int m_interval;
 
             //! @endcond
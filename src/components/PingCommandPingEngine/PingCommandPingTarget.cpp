@@ -79,6 +79,8 @@ Nedrysoft::PingCommandPingEngine::PingCommandPingTarget::PingCommandPingTarget(
 
                // pingProcess = new QProcess();
 
+                engine->m_counters.addRequest();
+
                 pingProcess.start("ping", pingArguments);
 
                 pingProcess.waitForStarted();
@@ -137,6 +139,9 @@ Nedrysoft::PingCommandPingEngine::PingCommandPingTarget::PingCommandPingTarget(
                         engine->emitResult(pingResult);
                     } else {
                         // some other error
+
+                        engine->m_counters.addSendErrors();
+                        engine->m_counters.cancelRequests(1);
                     }
                 }
 #if QT_VERSION < QT_VERSION_CHECK(5, 10, 0)
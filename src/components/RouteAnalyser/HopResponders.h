@@ -0,0 +1,262 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 18/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PINGNOO_COMPONENTS_ROUTEANALYSER_HOPRESPONDERS_H
+#define PINGNOO_COMPONENTS_ROUTEANALYSER_HOPRESPONDERS_H
+
+#include <QHostAddress>
+#include <QMetaType>
+#include <algorithm>
+#include <array>
+
+namespace Nedrysoft { namespace RouteAnalyser {
+    /**
+     * @brief       The HopResponders class holds the set of routers that answered for a single hop.
+     *
+     * @details     On a load balanced path, probes sent with the same ttl are answered by different routers depending
+     *              on the flow that each probe hashes to.  Each responder keeps its own sample count and latency
+     *              statistics, so that the spread of an equal cost multipath hop can be told apart from the latency
+     *              variance of a single router.
+     *
+     *              The set holds a small fixed number of responders, samples from any further responders are counted
+     *              as overflow but not stored.
+     */
+    class HopResponders {
+        public:
+            /**
+             * @brief       The maximum number of responders stored for a hop.
+             */
+            static constexpr int MaximumResponders = 8;
+
+            /**
+             * @brief       The Responder structure holds the statistics of a single router at a hop.
+             */
+            struct Responder {
+                QHostAddress hostAddress;           /**< the address of the router. */
+                unsigned long sampleCount;          /**< the number of replies received from the router. */
+                unsigned long latencyCount;         /**< the number of replies that carried a latency. */
+                double minimumLatency;              /**< the smallest latency in seconds, -1 if none. */
+                double maximumLatency;              /**< the largest latency in seconds, -1 if none. */
+                double averageLatency;              /**< the average latency in seconds, -1 if none. */
+            };
+
+        public:
+            /**
+             * @brief       Constructs an empty HopResponders.
+             */
+            HopResponders() :
+                    m_count(0),
+                    m_overflowCount(0) {
+
+            }
+
+            /**
+             * @brief       Adds a reply from a router to the set.
+             *
+             * @param[in]   hostAddress the address of the router that replied.
+             * @param[in]   latency the round trip time in seconds, or a negative value if the reply has no latency.
+             */
+            auto addSample(const QHostAddress &hostAddress, double latency = -1) -> void {
+                if (hostAddress.isNull()) {
+                    return;
+                }
+
+                auto index = indexOf(hostAddress);
+
+                if (index==-1) {
+                    if (m_count==MaximumResponders) {
+                        m_overflowCount++;
+
+                        return;
+                    }
+
+                    index = m_count++;
+
+                    m_responders[index] = Responder{hostAddress, 0, 0, -1, -1, -1};
+                }
+
+                auto &responder = m_responders[index];
+
+                responder.sampleCount++;
+
+                if (latency<0) {
+                    return;
+                }
+
+                responder.latencyCount++;
+
+                if (( responder.minimumLatency<0 ) || ( latency<responder.minimumLatency )) {
+                    responder.minimumLatency = latency;
+                }
+
+                if (latency>responder.maximumLatency) {
+                    responder.maximumLatency = latency;
+                }
+
+                if (responder.averageLatency<0) {
+                    responder.averageLatency = latency;
+                } else {
+                    responder.averageLatency +=
+                        ( latency-responder.averageLatency ) / static_cast<double>(responder.latencyCount);
+                }
+            }
+
+            /**
+             * @brief       Returns the number of responders stored for the hop.
+             *
+             * @returns     the number of responders.
+             */
+            auto count() const -> int {
+                return m_count;
+            }
+
+            /**
+             * @brief       Returns a responder.
+             *
+             * @param[in]   index the index of the responder, in the order that they first replied.
+             *
+             * @returns     the responder.
+             */
+            auto at(int index) const -> const Responder & {
+                return m_responders[index];
+            }
+
+            /**
+             * @brief       Returns the index of a responder.
+             *
+             * @param[in]   hostAddress the address of the router.
+             *
+             * @returns     the index of the responder if found; otherwise -1.
+             */
+            auto indexOf(const QHostAddress &hostAddress) const -> int {
+                for (auto index=0;index<m_count;index++) {
+                    if (m_responders[index].hostAddress==hostAddress) {
+                        return index;
+                    }
+                }
+
+                return -1;
+            }
+
+            /**
+             * @brief       Returns the responder that has answered the most samples.
+             *
+             * @returns     the index of the responder; -1 if the set is empty.
+             */
+            auto primaryIndex() const -> int {
+                auto primary = -1;
+
+                for (auto index=0;index<m_count;index++) {
+                    if (( primary==-1 ) || ( m_responders[index].sampleCount>m_responders[primary].sampleCount )) {
+                        primary = index;
+                    }
+                }
+
+                return primary;
+            }
+
+            /**
+             * @brief       Returns whether more than one router has answered for the hop.
+             *
+             * @returns     true if the hop is load balanced; otherwise false.
+             */
+            auto isMultipath() const -> bool {
+                return ( m_count>1 ) || ( m_overflowCount>0 );
+            }
+
+            /**
+             * @brief       Returns the number of samples from responders that did not fit in the set.
+             *
+             * @returns     the number of overflow samples.
+             */
+            auto overflowCount() const -> unsigned long {
+                return m_overflowCount;
+            }
+
+            /**
+             * @brief       Adds the responders and samples of another set to this set.
+             *
+             * @note        Latency statistics are combined as weighted averages and ranges.
+             *
+             * @param[in]   other the set to add.
+             */
+            auto merge(const HopResponders &other) -> void {
+                for (auto otherIndex=0;otherIndex<other.m_count;otherIndex++) {
+                    const auto &otherResponder = other.m_responders[otherIndex];
+
+                    auto index = indexOf(otherResponder.hostAddress);
+
+                    if (index==-1) {
+                        if (m_count==MaximumResponders) {
+                            m_overflowCount += otherResponder.sampleCount;
+
+                            continue;
+                        }
+
+                        m_responders[m_count++] = otherResponder;
+
+                        continue;
+                    }
+
+                    auto &responder = m_responders[index];
+
+                    if (otherResponder.latencyCount) {
+                        if (responder.latencyCount) {
+                            responder.averageLatency =
+                                ( responder.averageLatency*static_cast<double>(responder.latencyCount) +
+                                  otherResponder.averageLatency*static_cast<double>(otherResponder.latencyCount) ) /
+                                static_cast<double>(responder.latencyCount+otherResponder.latencyCount);
+
+                            responder.minimumLatency =
+                                std::min(responder.minimumLatency, otherResponder.minimumLatency);
+
+                            responder.maximumLatency =
+                                std::max(responder.maximumLatency, otherResponder.maximumLatency);
+                        } else {
+                            responder.averageLatency = otherResponder.averageLatency;
+                            responder.minimumLatency = otherResponder.minimumLatency;
+                            responder.maximumLatency = otherResponder.maximumLatency;
+                        }
+                    }
+
+                    responder.sampleCount += otherResponder.sampleCount;
+                    responder.latencyCount += otherResponder.latencyCount;
+                }
+
+                m_overflowCount += other.m_overflowCount;
+            }
+
+        private:
+            //! @cond
+
+            std::array<Responder, MaximumResponders> m_responders;
+            int m_count;
+            unsigned long m_overflowCount;
+
+            //! @endcond
+    };
+}}
+
+Q_DECLARE_METATYPE(Nedrysoft::RouteAnalyser::HopResponders)
+
+#endif // PINGNOO_COMPONENTS_ROUTEANALYSER_HOPRESPONDERS_H
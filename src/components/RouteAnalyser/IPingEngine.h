@@ -25,12 +25,15 @@
 #define PINGNOO_COMPONENTS_ROUTEANALYSER_IPINGENGINE_H
 
 #include "RouteAnalyserSpec.h"
+#include "PingEngineMetrics.h"
 #include "PingResult.h"
 
 #include <IConfiguration>
 #include <IInterface>
 #include <QHostAddress>
+#include <QVector>
 #include <chrono>
+#include <functional>
 
 namespace Nedrysoft { namespace RouteAnalyser {
     class IPingTarget;
@@ -135,6 +138,56 @@ namespace Nedrysoft { namespace RouteAnalyser {
                 double timeout
             ) -> Nedrysoft::RouteAnalyser::PingResult = 0;
 
+            /**
+             * @brief       Transmits a single ping for each of a list of TTL's.
+             *
+             * @details     Engines that can send the pings together override this so that all of the TTL's are
+             *              answered within one timeout, the default sends the pings one after another with
+             *              singleShot().  A TTL may appear more than once in the list, each occurrence is sent as
+             *              its own ping.
+             *
+             * @note        This is a blocking function.
+             *
+             * @param[in]   hostAddress the target host address.
+             * @param[in]   ttls the time to live of each ping.
+             * @param[in]   timeout time in seconds to wait for the responses.
+             * @param[in]   resultFunction if set, called with the index of the TTL and its result as each
+             *              result becomes available.
+             *
+             * @returns     the result for each TTL, in the order of ttls.
+             */
+            virtual auto multiShot(
+                QHostAddress hostAddress,
+                QVector<int> ttls,
+                double timeout,
+                std::function<void(int, const Nedrysoft::RouteAnalyser::PingResult &)> resultFunction = nullptr
+            ) -> QVector<Nedrysoft::RouteAnalyser::PingResult> {
+
+                QVector<Nedrysoft::RouteAnalyser::PingResult> results;
+
+                for (auto index = 0; index < ttls.count(); index++) {
+                    results.append(singleShot(hostAddress, ttls.at(index), timeout));
+
+                    if (resultFunction) {
+                        resultFunction(index, results.last());
+                    }
+                }
+
+                return results;
+            }
+
+            /**
+             * @brief       Returns whether multiShot() sends the pings together.
+             *
+             * @details     Engines that override multiShot() to answer every TTL within one timeout should
+             *              also override this, callers use it to decide whether extra pings are affordable.
+             *
+             * @returns     true if the pings are sent together; otherwise false.
+             */
+            virtual auto hasParallelMultiShot() -> bool {
+                return false;
+            }
+
             /**
              * @brief       Removes a ping target from this engine instance.
              *
@@ -154,10 +207,47 @@ namespace Nedrysoft { namespace RouteAnalyser {
             /**
              * @brief       Signal emitted to indicate the state of a ping request.
              *
+             * @details     Engines may record results on their receive path as a PingResultRecord instead, such
+             *              results are only delivered by resultsReady().
+             *
              * @param[in]   result the result of a ping request.
              */
             Q_SIGNAL void result(Nedrysoft::RouteAnalyser::PingResult result);
 
+            /**
+             * @brief       Signal emitted with a batch of ping results.
+             *
+             * @details     Every result of the engine, including those that are emitted by result(), is delivered in
+             *              a batch on the thread of the engine.  Receivers that update a view should use batches so that they can apply a
+             *              whole round of results in one pass rather than being called for each result.
+             *
+             * @see         Nedrysoft::RouteAnalyser::IPingEngine::setResultBatching
+             *
+             * @param[in]   results the results in the order that they were produced.
+             */
+            Q_SIGNAL void resultsReady(QVector<Nedrysoft::RouteAnalyser::PingResult> results);
+
+            /**
+             * @brief       Sets when a batch of results is delivered by resultsReady().
+             *
+             * @param[in]   interval the longest time in milliseconds that a result waits for its batch to be
+             *              delivered.
+             * @param[in]   batchSize the number of results after which a batch is delivered without waiting.
+             *
+             * @returns     true on success; otherwise false.
+             */
+            virtual auto setResultBatching(int interval, int batchSize) -> bool = 0;
+
+            /**
+             * @brief       Returns a snapshot of the engine counters.
+             *
+             * @details     The counters are updated without locks by the threads of the engine, so this may be called
+             *              from any thread, for example by a timer in the GUI thread.
+             *
+             * @returns     the metrics of the engine.
+             */
+            virtual auto metrics() -> Nedrysoft::RouteAnalyser::PingEngineMetrics = 0;
+
             /**
              * @brief       Returns the list of ping targets for the engine.
              *
@@ -52,7 +52,7 @@ namespace Nedrysoft { namespace RouteAnalyser {
 
             /**
              * @brief       Updates the plot with a new result.
-             * @param[in]   time the unix timestamp for this result.
+             * @param[in]   time the unix timestamp for this result in seconds, including the fractional part.
              * @param[in]   value the round trip time.
              */
             virtual auto update(double time, double value) -> void = 0;
@@ -24,6 +24,7 @@
 #ifndef PINGNOO_COMPONENTS_ROUTEANALYSER_IROUTEENGINE_H
 #define PINGNOO_COMPONENTS_ROUTEANALYSER_IROUTEENGINE_H
 
+#include "HopResponders.h"
 #include "RouteAnalyserSpec.h"
 
 #include <ICore>
@@ -33,6 +34,7 @@
 
 namespace Nedrysoft { namespace RouteAnalyser {
     typedef QList<QHostAddress> RouteList;
+    typedef QList<Nedrysoft::RouteAnalyser::HopResponders> RouteResponders;
     class IPingEngineFactory;
 
     /**
@@ -69,11 +71,30 @@ namespace Nedrysoft { namespace RouteAnalyser {
                     QString host,
                     Nedrysoft::Core::IPVersion ipVersion ) -> void = 0;
 
+            /**
+             * @brief       Sets how often the route is discovered again once it has been found.
+             *
+             * @details     changes found by rediscovery are reported with the routeUpdated signal.
+             *
+             * @param[in]   interval the interval in seconds, 0 disables rediscovery.
+             */
+            virtual auto setRediscoveryInterval(int interval) -> void = 0;
+
+            /**
+             * @brief       Requests that the route is discovered again as soon as possible.
+             *
+             * @details     used when a change in the route is suspected, for example when a hop is answered by
+             *              a router that has not been seen before.  The engine may ignore the request if a
+             *              discovery has been made recently.
+             */
+            virtual auto refreshRoute() -> void = 0;
+
             /**
              * @brief       Signal emitted when the route discovery is completed.
              *
              * @param[in]   hostAddress the address of the host that was the target.
              * @param[in]   result the discovered route to the host.
+             * @param[in]   responders the routers that answered at each hop of the route.
              * @param[in]   completed is true if the route has been discovered; otherwise false.
              * @param[in]   totalHops is the number of hops to the target if available; otheerwise false.
              * @param[in]   maximumHops is the maximum number of hops to consider, if the TTL exceeds this then
@@ -82,10 +103,28 @@ namespace Nedrysoft { namespace RouteAnalyser {
             Q_SIGNAL void result(
                 const QHostAddress hostAddress,
                 const Nedrysoft::RouteAnalyser::RouteList result,
+                const Nedrysoft::RouteAnalyser::RouteResponders responders,
                 const bool completed,
                 const int totalHops,
                 const int maximumHops
             );
+
+            /**
+             * @brief       Signal emitted when a route that has already been reported is discovered again.
+             *
+             * @details     a route loaded from the route cache is reported immediately and then verified by a
+             *              discovery run, the verified route is reported with this signal so that the analysis
+             *              can be corrected without being restarted.
+             *
+             * @param[in]   hostAddress the address of the host that was the target.
+             * @param[in]   result the rediscovered route to the host.
+             * @param[in]   responders the routers that answered at each hop of the route.
+             */
+            Q_SIGNAL void routeUpdated(
+                const QHostAddress hostAddress,
+                const Nedrysoft::RouteAnalyser::RouteList result,
+                const Nedrysoft::RouteAnalyser::RouteResponders responders
+            );
     };
 }}
 
@@ -27,6 +27,7 @@
 #include "FavouritesManagerDialog.h"
 #include "IPingEngineFactory.h"
 #include "OpenFavouriteDialog.h"
+#include "RouteAnalyserConstants.h"
 #include "RouteAnalyserEditor.h"
 #include "TargetManager.h"
 #include "TargetSettings.h" // TODO: what to do about this?  Separate library I guess...
@@ -138,7 +139,13 @@ Nedrysoft::RouteAnalyser::NewTargetRibbonGroup::NewTargetRibbonGroup(QWidget *pa
     });
 
     m_intervalHighlighter = new LineSyntaxHighlighter(ui->intervalLineEdit->document(), [=](const QString &text) {
-        return Nedrysoft::Utils::parseIntervalString(text);
+        double intervalValue;
+
+        if (!Nedrysoft::Utils::parseIntervalString(text, intervalValue)) {
+            return false;
+        }
+
+        return intervalValue * MillisecondsPerSecond >= Nedrysoft::RouteAnalyser::Constants::MinimumPingInterval;
     });
 
     m_targetHighlighter = new LineSyntaxHighlighter(ui->targetLineEdit->document(), [=](const QString &text) {
@@ -374,7 +381,9 @@ auto Nedrysoft::RouteAnalyser::NewTargetRibbonGroup::checkFieldsValid(QString &s
         returnWidget = ui->targetLineEdit;
     }
 
-    if (!Nedrysoft::Utils::parseIntervalString(interval, intervalValue)) {
+    if (( !Nedrysoft::Utils::parseIntervalString(interval, intervalValue) ) ||
+        ( intervalValue * MillisecondsPerSecond < Nedrysoft::RouteAnalyser::Constants::MinimumPingInterval )) {
+
         if (!returnWidget) {
             returnWidget = ui->intervalLineEdit;
         }
@@ -47,7 +47,8 @@ Nedrysoft::RouteAnalyser::PingData::PingData(QStandardItemModel *tableModel, int
         m_maximumLatency(-1),
         m_minimumLatency(-1),
         m_averageLatency(-1),
-        m_historicalLatency(-1) {
+        m_historicalLatency(-1),
+        m_timestampSource(Nedrysoft::RouteAnalyser::PingResult::TimestampSource::User) {
 }
 
 auto Nedrysoft::RouteAnalyser::PingData::runningAverage(double previousAverage, double value, double n) -> double {
@@ -126,6 +127,29 @@ auto Nedrysoft::RouteAnalyser::PingData::hostName() -> QString {
     return m_hostName;
 }
 
+auto Nedrysoft::RouteAnalyser::PingData::timestampSource() -> Nedrysoft::RouteAnalyser::PingResult::TimestampSource {
+    return m_timestampSource;
+}
+
+auto Nedrysoft::RouteAnalyser::PingData::responders() -> const Nedrysoft::RouteAnalyser::HopResponders & {
+    return m_responders;
+}
+
+auto Nedrysoft::RouteAnalyser::PingData::addResponders(
+        const Nedrysoft::RouteAnalyser::HopResponders &responders) -> void {
+
+    m_responders.merge(responders);
+    m_discoveredResponders.merge(responders);
+
+    if (m_tableModel) {
+        updateModel();
+    }
+}
+
+auto Nedrysoft::RouteAnalyser::PingData::discoveredResponders() -> const Nedrysoft::RouteAnalyser::HopResponders & {
+    return m_discoveredResponders;
+}
+
 auto Nedrysoft::RouteAnalyser::PingData::packetLoss() -> double {
     if (m_replyPacketCount+m_timeoutPacketCount==0) {
         return -1;
@@ -149,6 +173,11 @@ auto Nedrysoft::RouteAnalyser::PingData::updateItem(Nedrysoft::RouteAnalyser::Pi
     }
 
     m_currentLatency = result.roundTripTime();
+    m_timestampSource = result.timestampSource();
+
+    // on a load balanced path the samples of a hop are answered by different routers, each is tracked separately.
+
+    m_responders.addSample(result.hostAddress(), m_currentLatency);
 
     if (m_minimumLatency < 0) {
         m_minimumLatency = m_currentLatency;
@@ -202,7 +231,7 @@ auto Nedrysoft::RouteAnalyser::PingData::updateItem(Nedrysoft::RouteAnalyser::Pi
                 static_cast<double>(m_replyPacketCount+m_timeoutPacketCount))*100.0;*/
 
     for (auto plot : m_plots) {
-        plot->update(result.requestTime().toMSecsSinceEpoch(), result.roundTripTime());
+        plot->update(result.requestTimeSeconds(), result.roundTripTime());
     }
 
     if (m_tableModel) {
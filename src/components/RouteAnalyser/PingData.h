@@ -24,6 +24,7 @@
 #ifndef PINGNOO_COMPONENTS_ROUTEANALYSER_PINGDATA_H
 #define PINGNOO_COMPONENTS_ROUTEANALYSER_PINGDATA_H
 
+#include "HopResponders.h"
 #include "PingResult.h"
 
 #include <QPersistentModelIndex>
@@ -245,6 +246,34 @@ namespace Nedrysoft { namespace RouteAnalyser {
              */
             auto packetLoss() -> double;
 
+            /**
+             * @brief       Returns the source of the timestamps used for the most recent latency measurement.
+             *
+             * @returns     the timestamp source.
+             */
+            auto timestampSource() -> Nedrysoft::RouteAnalyser::PingResult::TimestampSource;
+
+            /**
+             * @brief       Returns the routers that have answered for this hop.
+             *
+             * @returns     the responders.
+             */
+            auto responders() -> const Nedrysoft::RouteAnalyser::HopResponders &;
+
+            /**
+             * @brief       Adds routers found for this hop during route discovery.
+             *
+             * @param[in]   responders the responders to add.
+             */
+            auto addResponders(const Nedrysoft::RouteAnalyser::HopResponders &responders) -> void;
+
+            /**
+             * @brief       Returns the routers that route discovery has found for this hop.
+             *
+             * @returns     the responders.
+             */
+            auto discoveredResponders() -> const Nedrysoft::RouteAnalyser::HopResponders &;
+
             /**
              * @brief       Sets the plots associated with this.
              *
@@ -336,6 +365,11 @@ namespace Nedrysoft { namespace RouteAnalyser {
             double m_averageLatency;
             double m_historicalLatency;
 
+            Nedrysoft::RouteAnalyser::PingResult::TimestampSource m_timestampSource;
+
+            Nedrysoft::RouteAnalyser::HopResponders m_responders;
+            Nedrysoft::RouteAnalyser::HopResponders m_discoveredResponders;
+
             QMap<Fields, bool> m_isMaximum;
 
             QList<Nedrysoft::RouteAnalyser::IPlot *> m_plots;
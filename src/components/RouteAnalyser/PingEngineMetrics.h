@@ -0,0 +1,380 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 18/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PINGNOO_COMPONENTS_ROUTEANALYSER_PINGENGINEMETRICS_H
+#define PINGNOO_COMPONENTS_ROUTEANALYSER_PINGENGINEMETRICS_H
+
+#include <array>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+
+namespace Nedrysoft { namespace RouteAnalyser {
+    /**
+     * @brief       The PingEngineMetrics structure holds a snapshot of the counters of a ping engine.
+     *
+     * @details     Counters that an engine cannot measure are left at 0, the values are approximate while the
+     *              engine is running as the counters are not read together.
+     */
+    struct PingEngineMetrics {
+        uint64_t probesSent;                /**< the number of echo requests passed to the socket. */
+        uint64_t sendErrors;                /**< the number of echo requests that could not be sent. */
+        uint64_t repliesMatched;            /**< the number of replies matched to an outstanding request. */
+        uint64_t unmatchedPackets;          /**< replies for this engine that matched no request. */
+        uint64_t foreignPackets;            /**< ICMP packets received that were not for any engine. */
+        uint64_t lateReplies;               /**< replies that arrived after their request timed out. */
+        uint64_t timeouts;                  /**< the number of requests that timed out. */
+        int64_t inFlight;                   /**< the number of requests waiting for a reply. */
+        uint64_t receiveDrops;              /**< packets dropped by the kernel because the socket queue was full. */
+        int64_t latenessMedian;             /**< the median send scheduling lateness in nanoseconds. */
+        int64_t latenessP90;                /**< the 90th percentile send scheduling lateness in nanoseconds. */
+        int64_t latenessP99;                /**< the 99th percentile send scheduling lateness in nanoseconds. */
+        int64_t latenessMaximum;            /**< the largest send scheduling lateness in nanoseconds. */
+    };
+
+    /**
+     * @brief       The PingEngineCounters class holds the counters that a ping engine updates as it runs.
+     *
+     * @details     Every counter is an atomic that is updated with relaxed ordering, so the counters can be updated
+     *              from the transmit and receive threads of an engine and read by snapshot() from the GUI thread
+     *              without taking a lock.
+     *
+     *              Send scheduling lateness is recorded in a log-linear histogram with 8 buckets per power of two,
+     *              percentiles are reported as the upper bound of their bucket and so are within 12.5%.
+     *
+     *              Late replies are detected by remembering the keys of recently timed out requests in a direct
+     *              mapped table, a reply that matches no request is counted as late if its key is in the table.
+     */
+    class PingEngineCounters {
+        public:
+            /**
+             * @brief       The number of timed out request keys remembered for late reply detection.
+             */
+            static constexpr int ExpiredKeyCount = 4096;
+
+        private:
+            static constexpr int SubBucketBits = 3;
+            static constexpr int SubBucketCount = 1 << SubBucketBits;
+            static constexpr int MaximumBucketBit = 40;
+            static constexpr int BucketCount = ( MaximumBucketBit - SubBucketBits + 2 ) * SubBucketCount;
+
+        public:
+            /**
+             * @brief       Constructs a PingEngineCounters with cleared counters.
+             */
+            PingEngineCounters() :
+                    m_probesSent(0),
+                    m_sendErrors(0),
+                    m_repliesMatched(0),
+                    m_unmatchedPackets(0),
+                    m_foreignPackets(0),
+                    m_lateReplies(0),
+                    m_timeouts(0),
+                    m_inFlight(0),
+                    m_receiveDrops(0),
+                    m_latenessMaximum(0) {
+
+                for (auto &bucket : m_latenessBuckets) {
+                    bucket.store(0, std::memory_order_relaxed);
+                }
+
+                for (auto &key : m_expiredKeys) {
+                    key.store(0, std::memory_order_relaxed);
+                }
+            }
+
+            PingEngineCounters(const PingEngineCounters &) = delete;
+            PingEngineCounters &operator=(const PingEngineCounters &) = delete;
+
+            /**
+             * @brief       Counts echo requests that were passed to the socket.
+             *
+             * @param[in]   count the number of requests.
+             */
+            auto addProbesSent(uint64_t count = 1) -> void {
+                m_probesSent.fetch_add(count, std::memory_order_relaxed);
+            }
+
+            /**
+             * @brief       Counts echo requests that could not be sent.
+             *
+             * @param[in]   count the number of requests.
+             */
+            auto addSendErrors(uint64_t count = 1) -> void {
+                m_sendErrors.fetch_add(count, std::memory_order_relaxed);
+            }
+
+            /**
+             * @brief       Counts a request that is now waiting for a reply.
+             */
+            auto addRequest() -> void {
+                m_inFlight.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            /**
+             * @brief       Counts a reply that was matched to its request.
+             */
+            auto addReply() -> void {
+                m_repliesMatched.fetch_add(1, std::memory_order_relaxed);
+                m_inFlight.fetch_sub(1, std::memory_order_relaxed);
+            }
+
+            /**
+             * @brief       Counts a request that timed out and remembers its key.
+             *
+             * @param[in]   key the key that the request was tracked with.
+             */
+            auto addTimeout(uint32_t key) -> void {
+                m_timeouts.fetch_add(1, std::memory_order_relaxed);
+                m_inFlight.fetch_sub(1, std::memory_order_relaxed);
+
+                m_expiredKeys[key % ExpiredKeyCount].store(key, std::memory_order_relaxed);
+            }
+
+            /**
+             * @brief       Removes requests that were discarded without a reply or timeout.
+             *
+             * @param[in]   count the number of requests.
+             */
+            auto cancelRequests(int64_t count) -> void {
+                m_inFlight.fetch_sub(count, std::memory_order_relaxed);
+            }
+
+            /**
+             * @brief       Counts a reply for this engine that did not match an outstanding request.
+             *
+             * @details     The reply is counted as late if its request timed out recently, a second reply with the
+             *              same key is counted as unmatched.
+             *
+             * @param[in]   key the key of the reply.
+             */
+            auto addUnmatchedReply(uint32_t key) -> void {
+                auto expiredKey = key;
+
+                if (( key != 0 ) &&
+                    ( m_expiredKeys[key % ExpiredKeyCount].compare_exchange_strong(
+                        expiredKey,
+                        0,
+                        std::memory_order_relaxed ) )) {
+
+                    m_lateReplies.fetch_add(1, std::memory_order_relaxed);
+                } else {
+                    m_unmatchedPackets.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+
+            /**
+             * @brief       Counts a received packet that was not for any engine.
+             */
+            auto addForeignPacket() -> void {
+                m_foreignPackets.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            /**
+             * @brief       Counts packets that the kernel dropped from the receive queue.
+             *
+             * @param[in]   count the number of packets.
+             */
+            auto addReceiveDrops(uint64_t count) -> void {
+                m_receiveDrops.fetch_add(count, std::memory_order_relaxed);
+            }
+
+            /**
+             * @brief       Records the send scheduling lateness of a probe.
+             *
+             * @param[in]   lateness the time in nanoseconds between the scheduled and actual transmit time.
+             */
+            auto addLateness(int64_t lateness) -> void {
+                if (lateness < 0) {
+                    lateness = 0;
+                }
+
+                m_latenessBuckets[bucketIndex(static_cast<uint64_t>(lateness))].fetch_add(1, std::memory_order_relaxed);
+
+                auto maximumLateness = m_latenessMaximum.load(std::memory_order_relaxed);
+
+                while (lateness > maximumLateness) {
+                    if (m_latenessMaximum.compare_exchange_weak(
+                            maximumLateness,
+                            lateness,
+                            std::memory_order_relaxed )) {
+
+                        break;
+                    }
+                }
+            }
+
+            /**
+             * @brief       Returns a snapshot of the counters.
+             *
+             * @returns     the metrics.
+             */
+            auto snapshot() const -> Nedrysoft::RouteAnalyser::PingEngineMetrics {
+                std::array<uint64_t, BucketCount> buckets;
+                uint64_t total = 0;
+
+                for (auto index = 0; index < BucketCount; index++) {
+                    buckets[index] = m_latenessBuckets[index].load(std::memory_order_relaxed);
+
+                    total += buckets[index];
+                }
+
+                auto latenessMaximum = m_latenessMaximum.load(std::memory_order_relaxed);
+
+                return Nedrysoft::RouteAnalyser::PingEngineMetrics {
+                    m_probesSent.load(std::memory_order_relaxed),
+                    m_sendErrors.load(std::memory_order_relaxed),
+                    m_repliesMatched.load(std::memory_order_relaxed),
+                    m_unmatchedPackets.load(std::memory_order_relaxed),
+                    m_foreignPackets.load(std::memory_order_relaxed),
+                    m_lateReplies.load(std::memory_order_relaxed),
+                    m_timeouts.load(std::memory_order_relaxed),
+                    m_inFlight.load(std::memory_order_relaxed),
+                    m_receiveDrops.load(std::memory_order_relaxed),
+                    percentile(buckets, total, 50, latenessMaximum),
+                    percentile(buckets, total, 90, latenessMaximum),
+                    percentile(buckets, total, 99, latenessMaximum),
+                    latenessMaximum
+                };
+            }
+
+        private:
+            /**
+             * @brief       Returns the position of the highest set bit of a value.
+             *
+             * @param[in]   value the value, must not be 0.
+             *
+             * @returns     the bit position.
+             */
+            static constexpr auto highestBit(uint64_t value) -> int {
+                auto bit = 0;
+
+                for (auto shift = 32; shift > 0; shift /= 2) {
+                    if (value >> shift) {
+                        value >>= shift;
+                        bit += shift;
+                    }
+                }
+
+                return bit;
+            }
+
+            /**
+             * @brief       Returns the histogram bucket of a lateness.
+             *
+             * @details     Values below SubBucketCount have a bucket each, above that every power of two is split
+             *              into SubBucketCount buckets.  Values beyond the range are counted in the last bucket.
+             *
+             * @param[in]   value the lateness in nanoseconds.
+             *
+             * @returns     the bucket index.
+             */
+            static constexpr auto bucketIndex(uint64_t value) -> int {
+                if (value < SubBucketCount) {
+                    return static_cast<int>(value);
+                }
+
+                auto bit = highestBit(value);
+
+                if (bit > MaximumBucketBit) {
+                    return BucketCount - 1;
+                }
+
+                return ( bit - SubBucketBits + 1 ) * SubBucketCount +
+                       static_cast<int>(( value >> ( bit - SubBucketBits ) ) & ( SubBucketCount - 1 ));
+            }
+
+            /**
+             * @brief       Returns the largest value that is counted in a bucket.
+             *
+             * @param[in]   index the bucket index.
+             *
+             * @returns     the upper bound in nanoseconds.
+             */
+            static constexpr auto bucketUpperBound(int index) -> int64_t {
+                if (index < SubBucketCount) {
+                    return index;
+                }
+
+                auto bit = index / SubBucketCount + SubBucketBits - 1;
+                auto width = INT64_C(1) << ( bit - SubBucketBits );
+
+                return ( ( SubBucketCount + index % SubBucketCount ) * width ) + width - 1;
+            }
+
+            /**
+             * @brief       Returns a percentile of the lateness histogram.
+             *
+             * @param[in]   buckets the bucket counts.
+             * @param[in]   total the sum of the bucket counts.
+             * @param[in]   percent the percentile.
+             * @param[in]   maximum the largest recorded value, the result is never larger.
+             *
+             * @returns     the percentile in nanoseconds; 0 if nothing has been recorded.
+             */
+            static auto percentile(
+                    const std::array<uint64_t, BucketCount> &buckets,
+                    uint64_t total,
+                    int percent,
+                    int64_t maximum) -> int64_t {
+
+                if (!total) {
+                    return 0;
+                }
+
+                auto rank = ( total * static_cast<uint64_t>(percent) + 99 ) / 100;
+                uint64_t count = 0;
+
+                for (auto index = 0; index < BucketCount; index++) {
+                    count += buckets[index];
+
+                    if (count >= rank) {
+                        return std::min(bucketUpperBound(index), maximum);
+                    }
+                }
+
+                return maximum;
+            }
+
+        private:
+            //! @cond
+
+            std::atomic<uint64_t> m_probesSent;
+            std::atomic<uint64_t> m_sendErrors;
+            std::atomic<uint64_t> m_repliesMatched;
+            std::atomic<uint64_t> m_unmatchedPackets;
+            std::atomic<uint64_t> m_foreignPackets;
+            std::atomic<uint64_t> m_lateReplies;
+            std::atomic<uint64_t> m_timeouts;
+            std::atomic<int64_t> m_inFlight;
+            std::atomic<uint64_t> m_receiveDrops;
+            std::atomic<int64_t> m_latenessMaximum;
+
+            std::array<std::atomic<uint64_t>, BucketCount> m_latenessBuckets;
+            std::array<std::atomic<uint32_t>, ExpiredKeyCount> m_expiredKeys;
+
+            //! @endcond
+    };
+}}
+
+#endif // PINGNOO_COMPONENTS_ROUTEANALYSER_PINGENGINEMETRICS_H
@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 18/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PingEngineMetricsWidget.h"
+
+#include "IPingEngine.h"
+
+#include <QGridLayout>
+#include <QLabel>
+#include <QTimer>
+
+constexpr auto UpdateInterval = 1000;
+constexpr auto ValuesPerRow = 5;
+constexpr auto NanosecondsInMillisecond = 1000000.0;
+
+Nedrysoft::RouteAnalyser::PingEngineMetricsWidget::PingEngineMetricsWidget(QWidget *parent) :
+        QWidget(parent),
+        m_updateTimer(new QTimer(this)) {
+
+    auto gridLayout = new QGridLayout();
+
+    setLayout(gridLayout);
+
+    m_probesSentLabel = addValue(tr("Probes Sent"), 0);
+    m_sendErrorsLabel = addValue(tr("Send Errors"), 1);
+    m_repliesMatchedLabel = addValue(tr("Replies"), 2);
+    m_timeoutsLabel = addValue(tr("Timeouts"), 3);
+    m_inFlightLabel = addValue(tr("In Flight"), 4);
+    m_lateRepliesLabel = addValue(tr("Late Replies"), 5);
+    m_unmatchedPacketsLabel = addValue(tr("Unmatched"), 6);
+    m_foreignPacketsLabel = addValue(tr("Foreign"), 7);
+    m_receiveDropsLabel = addValue(tr("Receive Drops"), 8);
+    m_latenessLabel = addValue(tr("Send Lateness (p50/p90/p99/max)"), 9);
+
+    m_updateTimer->setInterval(UpdateInterval);
+
+    connect(m_updateTimer, &QTimer::timeout, this, &PingEngineMetricsWidget::updateMetrics);
+}
+
+Nedrysoft::RouteAnalyser::PingEngineMetricsWidget::~PingEngineMetricsWidget() = default;
+
+auto Nedrysoft::RouteAnalyser::PingEngineMetricsWidget::setEngine(Nedrysoft::RouteAnalyser::IPingEngine *engine) -> void {
+    m_engine = engine;
+
+    if (!engine) {
+        m_updateTimer->stop();
+
+        return;
+    }
+
+    updateMetrics();
+
+    m_updateTimer->start();
+}
+
+auto Nedrysoft::RouteAnalyser::PingEngineMetricsWidget::addValue(const QString &name, int index) -> QLabel * {
+    auto gridLayout = qobject_cast<QGridLayout *>(layout());
+    auto nameLabel = new QLabel(name + ":");
+    auto valueLabel = new QLabel();
+
+    valueLabel->setTextInteractionFlags(Qt::TextSelectableByMouse);
+
+    auto row = index / ValuesPerRow;
+    auto column = ( index % ValuesPerRow ) * 2;
+
+    gridLayout->addWidget(nameLabel, row, column, Qt::AlignRight);
+    gridLayout->addWidget(valueLabel, row, column + 1, Qt::AlignLeft);
+
+    return valueLabel;
+}
+
+auto Nedrysoft::RouteAnalyser::PingEngineMetricsWidget::updateMetrics() -> void {
+    if (!m_engine) {
+        m_updateTimer->stop();
+
+        return;
+    }
+
+    auto metrics = m_engine->metrics();
+
+    auto milliseconds = [](int64_t nanoseconds) {
+        return QString::number(static_cast<double>(nanoseconds) / NanosecondsInMillisecond, 'f', 3);
+    };
+
+    m_probesSentLabel->setText(QString::number(metrics.probesSent));
+    m_sendErrorsLabel->setText(QString::number(metrics.sendErrors));
+    m_repliesMatchedLabel->setText(QString::number(metrics.repliesMatched));
+    m_timeoutsLabel->setText(QString::number(metrics.timeouts));
+    m_inFlightLabel->setText(QString::number(metrics.inFlight));
+    m_lateRepliesLabel->setText(QString::number(metrics.lateReplies));
+    m_unmatchedPacketsLabel->setText(QString::number(metrics.unmatchedPackets));
+    m_foreignPacketsLabel->setText(QString::number(metrics.foreignPackets));
+    m_receiveDropsLabel->setText(QString::number(metrics.receiveDrops));
+
+    m_latenessLabel->setText(QString(tr("%1/%2/%3/%4 ms"))
+        .arg(milliseconds(metrics.latenessMedian))
+        .arg(milliseconds(metrics.latenessP90))
+        .arg(milliseconds(metrics.latenessP99))
+        .arg(milliseconds(metrics.latenessMaximum)) );
+}
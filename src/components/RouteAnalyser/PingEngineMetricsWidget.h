@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 18/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PINGNOO_COMPONENTS_ROUTEANALYSER_PINGENGINEMETRICSWIDGET_H
+#define PINGNOO_COMPONENTS_ROUTEANALYSER_PINGENGINEMETRICSWIDGET_H
+
+#include <QPointer>
+#include <QWidget>
+
+class QLabel;
+class QTimer;
+
+namespace Nedrysoft { namespace RouteAnalyser {
+    class IPingEngine;
+
+    /**
+     * @brief       The PingEngineMetricsWidget shows the counters of a ping engine for diagnostics.
+     *
+     * @details     The metrics of the engine are read with a timer, the engine does not notify the widget so the
+     *              panel adds no cost to the ping threads.
+     */
+    class PingEngineMetricsWidget :
+            public QWidget {
+
+        private:
+            Q_OBJECT
+
+        public:
+            /**
+             * @brief       Constructs a new PingEngineMetricsWidget.
+             *
+             * @param[in]   parent the parent of this child widget.
+             */
+            explicit PingEngineMetricsWidget(QWidget *parent = nullptr);
+
+            /**
+             * @brief       Destroys the PingEngineMetricsWidget.
+             */
+            ~PingEngineMetricsWidget() override;
+
+            /**
+             * @brief       Sets the engine whose metrics are shown.
+             *
+             * @param[in]   engine the engine; nullptr to stop updating.
+             */
+            auto setEngine(Nedrysoft::RouteAnalyser::IPingEngine *engine) -> void;
+
+        private:
+            /**
+             * @brief       Reads the metrics of the engine and updates the labels.
+             */
+            auto updateMetrics() -> void;
+
+            /**
+             * @brief       Adds a named value to the panel.
+             *
+             * @param[in]   name the name of the value.
+             * @param[in]   index the position of the value in the panel.
+             *
+             * @returns     the label that shows the value.
+             */
+            auto addValue(const QString &name, int index) -> QLabel *;
+
+        private:
+            //! @cond
+
+            QPointer<Nedrysoft::RouteAnalyser::IPingEngine> m_engine;
+
+            QTimer *m_updateTimer;
+
+            QLabel *m_probesSentLabel;
+            QLabel *m_sendErrorsLabel;
+            QLabel *m_repliesMatchedLabel;
+            QLabel *m_timeoutsLabel;
+            QLabel *m_inFlightLabel;
+            QLabel *m_lateRepliesLabel;
+            QLabel *m_unmatchedPacketsLabel;
+            QLabel *m_foreignPacketsLabel;
+            QLabel *m_receiveDropsLabel;
+            QLabel *m_latenessLabel;
+
+            //! @endcond
+    };
+}}
+
+#endif // PINGNOO_COMPONENTS_ROUTEANALYSER_PINGENGINEMETRICSWIDGET_H
@@ -24,8 +24,6 @@
 #ifndef PINGNOO_COMPONENTS_ROUTEANALYSER_PINGRESULT_H
 #define PINGNOO_COMPONENTS_ROUTEANALYSER_PINGRESULT_H
 
-#include "RouteAnalyserSpec.h"
-
 #include <QDateTime>
 #include <QElapsedTimer>
 #include <QHostAddress>
@@ -41,7 +39,10 @@ namespace Nedrysoft { namespace RouteAnalyser {
      *
      * @class       Nedrysoft::RouteAnalyser::PingResult PingResult.h <PingResult>
      */
-    class NEDRYSOFT_ROUTEANALYSER_DLLSPEC PingResult {
+    class PingResult {
+        private:
+            static constexpr int64_t NanosecondsInMillisecond = 1000000;
+            static constexpr double NanosecondsInSecond = 1.0e9;
 
         public:
 
@@ -54,15 +55,34 @@ namespace Nedrysoft { namespace RouteAnalyser {
                 TimeExceeded
             };
 
+            /**
+             * @brief       The source of the timestamps used to calculate the round trip time.
+             */
+            enum class TimestampSource {
+                User,                       /**< transmit and receive times were taken by the application. */
+                KernelReceive,              /**< the receive time was taken by the kernel. */
+                Kernel                      /**< the transmit and receive times were taken by the kernel. */
+            };
+
             /**
              * @brief       Constructs a PingResult instance.
              */
-            PingResult();
+            PingResult() :
+                    m_sampleNumber(0),
+                    m_code(PingResult::ResultCode::NoReply),
+                    m_hostAddress(QHostAddress()),
+                    m_roundTripTime(-1),
+                    m_requestTime(0),
+                    m_target(nullptr),
+                    m_hops(-1),
+                    m_timestampSource(PingResult::TimestampSource::User) {
+
+            }
 
             /**
              * @brief       Destroys the PingResult.
              */
-            ~PingResult();
+            ~PingResult() = default;
 
             /**
              * @brief       Constructs a PingResult with parameters.
@@ -74,6 +94,7 @@ namespace Nedrysoft { namespace RouteAnalyser {
              * @param[in]   roundTripTime the time taken for the hop to respond.
              * @param[in]   target the target that was pinged.
              * @param[in]   hops the number of hops to the target if available; otherwise false.
+             * @param[in]   timestampSource the source of the timestamps used to calculate the round trip time.
              */
             PingResult(
                 unsigned long sampleNumber,
@@ -82,8 +103,52 @@ namespace Nedrysoft { namespace RouteAnalyser {
                 QDateTime requestTime,
                 double roundTripTime,
                 Nedrysoft::RouteAnalyser::IPingTarget *target,
-                int hops
-            );
+                int hops,
+                TimestampSource timestampSource = TimestampSource::User
+            ) :
+                    m_sampleNumber(sampleNumber),
+                    m_code(code),
+                    m_hostAddress(hostAddress),
+                    m_roundTripTime(roundTripTime),
+                    m_requestTime(requestTime.toMSecsSinceEpoch() * NanosecondsInMillisecond),
+                    m_target(target),
+                    m_hops(hops),
+                    m_timestampSource(timestampSource) {
+
+            }
+
+            /**
+             * @brief       Constructs a PingResult with a request time in nanoseconds.
+             *
+             * @param[in]   sampleNumber the count which this result is associated with.
+             * @param[in]   code the result code.
+             * @param[in]   hostAddress the IP address that responded to the request.
+             * @param[in]   requestTime the time the request was sent in nanoseconds since the unix epoch.
+             * @param[in]   roundTripTime the time taken for the hop to respond.
+             * @param[in]   target the target that was pinged.
+             * @param[in]   hops the number of hops to the target if available; otherwise false.
+             * @param[in]   timestampSource the source of the timestamps used to calculate the round trip time.
+             */
+            PingResult(
+                unsigned long sampleNumber,
+                ResultCode code,
+                const QHostAddress &hostAddress,
+                int64_t requestTime,
+                double roundTripTime,
+                Nedrysoft::RouteAnalyser::IPingTarget *target,
+                int hops,
+                TimestampSource timestampSource = TimestampSource::User
+            ) :
+                    m_sampleNumber(sampleNumber),
+                    m_code(code),
+                    m_hostAddress(hostAddress),
+                    m_roundTripTime(roundTripTime),
+                    m_requestTime(requestTime),
+                    m_target(target),
+                    m_hops(hops),
+                    m_timestampSource(timestampSource) {
+
+            }
 
         public:
 
@@ -92,21 +157,48 @@ namespace Nedrysoft { namespace RouteAnalyser {
              *
              * @returns     the sample number.
              */
-            auto sampleNumber() -> unsigned long;
+            auto sampleNumber() -> unsigned long {
+                return m_sampleNumber;
+            }
 
             /**
              * @brief       Returns the time that the request was transmitted at.
              *
              * @returns     the request time.
              */
-            auto requestTime() -> QDateTime;
+            auto requestTime() -> QDateTime {
+                return QDateTime::fromMSecsSinceEpoch(m_requestTime / NanosecondsInMillisecond);
+            }
+
+            /**
+             * @brief       Returns the time that the request was transmitted at with full resolution.
+             *
+             * @details     requestTime() is limited to millisecond resolution, results that are sent at a high rate
+             *              should be ordered and plotted using this value.
+             *
+             * @returns     the request time in nanoseconds since the unix epoch.
+             */
+            auto requestTimeNanoseconds() -> int64_t {
+                return m_requestTime;
+            }
+
+            /**
+             * @brief       Returns the time that the request was transmitted at as a plot coordinate.
+             *
+             * @returns     the request time in seconds since the unix epoch, including the fractional part.
+             */
+            auto requestTimeSeconds() -> double {
+                return static_cast<double>(m_requestTime) / NanosecondsInSecond;
+            }
 
             /**
              * @brief       The result code for the request (Echo Reply, Timeout).
              *
              * @returns     the result code.
              */
-            auto code() -> ResultCode;
+            auto code() -> ResultCode {
+                return m_code;
+            }
 
             /**
              * @brief       The host address of the reply.
@@ -117,7 +209,9 @@ namespace Nedrysoft { namespace RouteAnalyser {
              *
              * @returns     the IP address of the host that sent the reply..
              */
-            auto hostAddress() -> QHostAddress;
+            auto hostAddress() -> QHostAddress {
+                return m_hostAddress;
+            }
 
             /**
              * @brief       The round trip time.
@@ -126,21 +220,39 @@ namespace Nedrysoft { namespace RouteAnalyser {
              *
              * @returns     the round trip time in seconds.
              */
-            auto roundTripTime() -> double;
+            auto roundTripTime() -> double {
+                return m_roundTripTime;
+            }
 
             /**
              * @brief       The target associated with this result.
              *
              * @returns     the target.
              */
-            auto target() -> Nedrysoft::RouteAnalyser::IPingTarget *;
+            auto target() -> Nedrysoft::RouteAnalyser::IPingTarget * {
+                return m_target;
+            }
 
             /**
              * @brief       The number of hops to the target.
              *
              * @returns     The number of hops to the target if available; otherwise -1.
              */
-            auto hops() -> int;
+            auto hops() -> int {
+                return m_hops;
+            }
+
+            /**
+             * @brief       The source of the timestamps used to calculate the round trip time.
+             *
+             * @details     Kernel timestamps exclude the time taken for the application to be scheduled and process
+             *              the packet, so are more accurate than user timestamps.
+             *
+             * @returns     the timestamp source.
+             */
+            auto timestampSource() -> TimestampSource {
+                return m_timestampSource;
+            }
 
         protected:
             //! @cond
@@ -149,9 +261,10 @@ namespace Nedrysoft { namespace RouteAnalyser {
             PingResult::ResultCode m_code;
             QHostAddress m_hostAddress;
             double m_roundTripTime;
-            QDateTime m_requestTime;
+            int64_t m_requestTime;
             Nedrysoft::RouteAnalyser::IPingTarget *m_target;
             int m_hops;
+            PingResult::TimestampSource m_timestampSource;
 
             //! @endcond
     };
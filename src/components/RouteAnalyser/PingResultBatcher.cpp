@@ -0,0 +1,169 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 18/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "PingResultBatcher.h"
+
+#include <QMutexLocker>
+
+Nedrysoft::RouteAnalyser::PingResultBatcher::PingResultBatcher(QObject *parent) :
+        QObject(parent),
+        m_timer(new QTimer(this)),
+        m_interval(DefaultInterval),
+        m_batchSize(DefaultBatchSize),
+        m_isTimerPending(false),
+        m_isFlushPending(false) {
+
+    m_timer->setSingleShot(true);
+
+    connect(m_timer, &QTimer::timeout, this, &Nedrysoft::RouteAnalyser::PingResultBatcher::flush);
+}
+
+Nedrysoft::RouteAnalyser::PingResultBatcher::~PingResultBatcher() {
+    delete m_timer;
+}
+
+auto Nedrysoft::RouteAnalyser::PingResultBatcher::setInterval(int interval) -> void {
+    QMutexLocker locker(&m_mutex);
+
+    m_interval = qMax(interval, 0);
+}
+
+auto Nedrysoft::RouteAnalyser::PingResultBatcher::interval() -> int {
+    QMutexLocker locker(&m_mutex);
+
+    return m_interval;
+}
+
+auto Nedrysoft::RouteAnalyser::PingResultBatcher::setBatchSize(int batchSize) -> void {
+    QMutexLocker locker(&m_mutex);
+
+    m_batchSize = qMax(batchSize, 1);
+}
+
+auto Nedrysoft::RouteAnalyser::PingResultBatcher::batchSize() -> int {
+    QMutexLocker locker(&m_mutex);
+
+    return m_batchSize;
+}
+
+auto Nedrysoft::RouteAnalyser::PingResultBatcher::registerTarget(
+        Nedrysoft::RouteAnalyser::IPingTarget *target) -> uint32_t {
+
+    QMutexLocker locker(&m_mutex);
+
+    return targetIndex(target);
+}
+
+auto Nedrysoft::RouteAnalyser::PingResultBatcher::targetIndex(Nedrysoft::RouteAnalyser::IPingTarget *target) -> uint32_t {
+    if (!target) {
+        return Nedrysoft::RouteAnalyser::PingResultRecord::NoTarget;
+    }
+
+    auto targetIterator = m_targetIndexes.constFind(target);
+
+    if (targetIterator != m_targetIndexes.constEnd()) {
+        return targetIterator.value();
+    }
+
+    auto index = static_cast<uint32_t>(m_targets.count());
+
+    m_targets.append(target);
+    m_targetIndexes.insert(target, index);
+
+    return index;
+}
+
+auto Nedrysoft::RouteAnalyser::PingResultBatcher::addRecord(
+        const Nedrysoft::RouteAnalyser::PingResultRecord &record) -> void {
+
+    QMutexLocker locker(&m_mutex);
+
+    m_records.append(record);
+
+    scheduleFlush();
+}
+
+void Nedrysoft::RouteAnalyser::PingResultBatcher::addResult(Nedrysoft::RouteAnalyser::PingResult result) {
+    QMutexLocker locker(&m_mutex);
+
+    m_records.append(Nedrysoft::RouteAnalyser::PingResultRecord::fromPingResult(result, targetIndex(result.target())));
+
+    scheduleFlush();
+}
+
+auto Nedrysoft::RouteAnalyser::PingResultBatcher::scheduleFlush() -> void {
+    // the timer can only be started on the thread of the batcher, so it is started by a queued call when the first
+    // result of a batch arrives, a full batch posts a single flush.
+
+    if (( m_records.count() >= m_batchSize ) || ( m_interval == 0 )) {
+        if (!m_isFlushPending) {
+            m_isFlushPending = true;
+
+            QMetaObject::invokeMethod(this, "flush", Qt::QueuedConnection);
+        }
+    } else if (!m_isTimerPending) {
+        m_isTimerPending = true;
+
+        QMetaObject::invokeMethod(m_timer, "start", Qt::QueuedConnection, Q_ARG(int, m_interval));
+    }
+}
+
+void Nedrysoft::RouteAnalyser::PingResultBatcher::flush() {
+    QVector<Nedrysoft::RouteAnalyser::PingResultRecord> records;
+    QVector<Nedrysoft::RouteAnalyser::IPingTarget *> targets;
+
+    {
+        QMutexLocker locker(&m_mutex);
+
+        records.swap(m_records);
+
+        m_records.reserve(m_batchSize);
+
+        targets = m_targets;
+
+        m_isFlushPending = false;
+        m_isTimerPending = false;
+    }
+
+    m_timer->stop();
+
+    if (records.isEmpty()) {
+        return;
+    }
+
+    // the records are converted on the thread of the batcher, outside of the lock.
+
+    QVector<Nedrysoft::RouteAnalyser::PingResult> results;
+
+    results.reserve(records.count());
+
+    for (const auto &record : records) {
+        auto target = ( record.targetIndex < static_cast<uint32_t>(targets.count()) ) ?
+            targets.at(static_cast<int>(record.targetIndex)) : nullptr;
+
+        results.append(record.toPingResult(target));
+    }
+
+    Q_EMIT resultsReady(results);
+}
@@ -0,0 +1,200 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 18/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef PINGNOO_COMPONENTS_ROUTEANALYSER_PINGRESULTBATCHER_H
+#define PINGNOO_COMPONENTS_ROUTEANALYSER_PINGRESULTBATCHER_H
+
+#include "PingResult.h"
+#include "PingResultRecord.h"
+#include "RouteAnalyserSpec.h"
+
+#include <QHash>
+#include <QMutex>
+#include <QObject>
+#include <QTimer>
+#include <QVector>
+
+namespace Nedrysoft { namespace RouteAnalyser {
+    /**
+     * @brief       The PingResultBatcher class collects ping results and delivers them in batches.
+     *
+     * @details     Results may be added from any thread, they are appended to a list under a lock rather than
+     *              being posted to the thread of the receiver one at a time.  The list is delivered by the
+     *              resultsReady signal on the thread of the batcher, either once the interval has passed since
+     *              the first result of the batch was added or as soon as the batch reaches its maximum size,
+     *              so at most one event is posted per batch.
+     *
+     *              Results are held as PingResultRecord instances and only converted to PingResult when the batch
+     *              is delivered, an engine can add records directly from its receive path so that no Qt types are
+     *              constructed for each packet.  Targets are referred to by the index returned by registerTarget().
+     *
+     *              Ping engines use a batcher to implement Nedrysoft::RouteAnalyser::IPingEngine::resultsReady.
+     *
+     * @class       Nedrysoft::RouteAnalyser::PingResultBatcher PingResultBatcher.h <PingResultBatcher>
+     */
+    class NEDRYSOFT_ROUTEANALYSER_DLLSPEC PingResultBatcher :
+            public QObject {
+
+        private:
+            Q_OBJECT
+
+        public:
+            /**
+             * @brief       The default time between the first result of a batch and its delivery, in milliseconds.
+             */
+            static constexpr int DefaultInterval = 100;
+
+            /**
+             * @brief       The default number of results after which a batch is delivered immediately.
+             */
+            static constexpr int DefaultBatchSize = 128;
+
+        public:
+            /**
+             * @brief       Constructs a new PingResultBatcher.
+             *
+             * @param[in]   parent the parent object, batches are delivered on the thread of the batcher.
+             */
+            explicit PingResultBatcher(QObject *parent = nullptr);
+
+            /**
+             * @brief       Destroys the PingResultBatcher.
+             *
+             * @note        Results that have not been delivered are discarded.
+             */
+            ~PingResultBatcher();
+
+            /**
+             * @brief       Sets how long a result may wait before its batch is delivered.
+             *
+             * @param[in]   interval the interval in milliseconds, 0 delivers each batch as soon as the event loop
+             *              of the batcher runs.
+             */
+            auto setInterval(int interval) -> void;
+
+            /**
+             * @brief       Returns the delivery interval.
+             *
+             * @returns     the interval in milliseconds.
+             */
+            auto interval() -> int;
+
+            /**
+             * @brief       Sets the number of results after which a batch is delivered without waiting.
+             *
+             * @param[in]   batchSize the maximum number of results in a batch.
+             */
+            auto setBatchSize(int batchSize) -> void;
+
+            /**
+             * @brief       Returns the maximum number of results in a batch.
+             *
+             * @returns     the batch size.
+             */
+            auto batchSize() -> int;
+
+            /**
+             * @brief       Registers a target and returns the index that records use to refer to it.
+             *
+             * @details     Registering a target that is already registered returns its existing index.
+             *
+             * @note        This function is thread safe.
+             *
+             * @param[in]   target the target.
+             *
+             * @returns     the index of the target.
+             */
+            auto registerTarget(Nedrysoft::RouteAnalyser::IPingTarget *target) -> uint32_t;
+
+            /**
+             * @brief       Adds a record to the current batch.
+             *
+             * @note        This function is thread safe.
+             *
+             * @param[in]   record the record, its target index must have been returned by registerTarget().
+             */
+            auto addRecord(const Nedrysoft::RouteAnalyser::PingResultRecord &record) -> void;
+
+            /**
+             * @brief       Adds a result to the current batch.
+             *
+             * @details     The target of the result is registered if it has not been already.
+             *
+             * @note        This function is thread safe.
+             *
+             * @param[in]   result the result.
+             */
+            Q_SLOT void addResult(Nedrysoft::RouteAnalyser::PingResult result);
+
+            /**
+             * @brief       Delivers the current batch.
+             *
+             * @details     Does nothing if no results are waiting.  Must be called on the thread of the batcher.
+             */
+            Q_SLOT void flush();
+
+        public:
+            /**
+             * @brief       This signal is emitted with a batch of results.
+             *
+             * @param[in]   results the results in the order that they were added.
+             */
+            Q_SIGNAL void resultsReady(QVector<Nedrysoft::RouteAnalyser::PingResult> results);
+
+        private:
+            /**
+             * @brief       Schedules the delivery of the current batch, the mutex must be held.
+             */
+            auto scheduleFlush() -> void;
+
+            /**
+             * @brief       Returns the index of a target, registering it if required, the mutex must be held.
+             *
+             * @param[in]   target the target.
+             *
+             * @returns     the index; NoTarget if target is nullptr.
+             */
+            auto targetIndex(Nedrysoft::RouteAnalyser::IPingTarget *target) -> uint32_t;
+
+        private:
+            //! @cond
+
+            QTimer *m_timer;
+
+            QMutex m_mutex;
+            QVector<Nedrysoft::RouteAnalyser::PingResultRecord> m_records;
+            QVector<Nedrysoft::RouteAnalyser::IPingTarget *> m_targets;
+            QHash<Nedrysoft::RouteAnalyser::IPingTarget *, uint32_t> m_targetIndexes;
+
+            int m_interval;
+            int m_batchSize;
+
+            bool m_isTimerPending;
+            bool m_isFlushPending;
+
+            //! @endcond
+    };
+}}
+
+#endif // PINGNOO_COMPONENTS_ROUTEANALYSER_PINGRESULTBATCHER_H
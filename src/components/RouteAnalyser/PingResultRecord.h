@@ -0,0 +1,293 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 18/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef PINGNOO_COMPONENTS_ROUTEANALYSER_PINGRESULTRECORD_H
+#define PINGNOO_COMPONENTS_ROUTEANALYSER_PINGRESULTRECORD_H
+
+#include "PingResult.h"
+
+#include <QDateTime>
+#include <QHostAddress>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace Nedrysoft { namespace RouteAnalyser {
+    class IPingTarget;
+
+    /**
+     * @brief       The PingResultRecord structure is a compact, trivially copyable form of a PingResult.
+     *
+     * @details     Constructing a PingResult requires a QDateTime and a QHostAddress, which is expensive to do for
+     *              every packet on the receive path of an engine.  A record holds the same information in plain
+     *              integers, so it can be copied into queues and storage with memcpy and only converted to a
+     *              PingResult when it reaches the user interface.
+     *
+     *              The target is identified by an index which is resolved by the owner of the record, see
+     *              Nedrysoft::RouteAnalyser::PingResultBatcher::registerTarget.
+     *
+     * @class       Nedrysoft::RouteAnalyser::PingResultRecord PingResultRecord.h <PingResultRecord>
+     */
+    struct PingResultRecord {
+        /**
+         * @brief       The target index of a record that is not associated with a target.
+         */
+        static constexpr uint32_t NoTarget = UINT32_MAX;
+
+        /**
+         * @brief       The address families of a record.
+         */
+        enum AddressFamily : uint8_t {
+            NoAddress = 0,
+            IPv4 = 4,
+            IPv6 = 6
+        };
+
+        int64_t requestTime;                /**< transmit time in nanoseconds of the monotonic clock. */
+        int64_t roundTripTime;              /**< round trip time in nanoseconds. */
+        uint8_t address[16];                /**< responding address in network byte order, IPv4 uses 4 bytes. */
+        uint32_t sampleNumber;              /**< the sample number of the request. */
+        uint32_t targetIndex;               /**< the index of the target, or NoTarget. */
+        int16_t hops;                       /**< the number of hops to the target, or -1. */
+        uint8_t addressFamily;              /**< the AddressFamily of address. */
+        uint8_t code;                       /**< the PingResult::ResultCode of the request. */
+        uint8_t timestampSource;            /**< the PingResult::TimestampSource of the round trip time. */
+
+        /**
+         * @brief       Creates a record.
+         *
+         * @param[in]   sampleNumber the sample number of the request.
+         * @param[in]   code the result code.
+         * @param[in]   hostAddress the address that responded to the request.
+         * @param[in]   requestTime the time the request was sent, as returned by monotonicNanoseconds().
+         * @param[in]   roundTripTime the round trip time in nanoseconds.
+         * @param[in]   targetIndex the index of the target.
+         * @param[in]   hops the number of hops to the target if available; otherwise -1.
+         * @param[in]   timestampSource the source of the timestamps used to calculate the round trip time.
+         *
+         * @returns     the record.
+         */
+        static auto create(
+            uint32_t sampleNumber,
+            Nedrysoft::RouteAnalyser::PingResult::ResultCode code,
+            const QHostAddress &hostAddress,
+            int64_t requestTime,
+            int64_t roundTripTime,
+            uint32_t targetIndex,
+            int hops = -1,
+            Nedrysoft::RouteAnalyser::PingResult::TimestampSource timestampSource =
+                Nedrysoft::RouteAnalyser::PingResult::TimestampSource::User
+        ) -> Nedrysoft::RouteAnalyser::PingResultRecord {
+
+            Nedrysoft::RouteAnalyser::PingResultRecord record = {};
+
+            record.requestTime = requestTime;
+            record.roundTripTime = roundTripTime;
+            record.sampleNumber = sampleNumber;
+            record.targetIndex = targetIndex;
+            record.hops = static_cast<int16_t>(hops);
+            record.code = static_cast<uint8_t>(code);
+            record.timestampSource = static_cast<uint8_t>(timestampSource);
+
+            record.setHostAddress(hostAddress);
+
+            return record;
+        }
+
+        /**
+         * @brief       Creates a record from a PingResult.
+         *
+         * @details     The request time is converted from the wall clock to the monotonic clock using the current
+         *              offset between the two.
+         *
+         * @param[in]   result the result.
+         * @param[in]   targetIndex the index of the target of the result.
+         *
+         * @returns     the record.
+         */
+        static auto fromPingResult(
+            Nedrysoft::RouteAnalyser::PingResult &result,
+            uint32_t targetIndex
+        ) -> Nedrysoft::RouteAnalyser::PingResultRecord {
+
+            auto age = realtimeNanoseconds() - result.requestTimeNanoseconds();
+
+            return create(
+                static_cast<uint32_t>(result.sampleNumber()),
+                result.code(),
+                result.hostAddress(),
+                monotonicNanoseconds() - age,
+                static_cast<int64_t>(result.roundTripTime() * NanosecondsInSecond),
+                targetIndex,
+                result.hops(),
+                result.timestampSource()
+            );
+        }
+
+        /**
+         * @brief       Returns the current time of the clock used for request times.
+         *
+         * @returns     the time in nanoseconds.
+         */
+        static auto monotonicNanoseconds() -> int64_t {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch() ).count();
+        }
+
+        /**
+         * @brief       Stores an address in the record.
+         *
+         * @param[in]   hostAddress the address, a null address clears the address of the record.
+         */
+        auto setHostAddress(const QHostAddress &hostAddress) -> void {
+            memset(address, 0, sizeof(address));
+
+            addressFamily = NoAddress;
+
+            if (hostAddress.protocol() == QAbstractSocket::IPv4Protocol) {
+                auto ipv4Address = hostAddress.toIPv4Address();
+
+                address[0] = static_cast<uint8_t>(ipv4Address >> 24);
+                address[1] = static_cast<uint8_t>(ipv4Address >> 16);
+                address[2] = static_cast<uint8_t>(ipv4Address >> 8);
+                address[3] = static_cast<uint8_t>(ipv4Address);
+
+                addressFamily = IPv4;
+            } else if (hostAddress.protocol() == QAbstractSocket::IPv6Protocol) {
+                auto ipv6Address = hostAddress.toIPv6Address();
+
+                memcpy(address, &ipv6Address, IPv6AddressLength);
+
+                addressFamily = IPv6;
+            }
+        }
+
+        /**
+         * @brief       Returns the address stored in the record.
+         *
+         * @returns     the address; a null address if the record has no address.
+         */
+        auto hostAddress() const -> QHostAddress {
+            if (addressFamily == IPv4) {
+                return QHostAddress(
+                    static_cast<quint32>(
+                        ( address[0] << 24 ) | ( address[1] << 16 ) | ( address[2] << 8 ) | address[3] ) );
+            }
+
+            if (addressFamily == IPv6) {
+                return QHostAddress(address);
+            }
+
+            return QHostAddress();
+        }
+
+        /**
+         * @brief       Returns the result code of the record.
+         *
+         * @returns     the result code.
+         */
+        auto resultCode() const -> Nedrysoft::RouteAnalyser::PingResult::ResultCode {
+            return static_cast<Nedrysoft::RouteAnalyser::PingResult::ResultCode>(code);
+        }
+
+        /**
+         * @brief       Returns the request time as a wall clock time.
+         *
+         * @details     The monotonic request time is converted using the current offset between the clocks, so the
+         *              result moves if the wall clock has been stepped since the request was sent.
+         *
+         * @returns     the request time in nanoseconds since the unix epoch.
+         */
+        auto requestTimeNanoseconds() const -> int64_t {
+            auto age = monotonicNanoseconds() - requestTime;
+
+            return realtimeNanoseconds() - age;
+        }
+
+        /**
+         * @brief       Returns the request time as a wall clock date and time.
+         *
+         * @returns     the request time, with millisecond resolution.
+         */
+        auto requestDateTime() const -> QDateTime {
+            return QDateTime::fromMSecsSinceEpoch(requestTimeNanoseconds() / NanosecondsInMillisecond);
+        }
+
+        /**
+         * @brief       Returns the round trip time in seconds.
+         *
+         * @returns     the round trip time.
+         */
+        auto roundTripTimeSeconds() const -> double {
+            return static_cast<double>(roundTripTime) / NanosecondsInSecond;
+        }
+
+        /**
+         * @brief       Converts the record to a PingResult.
+         *
+         * @param[in]   target the target that the index of the record refers to.
+         *
+         * @returns     the result.
+         */
+        auto toPingResult(Nedrysoft::RouteAnalyser::IPingTarget *target) const -> Nedrysoft::RouteAnalyser::PingResult {
+            return Nedrysoft::RouteAnalyser::PingResult(
+                sampleNumber,
+                resultCode(),
+                hostAddress(),
+                requestTimeNanoseconds(),
+                roundTripTimeSeconds(),
+                target,
+                hops,
+                static_cast<Nedrysoft::RouteAnalyser::PingResult::TimestampSource>(timestampSource)
+            );
+        }
+
+        private:
+            //! @cond
+
+            static constexpr int64_t NanosecondsInMillisecond = 1000000;
+            static constexpr double NanosecondsInSecond = 1.0e9;
+            static constexpr int IPv6AddressLength = 16;
+
+            //! @endcond
+
+            /**
+             * @brief       Returns the current wall clock time.
+             *
+             * @returns     the time in nanoseconds since the unix epoch.
+             */
+            static auto realtimeNanoseconds() -> int64_t {
+                return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::system_clock::now().time_since_epoch() ).count();
+            }
+    };
+
+    static_assert(std::is_trivially_copyable<PingResultRecord>::value, "PingResultRecord must be trivially copyable");
+    static_assert(sizeof(PingResultRecord) == 48, "PingResultRecord has unexpected padding");
+}}
+
+Q_DECLARE_METATYPE(Nedrysoft::RouteAnalyser::PingResultRecord)
+
+#endif // PINGNOO_COMPONENTS_ROUTEANALYSER_PINGRESULTRECORD_H
@@ -91,7 +91,9 @@ RouteAnalyserComponent::~RouteAnalyserComponent() {
 
 auto RouteAnalyserComponent::initialiseEvent() -> void {
     qRegisterMetaType<Nedrysoft::RouteAnalyser::PingResult>("Nedrysoft::RouteAnalyser::PingResult");
+    qRegisterMetaType<QVector<Nedrysoft::RouteAnalyser::PingResult> >("QVector<Nedrysoft::RouteAnalyser::PingResult>");
     qRegisterMetaType<Nedrysoft::RouteAnalyser::RouteList>("Nedrysoft::RouteAnalyser::RouteList");
+    qRegisterMetaType<Nedrysoft::RouteAnalyser::RouteResponders>("Nedrysoft::RouteAnalyser::RouteResponders");
     qRegisterMetaType<Nedrysoft::RouteAnalyser::IPingEngineFactory *>("Nedrysoft::RouteAnalyser::IPingEngineFactory *");
 }
 
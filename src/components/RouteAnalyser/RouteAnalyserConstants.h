@@ -25,6 +25,11 @@
 #define PINGNOO_ROUTEANALYSERCONSTANTS_H
 
 namespace Nedrysoft { namespace RouteAnalyser { namespace Constants {
+    /**
+     * @brief       The shortest interval between pings in milliseconds, used by the high rate mode.
+     */
+    constexpr auto MinimumPingInterval = 10;
+
     namespace Commands {
         constexpr auto NewTarget = "RouteAnalyser.NewTarget";
     };
@@ -33,8 +33,10 @@
 #include "IPlotFactory.h"
 #include "IRouteEngineFactory.h"
 #include "LatencySettings.h"
+#include "PingEngineMetricsWidget.h"
 #include "PlotScrollArea.h"
 #include "RouteAnalyser.h"
+#include "RouteAnalyserConstants.h"
 #include "RouteDiscoveryWidget.h"
 #include "RouteTableItemDelegate.h"
 
@@ -44,10 +46,10 @@
 #include <IContextManager>
 #include <IGeoIPProvider>
 #include <IHostMasker>
+#include <IHostNameResolver>
 #include "IHostMaskerManager"
 #include <QDateTime>
 #include <QHostAddress>
-#include <QHostInfo>
 #include <QTimer>
 #include <cassert>
 #include <spdlog/spdlog.h>
@@ -59,6 +61,9 @@ constexpr auto DefaultGraphHeight = 300;
 constexpr auto TableRowHeight = 20;
 constexpr auto NoReplyColour = qRgb(255,0,0);
 constexpr auto PlotMargins = QMargins(80, 20, 40, 40);
+constexpr auto MillisecondsInSecond = 1000.0;
+constexpr auto RouteRediscoveryInterval = 5*60;
+constexpr auto RouteChangeColour = qRgb(255,140,0);
 
 QMap< Nedrysoft::RouteAnalyser::PingData::Fields, QPair<QString, QString> > &Nedrysoft::RouteAnalyser::RouteAnalyserWidget::headerMap() {
     static QMap<Nedrysoft::RouteAnalyser::PingData::Fields, QPair<QString, QString> > map = QMap<Nedrysoft::RouteAnalyser::PingData::Fields, QPair<QString, QString> >
@@ -94,7 +99,8 @@ Nedrysoft::RouteAnalyser::RouteAnalyserWidget::RouteAnalyserWidget(
             m_startPoint(-1),
             m_endPoint(0),
             m_interval(1000),
-            m_routeDiscoveryWidget(new Nedrysoft::RouteAnalyser::RouteDiscoveryWidget) {
+            m_routeDiscoveryWidget(new Nedrysoft::RouteAnalyser::RouteDiscoveryWidget),
+            m_metricsWidget(new Nedrysoft::RouteAnalyser::PingEngineMetricsWidget) {
 
     auto latencySettings = Nedrysoft::RouteAnalyser::LatencySettings::getInstance();
 
@@ -114,6 +120,8 @@ Nedrysoft::RouteAnalyser::RouteAnalyserWidget::RouteAnalyserWidget(
 
     auto routeEngine = sortedRouteEngines.first()->createEngine();
 
+    m_routeEngine = routeEngine;
+
     if (routeEngine) {
         connect(
             routeEngine,
@@ -122,8 +130,19 @@ Nedrysoft::RouteAnalyser::RouteAnalyserWidget::RouteAnalyserWidget(
             &RouteAnalyserWidget::onRouteResult
         );
 
+        connect(
+            routeEngine,
+            &Nedrysoft::RouteAnalyser::IRouteEngine::routeUpdated,
+            this,
+            &RouteAnalyserWidget::onRouteUpdated
+        );
+
         m_routeDiscoveryWidget->setTarget(targetHost);
 
+        // the route is discovered again at a low rate so that changes of path during a long analysis are seen.
+
+        routeEngine->setRediscoveryInterval(RouteRediscoveryInterval);
+
         routeEngine->findRoute(pingEngineFactory, targetHost, ipVersion);
     }
 
@@ -138,7 +157,7 @@ Nedrysoft::RouteAnalyser::RouteAnalyserWidget::RouteAnalyserWidget(
     });
 
     m_pingEngineFactory = pingEngineFactory;
-    m_interval = interval;
+    m_interval = qMax(interval, Nedrysoft::RouteAnalyser::Constants::MinimumPingInterval);
 
     m_scrollArea = new PlotScrollArea();
 
@@ -221,6 +240,9 @@ Nedrysoft::RouteAnalyser::RouteAnalyserWidget::RouteAnalyserWidget(
     verticalLayout->setMargin(0);
 #endif
     verticalLayout->addWidget(m_splitter);
+    verticalLayout->addWidget(m_metricsWidget);
+
+    m_metricsWidget->setVisible(false);
 
     this->setLayout(verticalLayout);
 
@@ -236,6 +258,10 @@ Nedrysoft::RouteAnalyser::RouteAnalyserWidget::RouteAnalyserWidget(
 }
 
 Nedrysoft::RouteAnalyser::RouteAnalyserWidget::~RouteAnalyserWidget() {
+    if (m_routeEngine) {
+        m_routeEngine->setRediscoveryInterval(0);
+    }
+
     if (m_tableView) {
         delete m_tableView;
     }
@@ -249,26 +275,48 @@ Nedrysoft::RouteAnalyser::RouteAnalyserWidget::~RouteAnalyserWidget() {
     }
 }
 
-auto Nedrysoft::RouteAnalyser::RouteAnalyserWidget::onPingResult(Nedrysoft::RouteAnalyser::PingResult result) -> void {
-    auto pingData = static_cast<PingData *>(result.target()->userData());
+auto Nedrysoft::RouteAnalyser::RouteAnalyserWidget::onPingResults(
+        QVector<Nedrysoft::RouteAnalyser::PingResult> results) -> void {
 
-    static QMap<Nedrysoft::RouteAnalyser::PingData::Fields, PingData *> m_maximumMap;
+    auto isLatencyChanged = false;
 
-    if (!pingData) {
+    for (auto &result : results) {
+        if (applyPingResult(result)) {
+            isLatencyChanged = true;
+        }
+    }
+
+    if (!isLatencyChanged) {
         return;
     }
 
+    updateRanges();
+
+    Q_EMIT datasetChanged(m_startPoint, m_endPoint);
+
+    m_tableView->viewport()->update();
+}
+
+auto Nedrysoft::RouteAnalyser::RouteAnalyserWidget::applyPingResult(
+        Nedrysoft::RouteAnalyser::PingResult &result) -> bool {
+
+    auto pingData = static_cast<PingData *>(result.target()->userData());
+
+    if (!pingData) {
+        return false;
+    }
+
     auto customPlot = pingData->customPlot();
 
     if (!customPlot) {
-        return;
+        return false;
     }
 
     switch (result.code()) {
         case Nedrysoft::RouteAnalyser::PingResult::ResultCode::Ok:
         case Nedrysoft::RouteAnalyser::PingResult::ResultCode::TimeExceeded: {
             QCPRange graphRange = customPlot->yAxis->range();
-            auto requestTime = static_cast<double>(result.requestTime().toSecsSinceEpoch());
+            auto requestTime = result.requestTimeSeconds();
 
             customPlot->graph(RoundTripGraph)->addData(requestTime, result.roundTripTime());
 
@@ -284,12 +332,20 @@ auto Nedrysoft::RouteAnalyser::RouteAnalyserWidget::onPingResult(Nedrysoft::Rout
                 m_endPoint = requestTime;
             }
 
-            updateRanges();
+            // a hop answered by a router that route discovery has never reported suggests that the path has
+            // changed, the other routers of a load balanced hop are expected to answer and are not checked for.
 
-            Q_EMIT datasetChanged(m_startPoint, m_endPoint);
+            auto isUndiscoveredResponder =
+                ( pingData->discoveredResponders().count() ) &&
+                ( pingData->discoveredResponders().indexOf(result.hostAddress())==-1 ) &&
+                ( pingData->responders().indexOf(result.hostAddress())==-1 );
 
             pingData->updateItem(result);
 
+            if (( isUndiscoveredResponder ) && ( m_routeEngine )) {
+                m_routeEngine->refreshRoute();
+            }
+
             switch(m_graphScaleMode) {
                 case ScaleMode::None: {
                     if (result.roundTripTime()> graphRange.upper) {
@@ -342,13 +398,11 @@ auto Nedrysoft::RouteAnalyser::RouteAnalyserWidget::onPingResult(Nedrysoft::Rout
                 }
             }
 
-            m_tableView->viewport()->update();
-
-            break;
+            return true;
         }
 
         case Nedrysoft::RouteAnalyser::PingResult::ResultCode::NoReply: {
-            auto requestTime = static_cast<double>(result.requestTime().toSecsSinceEpoch());
+            auto requestTime = result.requestTimeSeconds();
 
             QCPBars *barChart = m_barCharts[customPlot];
 
@@ -359,11 +413,14 @@ auto Nedrysoft::RouteAnalyser::RouteAnalyserWidget::onPingResult(Nedrysoft::Rout
             break;
         }
     }
+
+    return false;
 }
 
 auto Nedrysoft::RouteAnalyser::RouteAnalyserWidget::onRouteResult(
         const QHostAddress routeHostAddress,
         const Nedrysoft::RouteAnalyser::RouteList route,
+        const Nedrysoft::RouteAnalyser::RouteResponders responders,
         const bool completed,
         const int totalHops,
         const int maximumHops ) -> void {
@@ -371,15 +428,8 @@ auto Nedrysoft::RouteAnalyser::RouteAnalyserWidget::onRouteResult(
     Nedrysoft::RouteAnalyser::IRouteEngine *routeEngine =
         qobject_cast<Nedrysoft::RouteAnalyser::IRouteEngine *>(this->sender());
 
-    auto hop = 1;
-    auto geoIP = Nedrysoft::ComponentSystem::getObject<Nedrysoft::Core::IGeoIPProvider>();
-
     SPDLOG_TRACE("Got route result");
 
-    auto latencySettings = Nedrysoft::RouteAnalyser::LatencySettings::getInstance();
-
-    assert(latencySettings!=nullptr);
-
     if ((completed) && (routeEngine)) {
         disconnect(
             routeEngine,
@@ -395,51 +445,10 @@ auto Nedrysoft::RouteAnalyser::RouteAnalyserWidget::onRouteResult(
 
     if (!completed) {
         for (int hop=m_tableModel->rowCount();hop<route.count();hop++) {
-            auto host = route.at(hop);
-
-            auto hostAddress = host.toString();
-            auto hostName = QHostInfo::fromName(host.toString()).hostName();
-
-            auto maskedHostName = hostName;
-            auto maskedHostAddress = hostAddress;
-
-            auto pingData = new Nedrysoft::RouteAnalyser::PingData(m_tableModel, hop+1, !host.isNull());
-
-            m_pingData.append(pingData);
-
-            for (auto masker : Nedrysoft::ComponentSystem::getObjects<Nedrysoft::Core::IHostMasker>()) {
-                masker->mask(hop, hostName, hostAddress, maskedHostName, maskedHostAddress);
-            }
-
-            auto tableItem = new QStandardItem(1, headerMap().count());
-
-            tableItem->setData(QVariant::fromValue<Nedrysoft::RouteAnalyser::PingData *>(pingData));
-
-            if (host.isNull()) {
-                pingData->setHostAddress("*");
-                pingData->setHostName("*");
-                pingData->setMaskedHostAddress("*");
-                pingData->setMaskedHostName("*");
-            } else {
-                pingData->setHostName(hostName);
-                pingData->setHostAddress(hostAddress);
-                pingData->setMaskedHostName(maskedHostName);
-                pingData->setMaskedHostAddress(maskedHostAddress);
-            }
-
-            if (geoIP) {
-                geoIP->lookup(hostAddress, [pingData](const QString &, const QVariantMap &result) mutable {
-                    pingData->setLocation(result["country"].toString());
-                });
-            }
-
-            m_tableModel->appendRow(tableItem);
-
-            m_tableView->setRowHeight(tableItem->index().row(), TableRowHeight);
-
-            connect(m_tableView, &QObject::destroyed, [pingData](QObject *) {
-                delete pingData;
-            });
+            addHopRow(
+                hop,
+                route.at(hop),
+                ( hop<responders.count() ) ? responders.at(hop) : Nedrysoft::RouteAnalyser::HopResponders() );
         }
 
         m_routeDiscoveryWidget->setProgress(m_tableModel->rowCount(), totalHops, maximumHops);
@@ -460,351 +469,668 @@ auto Nedrysoft::RouteAnalyser::RouteAnalyserWidget::onRouteResult(
 
     connect(
         m_pingEngine,
-        &Nedrysoft::RouteAnalyser::IPingEngine::result,
+        &Nedrysoft::RouteAnalyser::IPingEngine::resultsReady,
         this,
-        &RouteAnalyserWidget::onPingResult
+        &RouteAnalyserWidget::onPingResults
     );
 
-    auto verticalLayout = new QVBoxLayout();
+    m_routeHostAddress = routeHostAddress;
 
-    //for (const QHostAddress &host : route) {
-    for (auto hop=1;hop<=route.count();hop++) {
-        auto host = route.at(hop-1);
+    m_plotLayout = new QVBoxLayout();
 
-        if (host.isNull()) {
+    for (auto hop=1;hop<=route.count();hop++) {
+        if (route.at(hop-1).isNull()) {
             continue;
         }
 
-        auto hostAddress = host.toString();
-        auto hostName = QHostInfo::fromName(host.toString()).hostName();
+        addHopPlot(hop, route.at(hop-1));
+    }
 
-        auto maskedHostName = hostName;
-        auto maskedHostAddress = hostAddress;
+    connect(
+        this,
+        &Nedrysoft::RouteAnalyser::RouteAnalyserWidget::filteredEvent,
+        [=](QObject *watched, QEvent *event) {
 
-        for (auto masker : Nedrysoft::ComponentSystem::getObjects<Nedrysoft::Core::IHostMasker>()) {
-            masker->mask(hop, hostName, hostAddress, maskedHostName, maskedHostAddress);
-        }
+            auto customPlot = qobject_cast<QCustomPlot *>(watched);
 
-        auto customPlot = new QCustomPlot();
+            auto line = m_graphLines[customPlot];
 
-        customPlot->addLayer("newBackground", customPlot->layer("grid"), QCustomPlot::limBelow);
+            if (event->type() == QEvent::PaletteChange) {
+                customPlot->setBackground(this->palette().brush(QPalette::Base));
 
-        auto latencyLayer = new GraphLatencyLayer(customPlot);
+                customPlot->xAxis->setLabelColor(this->palette().color(QPalette::Text));
+                customPlot->yAxis->setLabelColor(this->palette().color(QPalette::Text));
+                customPlot->xAxis->setTickLabelColor(this->palette().color(QPalette::Text));
+                customPlot->yAxis->setTickLabelColor(this->palette().color(QPalette::Text));
 
-        m_backgroundLayers.append(latencyLayer);
+                QCPTextElement *textElement = qobject_cast<QCPTextElement *>(
+                        customPlot->plotLayout()->element(0, 0));
 
-        connect(
-            latencySettings,
-            &Nedrysoft::RouteAnalyser::LatencySettings::gradientChanged,
-            [=](bool /*useGradient*/) {
-                latencyLayer->invalidate();
+                if (textElement) {
+                    textElement->setTextColor(this->palette().color(QPalette::Text));
+                }
             }
-        );
 
-        customPlot->setCurrentLayer("main");
+            if ((event->type() == QEvent::Enter) ||
+                (event->type() == QEvent::Leave)) {
 
-        customPlot->setMinimumHeight(DefaultGraphHeight);
+                /*m_pointInfoLabel->setText("");
+                m_hopInfoLabel->setText("");
+                m_hostInfoLabel->setText("");
+                m_timeInfoLabel->setText("");*/
 
-        customPlot->addGraph();
+                line->setVisible(event->type() == QEvent::Enter);
 
-        // the timeout bar chart uses axis 2 which is a unit axis.  This means it will always draw to the top
-        // of the axis independently of the main axis which may scale up/down depending on latency.
+                customPlot->replot();
 
-        customPlot->yAxis2->setRange(0,1);
-        customPlot->yAxis2->setVisible(true);
+                this->m_tableModel->setProperty("showHistorical", false);
 
-        auto barChart = new BarChart(customPlot->xAxis, customPlot->yAxis2);
+                auto topLeft = m_tableModel->index(0, 0);
+                auto bottomRight = topLeft.sibling(m_tableModel->rowCount() - 1,
+                                                   m_tableModel->columnCount() - 1);
 
-        barChart->setWidthType(QCPBars::wtPlotCoords);
-        barChart->setBrush(QColor(NoReplyColour));
-        barChart->setPen(QPen(QColor(NoReplyColour)));
+                m_tableModel->dataChanged(topLeft, bottomRight);
+            }
+        }
+    );
 
-        m_barCharts[customPlot] = barChart;
+    m_scrollArea->widget()->setLayout(m_plotLayout);
 
-        customPlot->yAxis->ticker()->setTickCount(1);
+    m_routeDiscoveryWidget->setVisible(false);
+    m_scrollArea->setVisible(true);
 
-        QSharedPointer<CPAxisTickerMS> msTicker(new CPAxisTickerMS);
+    update();
 
-        customPlot->yAxis->setTicker(msTicker);
-        customPlot->yAxis->setLabel(tr("Latency (ms)"));
-        customPlot->yAxis->setRange(0, DefaultMaxLatency);
+    m_pingEngine->start();
 
-        QSharedPointer<QCPAxisTickerDateTime> dateTicker(new QCPAxisTickerDateTime);
+    m_metricsWidget->setEngine(m_pingEngine);
+    m_metricsWidget->setVisible(true);
+}
 
-        auto locale = QLocale::system();
+auto Nedrysoft::RouteAnalyser::RouteAnalyserWidget::onRouteUpdated(
+        const QHostAddress routeHostAddress,
+        const Nedrysoft::RouteAnalyser::RouteList route,
+        const Nedrysoft::RouteAnalyser::RouteResponders responders ) -> void {
 
-        dateTicker->setDateTimeFormat(
-            locale.timeFormat(QLocale::LongFormat).remove("t").trimmed() +
-            "\n" +
-            locale.dateFormat(QLocale::ShortFormat)
-        );
+    if (( !m_pingEngine ) || ( route.isEmpty() )) {
+        return;
+    }
 
-#if QT_VERSION >= QT_VERSION_CHECK(5, 8, 0)
-        auto secondsSinceEpoch = QDateTime::currentSecsSinceEpoch();
-#else
-        auto secondsSinceEpoch = abs(QDateTime::currentDateTime().secsTo(QDateTime(QDate(1970,1,1), QTime(0, 0))));
-#endif
+    auto isChanged = false;
 
-        customPlot->xAxis->setTicker(dateTicker);
-        customPlot->xAxis->setRange(
-            static_cast<double>(secondsSinceEpoch),
-            static_cast<double>(secondsSinceEpoch + m_viewportSize)
-        );
+    // if the host name now resolves to a different address then the targets of every hop are recreated for the new
+    // address, the existing history and graph of each hop are kept.
 
-        customPlot->graph(RoundTripGraph)->setLineStyle(QCPGraph::lsStepCenter);
+    if (( !routeHostAddress.isNull() ) && ( routeHostAddress!=m_routeHostAddress )) {
+        isChanged = true;
 
-        customPlot->setBackground(this->palette().brush(QPalette::Base));
-        customPlot->xAxis->setLabelColor(this->palette().color(QPalette::Text));
-        customPlot->yAxis->setLabelColor(this->palette().color(QPalette::Text));
-        customPlot->xAxis->setTickLabelColor(this->palette().color(QPalette::Text));
-        customPlot->yAxis->setTickLabelColor(this->palette().color(QPalette::Text));
+        m_routeHostAddress = routeHostAddress;
 
-        customPlot->replot();
+        auto previousTargets = m_targetMap;
 
-        /**
-         * scroll wheel events, by default QCustomPlot does not propagate these so this code ensures that they cause
-         * the scroll area to scroll.
-         */
+        m_targetMap.clear();
 
-        connect(customPlot, &QCustomPlot::mouseWheel, [this](QWheelEvent *event) {
-            m_scrollArea->verticalScrollBar()->setValue(
-                m_scrollArea->verticalScrollBar()->value() - event->angleDelta().y()
-            );
-        });
+        for (auto target : previousTargets.keys()) {
+            auto hop = previousTargets.value(target);
 
-        /**
-         *  mouse over event
-         */
+            m_pingEngine->removeTarget(target);
 
-        auto graphLine = new QCPItemStraightLine(customPlot);
+            target->setUserData(nullptr);
 
-        graphLine->setPen(QPen(Qt::darkGray, 2, Qt::DotLine));
+            auto pingTarget = m_pingEngine->addTarget(m_routeHostAddress, hop);
 
-        m_graphLines[customPlot] = graphLine;
+            m_targetMap[pingTarget] = hop;
 
-        connect(
-            customPlot,
-            &QCustomPlot::mouseMove,
-            [this, customPlot, graphLine, maskedHostName](QMouseEvent *event) {
-                auto x = customPlot->xAxis->pixelToCoord(event->pos().x());
-                auto foundRange = false;
+            pingTarget->setUserData(m_pingData.at(hop-1));
+        }
+    }
 
-                auto data = customPlot->graph(RoundTripGraph)->data();
+    // hops beyond the end of the updated route are no longer probed, their rows are removed and their graphs
+    // hidden.  The PingData is still owned by the table view and is deleted with it.
 
-                if (!data) {
-                    return;
-                }
+    while (m_pingData.count()>route.count()) {
+        isChanged = true;
 
-                auto dataRange = data->keyRange(foundRange);
+        auto hop = m_pingData.count();
+        auto pingData = m_pingData.takeLast();
 
-                graphLine->point1->setCoords(x, 0);
-                graphLine->point2->setCoords(x, 1);
+        for (auto target : m_targetMap.keys(hop)) {
+            m_pingEngine->removeTarget(target);
 
-                customPlot->replot();
+            target->setUserData(nullptr);
 
-                if (( foundRange ) &&
-                    ( x >= dataRange.lower ) &&
-                    ( x <= dataRange.upper )) {
-                    auto valueString = QString();
-                    /*auto valueResultRange = customPlot->graph(RoundTripGraph)->data()->valueRange(
-                            foundRange,
-                            QCP::sdBoth,
-                            QCPRange(x - 1, x +1) );*/
+            m_targetMap.remove(target);
+        }
 
-                    for (auto currentItem = 0; currentItem < m_tableModel->rowCount(); currentItem++) {
-                        auto pingData = m_tableModel->item(
-                                currentItem,
-                                0
-                        )->data().value<Nedrysoft::RouteAnalyser::PingData *>();
+        if (pingData->customPlot()) {
+            pingData->customPlot()->parentWidget()->hide();
+        }
+
+        m_plotTitleLabels.remove(pingData);
+
+        for (auto field : m_maximumMap.keys(pingData)) {
+            m_maximumMap.remove(field);
+        }
+
+        m_tableModel->removeRow(hop-1);
+    }
+
+    auto hostNameResolver = Nedrysoft::Core::IHostNameResolver::getInstance();
+
+    for (auto hop=0;hop<route.count();hop++) {
+        auto host = route.at(hop);
+        auto hopResponders = ( hop<responders.count() ) ? responders.at(hop) : Nedrysoft::RouteAnalyser::HopResponders();
+
+        if (hop>=m_pingData.count()) {
+            isChanged = true;
+
+            addHopRow(hop, host, hopResponders);
 
-                        auto valueRange = QCPRange(x - 1, x + 1);
+            if (!host.isNull()) {
+                addHopPlot(hop+1, host);
+            }
+
+            continue;
+        }
+
+        auto pingData = m_pingData.at(hop);
 
-                        if (pingData->customPlot()) {
-                            auto tempResultRange = pingData->customPlot()->graph(
-                                    RoundTripGraph)->data()->valueRange(foundRange, QCP::sdBoth, valueRange);
+        // on a load balanced hop the primary router can differ between verifications, a router that has already
+        // answered for the hop is one of its paths rather than a change of route.
 
-                            pingData->setHistoricalLatency(tempResultRange.upper);
-                        } else {
-                            pingData->setHistoricalLatency(-1);
+        auto isKnownResponder = ( !host.isNull() ) && ( pingData->responders().indexOf(host)!=-1 );
 
-                            auto topLeft = m_tableModel->index(0, 0);
-                            auto bottomRight = topLeft.sibling(m_tableModel->rowCount() - 1,
-                                                               m_tableModel->columnCount() - 1);
+        pingData->addResponders(hopResponders);
+
+        // a hop that did not answer during verification keeps the address it already has, the existing history
+        // and graph of the hop are kept when the address changes as the same TTL is still being probed.
+
+        if (host.isNull()) {
+            continue;
+        }
 
-                            m_tableModel->dataChanged(topLeft, bottomRight);
+        if (( !isKnownResponder ) && ( pingData->hostAddress()!=host.toString() )) {
+            isChanged = true;
+
+            setHopAddress(pingData, hop, host);
+
+            if (m_plotTitleLabels.contains(pingData)) {
+                auto plotTitleLabel = m_plotTitleLabels[pingData];
+
+                plotTitleLabel->setText(pingData->plotTitle());
+
+                if (hostNameResolver) {
+                    hostNameResolver->lookup(
+                        host,
+                        plotTitleLabel,
+                        [pingData, plotTitleLabel](const QHostAddress &, const QString &) {
+                            plotTitleLabel->setText(pingData->plotTitle());
                         }
-                    }
+                    );
+                }
+            }
+        }
 
-                    this->m_tableModel->setProperty("showHistorical", true);
+        if (!pingData->customPlot()) {
+            addHopPlot(hop+1, host);
+        }
+    }
 
-                    /*
-                    auto seconds = std::chrono::duration<double>(valueResultRange.upper);
+    if (isChanged) {
+        auto routeChangeTime = static_cast<double>(QDateTime::currentMSecsSinceEpoch())/MillisecondsInSecond;
 
-                    if (seconds < std::chrono::seconds(1)) {
-                        auto milliseconds =
-                            std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(seconds);
+        m_routeChangeTimes.append(routeChangeTime);
 
-                        valueString = QString(tr("%1ms")).arg(milliseconds.count(), 0, 'f', 2);
-                    } else {
-                        valueString = QString(tr("%1s")).arg(seconds.count(), 0, 'f', 2);
-                    }
+        for (auto customPlot : m_plotList) {
+            addRouteChangeMarker(customPlot, routeChangeTime);
 
-                    auto dateTime = QDateTime::fromSecsSinceEpoch(static_cast<qint64>(x));
+            customPlot->replot();
+        }
+    }
 
-                    m_pointInfoLabel->setText(FontAwesome::richText(QString("[fas fa-stopwatch] %1").arg(valueString)));
-                    m_hopInfoLabel->setText(FontAwesome::richText(QString("[fas fa-project-diagram] %1 %2").arg(tr("hop")).arg(hop)));
-                    m_hostInfoLabel->setText(FontAwesome::richText(QString("[fas fa-server] %1").arg(maskedHostName)));
-                    m_timeInfoLabel->setText(FontAwesome::richText(QString("[far fa-calendar-alt] %1").arg(dateTime.toString())));
-                    */
-                } else {
-                    /*
-                    m_pointInfoLabel->setText("");
-                    m_hopInfoLabel->setText("");
-                    m_hostInfoLabel->setText("");
-                    m_timeInfoLabel->setText("");
-                    */
+    m_tableView->viewport()->update();
+}
+
+auto Nedrysoft::RouteAnalyser::RouteAnalyserWidget::addRouteChangeMarker(
+        QCustomPlot *customPlot,
+        double routeChangeTime ) -> void {
+
+    auto markerLine = new QCPItemStraightLine(customPlot);
+
+    markerLine->setPen(QPen(QColor(RouteChangeColour), 1, Qt::DashLine));
 
-                    this->m_tableModel->setProperty("showHistorical", false);
+    markerLine->point1->setCoords(routeChangeTime, 0);
+    markerLine->point2->setCoords(routeChangeTime, 1);
 
-                    auto topLeft = m_tableModel->index(0, 0);
-                    auto bottomRight = topLeft.sibling(
-                            m_tableModel->rowCount() - 1,
-                            m_tableModel->columnCount() - 1 );
+    auto markerText = new QCPItemText(customPlot);
 
-                    m_tableModel->dataChanged(topLeft, bottomRight);
+    markerText->setText(tr("Route changed"));
+    markerText->setColor(QColor(RouteChangeColour));
+    markerText->setPositionAlignment(Qt::AlignLeft | Qt::AlignTop);
+
+    markerText->position->setTypeX(QCPItemPosition::ptPlotCoords);
+    markerText->position->setTypeY(QCPItemPosition::ptAxisRectRatio);
+    markerText->position->setCoords(routeChangeTime, 0);
+}
+
+auto Nedrysoft::RouteAnalyser::RouteAnalyserWidget::addHopRow(
+        int hop,
+        const QHostAddress &host,
+        const Nedrysoft::RouteAnalyser::HopResponders &responders ) -> void {
+
+    auto pingData = new Nedrysoft::RouteAnalyser::PingData(m_tableModel, hop+1, !host.isNull());
+
+    m_pingData.append(pingData);
+
+    pingData->addResponders(responders);
+
+    auto tableItem = new QStandardItem(1, headerMap().count());
+
+    tableItem->setData(QVariant::fromValue<Nedrysoft::RouteAnalyser::PingData *>(pingData));
+
+    setHopAddress(pingData, hop, host);
+
+    m_tableModel->appendRow(tableItem);
+
+    m_tableView->setRowHeight(tableItem->index().row(), TableRowHeight);
+
+    connect(m_tableView, &QObject::destroyed, [pingData](QObject *) {
+        delete pingData;
+    });
+}
+
+auto Nedrysoft::RouteAnalyser::RouteAnalyserWidget::setHopAddress(
+        Nedrysoft::RouteAnalyser::PingData *pingData,
+        int hop,
+        const QHostAddress &host ) -> void {
+
+    auto geoIP = Nedrysoft::ComponentSystem::getObject<Nedrysoft::Core::IGeoIPProvider>();
+    auto hostNameResolver = Nedrysoft::Core::IHostNameResolver::getInstance();
+
+    // the address is shown until the resolver finds the name of the hop.
+
+    auto hostAddress = host.toString();
+    auto hostName = hostAddress;
+
+    auto maskedHostName = hostName;
+    auto maskedHostAddress = hostAddress;
+
+    for (auto masker : Nedrysoft::ComponentSystem::getObjects<Nedrysoft::Core::IHostMasker>()) {
+        masker->mask(hop, hostName, hostAddress, maskedHostName, maskedHostAddress);
+    }
+
+    if (host.isNull()) {
+        pingData->setHostAddress("*");
+        pingData->setHostName("*");
+        pingData->setMaskedHostAddress("*");
+        pingData->setMaskedHostName("*");
+    } else {
+        pingData->setHostName(hostName);
+        pingData->setHostAddress(hostAddress);
+        pingData->setMaskedHostName(maskedHostName);
+        pingData->setMaskedHostAddress(maskedHostAddress);
+    }
+
+    if (geoIP) {
+        geoIP->lookup(hostAddress, [pingData](const QString &, const QVariantMap &result) mutable {
+            pingData->setLocation(result["country"].toString());
+        });
+    }
+
+    if (( hostNameResolver ) && ( !host.isNull() )) {
+        hostNameResolver->lookup(
+            host,
+            m_tableView,
+            [pingData, hop](const QHostAddress &resolvedHost, const QString &resolvedHostName) {
+                auto resolvedHostAddress = pingData->hostAddress();
+
+                // the hop may have been given a different address while the lookup was in progress.
+
+                if (resolvedHostAddress!=resolvedHost.toString()) {
+                    return;
+                }
+
+                auto maskedHostName = resolvedHostName;
+                auto maskedHostAddress = resolvedHostAddress;
+
+                for (auto masker : Nedrysoft::ComponentSystem::getObjects<Nedrysoft::Core::IHostMasker>()) {
+                    masker->mask(hop, resolvedHostName, resolvedHostAddress, maskedHostName, maskedHostAddress);
                 }
+
+                pingData->setHostName(resolvedHostName);
+                pingData->setMaskedHostName(maskedHostName);
+                pingData->setMaskedHostAddress(maskedHostAddress);
             }
         );
+    }
+}
 
-        customPlot->installEventFilter(this);
+auto Nedrysoft::RouteAnalyser::RouteAnalyserWidget::addHopPlot(int hop, const QHostAddress &host) -> void {
+    auto latencySettings = Nedrysoft::RouteAnalyser::LatencySettings::getInstance();
+    auto geoIP = Nedrysoft::ComponentSystem::getObject<Nedrysoft::Core::IGeoIPProvider>();
+    auto hostNameResolver = Nedrysoft::Core::IHostNameResolver::getInstance();
+
+    assert(latencySettings!=nullptr);
+
+    // each hop has its own container so that the graph of a hop found after the analysis has started is placed
+    // in hop order.
 
-        m_plotList.append(customPlot);
+    auto hopWidget = new QWidget;
+    auto hopLayout = new QVBoxLayout;
 
-        auto plotTitleLabel = new QLabel;
+    hopLayout->setContentsMargins(0, 0, 0, 0);
 
-        QFont labelFont = plotTitleLabel->font();
+    hopWidget->setLayout(hopLayout);
 
-        labelFont.setPointSize(16);
+    auto hopPosition = 0;
 
-        plotTitleLabel->setFont(labelFont);
+    for (auto index=0;index<hop-1;index++) {
+        if (m_pingData.at(index)->customPlot()) {
+            hopPosition++;
+        }
+    }
 
-        plotTitleLabel->setAlignment(Qt::AlignHCenter);
+    m_plotLayout->insertWidget(hopPosition, hopWidget);
 
-        verticalLayout->addWidget(plotTitleLabel);
+    auto hostAddress = host.toString();
+    auto hostName = m_pingData.at(hop-1)->hostName();
 
-        // add any pre-plots.
+    auto maskedHostName = hostName;
+    auto maskedHostAddress = hostAddress;
 
-        auto plotFactories = ComponentSystem::getObjects<Nedrysoft::RouteAnalyser::IPlotFactory>();
+    for (auto masker : Nedrysoft::ComponentSystem::getObjects<Nedrysoft::Core::IHostMasker>()) {
+        masker->mask(hop, hostName, hostAddress, maskedHostName, maskedHostAddress);
+    }
 
-        QList<Nedrysoft::RouteAnalyser::IPlot *> plots;
+    auto customPlot = new QCustomPlot();
 
-        for (auto plotFactory : plotFactories) {
-            auto plot = plotFactory->createPlot(PlotMargins);
+    customPlot->addLayer("newBackground", customPlot->layer("grid"), QCustomPlot::limBelow);
 
-            m_extraPlots.append(plot);
+    auto latencyLayer = new GraphLatencyLayer(customPlot);
 
-            plots.append(plot);
+    m_backgroundLayers.append(latencyLayer);
 
-            verticalLayout->addWidget(plot->widget());
+    connect(
+        latencySettings,
+        &Nedrysoft::RouteAnalyser::LatencySettings::gradientChanged,
+        [=](bool /*useGradient*/) {
+            latencyLayer->invalidate();
         }
+    );
 
-        customPlot->axisRect()->setAutoMargins(QCP::msNone);
-        customPlot->axisRect()->setMargins(PlotMargins);
+    customPlot->setCurrentLayer("main");
 
-        // add the main plot
+    customPlot->setMinimumHeight(DefaultGraphHeight);
 
-        verticalLayout->addWidget(customPlot);
+    customPlot->addGraph();
 
-        auto pingTarget = m_pingEngine->addTarget(routeHostAddress, hop);
+    // the timeout bar chart uses axis 2 which is a unit axis.  This means it will always draw to the top
+    // of the axis independently of the main axis which may scale up/down depending on latency.
 
-        auto pingData = m_pingData.at(hop-1);
+    customPlot->yAxis2->setRange(0,1);
+    customPlot->yAxis2->setVisible(true);
 
-        pingData->setHopValid(true);
-        pingData->setPlots(plots);
-        pingData->setCustomPlot(customPlot);
+    auto barChart = new BarChart(customPlot->xAxis, customPlot->yAxis2);
 
-        pingTarget->setUserData(pingData);
+    // each timeout bar covers the interval of its request, at high ping rates several requests are sent
+    // within the same second.
 
-        if (geoIP) {
-            geoIP->lookup(hostAddress, [pingData](const QString &, const QVariantMap &result) mutable {
-                pingData->setLocation(result["country"].toString());
-            });
-        }
+    barChart->setWidthType(QCPBars::wtPlotCoords);
+    barChart->setWidth(m_interval / MillisecondsInSecond);
+    barChart->setBrush(QColor(NoReplyColour));
+    barChart->setPen(QPen(QColor(NoReplyColour)));
 
-        auto hostMaskerManager = Nedrysoft::Core::IHostMaskerManager::getInstance();
+    m_barCharts[customPlot] = barChart;
 
-        if (hostMaskerManager) {
-            connect(
-                hostMaskerManager,
-                &Nedrysoft::Core::IHostMaskerManager::maskStateChanged,
-                [pingData, plotTitleLabel](Nedrysoft::Core::HostMaskType type, bool state) {
-                    pingData->updateModel();
-                    plotTitleLabel->setText(pingData->plotTitle());
-            });
-        }
+    customPlot->yAxis->ticker()->setTickCount(1);
 
-        plotTitleLabel->setText(pingData->plotTitle());
-    }
+    QSharedPointer<CPAxisTickerMS> msTicker(new CPAxisTickerMS);
+
+    customPlot->yAxis->setTicker(msTicker);
+    customPlot->yAxis->setLabel(tr("Latency (ms)"));
+    customPlot->yAxis->setRange(0, DefaultMaxLatency);
+
+    QSharedPointer<QCPAxisTickerDateTime> dateTicker(new QCPAxisTickerDateTime);
+
+    auto locale = QLocale::system();
+
+    dateTicker->setDateTimeFormat(
+        locale.timeFormat(QLocale::LongFormat).remove("t").trimmed() +
+        "\n" +
+        locale.dateFormat(QLocale::ShortFormat)
+    );
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 8, 0)
+    auto secondsSinceEpoch = QDateTime::currentSecsSinceEpoch();
+#else
+    auto secondsSinceEpoch = abs(QDateTime::currentDateTime().secsTo(QDateTime(QDate(1970,1,1), QTime(0, 0))));
+#endif
+
+    customPlot->xAxis->setTicker(dateTicker);
+    customPlot->xAxis->setRange(
+        static_cast<double>(secondsSinceEpoch),
+        static_cast<double>(secondsSinceEpoch + m_viewportSize)
+    );
+
+    customPlot->graph(RoundTripGraph)->setLineStyle(QCPGraph::lsStepCenter);
+
+    customPlot->setBackground(this->palette().brush(QPalette::Base));
+    customPlot->xAxis->setLabelColor(this->palette().color(QPalette::Text));
+    customPlot->yAxis->setLabelColor(this->palette().color(QPalette::Text));
+    customPlot->xAxis->setTickLabelColor(this->palette().color(QPalette::Text));
+    customPlot->yAxis->setTickLabelColor(this->palette().color(QPalette::Text));
+
+    customPlot->replot();
+
+    /**
+     * scroll wheel events, by default QCustomPlot does not propagate these so this code ensures that they cause
+     * the scroll area to scroll.
+     */
+
+    connect(customPlot, &QCustomPlot::mouseWheel, [this](QWheelEvent *event) {
+        m_scrollArea->verticalScrollBar()->setValue(
+            m_scrollArea->verticalScrollBar()->value() - event->angleDelta().y()
+        );
+    });
+
+    /**
+     *  mouse over event
+     */
+
+    auto graphLine = new QCPItemStraightLine(customPlot);
+
+    graphLine->setPen(QPen(Qt::darkGray, 2, Qt::DotLine));
+
+    m_graphLines[customPlot] = graphLine;
 
     connect(
-        this,
-        &Nedrysoft::RouteAnalyser::RouteAnalyserWidget::filteredEvent,
-        [=](QObject *watched, QEvent *event) {
+        customPlot,
+        &QCustomPlot::mouseMove,
+        [this, customPlot, graphLine, maskedHostName](QMouseEvent *event) {
+            auto x = customPlot->xAxis->pixelToCoord(event->pos().x());
+            auto foundRange = false;
 
-            auto customPlot = qobject_cast<QCustomPlot *>(watched);
+            auto data = customPlot->graph(RoundTripGraph)->data();
 
-            auto line = m_graphLines[customPlot];
+            if (!data) {
+                return;
+            }
 
-            if (event->type() == QEvent::PaletteChange) {
-                customPlot->setBackground(this->palette().brush(QPalette::Base));
+            auto dataRange = data->keyRange(foundRange);
 
-                customPlot->xAxis->setLabelColor(this->palette().color(QPalette::Text));
-                customPlot->yAxis->setLabelColor(this->palette().color(QPalette::Text));
-                customPlot->xAxis->setTickLabelColor(this->palette().color(QPalette::Text));
-                customPlot->yAxis->setTickLabelColor(this->palette().color(QPalette::Text));
+            graphLine->point1->setCoords(x, 0);
+            graphLine->point2->setCoords(x, 1);
 
-                QCPTextElement *textElement = qobject_cast<QCPTextElement *>(
-                        customPlot->plotLayout()->element(0, 0));
+            customPlot->replot();
 
-                if (textElement) {
-                    textElement->setTextColor(this->palette().color(QPalette::Text));
+            if (( foundRange ) &&
+                ( x >= dataRange.lower ) &&
+                ( x <= dataRange.upper )) {
+                auto valueString = QString();
+                /*auto valueResultRange = customPlot->graph(RoundTripGraph)->data()->valueRange(
+                        foundRange,
+                        QCP::sdBoth,
+                        QCPRange(x - 1, x +1) );*/
+
+                for (auto currentItem = 0; currentItem < m_tableModel->rowCount(); currentItem++) {
+                    auto pingData = m_tableModel->item(
+                            currentItem,
+                            0
+                    )->data().value<Nedrysoft::RouteAnalyser::PingData *>();
+
+                    auto valueRange = QCPRange(
+                        x - m_interval / MillisecondsInSecond,
+                        x + m_interval / MillisecondsInSecond );
+
+                    if (pingData->customPlot()) {
+                        auto tempResultRange = pingData->customPlot()->graph(
+                                RoundTripGraph)->data()->valueRange(foundRange, QCP::sdBoth, valueRange);
+
+                        pingData->setHistoricalLatency(tempResultRange.upper);
+                    } else {
+                        pingData->setHistoricalLatency(-1);
+
+                        auto topLeft = m_tableModel->index(0, 0);
+                        auto bottomRight = topLeft.sibling(m_tableModel->rowCount() - 1,
+                                                           m_tableModel->columnCount() - 1);
+
+                        m_tableModel->dataChanged(topLeft, bottomRight);
+                    }
                 }
-            }
 
-            if ((event->type() == QEvent::Enter) ||
-                (event->type() == QEvent::Leave)) {
+                this->m_tableModel->setProperty("showHistorical", true);
 
-                /*m_pointInfoLabel->setText("");
-                m_hopInfoLabel->setText("");
-                m_hostInfoLabel->setText("");
-                m_timeInfoLabel->setText("");*/
+                /*
+                auto seconds = std::chrono::duration<double>(valueResultRange.upper);
 
-                line->setVisible(event->type() == QEvent::Enter);
+                if (seconds < std::chrono::seconds(1)) {
+                    auto milliseconds =
+                        std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(seconds);
 
-                customPlot->replot();
+                    valueString = QString(tr("%1ms")).arg(milliseconds.count(), 0, 'f', 2);
+                } else {
+                    valueString = QString(tr("%1s")).arg(seconds.count(), 0, 'f', 2);
+                }
+
+                auto dateTime = QDateTime::fromSecsSinceEpoch(static_cast<qint64>(x));
+
+                m_pointInfoLabel->setText(FontAwesome::richText(QString("[fas fa-stopwatch] %1").arg(valueString)));
+                m_hopInfoLabel->setText(FontAwesome::richText(QString("[fas fa-project-diagram] %1 %2").arg(tr("hop")).arg(hop)));
+                m_hostInfoLabel->setText(FontAwesome::richText(QString("[fas fa-server] %1").arg(maskedHostName)));
+                m_timeInfoLabel->setText(FontAwesome::richText(QString("[far fa-calendar-alt] %1").arg(dateTime.toString())));
+                */
+            } else {
+                /*
+                m_pointInfoLabel->setText("");
+                m_hopInfoLabel->setText("");
+                m_hostInfoLabel->setText("");
+                m_timeInfoLabel->setText("");
+                */
 
                 this->m_tableModel->setProperty("showHistorical", false);
 
                 auto topLeft = m_tableModel->index(0, 0);
-                auto bottomRight = topLeft.sibling(m_tableModel->rowCount() - 1,
-                                                   m_tableModel->columnCount() - 1);
+                auto bottomRight = topLeft.sibling(
+                        m_tableModel->rowCount() - 1,
+                        m_tableModel->columnCount() - 1 );
 
                 m_tableModel->dataChanged(topLeft, bottomRight);
             }
         }
     );
 
-    m_scrollArea->widget()->setLayout(verticalLayout);
+    customPlot->installEventFilter(this);
 
-    m_routeDiscoveryWidget->setVisible(false);
-    m_scrollArea->setVisible(true);
+    m_plotList.append(customPlot);
 
-    update();
+    for (auto routeChangeTime : m_routeChangeTimes) {
+        addRouteChangeMarker(customPlot, routeChangeTime);
+    }
 
-    m_pingEngine->start();
+    auto plotTitleLabel = new QLabel;
+
+    QFont labelFont = plotTitleLabel->font();
+
+    labelFont.setPointSize(16);
+
+    plotTitleLabel->setFont(labelFont);
+
+    plotTitleLabel->setAlignment(Qt::AlignHCenter);
+
+    hopLayout->addWidget(plotTitleLabel);
+
+    // add any pre-plots.
+
+    auto plotFactories = ComponentSystem::getObjects<Nedrysoft::RouteAnalyser::IPlotFactory>();
+
+    QList<Nedrysoft::RouteAnalyser::IPlot *> plots;
+
+    for (auto plotFactory : plotFactories) {
+        auto plot = plotFactory->createPlot(PlotMargins);
+
+        m_extraPlots.append(plot);
+
+        plots.append(plot);
+
+        hopLayout->addWidget(plot->widget());
+    }
+
+    customPlot->axisRect()->setAutoMargins(QCP::msNone);
+    customPlot->axisRect()->setMargins(PlotMargins);
+
+    // add the main plot
+
+    hopLayout->addWidget(customPlot);
+
+    auto pingTarget = m_pingEngine->addTarget(m_routeHostAddress, hop);
+
+    m_targetMap[pingTarget] = hop;
+
+    auto pingData = m_pingData.at(hop-1);
+
+    pingData->setHopValid(true);
+    pingData->setPlots(plots);
+    pingData->setCustomPlot(customPlot);
+
+    m_plotTitleLabels[pingData] = plotTitleLabel;
+
+    pingTarget->setUserData(pingData);
+
+    if (geoIP) {
+        geoIP->lookup(hostAddress, [pingData](const QString &, const QVariantMap &result) mutable {
+            pingData->setLocation(result["country"].toString());
+        });
+    }
+
+    auto hostMaskerManager = Nedrysoft::Core::IHostMaskerManager::getInstance();
+
+    if (hostMaskerManager) {
+        connect(
+            hostMaskerManager,
+            &Nedrysoft::Core::IHostMaskerManager::maskStateChanged,
+            [pingData, plotTitleLabel](Nedrysoft::Core::HostMaskType type, bool state) {
+                pingData->updateModel();
+                plotTitleLabel->setText(pingData->plotTitle());
+        });
+    }
+
+    plotTitleLabel->setText(pingData->plotTitle());
+
+    // the table row requested the name first, so its data has been updated when the title is refreshed.
+
+    if (hostNameResolver) {
+        hostNameResolver->lookup(
+            host,
+            plotTitleLabel,
+            [pingData, plotTitleLabel](const QHostAddress &, const QString &) {
+                plotTitleLabel->setText(pingData->plotTitle());
+            }
+        );
+    }
 }
 
-auto Nedrysoft::RouteAnalyser::RouteAnalyserWidget::eventFilter(QObject *watched, QEvent *event) -> bool {
+auto Nedrysoft::RouteAnalyser::RouteAnalyserWidget::eventFilter(
+QObject *watched, QEvent *event) -> bool {
     Q_EMIT filteredEvent(watched, event);
 
     return QWidget::eventFilter(watched, event);
@@ -42,16 +42,19 @@ namespace Nedrysoft { namespace Core {
     class IHostMasker;
 }}
 
+class QLabel;
 class QTableView;
 class QStandardItemModel;
 class QSplitter;
 class QScrollArea;
+class QVBoxLayout;
 class Timer;
 
 namespace Nedrysoft { namespace RouteAnalyser {
     class GraphLatencyLayer;
     class IPingEngine;
     class IPingEngineFactory;
+    class PingEngineMetricsWidget;
     class PlotScrollArea;
     class RouteTableItemDelegate;
     class RouteDiscoveryWidget;
@@ -100,11 +103,14 @@ namespace Nedrysoft { namespace RouteAnalyser {
             ~RouteAnalyserWidget();
 
             /**
-             * @brief       Called when a ping result is available.
+             * @brief       Called when a batch of ping results is available.
              *
-             * @param[in]   result the PingResult contains the timing information for the ping.
+             * @details     The results are added to the graphs and table first, the ranges, viewport and table are
+             *              then updated once for the whole batch.
+             *
+             * @param[in]   results the PingResults containing the timing information for the pings.
              */
-            Q_SLOT void onPingResult(Nedrysoft::RouteAnalyser::PingResult result);
+            Q_SLOT void onPingResults(QVector<Nedrysoft::RouteAnalyser::PingResult> results);
 
             /**
              * @brief       Called when a ping route is available.
@@ -113,6 +119,7 @@ namespace Nedrysoft { namespace RouteAnalyser {
              *
              * @param[in]   routeHostAddress the intended target of the route analysis.
              * @param[in]   route the route that was discovered.
+             * @param[in]   responders the routers that answered at each hop of the route.
              * @param[in]   completed whether the route is complete or still being discovered.
              * @param[in]   totalHops the total number of hops to the target if available; otherwise false.
              * @param[in]   maximumHops is the maximum number of hops to consider, if the TTL exceeds this then
@@ -121,11 +128,30 @@ namespace Nedrysoft { namespace RouteAnalyser {
             Q_SLOT void onRouteResult(
                 const QHostAddress routeHostAddress,
                 const Nedrysoft::RouteAnalyser::RouteList route,
+                const Nedrysoft::RouteAnalyser::RouteResponders responders,
                 const bool completed,
                 const int totalHops,
                 const int maximumHops
             );
 
+            /**
+             * @brief       Called when the route engine has verified or rediscovered the route.
+             *
+             * @details     the rows and graphs are reconciled with the updated route without restarting the ping
+             *              engine, hops that changed address keep their history, hops beyond the end of the route
+             *              are removed and new hops are added.  If the target now resolves to a different address
+             *              the hops are re-targeted to it.  Changes are marked on the time axis of the graphs.
+             *
+             * @param[in]   routeHostAddress the intended target of the route analysis.
+             * @param[in]   route the updated route.
+             * @param[in]   responders the routers that answered at each hop of the route.
+             */
+            Q_SLOT void onRouteUpdated(
+                const QHostAddress routeHostAddress,
+                const Nedrysoft::RouteAnalyser::RouteList route,
+                const Nedrysoft::RouteAnalyser::RouteResponders responders
+            );
+
             /**
              * @brief       This signal is emitted when a watched event on a child fires.
              *
@@ -212,6 +238,57 @@ namespace Nedrysoft { namespace RouteAnalyser {
              */
             auto updateRanges() -> void;
 
+            /**
+             * @brief       Adds a ping result to the graph and table of its hop.
+             *
+             * @param[in]   result the PingResult contains the timing information for the ping.
+             *
+             * @returns     true if the latency data was changed and the ranges must be updated; otherwise false.
+             */
+            auto applyPingResult(Nedrysoft::RouteAnalyser::PingResult &result) -> bool;
+
+            /**
+             * @brief       Adds the table row of a hop.
+             *
+             * @param[in]   hop the zero based index of the hop.
+             * @param[in]   host the address of the hop, a null address if the hop did not respond.
+             * @param[in]   responders the routers that answered at the hop.
+             */
+            auto addHopRow(
+                int hop,
+                const QHostAddress &host,
+                const Nedrysoft::RouteAnalyser::HopResponders &responders ) -> void;
+
+            /**
+             * @brief       Sets the address of a hop and starts the geoip and host name lookups.
+             *
+             * @param[in]   pingData the data of the hop.
+             * @param[in]   hop the zero based index of the hop.
+             * @param[in]   host the address of the hop, a null address if the hop did not respond.
+             */
+            auto setHopAddress(
+                Nedrysoft::RouteAnalyser::PingData *pingData,
+                int hop,
+                const QHostAddress &host ) -> void;
+
+            /**
+             * @brief       Adds the graph of a hop and starts probing it.
+             *
+             * @details     the graph is inserted in hop order, so hops can be added after the engine has started.
+             *
+             * @param[in]   hop the hop number (the TTL) starting at 1.
+             * @param[in]   host the address of the hop.
+             */
+            auto addHopPlot(int hop, const QHostAddress &host) -> void;
+
+            /**
+             * @brief       Marks a change of route on the time axis of a graph.
+             *
+             * @param[in]   customPlot the graph to mark.
+             * @param[in]   routeChangeTime the time of the change in seconds since the unix epoch.
+             */
+            auto addRouteChangeMarker(QCustomPlot *customPlot, double routeChangeTime) -> void;
+
             /**
              * @brief       A map containing the fields that are displayed on the list.
              *
@@ -233,6 +310,7 @@ namespace Nedrysoft { namespace RouteAnalyser {
             QSplitter *m_splitter;
             PlotScrollArea *m_scrollArea;
             Nedrysoft::RouteAnalyser::RouteDiscoveryWidget *m_routeDiscoveryWidget;
+            Nedrysoft::RouteAnalyser::PingEngineMetricsWidget *m_metricsWidget;
             Nedrysoft::RouteAnalyser::IPingEngineFactory *m_pingEngineFactory;
             int m_interval;
             QList<Nedrysoft::RouteAnalyser::GraphLatencyLayer *> m_backgroundLayers;
@@ -240,6 +318,12 @@ namespace Nedrysoft { namespace RouteAnalyser {
             ScaleMode m_graphScaleMode;
             QTimer *m_layerCleanupTimer;
             QList<PingData *> m_pingData;
+            QMap<PingData *, QLabel *> m_plotTitleLabels;
+            QMap<Nedrysoft::RouteAnalyser::PingData::Fields, PingData *> m_maximumMap;
+            QVBoxLayout *m_plotLayout = {};
+            QHostAddress m_routeHostAddress;
+            Nedrysoft::RouteAnalyser::IRouteEngine *m_routeEngine = {};
+            QList<double> m_routeChangeTimes;
 
             QList<Nedrysoft::RouteAnalyser::IPlot *> m_extraPlots;
 
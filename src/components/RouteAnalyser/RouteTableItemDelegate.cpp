@@ -29,12 +29,16 @@
 
 #include <IHostMaskerManager>
 #include <QHeaderView>
+#include <QHelpEvent>
 #include <QPainter>
 #include <QPainterPath>
 #include <QPropertyAnimation>
 #include <QStandardItemModel>
+#include <QStringList>
 #include <QTableView>
+#include <QToolTip>
 #include <ThemeSupport>
+#include <algorithm>
 #include <cassert>
 
 constexpr auto AverageLatencyRadius = 4;
@@ -69,6 +73,115 @@ Nedrysoft::RouteAnalyser::RouteTableItemDelegate::RouteTableItemDelegate(QWidget
 
 }
 
+auto Nedrysoft::RouteAnalyser::RouteTableItemDelegate::helpEvent(
+        QHelpEvent *event,
+        QAbstractItemView *view,
+        const QStyleOptionViewItem &option,
+        const QModelIndex &index ) -> bool {
+
+    if (( !event ) || ( event->type() != QEvent::ToolTip ) || ( !index.sibling(index.row(), 0).isValid() )) {
+        return QStyledItemDelegate::helpEvent(event, view, option, index);
+    }
+
+    switch (static_cast<PingData::Fields>(index.column())) {
+        case PingData::Fields::IP: {
+            return respondersHelpEvent(event, view, option, index);
+        }
+
+        case PingData::Fields::AverageLatency:
+        case PingData::Fields::CurrentLatency:
+        case PingData::Fields::MinimumLatency:
+        case PingData::Fields::MaximumLatency: {
+            break;
+        }
+
+        default: {
+            return QStyledItemDelegate::helpEvent(event, view, option, index);
+        }
+    }
+
+    auto pingData = index.sibling(index.row(), 0).data(Qt::UserRole + 1).value<Nedrysoft::RouteAnalyser::PingData *>();
+
+    if (( !pingData ) || ( pingData->latency(static_cast<int>(PingData::Fields::CurrentLatency)) < 0 )) {
+        return QStyledItemDelegate::helpEvent(event, view, option, index);
+    }
+
+    QString toolTipText;
+
+    switch (pingData->timestampSource()) {
+        case Nedrysoft::RouteAnalyser::PingResult::TimestampSource::Kernel: {
+            toolTipText = tr("Latency measured using kernel transmit and receive timestamps.");
+
+            break;
+        }
+
+        case Nedrysoft::RouteAnalyser::PingResult::TimestampSource::KernelReceive: {
+            toolTipText = tr("Latency measured using kernel receive timestamps.");
+
+            break;
+        }
+
+        case Nedrysoft::RouteAnalyser::PingResult::TimestampSource::User: {
+            toolTipText = tr("Latency measured using application timestamps.");
+
+            break;
+        }
+    }
+
+    QToolTip::showText(event->globalPos(), toolTipText, view);
+
+    return true;
+}
+
+auto Nedrysoft::RouteAnalyser::RouteTableItemDelegate::respondersHelpEvent(
+        QHelpEvent *event,
+        QAbstractItemView *view,
+        const QStyleOptionViewItem &option,
+        const QModelIndex &index ) -> bool {
+
+    auto pingData = index.sibling(index.row(), 0).data(Qt::UserRole + 1).value<Nedrysoft::RouteAnalyser::PingData *>();
+
+    if (( !pingData ) || ( !pingData->responders().isMultipath() )) {
+        return QStyledItemDelegate::helpEvent(event, view, option, index);
+    }
+
+    auto hostMaskerManager = Nedrysoft::Core::IHostMaskerManager::getInstance();
+    auto isMasked = (hostMaskerManager) && (hostMaskerManager->enabled(Nedrysoft::Core::HostMaskType::Screen));
+
+    const auto &responders = pingData->responders();
+
+    QStringList lines;
+
+    lines.append(tr("This hop is load balanced across %1 routers.").arg(responders.count()));
+
+    // the addresses of the other routers are not masked, so only the statistics are shown when masking is enabled.
+
+    for (auto responderIndex=0;responderIndex<responders.count();responderIndex++) {
+        const auto &responder = responders.at(responderIndex);
+
+        auto hostAddress = isMasked ? tr("Router %1").arg(responderIndex+1) : responder.hostAddress.toString();
+
+        if (responder.latencyCount) {
+            lines.append(tr("%1: %2 samples, %3/%4/%5 ms")
+                .arg(hostAddress)
+                .arg(responder.sampleCount)
+                .arg(responder.minimumLatency*1000.0, 0, 'f', 2)
+                .arg(responder.averageLatency*1000.0, 0, 'f', 2)
+                .arg(responder.maximumLatency*1000.0, 0, 'f', 2) );
+        } else {
+            lines.append(tr("%1: %2 samples").arg(hostAddress).arg(responder.sampleCount));
+        }
+    }
+
+    if (responders.overflowCount()) {
+        lines.append(tr("%1 samples from further routers.").arg(responders.overflowCount()));
+    }
+
+    QToolTip::showText(event->globalPos(), lines.join("\n"), view);
+
+    return true;
+}
+
 auto Nedrysoft::RouteAnalyser::RouteTableItemDelegate::paint(
         QPainter *painter,
         const QStyleOptionViewItem &option,
@@ -124,12 +237,22 @@ auto Nedrysoft::RouteAnalyser::RouteTableItemDelegate::paint(
 
             paintBackground(pingData, painter, option, index);
 
+            auto hostAddress = pingData->hostAddress();
+
             if ((hostMaskerManager) && (hostMaskerManager->enabled(Nedrysoft::Core::HostMaskType::Screen))) {
-                paintText(pingData->maskedHostAddress(), painter, option, index, false);
-            } else {
-                paintText(pingData->hostAddress(), painter, option, index, false);
+                hostAddress = pingData->maskedHostAddress();
+            }
+
+            // a load balanced hop shows the number of other routers that have answered for it.
+
+            if (pingData->responders().isMultipath()) {
+                auto otherResponders = std::max(pingData->responders().count()-1, 1);
+
+                hostAddress = QString(tr("%1 (+%2)")).arg(hostAddress).arg(otherResponders);
             }
 
+            paintText(hostAddress, painter, option, index, false);
+
             break;
         }
 
@@ -65,7 +65,43 @@ namespace Nedrysoft { namespace RouteAnalyser {
              */
             auto paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const -> void;
 
+            /**
+             * @brief       Reimplements: QStyledItemDelegate::helpEvent(QHelpEvent *event, QAbstractItemView *view,
+             *              const QStyleOptionViewItem &option, const QModelIndex &index).
+             *
+             * @details     Shows a tooltip over the latency columns which describes the source of the timestamps
+             *              that were used to measure the latency, and over the address column of a load balanced
+             *              hop which lists the routers that have answered for it.
+             *
+             * @param[in]   event the help event.
+             * @param[in]   view the view the item belongs to.
+             * @param[in]   option information about the item.
+             * @param[in]   index the index of the item in the model.
+             *
+             * @returns     true if the event was handled; otherwise false.
+             */
+            auto helpEvent(
+                QHelpEvent *event,
+                QAbstractItemView *view,
+                const QStyleOptionViewItem &option,
+                const QModelIndex &index ) -> bool override;
+
         private:
+            /**
+             * @brief       Shows the tooltip that lists the responders of a hop.
+             *
+             * @param[in]   event the help event.
+             * @param[in]   view the view the item belongs to.
+             * @param[in]   option information about the item.
+             * @param[in]   index the index of the item in the model.
+             *
+             * @returns     true if the event was handled; otherwise false.
+             */
+            auto respondersHelpEvent(
+                QHelpEvent *event,
+                QAbstractItemView *view,
+                const QStyleOptionViewItem &option,
+                const QModelIndex &index ) -> bool;
 
             /**
              * @brief       Returns a route item sibling.
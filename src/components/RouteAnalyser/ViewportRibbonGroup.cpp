@@ -31,6 +31,9 @@
 #include <QDateTime>
 
 constexpr auto DefaultViewportSize = 10*60;
+constexpr auto DefaultDurationIndex = 1;
+constexpr auto MillisecondsInSecond = 1000.0;
+constexpr auto DateTimeFormat = "yyyy-MM-dd hh:mm:ss.zzz";
 
 Nedrysoft::RouteAnalyser::ViewportRibbonGroup::ViewportRibbonGroup(QWidget *parent) :
         QWidget(parent),
@@ -40,6 +43,7 @@ Nedrysoft::RouteAnalyser::ViewportRibbonGroup::ViewportRibbonGroup(QWidget *pare
 
     ui->durationComboBox->addItems(
             QStringList() <<
+                "10 Seconds" <<
                 "60 Seconds" <<
                 "10 Minutes" <<
                 "15 Minutes" <<
@@ -49,6 +53,8 @@ Nedrysoft::RouteAnalyser::ViewportRibbonGroup::ViewportRibbonGroup(QWidget *pare
                 "12 Hours" <<
                 "24 Hours" );
 
+    ui->durationComboBox->setCurrentIndex(DefaultDurationIndex);
+
     connect(ui->trimmerWidget, &TrimmerWidget::positionChanged, [=](double start, double end) {
         Q_EMIT viewportChanged(start, end);
         // TODO: add logic.
@@ -83,13 +89,13 @@ auto Nedrysoft::RouteAnalyser::ViewportRibbonGroup::isViewportEnabled() -> bool
 }
 
 auto Nedrysoft::RouteAnalyser::ViewportRibbonGroup::setStartAndEnd(double start, double end) -> void {
-#if (QT_VERSION_MAJOR>=6)
-    ui->startLineEdit->setText(QDateTime::fromSecsSinceEpoch(start).toString());
-    ui->endLineEdit->setText(QDateTime::fromSecsSinceEpoch(end).toString());
-#else
-    ui->startLineEdit->setText(QDateTime::fromTime_t(start).toString());
-    ui->endLineEdit->setText(QDateTime::fromTime_t(end).toString());
-#endif
+    // the start and end are fractional seconds, milliseconds are shown so that high rate data can be located.
+
+    ui->startLineEdit->setText(
+        QDateTime::fromMSecsSinceEpoch(static_cast<qint64>(start * MillisecondsInSecond)).toString(DateTimeFormat) );
+
+    ui->endLineEdit->setText(
+        QDateTime::fromMSecsSinceEpoch(static_cast<qint64>(end * MillisecondsInSecond)).toString(DateTimeFormat) );
 }
 
 auto Nedrysoft::RouteAnalyser::ViewportRibbonGroup::viewportSize() -> double {
@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 18/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "RouteCache.h"
+
+#include <QDateTime>
+#include <QSettings>
+#include <QStringList>
+#include <QVariantMap>
+
+#include <algorithm>
+
+constexpr auto SettingsGroup = "RouteCache";
+constexpr auto MaximumEntries = 100;
+constexpr auto MaximumAge = 30*24*60*60;
+
+Nedrysoft::RouteEngine::RouteCache::RouteCache() = default;
+
+auto Nedrysoft::RouteEngine::RouteCache::key(const QString &host, Nedrysoft::Core::IPVersion ipVersion) -> QString {
+    // the host is hex encoded as host names and IPv6 addresses contain characters that have a meaning in keys.
+
+    auto versionPrefix = ( ipVersion==Nedrysoft::Core::IPVersion::V6 ) ? QString("v6") : QString("v4");
+
+    return versionPrefix + "-" + QString::fromLatin1(host.toLower().toUtf8().toHex());
+}
+
+auto Nedrysoft::RouteEngine::RouteCache::load(
+        const QString &host,
+        Nedrysoft::Core::IPVersion ipVersion,
+        QHostAddress &hostAddress,
+        Nedrysoft::RouteAnalyser::RouteList &route ) -> bool {
+
+    QSettings settings;
+
+    settings.beginGroup(SettingsGroup);
+
+    auto entry = settings.value(key(host, ipVersion)).toMap();
+
+    if (entry.isEmpty()) {
+        return false;
+    }
+
+    if (QDateTime::currentSecsSinceEpoch()-entry["updated"].toLongLong()>MaximumAge) {
+        return false;
+    }
+
+    auto cachedAddress = QHostAddress(entry["address"].toString());
+    auto hops = entry["hops"].toStringList();
+
+    if (( cachedAddress.isNull() ) || ( hops.isEmpty() )) {
+        return false;
+    }
+
+    // hops that did not respond are stored as empty strings, which convert to a null address.
+
+    route.clear();
+
+    for (auto &hop : hops) {
+        route.append(QHostAddress(hop));
+    }
+
+    hostAddress = cachedAddress;
+
+    return true;
+}
+
+auto Nedrysoft::RouteEngine::RouteCache::save(
+        const QString &host,
+        Nedrysoft::Core::IPVersion ipVersion,
+        const QHostAddress &hostAddress,
+        const Nedrysoft::RouteAnalyser::RouteList &route ) -> void {
+
+    if (( hostAddress.isNull() ) || ( route.isEmpty() )) {
+        return;
+    }
+
+    QSettings settings;
+
+    settings.beginGroup(SettingsGroup);
+
+    QStringList hops;
+
+    for (auto &hop : route) {
+        hops.append(hop.isNull() ? QString() : hop.toString());
+    }
+
+    QVariantMap entry;
+
+    entry["address"] = hostAddress.toString();
+    entry["hops"] = hops;
+    entry["updated"] = QDateTime::currentSecsSinceEpoch();
+
+    settings.setValue(key(host, ipVersion), entry);
+
+    // once the cache is full the entries that were updated least recently are removed.
+
+    auto keys = settings.childKeys();
+
+    if (keys.count()<=MaximumEntries) {
+        return;
+    }
+
+    QList<QPair<qint64, QString> > entries;
+
+    for (auto &entryKey : keys) {
+        entries.append(qMakePair(settings.value(entryKey).toMap()["updated"].toLongLong(), entryKey));
+    }
+
+    std::sort(entries.begin(), entries.end());
+
+    for (auto index=0;index<entries.count()-MaximumEntries;index++) {
+        settings.remove(entries.at(index).second);
+    }
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 18/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PINGNOO_COMPONENTS_ROUTEENGINE_ROUTECACHE_H
+#define PINGNOO_COMPONENTS_ROUTEENGINE_ROUTECACHE_H
+
+#include <ICore>
+#include <IRouteEngine>
+
+#include <QHostAddress>
+#include <QString>
+
+namespace Nedrysoft { namespace RouteEngine {
+    /**
+     * @brief       The RouteCache class stores the last route discovered to each target.
+     *
+     * @details     routes are persisted in the application settings keyed on the target and IP version, so that
+     *              an analysis can be started with the last known route while the route is verified.  Entries
+     *              that have not been updated recently are ignored and the oldest entries are removed once the
+     *              cache is full.
+     */
+    class RouteCache {
+        public:
+            /**
+             * @brief       Constructs a RouteCache.
+             */
+            RouteCache();
+
+            /**
+             * @brief       Loads the cached route to a target.
+             *
+             * @param[in]   host the target host name or address.
+             * @param[in]   ipVersion the IP version of the route.
+             * @param[out]  hostAddress the address of the target when the route was discovered.
+             * @param[out]  route the cached route.
+             *
+             * @returns     true if a valid route was found in the cache; otherwise false.
+             */
+            auto load(
+                const QString &host,
+                Nedrysoft::Core::IPVersion ipVersion,
+                QHostAddress &hostAddress,
+                Nedrysoft::RouteAnalyser::RouteList &route ) -> bool;
+
+            /**
+             * @brief       Saves a discovered route to the cache.
+             *
+             * @param[in]   host the target host name or address.
+             * @param[in]   ipVersion the IP version of the route.
+             * @param[in]   hostAddress the address of the target.
+             * @param[in]   route the discovered route.
+             */
+            auto save(
+                const QString &host,
+                Nedrysoft::Core::IPVersion ipVersion,
+                const QHostAddress &hostAddress,
+                const Nedrysoft::RouteAnalyser::RouteList &route ) -> void;
+
+        private:
+            /**
+             * @brief       Returns the settings key of a target.
+             *
+             * @param[in]   host the target host name or address.
+             * @param[in]   ipVersion the IP version of the route.
+             *
+             * @returns     the key.
+             */
+            auto key(const QString &host, Nedrysoft::Core::IPVersion ipVersion) -> QString;
+    };
+}}
+
+#endif // PINGNOO_COMPONENTS_ROUTEENGINE_ROUTECACHE_H
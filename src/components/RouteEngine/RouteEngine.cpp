@@ -26,6 +26,7 @@
 #include <IPingEngine>
 #include <IPingEngineFactory>
 #include <IPingTarget>
+#include "RouteCache.h"
 #include "RouteEngineWorker.h"
 
 #include <QThread>
@@ -33,10 +34,21 @@
 
 #include <cassert>
 
+constexpr auto MinimumRefreshInterval = 30;
+constexpr auto SecondsToMs = 1000;
+
 Nedrysoft::RouteEngine::RouteEngine::RouteEngine() :
         m_routeWorkerThread(nullptr),
-        m_routeWorker(nullptr) {
+        m_routeWorker(nullptr),
+        m_engineFactory(nullptr),
+        m_ipVersion(Nedrysoft::Core::IPVersion::V4),
+        m_isVerifying(false),
+        m_isDiscovering(false),
+        m_rediscoveryTimer(new QTimer(this)) {
+
+    m_rediscoveryTimer->setSingleShot(true);
 
+    connect(m_rediscoveryTimer, &QTimer::timeout, this, &Nedrysoft::RouteEngine::RouteEngine::startDiscovery);
 }
 
 auto Nedrysoft::RouteEngine::RouteEngine::findRoute(
@@ -44,7 +56,79 @@ auto Nedrysoft::RouteEngine::RouteEngine::findRoute(
         QString host,
         Nedrysoft::Core::IPVersion ipVersion) -> void {
 
-    m_routeWorker = new Nedrysoft::RouteEngine::RouteEngineWorker(host, engineFactory, ipVersion);
+    m_engineFactory = engineFactory;
+    m_host = host;
+    m_ipVersion = ipVersion;
+
+    // a cached route is reported straight away so that the analysis starts without waiting for discovery, the
+    // result is queued so that it is delivered after the caller has returned from findRoute.
+
+    QHostAddress cachedAddress;
+    Nedrysoft::RouteAnalyser::RouteList cachedRoute;
+
+    m_isVerifying = RouteCache().load(host, ipVersion, cachedAddress, cachedRoute);
+
+    m_hostAddress = m_isVerifying ? cachedAddress : QHostAddress();
+
+    if (m_isVerifying) {
+        QTimer::singleShot(0, this, [this, cachedAddress, cachedRoute]() {
+            Q_EMIT result(
+                cachedAddress,
+                cachedRoute,
+                Nedrysoft::RouteAnalyser::RouteResponders(),
+                false,
+                cachedRoute.count(),
+                cachedRoute.count() );
+
+            Q_EMIT result(
+                cachedAddress,
+                cachedRoute,
+                Nedrysoft::RouteAnalyser::RouteResponders(),
+                true,
+                cachedRoute.count(),
+                cachedRoute.count() );
+        });
+    }
+
+    startDiscovery();
+}
+
+auto Nedrysoft::RouteEngine::RouteEngine::setRediscoveryInterval(int interval) -> void {
+    m_rediscoveryInterval = interval;
+
+    if (!m_rediscoveryInterval) {
+        m_rediscoveryTimer->stop();
+    } else if (( !m_isDiscovering ) && ( m_engineFactory )) {
+        m_rediscoveryTimer->start(m_rediscoveryInterval*SecondsToMs);
+    }
+}
+
+auto Nedrysoft::RouteEngine::RouteEngine::refreshRoute() -> void {
+    if (( !m_engineFactory ) || ( m_isDiscovering )) {
+        return;
+    }
+
+    // requests are ignored shortly after a discovery, a change of path is usually seen on several hops at once.
+
+    if (( m_lastDiscoveryTimer.isValid() ) && ( m_lastDiscoveryTimer.elapsed()<MinimumRefreshInterval*SecondsToMs )) {
+        return;
+    }
+
+    startDiscovery();
+}
+
+auto Nedrysoft::RouteEngine::RouteEngine::startDiscovery() -> void {
+    m_rediscoveryTimer->stop();
+
+    m_isDiscovering = true;
+
+    m_lastDiscoveryTimer.start();
+
+    m_routeWorker = new Nedrysoft::RouteEngine::RouteEngineWorker(
+        m_host,
+        m_engineFactory,
+        m_ipVersion,
+        m_hostAddress );
 
     m_routeWorkerThread = new QThread();
 
@@ -56,17 +140,56 @@ auto Nedrysoft::RouteEngine::RouteEngine::findRoute(
         &Nedrysoft::RouteEngine::RouteEngineWorker::doWork
     );
 
-    connect(
-        m_routeWorkerThread,
-        &QThread::finished,
-        [=]() {
-            m_routeWorkerThread->deleteLater();
-    });
+    // the worker deletes itself when discovery has finished, the thread is then stopped and deleted as a new
+    // thread is created for each discovery.
+
+    connect(m_routeWorker, &QObject::destroyed, m_routeWorkerThread, &QThread::quit);
+
+    connect(m_routeWorkerThread, &QThread::finished, m_routeWorkerThread, &QObject::deleteLater);
 
     connect(m_routeWorker,
             &Nedrysoft::RouteEngine::RouteEngineWorker::result,
             this,
-            &Nedrysoft::RouteEngine::RouteEngine::result );
+            &Nedrysoft::RouteEngine::RouteEngine::onWorkerResult );
 
     m_routeWorkerThread->start();
 }
+
+auto Nedrysoft::RouteEngine::RouteEngine::onWorkerResult(
+        const QHostAddress hostAddress,
+        const Nedrysoft::RouteAnalyser::RouteList route,
+        const Nedrysoft::RouteAnalyser::RouteResponders responders,
+        const bool completed,
+        const int totalHops,
+        const int maximumHops ) -> void {
+
+    // only routes that reached the target are cached, a route that ran out of hops may be a transient failure.
+
+    if (( completed ) && ( totalHops!=-1 )) {
+        RouteCache().save(m_host, m_ipVersion, hostAddress, route);
+    }
+
+    if (!m_isVerifying) {
+        Q_EMIT result(hostAddress, route, responders, completed, totalHops, maximumHops);
+    } else if (( completed ) && ( totalHops!=-1 ) && ( !route.isEmpty() )) {
+        Q_EMIT routeUpdated(hostAddress, route, responders);
+    }
+
+    if (!completed) {
+        return;
+    }
+
+    // once a route has been reported, later discoveries verify it and report changes with routeUpdated.  A
+    // verification that failed to resolve the host keeps the reported route and tries again at the next interval.
+
+    m_isDiscovering = false;
+
+    if (!hostAddress.isNull()) {
+        m_hostAddress = hostAddress;
+        m_isVerifying = true;
+    }
+
+    if (( m_isVerifying ) && ( m_rediscoveryInterval )) {
+        m_rediscoveryTimer->start(m_rediscoveryInterval*SecondsToMs);
+    }
+}
@@ -29,10 +29,12 @@
 #include <ICore>
 #include <PingResult>
 #include <QHostAddress>
+#include <QElapsedTimer>
 #include <QHostInfo>
 #include <QList>
 
 class QThread;
+class QTimer;
 
 namespace Nedrysoft { namespace Core {
     class IPingEngineFactory;
@@ -68,6 +70,10 @@ namespace Nedrysoft { namespace RouteEngine {
              * @note        Route discovery is a asynchronous operation, the result signal is emitted when the
              *              discovery is completed.
              *
+             * @details     if the route to the host is in the route cache then the cached route is reported
+             *              immediately and discovery verifies it in the background, the verified route is reported
+             *              with the routeUpdated signal.
+             *
              * @param[in]   engineFactory the ping engine to be used for route discovery.
              * @param[in]   host the target host name or address.
              * @param[in]   ipVersion the IP version to be used for discovery.
@@ -78,12 +84,63 @@ namespace Nedrysoft { namespace RouteEngine {
                     Nedrysoft::Core::IPVersion ipVersion = Nedrysoft::Core::IPVersion::V4
             ) -> void override;
 
+            /**
+             * @brief       Sets how often the route is discovered again once it has been found.
+             *
+             * @param[in]   interval the interval in seconds, 0 disables rediscovery.
+             */
+            auto setRediscoveryInterval(int interval) -> void override;
+
+            /**
+             * @brief       Requests that the route is discovered again now.
+             *
+             * @details     the request is ignored if a discovery is in progress or one was started recently.
+             */
+            auto refreshRoute() -> void override;
+
+        private:
+            /**
+             * @brief       Starts a discovery of the route in a worker thread.
+             */
+            auto startDiscovery() -> void;
+
+            /**
+             * @brief       Called when the worker has a result.
+             *
+             * @details     completed routes are saved to the route cache, results are forwarded unless the route
+             *              is being verified in which case the completed route is reported with routeUpdated.
+             *
+             * @param[in]   hostAddress the target that was requested.
+             * @param[in]   route the route list.
+             * @param[in]   responders the routers that answered at each hop of the route.
+             * @param[in]   completed true if the route has been fully discovered; otherwise false.
+             * @param[in]   totalHops is the total number of hops to the target is available; otherwise -1.
+             * @param[in]   maximumHops is the maximum number of hops to consider.
+             */
+            auto onWorkerResult(
+                const QHostAddress hostAddress,
+                const Nedrysoft::RouteAnalyser::RouteList route,
+                const Nedrysoft::RouteAnalyser::RouteResponders responders,
+                const bool completed,
+                const int totalHops,
+                const int maximumHops ) -> void;
+
         private:
             //! @cond
 
             Nedrysoft::RouteEngine::RouteEngineWorker *m_routeWorker;
             QThread *m_routeWorkerThread;
 
+            Nedrysoft::RouteAnalyser::IPingEngineFactory *m_engineFactory;
+            QString m_host;
+            QHostAddress m_hostAddress;
+            Nedrysoft::Core::IPVersion m_ipVersion;
+            bool m_isVerifying;
+            bool m_isDiscovering;
+            int m_rediscoveryInterval = 0;
+            QTimer *m_rediscoveryTimer;
+            QElapsedTimer m_lastDiscoveryTimer;
+
             //! @endcond
     };
 }}
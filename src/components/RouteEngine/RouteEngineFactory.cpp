@@ -86,6 +86,12 @@ auto Nedrysoft::RouteEngine::RouteEngineFactory::description() -> QString {
 
 auto Nedrysoft::RouteEngine::RouteEngineFactory::priority() -> double {
 #if defined(Q_OS_LINUX)
+    // unprivileged datagram sockets are used when the group of the process is allowed to create them.
+
+    if (Nedrysoft::ICMPSocket::ICMPSocket::isDatagramSupported(Nedrysoft::ICMPSocket::V4)) {
+        return 1;
+    }
+
     auto socket = Nedrysoft::ICMPSocket::ICMPSocket::createReadSocket(Nedrysoft::ICMPSocket::V4);
 
     if (socket) {
@@ -28,15 +28,21 @@
 #include "spdlog.h"
 
 #include <QHostInfo>
+#include <QVector>
+#include <algorithm>
 
 constexpr auto DefaultDiscoveryTimeout = 1.0;
+constexpr auto DiscoveryProbesPerHop = 3;
+constexpr auto DiscoveryWindow = 16;
 constexpr auto MaxRouteHops = 64;
 
 Nedrysoft::RouteEngine::RouteEngineWorker::RouteEngineWorker(
         QString host,
         Nedrysoft::RouteAnalyser::IPingEngineFactory *pingEngineFactory,
-        Nedrysoft::Core::IPVersion ipVersion ) :
+        Nedrysoft::Core::IPVersion ipVersion,
+        QHostAddress preferredAddress ) :
             m_host(host),
+            m_preferredAddress(preferredAddress),
             m_ipVersion(ipVersion),
             m_pingEngineFactory(pingEngineFactory),
             m_isRunning(false),
@@ -61,7 +67,13 @@ auto Nedrysoft::RouteEngine::RouteEngineWorker::doWork() -> void {
     auto targetAddresses = QHostInfo::fromName(m_host).addresses();
 
     if (!targetAddresses.count()) {
-        Q_EMIT result(QHostAddress(), Nedrysoft::RouteAnalyser::RouteList(), true, -1, m_maximumHops);
+        Q_EMIT result(
+            QHostAddress(),
+            Nedrysoft::RouteAnalyser::RouteList(),
+            Nedrysoft::RouteAnalyser::RouteResponders(),
+            true,
+            -1,
+            m_maximumHops );
 
         SPDLOG_ERROR(QString("Failed to find address for %1.").arg(m_host).toStdString());
 
@@ -70,42 +82,118 @@ auto Nedrysoft::RouteEngine::RouteEngineWorker::doWork() -> void {
         return;
     }
 
-    auto route = Nedrysoft::RouteAnalyser::RouteList();
+    // the order of the resolved addresses can change between lookups, the address that the route is already
+    // reported for is kept while it is still valid so that the caller only re-targets when the host has moved.
 
-    auto pingResult = pingEngine->singleShot(
-        targetAddresses.at(0),
-        m_maximumHops,
-        DefaultDiscoveryTimeout
-    );
+    auto targetAddress = targetAddresses.contains(m_preferredAddress) ? m_preferredAddress : targetAddresses.at(0);
 
-    if (pingResult.code()==Nedrysoft::RouteAnalyser::PingResult::ResultCode::Ok) {
-        totalHops = pingResult.hops();
-    }
+    // an engine that sends the pings of a multiShot one after another would wait a timeout for every unanswered
+    // probe, so the hops are only probed more than once when the engine sends them together.
 
-    for (int hop=1;hop<MaxRouteHops;hop++) {
+    auto probesPerHop = pingEngine->hasParallelMultiShot() ? DiscoveryProbesPerHop : 1;
+
+    auto route = Nedrysoft::RouteAnalyser::RouteList();
+    auto responders = Nedrysoft::RouteAnalyser::RouteResponders();
+    auto isComplete = false;
+
+    // the hops are probed a window at a time, the ttl's of a window are sent together so that a window takes at most
+    // a single timeout.  Each ttl is probed several times, each probe is hashed to its own flow so that the routers of
+    // a load balanced hop are found.  Hops are added to the route in order as soon as every probe of the hop and of
+    // the hops before it has a result.
+
+    for (int firstHop=1;( firstHop<MaxRouteHops ) && ( !isComplete );firstHop+=DiscoveryWindow) {
         if (!m_isRunning) {
             m_pingEngineFactory->deleteEngine(pingEngine);
 
             return;
         }
 
-        pingResult = pingEngine->singleShot(targetAddresses.at(0), hop, DefaultDiscoveryTimeout);
+        QVector<int> ttls;
 
-        if (pingResult.code()==Nedrysoft::RouteAnalyser::PingResult::ResultCode::Ok) {
-            route.append(pingResult.hostAddress());
-            break;
-        } else  if (pingResult.code()==Nedrysoft::RouteAnalyser::PingResult::ResultCode::TimeExceeded) {
-            route.append(pingResult.hostAddress());
-        } else  {
-            route.append(QHostAddress());
+        for (int hop=firstHop;hop<std::min(firstHop+DiscoveryWindow, MaxRouteHops);hop++) {
+            for (int probe=0;probe<probesPerHop;probe++) {
+                ttls.append(hop);
+            }
         }
 
-        Q_EMIT result(targetAddresses[0], route, false, totalHops, m_maximumHops);
-    };
+        QVector<Nedrysoft::RouteAnalyser::PingResult> windowResults(ttls.count());
+        QVector<bool> hasResult(ttls.count(), false);
+        auto nextIndex = 0;
+
+        pingEngine->multiShot(
+            targetAddress,
+            ttls,
+            DefaultDiscoveryTimeout,
+            [&](int index, const Nedrysoft::RouteAnalyser::PingResult &pingResult) {
+
+                windowResults[index] = pingResult;
+                hasResult[index] = true;
+
+                while (( !isComplete ) && ( nextIndex<ttls.count() )) {
+                    auto hopAnswered = std::all_of(
+                        hasResult.begin()+nextIndex,
+                        hasResult.begin()+nextIndex+probesPerHop,
+                        [](bool value) {
+                            return value;
+                        }
+                    );
+
+                    if (!hopAnswered) {
+                        break;
+                    }
+
+                    auto hopResponders = Nedrysoft::RouteAnalyser::HopResponders();
+                    auto hostAddress = QHostAddress();
+
+                    for (int probe=0;probe<probesPerHop;probe++) {
+                        auto hopResult = windowResults[nextIndex++];
+
+                        switch (hopResult.code()) {
+                            case Nedrysoft::RouteAnalyser::PingResult::ResultCode::Ok: {
+                                hostAddress = hopResult.hostAddress();
+                                isComplete = true;
+
+                                hopResponders.addSample(hopResult.hostAddress(), hopResult.roundTripTime());
+
+                                break;
+                            }
+
+                            case Nedrysoft::RouteAnalyser::PingResult::ResultCode::TimeExceeded: {
+                                hopResponders.addSample(hopResult.hostAddress(), hopResult.roundTripTime());
+
+                                break;
+                            }
+
+                            default: {
+                                break;
+                            }
+                        }
+                    }
+
+                    // the hop is shown as the router that answered the most probes, unless the target answered.
+
+                    if (( hostAddress.isNull() ) && ( hopResponders.count() )) {
+                        hostAddress = hopResponders.at(hopResponders.primaryIndex()).hostAddress;
+                    }
+
+                    route.append(hostAddress);
+                    responders.append(hopResponders);
+
+                    if (isComplete) {
+                        totalHops = route.count();
+
+                        break;
+                    }
+
+                    Q_EMIT result(targetAddress, route, responders, false, totalHops, m_maximumHops);
+                }
+            }
+        );
+    }
 
     SPDLOG_TRACE(QString("Route to %1 (%2) completed, total of %3 hops.")
                          .arg(m_host)
-                         .arg(m_targetAddresses[0].toString())
+                         .arg(targetAddress.toString())
                          .arg(route.length())
                          .toStdString() );
 
@@ -115,8 +203,8 @@ auto Nedrysoft::RouteEngine::RouteEngineWorker::doWork() -> void {
      * set to false, without the extra emit the final hop would behave differently.
      */
 
-    Q_EMIT result(targetAddresses[0], route, false, totalHops, m_maximumHops);
-    Q_EMIT result(targetAddresses[0], route, true, totalHops, m_maximumHops);
+    Q_EMIT result(targetAddress, route, responders, false, totalHops, m_maximumHops);
+    Q_EMIT result(targetAddress, route, responders, true, totalHops, m_maximumHops);
 
     m_pingEngineFactory->deleteEngine(pingEngine);
 
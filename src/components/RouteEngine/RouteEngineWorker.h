@@ -48,10 +48,17 @@ namespace Nedrysoft { namespace RouteEngine {
     public:
         /**
          * @brief       Constructs a RouteEngineWorker.
+         *
+         * @param[in]   target the host name or address to discover the route to.
+         * @param[in]   pingEngineFactory the factory used to create the engine that probes the route.
+         * @param[in]   ipVersion the IP version to use.
+         * @param[in]   preferredAddress the address the route is currently reported for, it is kept while the
+         *              host still resolves to it so that a host with several addresses does not change target.
          */
         RouteEngineWorker(QString target,
                           Nedrysoft::RouteAnalyser::IPingEngineFactory *pingEngineFactory,
-                          Nedrysoft::Core::IPVersion ipVersion );
+                          Nedrysoft::Core::IPVersion ipVersion,
+                          QHostAddress preferredAddress = QHostAddress() );
 
         /**
          * @brief       Destroys the RouteEngineWorker.
@@ -68,6 +75,7 @@ namespace Nedrysoft { namespace RouteEngine {
          *
          * @param[in]   hostAddress the target that was requested.
          * @param[in]   result the route list.
+         * @param[in]   responders the routers that answered at each hop of the route.
          * @param[in]   completed true if the route has been fully discovered; otherwise false.
          * @param[in]   totalHops is the total number of hops to the target is available; otherwise -1.
          * @param[in]   maximumHops is the maximum number of hops to consider, if the TTL exceeds this then
@@ -76,6 +84,7 @@ namespace Nedrysoft { namespace RouteEngine {
         Q_SIGNAL void result(
             const QHostAddress hostAddress,
             const Nedrysoft::RouteAnalyser::RouteList result,
+            const Nedrysoft::RouteAnalyser::RouteResponders responders,
             const bool completed,
             const int totalHops,
             const int maximumHops
@@ -87,6 +96,7 @@ namespace Nedrysoft { namespace RouteEngine {
         Nedrysoft::RouteAnalyser::IPingEngineFactory *m_pingEngineFactory;
         Nedrysoft::Core::IPVersion m_ipVersion;
         QString m_host;
+        QHostAddress m_preferredAddress;
 
         int m_maximumHops;
         bool m_isRunning;
@@ -0,0 +1,287 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 18/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ICMPChecksum.h"
+
+#include <climits>
+#include <cstring>
+#include <initializer_list>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define NEDRYSOFT_ICMPCHECKSUM_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(NEDRYSOFT_ICMPCHECKSUM_X86) && ( defined(__GNUC__) || defined(__clang__) )
+#define NEDRYSOFT_TARGET(name) __attribute__((target(name)))
+#else
+#define NEDRYSOFT_TARGET(name)
+#endif
+
+namespace {
+    using ChecksumFunction = uint64_t (*)(const unsigned char *, size_t);
+
+    /**
+     * @brief       Folds a 64 bit one's complement sum to 16 bits and complements it.
+     */
+    auto fold(uint64_t sum) -> uint16_t {
+        sum = ( sum >> 32 ) + ( sum & UINT32_MAX );
+        sum = ( sum >> 32 ) + ( sum & UINT32_MAX );
+        sum = ( sum >> 16 ) + ( sum & UINT16_MAX );
+        sum = ( sum >> 16 ) + ( sum & UINT16_MAX );
+
+        return static_cast<uint16_t>(~sum);
+    }
+
+    /**
+     * @brief       Sums the data as 32 bit words, the trailing bytes are summed as 16 bit words and a final odd byte
+     *              is padded with zero.
+     */
+    auto scalarSum(const unsigned char *data, size_t length) -> uint64_t {
+        uint64_t sum = 0;
+
+        while (length >= sizeof(uint32_t)) {
+            uint32_t word;
+
+            memcpy(&word, data, sizeof(word));
+
+            sum += word;
+
+            data += sizeof(uint32_t);
+            length -= sizeof(uint32_t);
+        }
+
+        if (length >= sizeof(uint16_t)) {
+            uint16_t word;
+
+            memcpy(&word, data, sizeof(word));
+
+            sum += word;
+
+            data += sizeof(uint16_t);
+            length -= sizeof(uint16_t);
+        }
+
+        if (length) {
+            uint16_t word = 0;
+
+            memcpy(&word, data, 1);
+
+            sum += word;
+        }
+
+        return sum;
+    }
+
+#if defined(NEDRYSOFT_ICMPCHECKSUM_X86)
+    /**
+     * @brief       Sums the data 16 bytes at a time, each 32 bit word is widened to 64 bits so the accumulators
+     *              cannot overflow.
+     */
+    NEDRYSOFT_TARGET("sse2")
+    auto sse2Sum(const unsigned char *data, size_t length) -> uint64_t {
+        constexpr size_t BlockSize = sizeof(__m128i);
+
+        auto zero = _mm_setzero_si128();
+        auto accumulatorA = _mm_setzero_si128();
+        auto accumulatorB = _mm_setzero_si128();
+
+        while (length >= BlockSize) {
+            auto block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data));
+
+            accumulatorA = _mm_add_epi64(accumulatorA, _mm_unpacklo_epi32(block, zero));
+            accumulatorB = _mm_add_epi64(accumulatorB, _mm_unpackhi_epi32(block, zero));
+
+            data += BlockSize;
+            length -= BlockSize;
+        }
+
+        uint64_t lanes[2];
+
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes), _mm_add_epi64(accumulatorA, accumulatorB));
+
+        uint64_t sum = ( lanes[0] >> 32 ) + ( lanes[0] & UINT32_MAX ) + ( lanes[1] >> 32 ) + ( lanes[1] & UINT32_MAX );
+
+        return sum + scalarSum(data, length);
+    }
+
+    /**
+     * @brief       Sums the data 32 bytes at a time, each 32 bit word is widened to 64 bits so the accumulators
+     *              cannot overflow.
+     */
+    NEDRYSOFT_TARGET("avx2")
+    auto avx2Sum(const unsigned char *data, size_t length) -> uint64_t {
+        constexpr size_t BlockSize = sizeof(__m256i);
+
+        auto zero = _mm256_setzero_si256();
+        auto accumulatorA = _mm256_setzero_si256();
+        auto accumulatorB = _mm256_setzero_si256();
+
+        while (length >= BlockSize) {
+            auto block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data));
+
+            accumulatorA = _mm256_add_epi64(accumulatorA, _mm256_unpacklo_epi32(block, zero));
+            accumulatorB = _mm256_add_epi64(accumulatorB, _mm256_unpackhi_epi32(block, zero));
+
+            data += BlockSize;
+            length -= BlockSize;
+        }
+
+        uint64_t lanes[4];
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes), _mm256_add_epi64(accumulatorA, accumulatorB));
+
+        uint64_t sum = 0;
+
+        for (auto lane : lanes) {
+            sum += ( lane >> 32 ) + ( lane & UINT32_MAX );
+        }
+
+        return sum + scalarSum(data, length);
+    }
+
+    /**
+     * @brief       Queries the processor for a feature.
+     */
+    auto processorSupports(Nedrysoft::ICMPPacket::ICMPChecksum::Implementation implementation) -> bool {
+#if defined(_MSC_VER)
+        int registers[4];
+
+        __cpuid(registers, 0);
+
+        auto highestFunction = registers[0];
+
+        if (implementation == Nedrysoft::ICMPPacket::ICMPChecksum::Implementation::SSE2) {
+            __cpuid(registers, 1);
+
+            return ( registers[3] & ( 1 << 26 ) ) != 0;
+        }
+
+        if (highestFunction < 7) {
+            return false;
+        }
+
+        __cpuid(registers, 1);
+
+        // the operating system must save the ymm registers (OSXSAVE and XCR0 bits 1 and 2).
+
+        if (!( registers[2] & ( 1 << 27 ) ) || ( ( _xgetbv(0) & 0x6 ) != 0x6 )) {
+            return false;
+        }
+
+        __cpuidex(registers, 7, 0);
+
+        return ( registers[1] & ( 1 << 5 ) ) != 0;
+#else
+        __builtin_cpu_init();
+
+        if (implementation == Nedrysoft::ICMPPacket::ICMPChecksum::Implementation::SSE2) {
+            return __builtin_cpu_supports("sse2");
+        }
+
+        return __builtin_cpu_supports("avx2");
+#endif
+    }
+#endif
+
+    /**
+     * @brief       Returns the function for an implementation.
+     */
+    auto checksumFunction(Nedrysoft::ICMPPacket::ICMPChecksum::Implementation implementation) -> ChecksumFunction {
+        switch (implementation) {
+#if defined(NEDRYSOFT_ICMPCHECKSUM_X86)
+            case Nedrysoft::ICMPPacket::ICMPChecksum::Implementation::SSE2: {
+                return sse2Sum;
+            }
+
+            case Nedrysoft::ICMPPacket::ICMPChecksum::Implementation::AVX2: {
+                return avx2Sum;
+            }
+#endif
+            default: {
+                return scalarSum;
+            }
+        }
+    }
+
+    /**
+     * @brief       Selects the fastest implementation supported by the processor.
+     */
+    auto selectImplementation() -> Nedrysoft::ICMPPacket::ICMPChecksum::Implementation {
+        for (auto implementation : {
+                Nedrysoft::ICMPPacket::ICMPChecksum::Implementation::AVX2,
+                Nedrysoft::ICMPPacket::ICMPChecksum::Implementation::SSE2 }) {
+
+            if (Nedrysoft::ICMPPacket::ICMPChecksum::isSupported(implementation)) {
+                return implementation;
+            }
+        }
+
+        return Nedrysoft::ICMPPacket::ICMPChecksum::Implementation::Scalar;
+    }
+}
+
+auto Nedrysoft::ICMPPacket::ICMPChecksum::checksum(const void *buffer, int length) -> uint16_t {
+    static const auto selectedFunction = checksumFunction(implementation());
+
+    if (length <= 0) {
+        return fold(0);
+    }
+
+    return fold(selectedFunction(static_cast<const unsigned char *>(buffer), static_cast<size_t>(length)));
+}
+
+auto Nedrysoft::ICMPPacket::ICMPChecksum::checksum(
+        const void *buffer,
+        int length,
+        Nedrysoft::ICMPPacket::ICMPChecksum::Implementation implementation) -> uint16_t {
+
+    if (length <= 0) {
+        return fold(0);
+    }
+
+    return fold(checksumFunction(implementation)(static_cast<const unsigned char *>(buffer), static_cast<size_t>(length)));
+}
+
+auto Nedrysoft::ICMPPacket::ICMPChecksum::isSupported(
+        Nedrysoft::ICMPPacket::ICMPChecksum::Implementation implementation) -> bool {
+
+    if (implementation == Implementation::Scalar) {
+        return true;
+    }
+
+#if defined(NEDRYSOFT_ICMPCHECKSUM_X86)
+    return processorSupports(implementation);
+#else
+    return false;
+#endif
+}
+
+auto Nedrysoft::ICMPPacket::ICMPChecksum::implementation() -> Nedrysoft::ICMPPacket::ICMPChecksum::Implementation {
+    static const auto selectedImplementation = selectImplementation();
+
+    return selectedImplementation;
+}
@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 18/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NEDRYSOFT_ICMPPACKET_ICMPCHECKSUM_H
+#define NEDRYSOFT_ICMPPACKET_ICMPCHECKSUM_H
+
+#include <QtGlobal>
+
+#include <cstdint>
+
+#if ( defined(NEDRYSOFT_LIBRARY_ICMPPACKET_EXPORT))
+#define NEDRYSOFT_ICMPPACKET_DLLSPEC Q_DECL_EXPORT
+#else
+#define NEDRYSOFT_ICMPPACKET_DLLSPEC Q_DECL_IMPORT
+#endif
+
+namespace Nedrysoft { namespace ICMPPacket {
+    /**
+     * @brief       The ICMPChecksum class calculates the internet checksum (RFC 1071).
+     *
+     * @details     The one's complement sum is independent of byte order, so the data is summed in host byte order
+     *              as wide words and folded to 16 bits at the end.  Vectorised SSE2 and AVX2 implementations are
+     *              provided on x86 processors, the fastest implementation supported by the processor is selected
+     *              the first time a checksum is calculated, other processors use the scalar implementation.
+     *
+     *              The returned checksum is in host byte order as read from memory, so it can be stored directly
+     *              into the checksum field of a packet.  A buffer that contains a valid checksum sums to 0.
+     */
+    class NEDRYSOFT_ICMPPACKET_DLLSPEC ICMPChecksum {
+        public:
+            /**
+             * @brief       The available checksum implementations.
+             */
+            enum class Implementation {
+                Scalar,                     /**< portable implementation. */
+                SSE2,                       /**< 128 bit vector implementation. */
+                AVX2                        /**< 256 bit vector implementation. */
+            };
+
+        public:
+            /**
+             * @brief       Calculates the checksum using the fastest supported implementation.
+             *
+             * @param[in]   buffer the data.
+             * @param[in]   length the length of the data, an odd length is padded with a zero byte.
+             *
+             * @returns     the checksum.
+             */
+            static auto checksum(const void *buffer, int length) -> uint16_t;
+
+            /**
+             * @brief       Calculates the checksum using the given implementation.
+             *
+             * @note        The implementation must be supported by the processor, see isSupported().
+             *
+             * @param[in]   buffer the data.
+             * @param[in]   length the length of the data, an odd length is padded with a zero byte.
+             * @param[in]   implementation the implementation to use.
+             *
+             * @returns     the checksum.
+             */
+            static auto checksum(const void *buffer, int length, Implementation implementation) -> uint16_t;
+
+            /**
+             * @brief       Returns whether an implementation is supported by the processor.
+             *
+             * @param[in]   implementation the implementation.
+             *
+             * @returns     true if supported; otherwise false.
+             */
+            static auto isSupported(Implementation implementation) -> bool;
+
+            /**
+             * @brief       Returns the implementation that is used by checksum().
+             *
+             * @returns     the selected implementation.
+             */
+            static auto implementation() -> Implementation;
+    };
+}}
+
+#endif // NEDRYSOFT_ICMPPACKET_ICMPCHECKSUM_H
@@ -23,6 +23,8 @@
 
 #include "ICMPPacket.h"
 
+#include "ICMPChecksum.h"
+#include "ICMPReplyView.h"
 #include "Utils.h"
 
 #include <array>
@@ -40,34 +42,9 @@
 #include <WS2tcpip.h>
 #endif
 
-#include <QDataStream>
 #include <QtEndian>
 #include <gsl/gsl>
 
-/**
- * @private
- */
-struct ipv6_header {
-    unsigned int version: 4;
-    unsigned int trafficClass: 8;
-    unsigned int flowLabel: 20;
-    uint16_t payloadLength;
-    uint8_t nextHeader;
-    uint8_t hopLimit;
-    uint8_t sourceAddress[16];
-    uint8_t destinationAddress[16];
-};
-
-/**
- * @private
- */
-struct icmp_header {
-    uint8_t type;
-    uint8_t code;
-    uint16_t checksum;
-    uint32_t reserved;
-};
-
 /**
  * @private
  */
@@ -88,7 +65,6 @@ struct icmp_v6 {
 };
 
 constexpr auto ICMP6_ECHO = 128;
-constexpr auto ICMP6_ECHO_REPLY = 129;
 
 Nedrysoft::ICMPPacket::ICMPPacket::ICMPPacket() :
         m_resultCode(Invalid),
@@ -115,119 +91,56 @@ Nedrysoft::ICMPPacket::ICMPPacket::ICMPPacket(
 
 auto Nedrysoft::ICMPPacket::ICMPPacket::fromData(
         const QByteArray &dataBuffer,
-        Nedrysoft::ICMPPacket::IPVersion version) -> Nedrysoft::ICMPPacket::ICMPPacket {
+        Nedrysoft::ICMPPacket::IPVersion version,
+        Nedrysoft::ICMPPacket::PacketFormat format) -> Nedrysoft::ICMPPacket::ICMPPacket {
 
-    if (version == Nedrysoft::ICMPPacket::V4) {
-        return fromData_v4(dataBuffer);
-    } else if (version == Nedrysoft::ICMPPacket::V6) {
-        return fromData_v6(dataBuffer);
-    } else {
+    auto replyView = Nedrysoft::ICMPPacket::ICMPReplyView(
+        gsl::span<const uint8_t>(reinterpret_cast<const uint8_t *>(dataBuffer.constData()), dataBuffer.length()),
+        version,
+        format );
+
+    if (!replyView.isValid()) {
         return ICMPPacket();
     }
-}
-
-auto Nedrysoft::ICMPPacket::ICMPPacket::fromData_v4(const QByteArray &dataBuffer) -> Nedrysoft::ICMPPacket::ICMPPacket {
-    unsigned char ip_vhl;
-    unsigned char ip_vhl_tx;
-    unsigned char ip_header_size;
-    unsigned char ip_header_size_tx;
-    uint16_t received_id;
-    uint16_t received_sequence;
-    constexpr unsigned int IP_HEADER_LENGTH_MASK = 0x0F;
-
-    auto mainSpan = gsl::span<const unsigned char>(
-            reinterpret_cast<const unsigned char *>(dataBuffer.data()),
-            dataBuffer.length() );
-
-    ip_vhl = mainSpan[0];
-    ip_header_size = ( ip_vhl & IP_HEADER_LENGTH_MASK ) * sizeof(uint32_t);
-
-    auto responseSpan = mainSpan.subspan(ip_header_size);
-
-    auto icmp_response = reinterpret_cast<const struct icmp *>(responseSpan.data());
-
-    if (icmp_response->icmp_code == ICMP_ECHOREPLY) {
-        if (icmp_response->icmp_type == ICMP_ECHOREPLY) {
-            auto ip_response = reinterpret_cast<const struct ip *>(dataBuffer.data());
 
-            received_id = qFromBigEndian<uint16_t>(icmp_response->icmp_hun.ih_idseq.icd_id);
-            received_sequence = qFromBigEndian<uint16_t>(icmp_response->icmp_hun.ih_idseq.icd_seq);
+    // the ttl is only reported for echo replies, for a time exceeded message it is the ttl of the router's reply.
 
-            return ICMPPacket(received_id, received_sequence, EchoReply, V4, ip_response->ip_ttl);
-        }
-
-        if (icmp_response->icmp_type == ICMP_TIMXCEED) {
-            constexpr unsigned int IP_HEADER_OFFSET = 0x08;
-
-            ip_vhl_tx = mainSpan[ip_header_size + IP_HEADER_OFFSET];
-            ip_header_size_tx = ( ip_vhl_tx & IP_HEADER_LENGTH_MASK ) * sizeof(uint32_t);
-
-            auto receivedRequestSpan = mainSpan.subspan(ip_header_size + IP_HEADER_OFFSET + ip_header_size_tx);
-
-            auto received_icmp_request = reinterpret_cast<const struct icmp *>(receivedRequestSpan.data());
-
-            received_id = qFromBigEndian<uint16_t>(received_icmp_request->icmp_hun.ih_idseq.icd_id);
+    auto ttl = -1;
 
-            received_sequence = qFromBigEndian<uint16_t>(received_icmp_request->icmp_hun.ih_idseq.icd_seq);
-
-            return ICMPPacket(received_id, received_sequence, TimeExceeded, V4, -1);
-        }
+    if (replyView.resultCode() == Nedrysoft::ICMPPacket::EchoReply) {
+        ttl = replyView.ttl();
     }
 
-    return ICMPPacket();
+    return ICMPPacket(replyView.id(), replyView.sequence(), replyView.resultCode(), version, ttl);
 }
 
-auto Nedrysoft::ICMPPacket::ICMPPacket::fromData_v6(const QByteArray &dataBuffer) -> Nedrysoft::ICMPPacket::ICMPPacket {
-    uint16_t received_id;
-    uint16_t received_sequence;
-
-    auto responseSpan = gsl::span<const unsigned char>(
-            reinterpret_cast<const unsigned char *>(dataBuffer.data()),
-            dataBuffer.length() );
-
-    auto icmp_response = reinterpret_cast<const struct icmp *>(responseSpan.data());
-
-    if (icmp_response->icmp_code == 0) {
-        if (icmp_response->icmp_type == ICMP6_ECHO_REPLY) {
-            received_id = qFromBigEndian<uint16_t>(icmp_response->icmp_hun.ih_idseq.icd_id);
-            received_sequence = qFromBigEndian<uint16_t>(icmp_response->icmp_hun.ih_idseq.icd_seq);
-
-            return ICMPPacket(received_id, received_sequence, EchoReply, V6, -1);
-        }
-
-        if (icmp_response->icmp_type == 3) {
-            auto ip_response = reinterpret_cast<const struct ipv6_header *>(dataBuffer.data());
-            auto request_icmp_header = responseSpan.subspan(sizeof(icmp_header) + sizeof(ipv6_header));
+auto Nedrysoft::ICMPPacket::ICMPPacket::checksum(const void *buffer, int length) -> uint16_t {
+    return Nedrysoft::ICMPPacket::ICMPChecksum::checksum(buffer, length);
+}
 
-            auto rx_icmp_request = reinterpret_cast<const struct icmp *>(request_icmp_header.data());
+auto Nedrysoft::ICMPPacket::ICMPPacket::isChecksumValid(
+        const QByteArray &dataBuffer,
+        Nedrysoft::ICMPPacket::IPVersion version) -> bool {
 
-            received_id = qFromBigEndian<uint16_t>(rx_icmp_request->icmp_hun.ih_idseq.icd_id);
-            received_sequence = qFromBigEndian<uint16_t>(rx_icmp_request->icmp_hun.ih_idseq.icd_seq);
+    constexpr unsigned int IP_HEADER_LENGTH_MASK = 0x0F;
 
-            return ICMPPacket(received_id, received_sequence, TimeExceeded, V6, ip_response->hopLimit);
-        }
+    if (version != Nedrysoft::ICMPPacket::V4) {
+        return true;
     }
 
-    return ICMPPacket();
-}
-
-auto Nedrysoft::ICMPPacket::ICMPPacket::checksum(void *buffer, int length) -> uint16_t {
-    QByteArray dataArray(reinterpret_cast<char *>(buffer), length);
-    QDataStream dataStream(dataArray);
-    uint32_t checksum = 0;
-
-    dataStream.setByteOrder(QDataStream::LittleEndian);
+    if (dataBuffer.isEmpty()) {
+        return false;
+    }
 
-    while (!dataStream.atEnd()) {
-        checksum += read<uint16_t>(dataStream);
+    auto ip_header_size = static_cast<int>(( dataBuffer.at(0) & IP_HEADER_LENGTH_MASK ) * sizeof(uint32_t));
 
-        length -= 2;
+    if (dataBuffer.length() <= ip_header_size) {
+        return false;
     }
 
-    checksum = ( checksum >> ( sizeof(uint16_t) * CHAR_BIT )) + ( checksum & UINT16_MAX );
-    checksum += ( checksum >> ( sizeof(uint16_t) * CHAR_BIT ));
-
-    return static_cast<uint16_t>(~checksum);
+    return Nedrysoft::ICMPPacket::ICMPChecksum::checksum(
+        dataBuffer.constData() + ip_header_size,
+        dataBuffer.length() - ip_header_size ) == 0;
 }
 
 auto Nedrysoft::ICMPPacket::ICMPPacket::resultCode() -> Nedrysoft::ICMPPacket::ResultCode {
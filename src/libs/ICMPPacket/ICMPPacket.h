@@ -54,6 +54,14 @@ namespace Nedrysoft { namespace ICMPPacket {
         TimeExceeded = 2
     };
 
+    /**
+     * @brief       The format of the packets returned by a socket.
+     */
+    enum class PacketFormat {
+        Raw,                                /**< raw socket, IPv4 packets start with the IP header. */
+        Datagram                            /**< datagram (ping) socket, packets start with the ICMP header. */
+    };
+
     /**
      * @brief       THe ICMPPacket class provides functions to decode and encode ICMP packets.
      */
@@ -62,22 +70,45 @@ namespace Nedrysoft { namespace ICMPPacket {
             /**
              * @brief       Creates an ICMP packet from raw data.
              *
+             * @see         Nedrysoft::ICMPPacket::ICMPReplyView
+             *
              * @param[in]   dataBuffer the raw icmp packet.
              * @param[in]   version version of ICMP packet we are expecting.
+             * @param[in]   format the format of the packet, datagram sockets do not return the IP header.
              *
              * @returns     the decoded packet.
              */
-            static auto fromData(const QByteArray &dataBuffer, IPVersion version) -> ICMPPacket;
+            static auto fromData(
+                const QByteArray &dataBuffer,
+                IPVersion version,
+                PacketFormat format = PacketFormat::Raw
+            ) -> ICMPPacket;
 
             /**
              * @brief       Calculate ICMP crc16 from raw data.
              *
+             * @see         Nedrysoft::ICMPPacket::ICMPChecksum
+             *
              * @param[in]   buffer the raw icmp packet.
              * @param[in]   length the length of the packet.
              *
              * @returns     the crc16 result.
              */
-            static auto checksum(void *buffer, int length) -> uint16_t;
+            static auto checksum(const void *buffer, int length) -> uint16_t;
+
+            /**
+             * @brief       Checks the ICMP checksum of a received packet.
+             *
+             * @details     IPv4 packets include the IP header, the checksum of the ICMP message that follows it is
+             *              checked.  The ICMPv6 checksum covers a pseudo header that is not available to the
+             *              application and is checked by the kernel, so IPv6 packets are always reported as valid.
+             *
+             * @param[in]   dataBuffer the raw packet as received from the socket.
+             * @param[in]   version the IP version of the packet.
+             *
+             * @returns     true if the checksum is valid; otherwise false.
+             */
+            static auto isChecksumValid(const QByteArray &dataBuffer, IPVersion version) -> bool;
 
             /**
              * @brief       Create a ping request packet.
@@ -152,24 +183,6 @@ namespace Nedrysoft { namespace ICMPPacket {
              */
             ICMPPacket(uint16_t id, uint16_t sequence, ResultCode resultCode, IPVersion ipVersion, int ttl);
 
-            /**
-             * @brief       Decodes an ipv4 icmp packet for from raw data.
-             *
-             * @param[in]   dataBuffer the raw data.
-             *
-             * @returns     the decoded icmp packet.
-             */
-            static auto fromData_v4(const QByteArray &dataBuffer) -> ICMPPacket;
-
-            /**
-             * @brief       Decodes a ipv6 icmp packet for from raw data.
-             *
-             * @param[in]   dataBuffer the raw data.
-             *
-             * @returns     the decoded icmp packet.
-             */
-            static auto fromData_v6(const QByteArray &dataBuffer) -> ICMPPacket;
-
             /**
              * @brief       Creates an ipv6 icmp packet.
              *
@@ -204,18 +217,6 @@ namespace Nedrysoft { namespace ICMPPacket {
                 const QHostAddress &destinationAddress
             ) -> QByteArray;
 
-            /**
-             * @brief       Template to read raw data from a data stream.
-             */
-            template<class T>
-            static auto read(QDataStream &dataStream) -> T {
-                T data;
-
-                dataStream >> data;
-
-                return data;
-            }
-
         private:
             //! @cond
 
@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 18/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ICMPPacketTemplate.h"
+
+#include <QtEndian>
+#include <climits>
+#include <cstring>
+
+constexpr auto ChecksumOffset = 2;
+constexpr auto SequenceOffset = 6;
+constexpr auto PayloadOffset = 8;
+constexpr auto TimestampWords = static_cast<int>(sizeof(int64_t) / sizeof(uint16_t));
+
+namespace {
+    /**
+     * @brief       Reads a 16 bit word in host byte order from an unaligned buffer.
+     */
+    auto readWord(const char *buffer) -> uint16_t {
+        uint16_t word;
+
+        memcpy(&word, buffer, sizeof(word));
+
+        return word;
+    }
+
+    /**
+     * @brief       Writes a 16 bit word in host byte order to an unaligned buffer.
+     */
+    auto writeWord(char *buffer, uint16_t word) -> void {
+        memcpy(buffer, &word, sizeof(word));
+    }
+}
+
+Nedrysoft::ICMPPacket::ICMPPacketTemplate::ICMPPacketTemplate(
+        uint16_t id,
+        int payloadLength,
+        const QHostAddress &destinationAddress,
+        Nedrysoft::ICMPPacket::IPVersion version) :
+            m_packet(Nedrysoft::ICMPPacket::ICMPPacket::pingPacket(id, 0, payloadLength, destinationAddress, version)),
+            m_id(id),
+            m_hasTimestamp(false) {
+
+    m_hasTimestamp = ( m_packet.length() >= static_cast<int>(PayloadOffset + sizeof(int64_t)) );
+}
+
+auto Nedrysoft::ICMPPacket::ICMPPacketTemplate::length() const -> int {
+    return m_packet.length();
+}
+
+auto Nedrysoft::ICMPPacket::ICMPPacketTemplate::id() const -> uint16_t {
+    return m_id;
+}
+
+auto Nedrysoft::ICMPPacket::ICMPPacketTemplate::write(
+        char *buffer,
+        int bufferLength,
+        uint16_t sequence,
+        int64_t timestamp) const -> int {
+
+    auto packetLength = m_packet.length();
+
+    if (( !packetLength ) || ( bufferLength < packetLength )) {
+        return 0;
+    }
+
+    auto templateData = m_packet.constData();
+
+    memcpy(buffer, templateData, static_cast<size_t>(packetLength));
+
+    // the checksum and the words are all kept in the byte order they have in the packet, the one's complement sum
+    // is independent of byte order so no conversion is required.
+
+    auto checksum = readWord(templateData + ChecksumOffset);
+
+    writeWord(buffer + SequenceOffset, qToBigEndian<uint16_t>(sequence));
+
+    checksum = updateChecksum(
+        checksum,
+        readWord(templateData + SequenceOffset),
+        readWord(buffer + SequenceOffset) );
+
+    if (m_hasTimestamp) {
+        qToBigEndian<int64_t>(timestamp, buffer + PayloadOffset);
+
+        for (auto wordIndex = 0; wordIndex < TimestampWords; wordIndex++) {
+            auto offset = PayloadOffset + wordIndex * static_cast<int>(sizeof(uint16_t));
+
+            checksum = updateChecksum(checksum, readWord(templateData + offset), readWord(buffer + offset));
+        }
+    }
+
+    writeWord(buffer + ChecksumOffset, checksum);
+
+    return packetLength;
+}
+
+auto Nedrysoft::ICMPPacket::ICMPPacketTemplate::updateChecksum(
+        uint16_t checksum,
+        uint16_t oldValue,
+        uint16_t newValue) -> uint16_t {
+
+    uint32_t sum = static_cast<uint16_t>(~checksum);
+
+    sum += static_cast<uint16_t>(~oldValue);
+    sum += newValue;
+
+    sum = ( sum >> ( sizeof(uint16_t) * CHAR_BIT ) ) + ( sum & UINT16_MAX );
+    sum += ( sum >> ( sizeof(uint16_t) * CHAR_BIT ) );
+
+    return static_cast<uint16_t>(~sum);
+}
@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 18/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NEDRYSOFT_ICMPPACKET_ICMPPACKETTEMPLATE_H
+#define NEDRYSOFT_ICMPPACKET_ICMPPACKETTEMPLATE_H
+
+#include "ICMPPacket.h"
+
+#include <QByteArray>
+#include <QHostAddress>
+#include <cstdint>
+
+namespace Nedrysoft { namespace ICMPPacket {
+    /**
+     * @brief       The ICMPPacketTemplate class creates echo requests from a precomputed packet.
+     *
+     * @details     The echo request for a target only differs between probes by the sequence number and the
+     *              timestamp held in the payload, so the packet (including its checksum) is built once when the
+     *              template is created.  Each probe copies the template into a caller provided buffer, patches the
+     *              changed fields and adjusts the checksum incrementally as described in RFC 1624, so creating a
+     *              probe neither allocates memory nor sums the whole packet.
+     */
+    class NEDRYSOFT_ICMPPACKET_DLLSPEC ICMPPacketTemplate {
+        public:
+            /**
+             * @brief       Constructs a template for echo requests.
+             *
+             * @param[in]   id the packet id.
+             * @param[in]   payloadLength the length of the payload.
+             * @param[in]   destinationAddress the address of the target.
+             * @param[in]   version the ip version of the icmp packet.
+             */
+            ICMPPacketTemplate(
+                uint16_t id,
+                int payloadLength,
+                const QHostAddress &destinationAddress,
+                Nedrysoft::ICMPPacket::IPVersion version
+            );
+
+            /**
+             * @brief       Returns the length of the packets created by the template.
+             *
+             * @returns     the length in bytes.
+             */
+            auto length() const -> int;
+
+            /**
+             * @brief       Returns the packet id.
+             *
+             * @returns     the icmp id.
+             */
+            auto id() const -> uint16_t;
+
+            /**
+             * @brief       Writes an echo request to a buffer.
+             *
+             * @details     The timestamp is written in network byte order to the first 8 bytes of the payload, if
+             *              the payload is too short to hold it then it is omitted.
+             *
+             * @param[out]  buffer the buffer to write the packet to.
+             * @param[in]   bufferLength the length of the buffer.
+             * @param[in]   sequence the packet sequence.
+             * @param[in]   timestamp the transmit timestamp to place in the payload.
+             *
+             * @returns     the length of the packet; 0 if the buffer is too small.
+             */
+            auto write(char *buffer, int bufferLength, uint16_t sequence, int64_t timestamp = 0) const -> int;
+
+            /**
+             * @brief       Updates an internet checksum after a 16 bit word of the data has changed.
+             *
+             * @details     Implements equation 3 of RFC 1624, HC' = ~(~HC + ~m + m').  The checksum and the words
+             *              must all be in the same byte order.
+             *
+             * @param[in]   checksum the current checksum.
+             * @param[in]   oldValue the previous value of the word.
+             * @param[in]   newValue the new value of the word.
+             *
+             * @returns     the updated checksum.
+             */
+            static auto updateChecksum(uint16_t checksum, uint16_t oldValue, uint16_t newValue) -> uint16_t;
+
+        private:
+            //! @cond
+
+            QByteArray m_packet;
+            uint16_t m_id;
+            bool m_hasTimestamp;
+
+            //! @endcond
+    };
+}}
+
+#endif // NEDRYSOFT_ICMPPACKET_ICMPPACKETTEMPLATE_H
@@ -0,0 +1,293 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 18/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ICMPReplyView.h"
+
+constexpr std::ptrdiff_t ICMPHeaderLength = 8;
+constexpr std::ptrdiff_t IPv4MinimumHeaderLength = 20;
+constexpr std::ptrdiff_t IPv6HeaderLength = 40;
+constexpr std::ptrdiff_t IPv4TTLOffset = 8;
+constexpr std::ptrdiff_t IPv4ProtocolOffset = 9;
+constexpr std::ptrdiff_t IPv6NextHeaderOffset = 6;
+constexpr std::ptrdiff_t ICMPTypeOffset = 0;
+constexpr std::ptrdiff_t ICMPCodeOffset = 1;
+constexpr std::ptrdiff_t ICMPIdOffset = 4;
+constexpr std::ptrdiff_t ICMPSequenceOffset = 6;
+constexpr unsigned int IPHeaderLengthMask = 0x0F;
+constexpr unsigned int IPVersionShift = 4;
+
+constexpr uint8_t ProtocolICMP = 1;
+constexpr uint8_t ProtocolICMPv6 = 58;
+
+constexpr uint8_t ICMPv4EchoReply = 0;
+constexpr uint8_t ICMPv4EchoRequest = 8;
+constexpr uint8_t ICMPv4TimeExceeded = 11;
+constexpr uint8_t ICMPv6TimeExceeded = 3;
+constexpr uint8_t ICMPv6EchoRequest = 128;
+constexpr uint8_t ICMPv6EchoReply = 129;
+
+namespace {
+    /**
+     * @brief       Returns whether a span holds the given range of bytes.
+     */
+    auto contains(gsl::span<const uint8_t> data, std::ptrdiff_t offset, std::ptrdiff_t length) -> bool {
+        return ( offset >= 0 ) && ( length >= 0 ) && ( data.size() - offset >= length );
+    }
+
+    /**
+     * @brief       Reads a 16 bit network byte order value, the caller must check the range with contains().
+     */
+    auto readUint16(gsl::span<const uint8_t> data, std::ptrdiff_t offset) -> uint16_t {
+        return static_cast<uint16_t>(( data[offset] << 8 ) | data[offset + 1]);
+    }
+}
+
+Nedrysoft::ICMPPacket::ICMPReplyView::ICMPReplyView(gsl::span<const uint8_t> data) :
+        m_data(data),
+        m_resultCode(Nedrysoft::ICMPPacket::Invalid),
+        m_id(0),
+        m_sequence(0),
+        m_ttl(-1),
+        m_type(-1),
+        m_code(-1) {
+
+}
+
+Nedrysoft::ICMPPacket::ICMPReplyView::ICMPReplyView(
+        gsl::span<const uint8_t> data,
+        Nedrysoft::ICMPPacket::IPVersion version,
+        Nedrysoft::ICMPPacket::PacketFormat format) :
+            ICMPReplyView(data) {
+
+    // ICMPv6 sockets never return the IPv6 header, so the hop limit of the reply is not available.
+
+    if (version == Nedrysoft::ICMPPacket::V4) {
+        if (format == Nedrysoft::ICMPPacket::PacketFormat::Raw) {
+            parse_v4();
+        } else if (contains(m_data, 0, ICMPHeaderLength)) {
+            m_message = m_data;
+
+            parseMessage_v4();
+        }
+    } else if (version == Nedrysoft::ICMPPacket::V6) {
+        if (contains(m_data, 0, ICMPHeaderLength)) {
+            m_message = m_data;
+
+            parseMessage_v6();
+        }
+    }
+}
+
+auto Nedrysoft::ICMPPacket::ICMPReplyView::fromError(
+        gsl::span<const uint8_t> request,
+        Nedrysoft::ICMPPacket::IPVersion version,
+        int errorType,
+        int errorCode) -> Nedrysoft::ICMPPacket::ICMPReplyView {
+
+    auto replyView = ICMPReplyView(request);
+
+    replyView.m_type = errorType;
+    replyView.m_code = errorCode;
+
+    if (( errorCode != 0 ) || ( !contains(request, 0, ICMPHeaderLength) )) {
+        return replyView;
+    }
+
+    if (version == Nedrysoft::ICMPPacket::V4) {
+        if (( errorType != ICMPv4TimeExceeded ) || ( request[ICMPTypeOffset] != ICMPv4EchoRequest )) {
+            return replyView;
+        }
+    } else if (version == Nedrysoft::ICMPPacket::V6) {
+        if (( errorType != ICMPv6TimeExceeded ) || ( request[ICMPTypeOffset] != ICMPv6EchoRequest )) {
+            return replyView;
+        }
+    } else {
+        return replyView;
+    }
+
+    replyView.m_originalHeader = request.subspan(0, ICMPHeaderLength);
+    replyView.m_id = readUint16(request, ICMPIdOffset);
+    replyView.m_sequence = readUint16(request, ICMPSequenceOffset);
+    replyView.m_resultCode = Nedrysoft::ICMPPacket::TimeExceeded;
+
+    return replyView;
+}
+
+auto Nedrysoft::ICMPPacket::ICMPReplyView::parse_v4() -> void {
+    if (!contains(m_data, 0, IPv4MinimumHeaderLength)) {
+        return;
+    }
+
+    if (( m_data[0] >> IPVersionShift ) != Nedrysoft::ICMPPacket::V4) {
+        return;
+    }
+
+    auto headerLength = static_cast<std::ptrdiff_t>(( m_data[0] & IPHeaderLengthMask ) * sizeof(uint32_t));
+
+    if (( headerLength < IPv4MinimumHeaderLength ) || ( !contains(m_data, headerLength, ICMPHeaderLength) )) {
+        return;
+    }
+
+    m_ttl = m_data[IPv4TTLOffset];
+    m_message = m_data.subspan(headerLength);
+
+    parseMessage_v4();
+}
+
+auto Nedrysoft::ICMPPacket::ICMPReplyView::parseMessage_v4() -> void {
+    m_type = m_message[ICMPTypeOffset];
+    m_code = m_message[ICMPCodeOffset];
+
+    if (m_code != 0) {
+        return;
+    }
+
+    if (m_type == ICMPv4EchoReply) {
+        m_id = readUint16(m_message, ICMPIdOffset);
+        m_sequence = readUint16(m_message, ICMPSequenceOffset);
+        m_resultCode = Nedrysoft::ICMPPacket::EchoReply;
+
+        return;
+    }
+
+    if (m_type != ICMPv4TimeExceeded) {
+        return;
+    }
+
+    // the message contains the IP header of the original datagram followed by (at least) its first 8 bytes.
+
+    if (!contains(m_message, ICMPHeaderLength, IPv4MinimumHeaderLength)) {
+        return;
+    }
+
+    auto original = m_message.subspan(ICMPHeaderLength);
+
+    if (( original[0] >> IPVersionShift ) != Nedrysoft::ICMPPacket::V4) {
+        return;
+    }
+
+    auto originalHeaderLength = static_cast<std::ptrdiff_t>(( original[0] & IPHeaderLengthMask ) * sizeof(uint32_t));
+
+    if (( originalHeaderLength < IPv4MinimumHeaderLength ) ||
+        ( !contains(original, originalHeaderLength, ICMPHeaderLength) )) {
+
+        return;
+    }
+
+    if (original[IPv4ProtocolOffset] != ProtocolICMP) {
+        return;
+    }
+
+    auto originalMessage = original.subspan(originalHeaderLength, ICMPHeaderLength);
+
+    if (originalMessage[ICMPTypeOffset] != ICMPv4EchoRequest) {
+        return;
+    }
+
+    m_originalHeader = original.subspan(0, originalHeaderLength + ICMPHeaderLength);
+    m_id = readUint16(originalMessage, ICMPIdOffset);
+    m_sequence = readUint16(originalMessage, ICMPSequenceOffset);
+    m_resultCode = Nedrysoft::ICMPPacket::TimeExceeded;
+}
+
+auto Nedrysoft::ICMPPacket::ICMPReplyView::parseMessage_v6() -> void {
+    m_type = m_message[ICMPTypeOffset];
+    m_code = m_message[ICMPCodeOffset];
+
+    if (m_code != 0) {
+        return;
+    }
+
+    if (m_type == ICMPv6EchoReply) {
+        m_id = readUint16(m_message, ICMPIdOffset);
+        m_sequence = readUint16(m_message, ICMPSequenceOffset);
+        m_resultCode = Nedrysoft::ICMPPacket::EchoReply;
+
+        return;
+    }
+
+    if (m_type != ICMPv6TimeExceeded) {
+        return;
+    }
+
+    if (!contains(m_message, ICMPHeaderLength, IPv6HeaderLength + ICMPHeaderLength)) {
+        return;
+    }
+
+    auto original = m_message.subspan(ICMPHeaderLength, IPv6HeaderLength + ICMPHeaderLength);
+
+    if (( original[0] >> IPVersionShift ) != Nedrysoft::ICMPPacket::V6) {
+        return;
+    }
+
+    if (original[IPv6NextHeaderOffset] != ProtocolICMPv6) {
+        return;
+    }
+
+    auto originalMessage = original.subspan(IPv6HeaderLength);
+
+    if (originalMessage[ICMPTypeOffset] != ICMPv6EchoRequest) {
+        return;
+    }
+
+    m_originalHeader = original;
+    m_id = readUint16(originalMessage, ICMPIdOffset);
+    m_sequence = readUint16(originalMessage, ICMPSequenceOffset);
+    m_resultCode = Nedrysoft::ICMPPacket::TimeExceeded;
+}
+
+auto Nedrysoft::ICMPPacket::ICMPReplyView::isValid() const -> bool {
+    return m_resultCode != Nedrysoft::ICMPPacket::Invalid;
+}
+
+auto Nedrysoft::ICMPPacket::ICMPReplyView::resultCode() const -> Nedrysoft::ICMPPacket::ResultCode {
+    return m_resultCode;
+}
+
+auto Nedrysoft::ICMPPacket::ICMPReplyView::type() const -> int {
+    return m_type;
+}
+
+auto Nedrysoft::ICMPPacket::ICMPReplyView::code() const -> int {
+    return m_code;
+}
+
+auto Nedrysoft::ICMPPacket::ICMPReplyView::id() const -> uint16_t {
+    return m_id;
+}
+
+auto Nedrysoft::ICMPPacket::ICMPReplyView::sequence() const -> uint16_t {
+    return m_sequence;
+}
+
+auto Nedrysoft::ICMPPacket::ICMPReplyView::ttl() const -> int {
+    return m_ttl;
+}
+
+auto Nedrysoft::ICMPPacket::ICMPReplyView::message() const -> gsl::span<const uint8_t> {
+    return m_message;
+}
+
+auto Nedrysoft::ICMPPacket::ICMPReplyView::originalHeader() const -> gsl::span<const uint8_t> {
+    return m_originalHeader;
+}
@@ -0,0 +1,196 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 18/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NEDRYSOFT_ICMPPACKET_ICMPREPLYVIEW_H
+#define NEDRYSOFT_ICMPPACKET_ICMPREPLYVIEW_H
+
+#include "ICMPPacket.h"
+
+#include <cstdint>
+#include <gsl/gsl>
+
+namespace Nedrysoft { namespace ICMPPacket {
+    /**
+     * @brief       The ICMPReplyView class is a non-owning parsed view of a received ICMP packet.
+     *
+     * @details     The view refers directly to the received data (for example a slot in the receive ring of a
+     *              socket) and does not allocate memory.  The data is parsed once when the view is constructed and
+     *              every field is checked against the length of the data before it is read, a packet that is too
+     *              short for the fields that its type requires is reported as Invalid.
+     *
+     *              For an echo reply the id and sequence are taken from the reply, for a time exceeded message they
+     *              are taken from the echo request embedded in the message.
+     *
+     *              Datagram (ping) sockets return replies without the IP header and report ICMP errors on the
+     *              socket error queue rather than as packets, fromError() creates a view of such an error from the
+     *              echo request that the kernel returns with it.
+     *
+     * @note        The view must not outlive the data that it refers to.
+     */
+    class NEDRYSOFT_ICMPPACKET_DLLSPEC ICMPReplyView {
+        public:
+            /**
+             * @brief       Constructs a view of a received packet.
+             *
+             * @param[in]   data the packet as received from the socket.  For a raw socket IPv4 packets include
+             *              the IP header and IPv6 packets start at the ICMPv6 header, for a datagram socket both
+             *              start at the ICMP header.
+             * @param[in]   version the IP version of the packet.
+             * @param[in]   format the type of socket that the packet was read from.
+             */
+            ICMPReplyView(
+                gsl::span<const uint8_t> data,
+                Nedrysoft::ICMPPacket::IPVersion version,
+                Nedrysoft::ICMPPacket::PacketFormat format = Nedrysoft::ICMPPacket::PacketFormat::Raw
+            );
+
+            /**
+             * @brief       Constructs a view of an ICMP error reported on the error queue of a datagram socket.
+             *
+             * @details     Only time exceeded errors are decoded, any other error results in an Invalid view.
+             *
+             * @param[in]   request the echo request returned with the error, starting at the ICMP header.
+             * @param[in]   version the IP version of the request.
+             * @param[in]   errorType the ICMP type of the error.
+             * @param[in]   errorCode the ICMP code of the error.
+             *
+             * @returns     the view.
+             */
+            static auto fromError(
+                gsl::span<const uint8_t> request,
+                Nedrysoft::ICMPPacket::IPVersion version,
+                int errorType,
+                int errorCode
+            ) -> ICMPReplyView;
+
+            /**
+             * @brief       Returns whether the packet was decoded as a reply to an echo request.
+             *
+             * @returns     true if the packet is an echo reply or time exceeded message; otherwise false.
+             */
+            auto isValid() const -> bool;
+
+            /**
+             * @brief       Returns the result of the decode.
+             *
+             * @returns     the ResultCode value which indicates what was decoded.
+             */
+            auto resultCode() const -> Nedrysoft::ICMPPacket::ResultCode;
+
+            /**
+             * @brief       Returns the ICMP type of the packet.
+             *
+             * @returns     the type, or the type of the error for a view created by fromError(); -1 if the packet is
+             *              too short to contain it.
+             */
+            auto type() const -> int;
+
+            /**
+             * @brief       Returns the ICMP code of the packet.
+             *
+             * @returns     the code, or the code of the error for a view created by fromError(); -1 if the packet is
+             *              too short to contain it.
+             */
+            auto code() const -> int;
+
+            /**
+             * @brief       Returns the id of the echo request that the packet is a reply to.
+             *
+             * @returns     the id; 0 if the packet is not valid.
+             */
+            auto id() const -> uint16_t;
+
+            /**
+             * @brief       Returns the sequence of the echo request that the packet is a reply to.
+             *
+             * @returns     the sequence; 0 if the packet is not valid.
+             */
+            auto sequence() const -> uint16_t;
+
+            /**
+             * @brief       Returns the TTL of the received packet.
+             *
+             * @returns     the ttl if the packet includes its IP header; otherwise -1, for a datagram socket the ttl
+             *              may be available as ancillary data.
+             */
+            auto ttl() const -> int;
+
+            /**
+             * @brief       Returns the ICMP message of the packet, without the IP header.
+             *
+             * @returns     the message; empty if the packet is too short to contain an ICMP header, or the view was
+             *              created by fromError().
+             */
+            auto message() const -> gsl::span<const uint8_t>;
+
+            /**
+             * @brief       Returns the header of the original datagram embedded in a time exceeded message.
+             *
+             * @returns     the original IP header followed by the original ICMP header, or only the ICMP header
+             *              for a view created by fromError(); empty if there is no embedded datagram.
+             */
+            auto originalHeader() const -> gsl::span<const uint8_t>;
+
+        private:
+            /**
+             * @brief       Constructs an empty (Invalid) view of the data.
+             *
+             * @param[in]   data the data.
+             */
+            explicit ICMPReplyView(gsl::span<const uint8_t> data);
+
+            /**
+             * @brief       Removes the IP header from an IPv4 packet and decodes the ICMP message.
+             */
+            auto parse_v4() -> void;
+
+            /**
+             * @brief       Decodes an ICMPv4 message.
+             */
+            auto parseMessage_v4() -> void;
+
+            /**
+             * @brief       Decodes an ICMPv6 message.
+             */
+            auto parseMessage_v6() -> void;
+
+        private:
+            //! @cond
+
+            gsl::span<const uint8_t> m_data;
+            gsl::span<const uint8_t> m_message;
+            gsl::span<const uint8_t> m_originalHeader;
+
+            Nedrysoft::ICMPPacket::ResultCode m_resultCode;
+
+            uint16_t m_id;
+            uint16_t m_sequence;
+            int m_ttl;
+            int m_type;
+            int m_code;
+
+            //! @endcond
+    };
+}}
+
+#endif // NEDRYSOFT_ICMPPACKET_ICMPREPLYVIEW_H
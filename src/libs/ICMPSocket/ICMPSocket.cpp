@@ -23,6 +23,8 @@
 
 #include "ICMPSocket.h"
 
+#include "ICMPSocketFilter.h"
+
 #if defined(Q_OS_UNIX)
 #include <fcntl.h>
 #include <netinet/in.h>
@@ -30,12 +32,23 @@
 #include <sys/socket.h>
 #include <unistd.h>
 
+#if defined(Q_OS_LINUX)
+#include <cerrno>
+#include <linux/errqueue.h>
+#include <linux/filter.h>
+#include <linux/net_tstamp.h>
+#include <netinet/ip6.h>
+#include <time.h>
+#endif
+
 #elif defined(Q_OS_WIN)
 #include <WS2tcpip.h>
 #include <WinSock2.h>
 #endif
 
 #include <QtEndian>
+#include <algorithm>
+#include <chrono>
 
 #if defined(Q_OS_WIN)
 constexpr int SocketError = SOCKET_ERROR;
@@ -44,12 +57,29 @@ constexpr int SocketError = -1;
 #endif
 
 constexpr auto ReceiveBufferSize = 4096;
+constexpr auto MaximumQueuedPackets = 64;
+constexpr auto TransmitBufferSize = 1500;
+constexpr auto TransmitControlSize = 32;
+constexpr auto MaximumReceivedPackets = 64;
+constexpr auto ReceiveControlSize = 96;
+constexpr auto TransmitTagRingSize = 1024;
+constexpr auto ErrorQueueControlSize = 512;
+constexpr auto DefaultSendTimeout = 100;
 
 Nedrysoft::ICMPSocket::ICMPSocket::ICMPSocket(Nedrysoft::ICMPSocket::ICMPSocket::socket_t socket, IPVersion version) :
         m_socketDescriptor(socket),
         m_version(version),
-        m_ttl(64) {
+        m_ttl(64),
+        m_transmitCount(0),
+        m_transmitTimestamps(false),
+        m_isDatagram(false),
+        m_id(0) {
+
+}
 
+auto Nedrysoft::ICMPSocket::realtimeNanoseconds() -> int64_t {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch() ).count();
 }
 
 Nedrysoft::ICMPSocket::ICMPSocket::~ICMPSocket() {
@@ -150,6 +180,24 @@ auto Nedrysoft::ICMPSocket::ICMPSocket::createReadSocket(
     }
 #endif
 
+#if defined(Q_OS_LINUX)
+    int enableTimestamps = 1;
+
+    if (setsockopt(
+            socketDescriptor,
+            SOL_SOCKET,
+            SO_TIMESTAMPNS,
+            &enableTimestamps,
+            sizeof(enableTimestamps) ) == SocketError) {
+
+        qWarning() << QObject::tr("Kernel receive timestamps are unavailable.");
+    }
+
+    // the number of packets dropped because the receive queue was full is returned with each packet.
+
+    setsockopt(socketDescriptor, SOL_SOCKET, SO_RXQ_OVFL, &enableTimestamps, sizeof(enableTimestamps));
+#endif
+
     return new Nedrysoft::ICMPSocket::ICMPSocket(socketDescriptor, version);
 }
 
@@ -223,6 +271,28 @@ auto Nedrysoft::ICMPSocket::ICMPSocket::createWriteSocket(
                 socketInstance->setHopLimit(ttl);
             }
         }
+
+#if defined(Q_OS_LINUX)
+        // request a software timestamp as each packet leaves the network stack, OPT_ID tags each timestamp with
+        // the index of the packet sent on this socket and OPT_TSONLY stops the packet itself being looped back.
+
+        unsigned int timestampFlags =
+            SOF_TIMESTAMPING_TX_SOFTWARE |
+            SOF_TIMESTAMPING_SOFTWARE |
+            SOF_TIMESTAMPING_OPT_ID |
+            SOF_TIMESTAMPING_OPT_TSONLY;
+
+        if (setsockopt(
+                socketDescriptor,
+                SOL_SOCKET,
+                SO_TIMESTAMPING,
+                &timestampFlags,
+                sizeof(timestampFlags) ) != SocketError) {
+
+            socketInstance->m_transmitTimestamps = true;
+            socketInstance->m_transmitTags.resize(TransmitTagRingSize);
+        }
+#endif
     } else {
         qWarning() << QObject::tr("Error creating socket descriptor.");
     }
@@ -230,6 +300,130 @@ auto Nedrysoft::ICMPSocket::ICMPSocket::createWriteSocket(
     return socketInstance;
 }
 
+auto Nedrysoft::ICMPSocket::ICMPSocket::createDatagramSocket(
+        Nedrysoft::ICMPSocket::IPVersion version ) -> Nedrysoft::ICMPSocket::ICMPSocket * {
+
+#if defined(Q_OS_LINUX)
+    Nedrysoft::ICMPSocket::ICMPSocket::socket_t socketDescriptor;
+    struct sockaddr_storage address = {};
+    socklen_t addressLength;
+
+    initialiseSockets();
+
+    if (version == Nedrysoft::ICMPSocket::V4) {
+        socketDescriptor = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, IPPROTO_ICMP);
+
+        address.ss_family = AF_INET;
+        addressLength = sizeof(sockaddr_in);
+    } else if (version == Nedrysoft::ICMPSocket::V6) {
+        socketDescriptor = socket(AF_INET6, SOCK_DGRAM | SOCK_NONBLOCK, IPPROTO_ICMPV6);
+
+        address.ss_family = AF_INET6;
+        addressLength = sizeof(sockaddr_in6);
+    } else {
+        qWarning() << QObject::tr("Unknown IP version");
+
+        return nullptr;
+    }
+
+    // creation fails with EACCES if the group of the process is not in net.ipv4.ping_group_range.
+
+    if (!isValid(socketDescriptor)) {
+        return nullptr;
+    }
+
+    // binding to port 0 makes the kernel allocate the ICMP id now rather than on the first send, the id is needed
+    // to match replies to requests before anything has been sent.
+
+    if (( bind(socketDescriptor, reinterpret_cast<sockaddr *>(&address), addressLength) == SocketError ) ||
+        ( getsockname(socketDescriptor, reinterpret_cast<sockaddr *>(&address), &addressLength) == SocketError )) {
+
+        qWarning() << QObject::tr("Error binding datagram socket.");
+
+        close(socketDescriptor);
+
+        return nullptr;
+    }
+
+    int enableOption = 1;
+
+    if (setsockopt(
+            socketDescriptor,
+            SOL_SOCKET,
+            SO_TIMESTAMPNS,
+            &enableOption,
+            sizeof(enableOption) ) == SocketError) {
+
+        qWarning() << QObject::tr("Kernel receive timestamps are unavailable.");
+    }
+
+    setsockopt(socketDescriptor, SOL_SOCKET, SO_RXQ_OVFL, &enableOption, sizeof(enableOption));
+
+    // time exceeded messages are only queued on the socket error queue if IP_RECVERR is enabled, the ttl of
+    // replies is returned as ancillary data as the IP header is not returned.
+
+    auto result = 0;
+
+    if (version == Nedrysoft::ICMPSocket::V4) {
+        result |= setsockopt(socketDescriptor, IPPROTO_IP, IP_RECVERR, &enableOption, sizeof(enableOption));
+        result |= setsockopt(socketDescriptor, IPPROTO_IP, IP_RECVTTL, &enableOption, sizeof(enableOption));
+    } else {
+        result |= setsockopt(socketDescriptor, IPPROTO_IPV6, IPV6_RECVERR, &enableOption, sizeof(enableOption));
+        result |= setsockopt(socketDescriptor, IPPROTO_IPV6, IPV6_RECVHOPLIMIT, &enableOption, sizeof(enableOption));
+    }
+
+    if (result == SocketError) {
+        qWarning() << QObject::tr("Error enabling ICMP errors on datagram socket.");
+    }
+
+    auto socketInstance = new Nedrysoft::ICMPSocket::ICMPSocket(socketDescriptor, version);
+
+    socketInstance->m_isDatagram = true;
+
+    if (version == Nedrysoft::ICMPSocket::V4) {
+        socketInstance->m_id = qFromBigEndian<uint16_t>(reinterpret_cast<sockaddr_in *>(&address)->sin_port);
+    } else {
+        socketInstance->m_id = qFromBigEndian<uint16_t>(reinterpret_cast<sockaddr_in6 *>(&address)->sin6_port);
+    }
+
+    // kernel transmit timestamps are not requested, they are reported on the error queue which is read by the
+    // receiver, so the application transmit time is used instead.
+
+    return socketInstance;
+#else
+    Q_UNUSED(version)
+
+    return nullptr;
+#endif
+}
+
+auto Nedrysoft::ICMPSocket::ICMPSocket::isDatagramSupported(Nedrysoft::ICMPSocket::IPVersion version) -> bool {
+#if defined(Q_OS_LINUX)
+    auto checkVersion = [](Nedrysoft::ICMPSocket::IPVersion socketVersion) {
+        auto socket = createDatagramSocket(socketVersion);
+
+        delete socket;
+
+        return socket != nullptr;
+    };
+
+    static const auto isSupported_v4 = checkVersion(Nedrysoft::ICMPSocket::V4);
+    static const auto isSupported_v6 = checkVersion(Nedrysoft::ICMPSocket::V6);
+
+    if (version == Nedrysoft::ICMPSocket::V4) {
+        return isSupported_v4;
+    }
+
+    if (version == Nedrysoft::ICMPSocket::V6) {
+        return isSupported_v6;
+    }
+#else
+    Q_UNUSED(version)
+#endif
+
+    return false;
+}
+
 auto Nedrysoft::ICMPSocket::ICMPSocket::recvfrom(
         QByteArray &buffer,
         QHostAddress &receiveAddress,
@@ -292,6 +486,251 @@ auto Nedrysoft::ICMPSocket::ICMPSocket::recvfrom(
     return -1;
 }
 
+auto Nedrysoft::ICMPSocket::ICMPSocket::recvmmsg(
+        QVector<Nedrysoft::ICMPSocket::ReceivedPacket> &packets,
+        int timeout) -> int {
+
+#if defined(Q_OS_WIN)
+    int (WSAAPI *poll)(struct pollfd *, ulong , int ) = WSAPoll;
+#endif
+    struct pollfd descriptorSet = {};
+
+    packets.clear();
+
+    descriptorSet.fd = m_socketDescriptor;
+    descriptorSet.events = POLLIN;
+
+    if (poll(&descriptorSet, 1, timeout) <= 0) {
+        return -1;
+    }
+
+    if (m_receiveRing.empty()) {
+        m_receiveRing.resize(static_cast<size_t>(MaximumReceivedPackets * ReceiveBufferSize));
+        m_receiveAddresses.resize(MaximumReceivedPackets);
+        m_receiveControl.resize(MaximumReceivedPackets * ReceiveControlSize / sizeof(uint64_t));
+
+#if defined(Q_OS_LINUX)
+        m_receiveMessages.resize(MaximumReceivedPackets);
+        m_receiveVectors.resize(MaximumReceivedPackets);
+
+        for (auto packetIndex = 0; packetIndex < MaximumReceivedPackets; packetIndex++) {
+            m_receiveVectors[packetIndex].iov_base = &m_receiveRing[packetIndex * ReceiveBufferSize];
+            m_receiveVectors[packetIndex].iov_len = ReceiveBufferSize;
+        }
+#endif
+    }
+
+    auto receivedPackets = 0;
+
+#if defined(Q_OS_LINUX)
+    for (auto packetIndex = 0; packetIndex < MaximumReceivedPackets; packetIndex++) {
+        auto &message = m_receiveMessages[packetIndex].msg_hdr;
+
+        memset(&m_receiveMessages[packetIndex], 0, sizeof(mmsghdr));
+
+        message.msg_name = &m_receiveAddresses[packetIndex];
+        message.msg_namelen = sizeof(sockaddr_storage);
+        message.msg_iov = &m_receiveVectors[packetIndex];
+        message.msg_iovlen = 1;
+        message.msg_control = &m_receiveControl[packetIndex * ReceiveControlSize / sizeof(uint64_t)];
+        message.msg_controllen = ReceiveControlSize;
+    }
+
+    receivedPackets = ::recvmmsg(
+        m_socketDescriptor,
+        m_receiveMessages.data(),
+        MaximumReceivedPackets,
+        MSG_DONTWAIT,
+        nullptr );
+
+    if (receivedPackets < 0) {
+        receivedPackets = 0;
+    }
+
+    auto receiveTime = realtimeNanoseconds();
+
+    for (auto packetIndex = 0; packetIndex < receivedPackets; packetIndex++) {
+        auto &message = m_receiveMessages[packetIndex].msg_hdr;
+
+        Nedrysoft::ICMPSocket::ReceivedPacket packet = {
+            QByteArray::fromRawData(
+                &m_receiveRing[packetIndex * ReceiveBufferSize],
+                static_cast<int>(m_receiveMessages[packetIndex].msg_len) ),
+            QHostAddress(reinterpret_cast<sockaddr *>(&m_receiveAddresses[packetIndex])),
+            receiveTime,
+            Nedrysoft::ICMPSocket::TimestampSource::User
+        };
+
+        readControlMessages(message, packet);
+
+        packets.append(packet);
+    }
+
+    if (m_isDatagram) {
+        receivedPackets += receiveErrors(packets, receivedPackets);
+    }
+
+    if (!receivedPackets) {
+        return -1;
+    }
+#else
+#if defined(Q_OS_UNIX)
+    socklen_t addressLength;
+#elif defined(Q_OS_WIN)
+    int addressLength;
+#endif
+
+    while (receivedPackets < MaximumReceivedPackets) {
+        auto packetBuffer = &m_receiveRing[receivedPackets * ReceiveBufferSize];
+
+        addressLength = sizeof(sockaddr_storage);
+
+        auto result = ::recvfrom(
+            m_socketDescriptor,
+            packetBuffer,
+            ReceiveBufferSize,
+            0,
+            reinterpret_cast<sockaddr *>(&m_receiveAddresses[receivedPackets]),
+            &addressLength
+        );
+
+        if (result < 0) {
+            break;
+        }
+
+        packets.append(Nedrysoft::ICMPSocket::ReceivedPacket{
+            QByteArray::fromRawData(packetBuffer, static_cast<int>(result)),
+            QHostAddress(reinterpret_cast<sockaddr *>(&m_receiveAddresses[receivedPackets])),
+            realtimeNanoseconds(),
+            Nedrysoft::ICMPSocket::TimestampSource::User
+        });
+
+        receivedPackets++;
+    }
+
+    if (!receivedPackets) {
+        return -1;
+    }
+#endif
+
+    return receivedPackets;
+}
+
+auto Nedrysoft::ICMPSocket::ICMPSocket::receiveErrors(
+        QVector<Nedrysoft::ICMPSocket::ReceivedPacket> &packets,
+        int firstIndex) -> int {
+
+    auto errorCount = 0;
+
+#if defined(Q_OS_LINUX)
+    uint64_t controlBuffer[ErrorQueueControlSize / sizeof(uint64_t)];
+    auto packetIndex = firstIndex;
+
+    while (packetIndex < MaximumReceivedPackets) {
+        auto packetBuffer = &m_receiveRing[packetIndex * ReceiveBufferSize];
+        struct msghdr message = {};
+        struct iovec dataVector = {};
+
+        dataVector.iov_base = packetBuffer;
+        dataVector.iov_len = ReceiveBufferSize;
+
+        message.msg_iov = &dataVector;
+        message.msg_iovlen = 1;
+        message.msg_control = controlBuffer;
+        message.msg_controllen = sizeof(controlBuffer);
+
+        auto result = recvmsg(m_socketDescriptor, &message, MSG_ERRQUEUE | MSG_DONTWAIT);
+
+        if (result == SocketError) {
+            break;
+        }
+
+        // the data of an ICMP error is the echo request that caused it.
+
+        Nedrysoft::ICMPSocket::ReceivedPacket packet = {
+            QByteArray::fromRawData(packetBuffer, static_cast<int>(result)),
+            QHostAddress(),
+            realtimeNanoseconds(),
+            Nedrysoft::ICMPSocket::TimestampSource::User
+        };
+
+        readControlMessages(message, packet);
+
+        // local errors (i.e a failed send) are not reported.
+
+        if (packet.errorType == -1) {
+            continue;
+        }
+
+        packets.append(packet);
+
+        packetIndex++;
+        errorCount++;
+    }
+#else
+    Q_UNUSED(packets)
+    Q_UNUSED(firstIndex)
+#endif
+
+    return errorCount;
+}
+
+#if defined(Q_OS_LINUX)
+auto Nedrysoft::ICMPSocket::ICMPSocket::readControlMessages(
+        msghdr &message,
+        Nedrysoft::ICMPSocket::ReceivedPacket &packet) -> void {
+
+    for (auto controlMessage = CMSG_FIRSTHDR(&message);
+         controlMessage;
+         controlMessage = CMSG_NXTHDR(&message, controlMessage)) {
+
+        if (( controlMessage->cmsg_level == SOL_SOCKET ) && ( controlMessage->cmsg_type == SCM_TIMESTAMPNS )) {
+            struct timespec kernelTime = {};
+
+            memcpy(&kernelTime, CMSG_DATA(controlMessage), sizeof(kernelTime));
+
+            packet.timestamp = static_cast<int64_t>(kernelTime.tv_sec) * 1000000000 + kernelTime.tv_nsec;
+            packet.timestampSource = Nedrysoft::ICMPSocket::TimestampSource::Kernel;
+        } else if (( controlMessage->cmsg_level == SOL_SOCKET ) && ( controlMessage->cmsg_type == SO_RXQ_OVFL )) {
+            uint32_t dropCount = 0;
+
+            memcpy(&dropCount, CMSG_DATA(controlMessage), sizeof(dropCount));
+
+            packet.dropCount = dropCount;
+        } else if (( ( controlMessage->cmsg_level == IPPROTO_IP ) && ( controlMessage->cmsg_type == IP_TTL ) ) ||
+                   ( ( controlMessage->cmsg_level == IPPROTO_IPV6 ) && ( controlMessage->cmsg_type == IPV6_HOPLIMIT ) )) {
+
+            memcpy(&packet.ttl, CMSG_DATA(controlMessage), sizeof(packet.ttl));
+        } else if (( ( controlMessage->cmsg_level == IPPROTO_IP ) && ( controlMessage->cmsg_type == IP_RECVERR ) ) ||
+                   ( ( controlMessage->cmsg_level == IPPROTO_IPV6 ) && ( controlMessage->cmsg_type == IPV6_RECVERR ) )) {
+
+            struct sock_extended_err extendedError = {};
+
+            memcpy(&extendedError, CMSG_DATA(controlMessage), sizeof(extendedError));
+
+            if (( extendedError.ee_origin != SO_EE_ORIGIN_ICMP ) && ( extendedError.ee_origin != SO_EE_ORIGIN_ICMP6 )) {
+                continue;
+            }
+
+            packet.errorType = extendedError.ee_type;
+            packet.errorCode = extendedError.ee_code;
+
+            // the address that the error came from is stored after the extended error.
+
+            struct sockaddr_storage offenderAddress = {};
+
+            auto offenderLength = std::min<size_t>(
+                controlMessage->cmsg_len - CMSG_LEN(sizeof(extendedError)),
+                sizeof(offenderAddress) );
+
+            memcpy(&offenderAddress, CMSG_DATA(controlMessage) + sizeof(extendedError), offenderLength);
+
+            packet.receiveAddress = QHostAddress(reinterpret_cast<sockaddr *>(&offenderAddress));
+        }
+    }
+}
+#endif
+
 auto Nedrysoft::ICMPSocket::ICMPSocket::sendto(QByteArray &buffer, const QHostAddress &hostAddress) -> int {
     if (m_version == V4) {
         struct sockaddr_in toAddress = {};
@@ -318,6 +757,296 @@ auto Nedrysoft::ICMPSocket::ICMPSocket::sendto(QByteArray &buffer, const QHostAd
     return -1;
 }
 
+auto Nedrysoft::ICMPSocket::ICMPSocket::toSocketAddress(
+        const QHostAddress &hostAddress,
+        sockaddr_storage &socketAddress) -> socklen_t {
+
+    memset(&socketAddress, 0, sizeof(socketAddress));
+
+    if (( m_version == V4 ) && ( hostAddress.protocol() == QAbstractSocket::IPv4Protocol )) {
+        auto toAddress = reinterpret_cast<sockaddr_in *>(&socketAddress);
+
+        toAddress->sin_family = AF_INET;
+        toAddress->sin_addr.s_addr = qToBigEndian<uint32_t>(hostAddress.toIPv4Address());
+
+        return sizeof(sockaddr_in);
+    } else if (( m_version == V6 ) && ( hostAddress.protocol() == QAbstractSocket::IPv6Protocol )) {
+        auto toAddress = reinterpret_cast<sockaddr_in6 *>(&socketAddress);
+
+        auto destinationAddress = hostAddress.toIPv6Address();
+
+        toAddress->sin6_family = AF_INET6;
+        memcpy(toAddress->sin6_addr.s6_addr, &destinationAddress, 16);
+
+        return sizeof(sockaddr_in6);
+    }
+
+    return 0;
+}
+
+auto Nedrysoft::ICMPSocket::ICMPSocket::queue(
+        const QByteArray &buffer,
+        const QHostAddress &hostAddress,
+        int ttl,
+        uint32_t tag) -> Nedrysoft::ICMPSocket::QueueResult {
+
+    return queue(buffer.constData(), buffer.length(), hostAddress, ttl, tag);
+}
+
+auto Nedrysoft::ICMPSocket::ICMPSocket::queue(
+        const char *data,
+        int length,
+        const QHostAddress &hostAddress,
+        int ttl,
+        uint32_t tag) -> Nedrysoft::ICMPSocket::QueueResult {
+
+    if (m_queue.size() >= static_cast<size_t>(MaximumQueuedPackets)) {
+        return Nedrysoft::ICMPSocket::QueueResult::Full;
+    }
+
+    if (( length < 0 ) || ( length > TransmitBufferSize )) {
+        qWarning() << QObject::tr("Packet is too large to be queued.");
+
+        return Nedrysoft::ICMPSocket::QueueResult::Rejected;
+    }
+
+    if (m_transmitRing.empty()) {
+        m_queue.reserve(MaximumQueuedPackets);
+        m_transmitRing.resize(static_cast<size_t>(MaximumQueuedPackets * TransmitBufferSize));
+    }
+
+    QueuedPacket packet;
+
+    packet.addressLength = toSocketAddress(hostAddress, packet.address);
+
+    if (!packet.addressLength) {
+        qWarning() << QObject::tr("Address does not match socket IP version.");
+
+        return Nedrysoft::ICMPSocket::QueueResult::Rejected;
+    }
+
+    memcpy(&m_transmitRing[m_queue.size() * TransmitBufferSize], data, static_cast<size_t>(length));
+
+    packet.length = length;
+    packet.ttl = ttl;
+    packet.tag = tag;
+
+    m_queue.push_back(packet);
+
+    return Nedrysoft::ICMPSocket::QueueResult::Queued;
+}
+
+auto Nedrysoft::ICMPSocket::ICMPSocket::flush() -> int {
+    auto sentPackets = 0;
+
+#if defined(Q_OS_LINUX)
+    // each message carries its own ttl/hop limit as ancillary data, the control buffers are held in 64 bit words to
+    // guarantee the alignment required by the CMSG macros.
+    static_assert(CMSG_SPACE(sizeof(int)) <= TransmitControlSize, "transmit control buffer is too small");
+
+    auto packetCount = m_queue.size();
+
+    if (m_transmitMessages.empty()) {
+        m_transmitMessages.resize(MaximumQueuedPackets);
+        m_transmitVectors.resize(MaximumQueuedPackets);
+        m_transmitControl.resize(MaximumQueuedPackets * TransmitControlSize / sizeof(uint64_t));
+    }
+
+    auto &messages = m_transmitMessages;
+
+    for (size_t packetIndex = 0; packetIndex < packetCount; packetIndex++) {
+        auto &packet = m_queue[packetIndex];
+        auto &message = messages[packetIndex].msg_hdr;
+        auto &vector = m_transmitVectors[packetIndex];
+
+        memset(&messages[packetIndex], 0, sizeof(mmsghdr));
+
+        vector.iov_base = &m_transmitRing[packetIndex * TransmitBufferSize];
+        vector.iov_len = static_cast<size_t>(packet.length);
+
+        message.msg_name = &packet.address;
+        message.msg_namelen = packet.addressLength;
+        message.msg_iov = &vector;
+        message.msg_iovlen = 1;
+
+        if (packet.ttl) {
+            auto controlBuffer = reinterpret_cast<char *>(m_transmitControl.data()) + packetIndex * TransmitControlSize;
+
+            memset(controlBuffer, 0, TransmitControlSize);
+
+            message.msg_control = controlBuffer;
+            message.msg_controllen = CMSG_SPACE(sizeof(int));
+
+            auto controlMessage = CMSG_FIRSTHDR(&message);
+
+            if (m_version == V4) {
+                controlMessage->cmsg_level = IPPROTO_IP;
+                controlMessage->cmsg_type = IP_TTL;
+            } else {
+                controlMessage->cmsg_level = IPPROTO_IPV6;
+                controlMessage->cmsg_type = IPV6_HOPLIMIT;
+            }
+
+            controlMessage->cmsg_len = CMSG_LEN(sizeof(int));
+
+            memcpy(CMSG_DATA(controlMessage), &packet.ttl, sizeof(int));
+        }
+    }
+
+    size_t packetIndex = 0;
+
+    while (packetIndex < packetCount) {
+        auto result = ::sendmmsg(
+            m_socketDescriptor,
+            &messages[packetIndex],
+            static_cast<unsigned int>(packetCount - packetIndex),
+            0 );
+
+        if (result > 0) {
+            if (m_transmitTimestamps) {
+                // the kernel numbers timestamps by the order packets were sent on the socket, record the tag of
+                // each sent packet against that number.
+
+                for (auto sentIndex = 0; sentIndex < result; sentIndex++) {
+                    m_transmitTags[m_transmitCount++ % TransmitTagRingSize] = m_queue[packetIndex + sentIndex].tag;
+                }
+            }
+
+            sentPackets += result;
+            packetIndex += static_cast<size_t>(result);
+
+            continue;
+        }
+
+        if (( result == SocketError ) && ( ( errno == EAGAIN ) || ( errno == EWOULDBLOCK ) || ( errno == ENOBUFS ) )) {
+            struct pollfd descriptorSet = {};
+
+            descriptorSet.fd = m_socketDescriptor;
+            descriptorSet.events = POLLOUT;
+
+            if (poll(&descriptorSet, 1, DefaultSendTimeout) > 0) {
+                continue;
+            }
+        }
+
+        // the packet at the head of the batch could not be sent, skip it so the remainder are still transmitted.
+
+        packetIndex++;
+    }
+#else
+    for (size_t packetIndex = 0; packetIndex < m_queue.size(); packetIndex++) {
+        auto &packet = m_queue[packetIndex];
+
+        if (( packet.ttl ) && ( packet.ttl != m_ttl )) {
+            if (m_version == V4) {
+                setTTL(packet.ttl);
+            } else {
+                setHopLimit(packet.ttl);
+
+                m_ttl = packet.ttl;
+            }
+        }
+
+        auto result = ::sendto(
+            m_socketDescriptor,
+            &m_transmitRing[packetIndex * TransmitBufferSize],
+            packet.length,
+            0,
+            reinterpret_cast<struct sockaddr *>(&packet.address),
+            packet.addressLength );
+
+        if (result == packet.length) {
+            sentPackets++;
+        }
+    }
+#endif
+
+    m_queue.clear();
+
+    return sentPackets;
+}
+
+auto Nedrysoft::ICMPSocket::ICMPSocket::transmitTimestamps(
+        QVector<Nedrysoft::ICMPSocket::TransmitTimestamp> &timestamps) -> int {
+
+    auto timestampCount = 0;
+
+#if defined(Q_OS_LINUX)
+    if (!m_transmitTimestamps) {
+        return 0;
+    }
+
+    uint64_t controlBuffer[ErrorQueueControlSize / sizeof(uint64_t)];
+    char dataBuffer[ReceiveBufferSize];
+
+    while (true) {
+        struct msghdr message = {};
+        struct iovec dataVector = {};
+
+        dataVector.iov_base = dataBuffer;
+        dataVector.iov_len = sizeof(dataBuffer);
+
+        message.msg_iov = &dataVector;
+        message.msg_iovlen = 1;
+        message.msg_control = controlBuffer;
+        message.msg_controllen = sizeof(controlBuffer);
+
+        if (recvmsg(m_socketDescriptor, &message, MSG_ERRQUEUE | MSG_DONTWAIT) == SocketError) {
+            break;
+        }
+
+        int64_t timestamp = 0;
+        auto hasIdentifier = false;
+        uint32_t identifier = 0;
+
+        for (auto controlMessage = CMSG_FIRSTHDR(&message);
+             controlMessage;
+             controlMessage = CMSG_NXTHDR(&message, controlMessage)) {
+
+            if (( controlMessage->cmsg_level == SOL_SOCKET ) && ( controlMessage->cmsg_type == SCM_TIMESTAMPING )) {
+                struct scm_timestamping kernelTime = {};
+
+                memcpy(&kernelTime, CMSG_DATA(controlMessage), sizeof(kernelTime));
+
+                timestamp = static_cast<int64_t>(kernelTime.ts[0].tv_sec) * 1000000000 + kernelTime.ts[0].tv_nsec;
+            } else if (( ( controlMessage->cmsg_level == IPPROTO_IP ) && ( controlMessage->cmsg_type == IP_RECVERR ) ) ||
+                       ( ( controlMessage->cmsg_level == IPPROTO_IPV6 ) && ( controlMessage->cmsg_type == IPV6_RECVERR ) )) {
+
+                struct sock_extended_err extendedError = {};
+
+                memcpy(&extendedError, CMSG_DATA(controlMessage), sizeof(extendedError));
+
+                if (( extendedError.ee_errno == ENOMSG ) && ( extendedError.ee_origin == SO_EE_ORIGIN_TIMESTAMPING )) {
+                    identifier = extendedError.ee_data;
+                    hasIdentifier = true;
+                }
+            }
+        }
+
+        // identifiers that have fallen out of the tag ring are too old to be matched to a packet.
+
+        if (( !timestamp ) || ( !hasIdentifier ) || ( m_transmitCount - identifier > TransmitTagRingSize )) {
+            continue;
+        }
+
+        timestamps.append(Nedrysoft::ICMPSocket::TransmitTimestamp{
+            m_transmitTags[identifier % TransmitTagRingSize],
+            timestamp
+        });
+
+        timestampCount++;
+    }
+#else
+    Q_UNUSED(timestamps)
+#endif
+
+    return timestampCount;
+}
+
+auto Nedrysoft::ICMPSocket::ICMPSocket::queuedPackets() -> int {
+    return static_cast<int>(m_queue.size());
+}
+
 auto Nedrysoft::ICMPSocket::ICMPSocket::isValid(Nedrysoft::ICMPSocket::ICMPSocket::socket_t socket) -> bool {
 #if defined(Q_OS_WIN)
     return socket!=INVALID_SOCKET;
@@ -360,6 +1089,49 @@ auto Nedrysoft::ICMPSocket::ICMPSocket::setHopLimit(int hopLimit) -> void {
     }
 }
 
+auto Nedrysoft::ICMPSocket::ICMPSocket::descriptor() -> Nedrysoft::ICMPSocket::ICMPSocket::socket_t {
+    return m_socketDescriptor;
+}
+
+auto Nedrysoft::ICMPSocket::ICMPSocket::setFilter(const QVector<uint16_t> &ids) -> bool {
+#if defined(Q_OS_LINUX)
+    static_assert(
+        sizeof(Nedrysoft::ICMPSocket::ICMPSocketFilterInstruction) == sizeof(sock_filter),
+        "filter instruction does not match the kernel layout" );
+
+    if (m_isDatagram) {
+        return false;
+    }
+
+    auto program = Nedrysoft::ICMPSocket::ICMPSocketFilter::program(m_version, ids);
+
+    struct sock_fprog filter = {};
+
+    filter.len = static_cast<unsigned short>(program.count());
+    filter.filter = reinterpret_cast<sock_filter *>(program.data());
+
+    if (setsockopt(m_socketDescriptor, SOL_SOCKET, SO_ATTACH_FILTER, &filter, sizeof(filter)) == SocketError) {
+        qWarning() << QObject::tr("Error attaching filter to socket.");
+
+        return false;
+    }
+
+    return true;
+#else
+    Q_UNUSED(ids)
+
+    return false;
+#endif
+}
+
+auto Nedrysoft::ICMPSocket::ICMPSocket::isDatagram() -> bool {
+    return m_isDatagram;
+}
+
+auto Nedrysoft::ICMPSocket::ICMPSocket::id() -> uint16_t {
+    return m_id;
+}
+
 auto  Nedrysoft::ICMPSocket::ICMPSocket::version() -> Nedrysoft::ICMPSocket::IPVersion {
     return m_version;
 }
@@ -37,6 +37,7 @@
 #include <sys/socket.h>
 #include <sys/time.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <unistd.h>
 #elif defined(Q_OS_WIN)
 #define NOMINMAX
@@ -46,6 +47,9 @@
 
 #include <QByteArray>
 #include <QHostAddress>
+#include <QVector>
+#include <cstdint>
+#include <vector>
 
 #if ( defined(NEDRYSOFT_LIBRARY_ICMPSOCKET_EXPORT))
 #define NEDRYSOFT_ICMPSOCKET_DLLSPEC Q_DECL_EXPORT
@@ -59,11 +63,63 @@ namespace Nedrysoft { namespace ICMPSocket {
         V6 = 6
     };
 
+    /**
+     * @brief           The source of a packet timestamp.
+     */
+    enum class TimestampSource {
+        User,                               /**< taken in user space after the system call returned. */
+        Kernel                              /**< taken by the kernel as the packet was sent or received. */
+    };
+
+    /**
+     * @brief           The result of queueing a packet with ICMPSocket::queue.
+     */
+    enum class QueueResult {
+        Queued,                             /**< the packet was queued. */
+        Full,                               /**< the queue is full and must be flushed before the packet is queued. */
+        Rejected                            /**< the packet can never be sent on the socket and was discarded. */
+    };
+
+    /**
+     * @brief           A packet received by ICMPSocket::recvmmsg.
+     *
+     * @note            The buffer references the receive ring of the socket and is only valid until the next call
+     *                  to recvmmsg, it must be copied if it needs to be retained.
+     */
+    struct ReceivedPacket {
+        QByteArray buffer;
+        QHostAddress receiveAddress;
+        int64_t timestamp;                  /**< receive time in nanoseconds since the unix epoch. */
+        TimestampSource timestampSource;
+        int ttl = -1;                       /**< the ttl (or hop limit) reported by a datagram socket, or -1. */
+        int errorType = -1;                 /**< the ICMP type of an error reported by a datagram socket, or -1. */
+        int errorCode = -1;                 /**< the ICMP code of an error reported by a datagram socket, or -1. */
+        int64_t dropCount = -1;             /**< the number of packets the socket has dropped (mod 2^32), or -1. */
+    };
+
+    /**
+     * @brief           A transmit timestamp reported by ICMPSocket::transmitTimestamps.
+     */
+    struct TransmitTimestamp {
+        uint32_t tag;                       /**< the tag that the packet was queued with. */
+        int64_t timestamp;                  /**< transmit time in nanoseconds since the unix epoch. */
+    };
+
+    /**
+     * @brief           Returns the current wall clock time.
+     *
+     * @details         Kernel timestamps are taken from the realtime clock, this is used for user space
+     *                  timestamps so that they can be compared against kernel timestamps.
+     *
+     * @returns         the time in nanoseconds since the unix epoch.
+     */
+    NEDRYSOFT_ICMPSOCKET_DLLSPEC auto realtimeNanoseconds() -> int64_t;
+
     /**
      * @brief           The ICMPSocket class abstracts the platform specific code for ICMP sockets.
      */
     class NEDRYSOFT_ICMPSOCKET_DLLSPEC ICMPSocket {
-        private:
+        public:
 #if defined(Q_OS_WIN)
             typedef SOCKET socket_t;
 #else
@@ -123,6 +179,38 @@ namespace Nedrysoft { namespace ICMPSocket {
                 Nedrysoft::ICMPSocket::IPVersion version = Nedrysoft::ICMPSocket::V4
              ) -> ICMPSocket *;
 
+            /**
+             * @brief       Creates an unprivileged datagram socket for sending and receiving ICMP echo requests.
+             *
+             * @details     On Linux a SOCK_DGRAM socket with the protocol IPPROTO_ICMP (or IPPROTO_ICMPV6) can be
+             *              created without privileges by members of the groups in net.ipv4.ping_group_range.  The
+             *              kernel assigns the socket an ICMP id, replaces the id and checksum of every request sent
+             *              on the socket and only delivers replies that carry the id, so each socket only receives
+             *              its own replies.
+             *
+             *              Replies are returned without the IP header, time exceeded messages are reported on the
+             *              socket error queue, recvmmsg() returns both with the ttl and error fields of the
+             *              ReceivedPacket set.  The same socket is used to send and receive.
+             *
+             * @param[in]   version the IP version of the socket to create.
+             *
+             * @returns     the socket instance; nullptr if datagram sockets are not available.
+             */
+            static auto createDatagramSocket(
+                Nedrysoft::ICMPSocket::IPVersion version = Nedrysoft::ICMPSocket::V4
+            ) -> ICMPSocket *;
+
+            /**
+             * @brief       Returns whether createDatagramSocket() is able to create a socket.
+             *
+             * @note        The result is checked once per IP version and cached.
+             *
+             * @param[in]   version the IP version.
+             *
+             * @returns     true if datagram sockets are available; otherwise false.
+             */
+            static auto isDatagramSupported(Nedrysoft::ICMPSocket::IPVersion version = Nedrysoft::ICMPSocket::V4) -> bool;
+
             /**
              * @brief       Receives data from a read or write socket.
              *
@@ -134,6 +222,25 @@ namespace Nedrysoft { namespace ICMPSocket {
              */
             auto recvfrom(QByteArray &buffer, QHostAddress &receiveAddress, int timeout) -> int;
 
+            /**
+             * @brief       Receives all available packets from a read socket.
+             *
+             * @details     Waits for the socket to become readable and then drains up to a fixed number of packets
+             *              into a receive ring that is allocated once per socket.  On Linux the packets are read with
+             *              a single recvmmsg call, on other platforms recvfrom is called until no more packets are
+             *              waiting.
+             *
+             *              For a datagram socket the errors waiting on the socket error queue are also read, these
+             *              contain the echo request that caused the error and are returned from the address of the
+             *              router that reported it.
+             *
+             * @param[out]  packets the list of received packets, this is cleared before packets are added.
+             * @param[in]   timeout read timeout in milliseconds.
+             *
+             * @returns     -1 on timeout or error; otherwise the number of packets received.
+             */
+            auto recvmmsg(QVector<Nedrysoft::ICMPSocket::ReceivedPacket> &packets, int timeout) -> int;
+
             /**
              * @brief       Sends data to a write socket.
              *
@@ -144,6 +251,81 @@ namespace Nedrysoft { namespace ICMPSocket {
              */
             auto sendto(QByteArray &buffer, const QHostAddress &hostAddress) -> int;
 
+            /**
+             * @brief       Queues a packet for transmission by the next call to flush().
+             *
+             * @details     Queued packets are sent in a single system call where the platform supports it (sendmmsg
+             *              on Linux), the ttl is attached to each packet as ancillary data so that a single write
+             *              socket can be used to send packets with different TTL's.  On other platforms the packets
+             *              are sent individually and the socket TTL is changed when required.
+             *
+             * @param[in]   buffer the data to send.
+             * @param[in]   hostAddress the address to send the packet to.
+             * @param[in]   ttl the ttl (or hop limit) for the packet, 0 to use the socket default.
+             * @param[in]   tag a caller defined value that identifies the packet in transmitTimestamps().
+             *
+             * @returns     Full if the queue must be flushed first; Rejected if the packet is too large or the address
+             *              does not match the socket; otherwise Queued.
+             */
+            auto queue(
+                const QByteArray &buffer,
+                const QHostAddress &hostAddress,
+                int ttl = 0,
+                uint32_t tag = 0
+            ) -> Nedrysoft::ICMPSocket::QueueResult;
+
+            /**
+             * @brief       Queues a packet for transmission by the next call to flush().
+             *
+             * @details     The data is copied into a transmit buffer owned by the socket, so the caller may reuse its
+             *              buffer immediately and no memory is allocated once the socket has queued its first packet.
+             *
+             * @param[in]   data the data to send.
+             * @param[in]   length the length of the data.
+             * @param[in]   hostAddress the address to send the packet to.
+             * @param[in]   ttl the ttl (or hop limit) for the packet, 0 to use the socket default.
+             * @param[in]   tag a caller defined value that identifies the packet in transmitTimestamps().
+             *
+             * @returns     Full if the queue must be flushed first; Rejected if the packet is too large or the address
+             *              does not match the socket; otherwise Queued.
+             */
+            auto queue(
+                const char *data,
+                int length,
+                const QHostAddress &hostAddress,
+                int ttl = 0,
+                uint32_t tag = 0
+            ) -> Nedrysoft::ICMPSocket::QueueResult;
+
+            /**
+             * @brief       Sends all queued packets.
+             *
+             * @returns     the number of packets that were sent.
+             */
+            auto flush() -> int;
+
+            /**
+             * @brief       Returns the kernel transmit timestamps of packets sent by flush().
+             *
+             * @details     On Linux, write sockets request software transmit timestamps with SO_TIMESTAMPING, the
+             *              kernel reports them on the socket error queue as packets leave the network stack.  This
+             *              reads any timestamps that are waiting without blocking, a timestamp may not yet be
+             *              available for a packet that has just been flushed.  On other platforms no timestamps are
+             *              returned.
+             *
+             * @param[out]  timestamps the list that the timestamps are appended to.
+             *
+             * @returns     the number of timestamps read.
+             */
+            auto transmitTimestamps(QVector<Nedrysoft::ICMPSocket::TransmitTimestamp> &timestamps) -> int;
+
+            /**
+             * @brief       Returns the number of packets waiting to be sent.
+             *
+             * @returns     the number of queued packets.
+             */
+            auto queuedPackets() -> int;
+
             /**
              * @brief       Sets the TTL on a write socket.
              *
@@ -172,13 +354,123 @@ namespace Nedrysoft { namespace ICMPSocket {
              */
             auto version() -> Nedrysoft::ICMPSocket::IPVersion;
 
+            /**
+             * @brief       Returns the platform socket handle.
+             *
+             * @details     The handle allows the socket to be waited on alongside other descriptors, it must not be
+             *              closed by the caller.
+             *
+             * @returns     the socket handle.
+             */
+            auto descriptor() -> ICMPSocket::socket_t;
+
+            /**
+             * @brief       Attaches a kernel filter to a raw read socket so that it only receives replies to the
+             *              given ICMP ids.
+             *
+             * @details     The filter replaces any filter already attached to the socket.  Filters are only
+             *              supported on Linux, the kernel already restricts a datagram socket to its own id.
+             *
+             * @see         Nedrysoft::ICMPSocket::ICMPSocketFilter
+             *
+             * @param[in]   ids the ids to accept.
+             *
+             * @returns     true if the filter was attached; otherwise false.
+             */
+            auto setFilter(const QVector<uint16_t> &ids) -> bool;
+
+            /**
+             * @brief       Returns whether the socket is a datagram socket.
+             *
+             * @see         createDatagramSocket
+             *
+             * @returns     true if the socket is a datagram socket; otherwise false if it is a raw socket.
+             */
+            auto isDatagram() -> bool;
+
+            /**
+             * @brief       Returns the ICMP id that the kernel assigned to a datagram socket.
+             *
+             * @returns     the id; 0 if the socket is a raw socket.
+             */
+            auto id() -> uint16_t;
+
+            /**
+             * @brief       Converts a host address to a socket address.
+             *
+             * @param[in]   hostAddress the host address.
+             * @param[out]  socketAddress the socket address.
+             *
+             * @returns     the length of the socket address; 0 if the address does not match the socket version.
+             */
+            auto toSocketAddress(const QHostAddress &hostAddress, sockaddr_storage &socketAddress) -> socklen_t;
+
+#if defined(Q_OS_LINUX)
+            /**
+             * @brief       Reads the ancillary data of a received message into a packet.
+             *
+             * @details     Decodes the kernel receive timestamp, the ttl (or hop limit) of the reply and an ICMP
+             *              error reported on the error queue, this allows messages that were received outside of
+             *              recvmmsg (i.e by an io_uring request) to be decoded in the same way.
+             *
+             * @param[in]   message the received message.
+             * @param[out]  packet the packet that the decoded values are written to.
+             */
+            static auto readControlMessages(msghdr &message, Nedrysoft::ICMPSocket::ReceivedPacket &packet) -> void;
+#endif
+
+        private:
+            /**
+             * @brief       Reads the ICMP errors waiting on the error queue of a datagram socket.
+             *
+             * @param[out]  packets the list that the errors are appended to.
+             * @param[in]   firstIndex the first free slot of the receive ring.
+             *
+             * @returns     the number of errors read.
+             */
+            auto receiveErrors(QVector<Nedrysoft::ICMPSocket::ReceivedPacket> &packets, int firstIndex) -> int;
+
         private:
             //! @cond
 
+            /**
+             * @brief       A packet that has been queued for transmission.
+             */
+            struct QueuedPacket {
+                int length;
+                sockaddr_storage address;
+                socklen_t addressLength;
+                int ttl;
+                uint32_t tag;
+            };
+
             ICMPSocket::socket_t m_socketDescriptor;
             Nedrysoft::ICMPSocket::IPVersion m_version;
             int m_ttl;
 
+            std::vector<QueuedPacket> m_queue;
+            std::vector<char> m_transmitRing;
+#if defined(Q_OS_LINUX)
+            std::vector<uint64_t> m_transmitControl;
+            std::vector<mmsghdr> m_transmitMessages;
+            std::vector<iovec> m_transmitVectors;
+#endif
+
+            std::vector<char> m_receiveRing;
+            std::vector<sockaddr_storage> m_receiveAddresses;
+            std::vector<uint64_t> m_receiveControl;
+#if defined(Q_OS_LINUX)
+            std::vector<mmsghdr> m_receiveMessages;
+            std::vector<iovec> m_receiveVectors;
+#endif
+
+            std::vector<uint32_t> m_transmitTags;
+            uint32_t m_transmitCount;
+            bool m_transmitTimestamps;
+
+            bool m_isDatagram;
+            uint16_t m_id;
+
             //! @endcond
     };
 }}
@@ -0,0 +1,184 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 18/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "ICMPSocketFilter.h"
+
+#include <algorithm>
+
+// classic BPF opcodes, these are defined here rather than taken from linux/filter.h as the program is generated on
+// all platforms.
+
+constexpr uint16_t OpLoad = 0x00;
+constexpr uint16_t OpLoadX = 0x01;
+constexpr uint16_t OpAlu = 0x04;
+constexpr uint16_t OpJump = 0x05;
+constexpr uint16_t OpReturn = 0x06;
+constexpr uint16_t OpMisc = 0x07;
+
+constexpr uint16_t SizeHalfWord = 0x08;
+constexpr uint16_t SizeByte = 0x10;
+
+constexpr uint16_t ModeAbsolute = 0x20;
+constexpr uint16_t ModeIndirect = 0x40;
+constexpr uint16_t ModeHeaderLength = 0xa0;
+
+constexpr uint16_t AluAdd = 0x00;
+constexpr uint16_t AluAnd = 0x50;
+constexpr uint16_t AluShiftLeft = 0x60;
+
+constexpr uint16_t JumpAlways = 0x00;
+constexpr uint16_t JumpEqual = 0x10;
+constexpr uint16_t JumpGreater = 0x20;
+constexpr uint16_t JumpGreaterOrEqual = 0x30;
+
+constexpr uint16_t SourceX = 0x08;
+constexpr uint16_t MiscTransferAToX = 0x00;
+
+constexpr uint32_t AcceptPacket = UINT32_MAX;
+constexpr uint32_t RejectPacket = 0;
+
+constexpr uint32_t ICMPv4EchoReply = 0;
+constexpr uint32_t ICMPv4TimeExceeded = 11;
+constexpr uint32_t ICMPv6EchoReply = 129;
+constexpr uint32_t ICMPv6TimeExceeded = 3;
+
+constexpr uint32_t ICMPHeaderLength = 8;
+constexpr uint32_t ICMPIdOffset = 4;
+constexpr uint32_t IPv6HeaderLength = 40;
+constexpr uint32_t IPHeaderLengthMask = 0x0F;
+constexpr uint32_t IPHeaderLengthShift = 2;
+
+namespace {
+    /**
+     * @brief       Creates an instruction that does not jump.
+     */
+    auto statement(uint16_t code, uint32_t k) -> Nedrysoft::ICMPSocket::ICMPSocketFilterInstruction {
+        return Nedrysoft::ICMPSocket::ICMPSocketFilterInstruction{code, 0, 0, k};
+    }
+
+    /**
+     * @brief       Creates a conditional jump, the offsets are relative to the next instruction.
+     */
+    auto jump(uint16_t code, uint32_t k, int jt, int jf) -> Nedrysoft::ICMPSocket::ICMPSocketFilterInstruction {
+        return Nedrysoft::ICMPSocket::ICMPSocketFilterInstruction{
+            code,
+            static_cast<uint8_t>(jt),
+            static_cast<uint8_t>(jf),
+            k
+        };
+    }
+
+    /**
+     * @brief       Appends the instructions that test the id in the accumulator followed by the reject and accept
+     *              instructions.
+     */
+    auto appendIdCheck(
+            QVector<Nedrysoft::ICMPSocket::ICMPSocketFilterInstruction> &program,
+            const QVector<uint16_t> &ids) -> void {
+
+        if (ids.count() > Nedrysoft::ICMPSocket::ICMPSocketFilter::MaximumIds) {
+            // the jump offsets are 8 bits, so a large set of ids is matched as a range.
+
+            program.append(jump(OpJump | JumpGreaterOrEqual, ids.first(), 0, 1));
+            program.append(jump(OpJump | JumpGreater, ids.last(), 0, 1));
+        } else {
+            // each comparison jumps over the remaining comparisons and the reject instruction to the accept.
+
+            for (auto index = 0; index < ids.count(); index++) {
+                program.append(jump(OpJump | JumpEqual, ids.at(index), ids.count() - index, 0));
+            }
+        }
+
+        program.append(statement(OpReturn, RejectPacket));
+        program.append(statement(OpReturn, AcceptPacket));
+    }
+}
+
+auto Nedrysoft::ICMPSocket::ICMPSocketFilter::program(
+        Nedrysoft::ICMPSocket::IPVersion version,
+        QVector<uint16_t> ids) -> QVector<Nedrysoft::ICMPSocket::ICMPSocketFilterInstruction> {
+
+    QVector<Nedrysoft::ICMPSocket::ICMPSocketFilterInstruction> program;
+
+    std::sort(ids.begin(), ids.end());
+
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+
+    // the id check follows a fixed length header, so the jumps to it (and to the reject instruction at its end) are
+    // known in advance.
+
+    auto idCheckLength = ( ids.count() > MaximumIds ) ? 2 : ids.count();
+
+    if (version == Nedrysoft::ICMPSocket::V4) {
+        constexpr auto HeaderLength = 12;
+
+        // X = length of the IP header, A = ICMP type.
+
+        program.append(statement(OpLoadX | SizeByte | ModeHeaderLength, 0));
+        program.append(statement(OpLoad | SizeByte | ModeIndirect, 0));
+
+        // echo reply, A = id.
+
+        program.append(jump(OpJump | JumpEqual, ICMPv4EchoReply, 0, 2));
+        program.append(statement(OpLoad | SizeHalfWord | ModeIndirect, ICMPIdOffset));
+        program.append(statement(OpJump | JumpAlways, HeaderLength - 5));
+
+        // time exceeded, X = length of the IP header + length of the embedded IP header, A = embedded id.
+
+        program.append(jump(OpJump | JumpEqual, ICMPv4TimeExceeded, 0, HeaderLength - 6 + idCheckLength));
+        program.append(statement(OpLoad | SizeByte | ModeIndirect, ICMPHeaderLength));
+        program.append(statement(OpAlu | AluAnd, IPHeaderLengthMask));
+        program.append(statement(OpAlu | AluShiftLeft, IPHeaderLengthShift));
+        program.append(statement(OpAlu | AluAdd | SourceX, 0));
+        program.append(statement(OpMisc | MiscTransferAToX, 0));
+        program.append(statement(OpLoad | SizeHalfWord | ModeIndirect, ICMPHeaderLength + ICMPIdOffset));
+
+        Q_ASSERT(program.count() == HeaderLength);
+    } else {
+        constexpr auto HeaderLength = 6;
+
+        // A = ICMPv6 type.
+
+        program.append(statement(OpLoad | SizeByte | ModeAbsolute, 0));
+
+        // echo reply, A = id.
+
+        program.append(jump(OpJump | JumpEqual, ICMPv6EchoReply, 0, 2));
+        program.append(statement(OpLoad | SizeHalfWord | ModeAbsolute, ICMPIdOffset));
+        program.append(statement(OpJump | JumpAlways, HeaderLength - 4));
+
+        // time exceeded, A = embedded id.
+
+        program.append(jump(OpJump | JumpEqual, ICMPv6TimeExceeded, 0, HeaderLength - 5 + idCheckLength));
+        program.append(statement(
+            OpLoad | SizeHalfWord | ModeAbsolute,
+            ICMPHeaderLength + IPv6HeaderLength + ICMPIdOffset ));
+
+        Q_ASSERT(program.count() == HeaderLength);
+    }
+
+    appendIdCheck(program, ids);
+
+    return program;
+}
@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 18/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef NEDRYSOFT_ICMPSOCKET_ICMPSOCKETFILTER_H
+#define NEDRYSOFT_ICMPSOCKET_ICMPSOCKETFILTER_H
+
+#include "ICMPSocket.h"
+
+#include <QVector>
+#include <cstdint>
+
+namespace Nedrysoft { namespace ICMPSocket {
+    /**
+     * @brief       A classic BPF instruction, the layout matches struct sock_filter.
+     */
+    struct ICMPSocketFilterInstruction {
+        uint16_t code;                      /**< the operation. */
+        uint8_t jt;                         /**< the offset of the next instruction if a jump is taken. */
+        uint8_t jf;                         /**< the offset of the next instruction if a jump is not taken. */
+        uint32_t k;                         /**< the operand. */
+    };
+
+    /**
+     * @brief       The ICMPSocketFilter class generates a classic BPF program for a raw ICMP read socket.
+     *
+     * @details     A raw socket receives a copy of every ICMP packet that arrives at the host, the program runs in
+     *              the kernel and only accepts echo replies and time exceeded messages whose id (the id of the
+     *              embedded echo request for a time exceeded message) is one of the given ids, so other packets
+     *              are dropped before they are copied to user space.
+     *
+     *              An IPv4 raw socket receives the IP header, so the program skips the header (and the header of
+     *              the embedded datagram) using their lengths.  An IPv6 raw socket starts at the ICMPv6 header and
+     *              the embedded IPv6 header is assumed to have no extension headers.
+     *
+     *              The ids are matched exactly, up to MaximumIds ids, beyond that the program accepts the range
+     *              between the lowest and highest id.
+     *
+     *              The program only selects candidate packets, accepted packets must still be fully validated.
+     */
+    class NEDRYSOFT_ICMPSOCKET_DLLSPEC ICMPSocketFilter {
+        public:
+            /**
+             * @brief       The largest number of ids that are matched individually.
+             */
+            static constexpr int MaximumIds = 128;
+
+        public:
+            /**
+             * @brief       Generates the program for a socket.
+             *
+             * @param[in]   version the IP version of the socket.
+             * @param[in]   ids the ids to accept, if empty the program rejects all packets.
+             *
+             * @returns     the program.
+             */
+            static auto program(
+                Nedrysoft::ICMPSocket::IPVersion version,
+                QVector<uint16_t> ids
+            ) -> QVector<Nedrysoft::ICMPSocket::ICMPSocketFilterInstruction>;
+    };
+}}
+
+#endif // NEDRYSOFT_ICMPSOCKET_ICMPSOCKETFILTER_H
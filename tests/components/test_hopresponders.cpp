@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 18/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "catch.hpp"
+#include "RouteAnalyser/HopResponders.h"
+
+#include <QHostAddress>
+
+TEST_CASE("HopResponders Tests", "[app][components][routeanalyser]") {
+    using Nedrysoft::RouteAnalyser::HopResponders;
+
+    auto firstRouter = QHostAddress("10.0.0.1");
+    auto secondRouter = QHostAddress("10.0.0.2");
+
+    SECTION("samples from the same router are combined") {
+        HopResponders responders;
+
+        responders.addSample(firstRouter, 0.010);
+        responders.addSample(firstRouter, 0.030);
+        responders.addSample(firstRouter);
+
+        REQUIRE(responders.count() == 1);
+        REQUIRE_FALSE(responders.isMultipath());
+        REQUIRE(responders.at(0).sampleCount == 3);
+        REQUIRE(responders.at(0).latencyCount == 2);
+        REQUIRE(responders.at(0).minimumLatency == Approx(0.010));
+        REQUIRE(responders.at(0).maximumLatency == Approx(0.030));
+        REQUIRE(responders.at(0).averageLatency == Approx(0.020));
+    }
+
+    SECTION("each router of a load balanced hop keeps its own statistics") {
+        HopResponders responders;
+
+        responders.addSample(firstRouter, 0.010);
+        responders.addSample(secondRouter, 0.050);
+        responders.addSample(secondRouter, 0.070);
+
+        REQUIRE(responders.count() == 2);
+        REQUIRE(responders.isMultipath());
+        REQUIRE(responders.primaryIndex() == responders.indexOf(secondRouter));
+        REQUIRE(responders.at(responders.indexOf(firstRouter)).averageLatency == Approx(0.010));
+        REQUIRE(responders.at(responders.indexOf(secondRouter)).averageLatency == Approx(0.060));
+    }
+
+    SECTION("null addresses are ignored") {
+        HopResponders responders;
+
+        responders.addSample(QHostAddress(), 0.010);
+
+        REQUIRE(responders.count() == 0);
+        REQUIRE(responders.primaryIndex() == -1);
+    }
+
+    SECTION("routers beyond the capacity are counted as overflow") {
+        HopResponders responders;
+
+        for (auto router=0;router<HopResponders::MaximumResponders+2;router++) {
+            responders.addSample(QHostAddress(static_cast<quint32>(0x0a000001+router)), 0.010);
+        }
+
+        REQUIRE(responders.count() == HopResponders::MaximumResponders);
+        REQUIRE(responders.overflowCount() == 2);
+    }
+
+    SECTION("merging combines the samples of matching routers") {
+        HopResponders discovered;
+        HopResponders measured;
+
+        discovered.addSample(firstRouter, 0.010);
+        measured.addSample(firstRouter, 0.030);
+        measured.addSample(secondRouter, 0.020);
+
+        discovered.merge(measured);
+
+        REQUIRE(discovered.count() == 2);
+        REQUIRE(discovered.at(discovered.indexOf(firstRouter)).sampleCount == 2);
+        REQUIRE(discovered.at(discovered.indexOf(firstRouter)).averageLatency == Approx(0.020));
+        REQUIRE(discovered.at(discovered.indexOf(firstRouter)).maximumLatency == Approx(0.030));
+        REQUIRE(discovered.at(discovered.indexOf(secondRouter)).sampleCount == 1);
+    }
+}
@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 18/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "catch.hpp"
+#include "Core/HostNameCache.h"
+
+#include <QHostAddress>
+#include <QString>
+
+TEST_CASE("HostNameCache Tests", "[app][components][core]") {
+    using Nedrysoft::Core::HostNameCache;
+
+    auto firstAddress = QHostAddress("10.0.0.1");
+    auto secondAddress = QHostAddress("10.0.0.2");
+    auto thirdAddress = QHostAddress("10.0.0.3");
+
+    SECTION("entries are found until they expire") {
+        HostNameCache cache;
+        QString hostName;
+
+        cache.insert(firstAddress, "router.example.com", 1000);
+
+        REQUIRE(cache.find(firstAddress, 999, hostName));
+        REQUIRE(hostName == "router.example.com");
+        REQUIRE_FALSE(cache.find(firstAddress, 1000, hostName));
+        REQUIRE(cache.count() == 0);
+    }
+
+    SECTION("addresses without a name are cached") {
+        HostNameCache cache;
+        QString hostName = "unchanged";
+
+        cache.insert(firstAddress, QString(), 1000);
+
+        REQUIRE(cache.find(firstAddress, 0, hostName));
+        REQUIRE(hostName.isEmpty());
+    }
+
+    SECTION("the least recently used entry is removed when the cache is full") {
+        HostNameCache cache(2);
+        QString hostName;
+
+        cache.insert(firstAddress, "first", 1000);
+        cache.insert(secondAddress, "second", 1000);
+
+        REQUIRE(cache.find(firstAddress, 0, hostName));
+
+        cache.insert(thirdAddress, "third", 1000);
+
+        REQUIRE(cache.count() == 2);
+        REQUIRE(cache.find(firstAddress, 0, hostName));
+        REQUIRE_FALSE(cache.find(secondAddress, 0, hostName));
+        REQUIRE(cache.find(thirdAddress, 0, hostName));
+    }
+
+    SECTION("inserting an address again replaces its entry") {
+        HostNameCache cache;
+        QString hostName;
+
+        cache.insert(firstAddress, "old", 1000);
+        cache.insert(firstAddress, "new", 2000);
+
+        REQUIRE(cache.count() == 1);
+        REQUIRE(cache.find(firstAddress, 1500, hostName));
+        REQUIRE(hostName == "new");
+    }
+}
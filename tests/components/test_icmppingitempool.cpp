@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 18/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "catch.hpp"
+#include "ICMPPingEngine/ICMPPingItemPool.h"
+
+#include <atomic>
+#include <set>
+#include <thread>
+#include <vector>
+
+constexpr auto PoolCapacity = 64;
+constexpr auto ThreadCount = 4;
+constexpr auto IterationsPerThread = 100000;
+constexpr auto ItemsPerIteration = 8;
+
+namespace {
+    struct TestItem {
+        std::atomic<int> owner = {0};
+    };
+}
+
+TEST_CASE("ICMPPingItemPool Tests", "[app][components][icmppingengine]") {
+    SECTION("items are taken from the slab until it is exhausted") {
+        Nedrysoft::ICMPPingEngine::ICMPPingItemPool<TestItem, 4> pool;
+        std::set<TestItem *> items;
+
+        for (auto index = 0; index < 4; index++) {
+            items.insert(pool.acquire());
+        }
+
+        REQUIRE_MESSAGE(items.size() == 4, "The same item was returned more than once.");
+        REQUIRE_MESSAGE(pool.statistics().heapAllocations == 0, "The slab was not used.");
+
+        auto overflowItem = pool.acquire();
+
+        REQUIRE_MESSAGE(items.count(overflowItem) == 0, "An item in use was returned.");
+        REQUIRE_MESSAGE(pool.statistics().heapAllocations == 1, "The overflow item was not counted.");
+
+        pool.release(overflowItem);
+
+        for (auto item : items) {
+            pool.release(item);
+        }
+
+        auto statistics = pool.statistics();
+
+        REQUIRE(statistics.acquired == 5);
+        REQUIRE(statistics.released == 5);
+        REQUIRE(statistics.capacity == 4);
+    }
+
+    SECTION("released items are reused without allocating") {
+        Nedrysoft::ICMPPingEngine::ICMPPingItemPool<TestItem, 4> pool;
+
+        for (auto iteration = 0; iteration < 1000; iteration++) {
+            auto first = pool.acquire();
+            auto second = pool.acquire();
+
+            pool.release(first);
+            pool.release(second);
+        }
+
+        REQUIRE_MESSAGE(pool.statistics().heapAllocations == 0, "The steady state allocated memory.");
+    }
+
+    SECTION("items are owned by a single thread under contention") {
+        auto pool = std::make_unique<Nedrysoft::ICMPPingEngine::ICMPPingItemPool<TestItem, PoolCapacity> >();
+        std::atomic<int> conflicts(0);
+        std::vector<std::thread> threads;
+
+        for (auto thread = 1; thread <= ThreadCount; thread++) {
+            threads.emplace_back([&pool, &conflicts, thread]() {
+                TestItem *items[ItemsPerIteration];
+
+                for (auto iteration = 0; iteration < IterationsPerThread; iteration++) {
+                    for (auto &item : items) {
+                        item = pool->acquire();
+
+                        auto expected = 0;
+
+                        if (!item->owner.compare_exchange_strong(expected, thread)) {
+                            conflicts++;
+                        }
+                    }
+
+                    for (auto &item : items) {
+                        item->owner.store(0);
+
+                        pool->release(item);
+                    }
+                }
+            });
+        }
+
+        for (auto &thread : threads) {
+            thread.join();
+        }
+
+        auto statistics = pool->statistics();
+
+        REQUIRE_MESSAGE(conflicts == 0, "An item was handed to more than one thread.");
+        REQUIRE_MESSAGE(statistics.acquired == statistics.released, "Items were lost.");
+        REQUIRE_MESSAGE(statistics.heapAllocations == 0, "The pool allocated while items were available.");
+    }
+}
@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 18/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "catch.hpp"
+#include "ICMPPingEngine/ICMPPingPacing.h"
+#include "ICMPPingEngine/Utils.h"
+
+#include <algorithm>
+#include <set>
+#include <vector>
+
+constexpr auto Interval = INT64_C(2500000000);
+constexpr auto TargetCount = 30;
+
+TEST_CASE("ICMPPingPacing Tests", "[app][components][icmppingengine]") {
+    using Nedrysoft::ICMPPingEngine::ICMPPingPacing;
+    using Nedrysoft::ICMPPingEngine::PacingMode;
+
+    SECTION("burst mode sends every target at the start of the round") {
+        for (auto index = 0; index < TargetCount; index++) {
+            REQUIRE(ICMPPingPacing::offset(PacingMode::Burst, index, TargetCount, index, Interval) == 0);
+        }
+    }
+
+    SECTION("even mode spaces targets equally across the interval") {
+        for (auto index = 0; index < TargetCount; index++) {
+            auto offset = ICMPPingPacing::offset(PacingMode::Even, index, TargetCount, 0, Interval);
+
+            REQUIRE_MESSAGE(offset == Interval * index / TargetCount, "Target is not at its even offset.");
+        }
+    }
+
+    SECTION("random mode offsets are stable, in range and spread out") {
+        std::vector<int64_t> offsets;
+
+        for (auto ttl = 1; ttl <= TargetCount; ttl++) {
+            auto key = Nedrysoft::Utils::fzMake32(0x1234, static_cast<uint16_t>(ttl));
+            auto offset = ICMPPingPacing::offset(PacingMode::Random, ttl - 1, TargetCount, key, Interval);
+
+            REQUIRE_MESSAGE((( offset >= 0 ) && ( offset < Interval )), "Offset is outside of the interval.");
+            REQUIRE_MESSAGE(
+                offset == ICMPPingPacing::offset(PacingMode::Random, 0, 1, key, Interval),
+                "Offset changed between rounds." );
+
+            offsets.push_back(offset);
+        }
+
+        std::sort(offsets.begin(), offsets.end());
+
+        REQUIRE_MESSAGE(
+            std::set<int64_t>(offsets.begin(), offsets.end()).size() == offsets.size(),
+            "Targets share an offset." );
+
+        // consecutive hops should not be clustered at one end of the interval.
+
+        REQUIRE(offsets.front() < Interval / 4);
+        REQUIRE(offsets.back() > Interval * 3 / 4);
+    }
+
+    SECTION("lateness is accumulated") {
+        ICMPPingPacing pacing;
+
+        pacing.record(-10);
+        pacing.record(500);
+        pacing.record(ICMPPingPacing::LateThreshold * 3);
+
+        auto statistics = pacing.statistics();
+
+        REQUIRE(statistics.probes == 3);
+        REQUIRE(statistics.lateProbes == 1);
+        REQUIRE(statistics.totalLateness == 500 + ICMPPingPacing::LateThreshold * 3);
+        REQUIRE(statistics.maximumLateness == ICMPPingPacing::LateThreshold * 3);
+    }
+
+    SECTION("sleepUntil waits for an absolute deadline") {
+        auto deadline = Nedrysoft::Utils::monotonicNanoseconds() + INT64_C(20000000);
+
+        Nedrysoft::Utils::sleepUntil(deadline);
+
+        REQUIRE(Nedrysoft::Utils::monotonicNanoseconds() >= deadline);
+    }
+}
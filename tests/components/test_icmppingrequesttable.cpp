@@ -0,0 +1,266 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 18/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "catch.hpp"
+#include "ICMPPingEngine/ICMPPingRequestTable.h"
+#include "ICMPPingEngine/Utils.h"
+
+#include <QMap>
+#include <QMutex>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+constexpr auto BenchmarkRequestCount = 20000;
+constexpr auto BenchmarkTargetId = 0x1234;
+constexpr auto TableCapacity = 8192;
+
+namespace {
+    struct TestItem {
+        uint32_t id;
+    };
+
+    /**
+     * @brief       Reproduces the QMap and mutex request tracking previously used by ICMPPingEngine.
+     */
+    class MutexRequestMap {
+        public:
+            auto insert(uint32_t key, TestItem *value, int64_t deadline) -> bool {
+                QMutexLocker locker(&m_mutex);
+
+                m_requests[key] = qMakePair(value, deadline);
+
+                return true;
+            }
+
+            auto take(uint32_t key) -> TestItem * {
+                QMutexLocker locker(&m_mutex);
+
+                if (!m_requests.contains(key)) {
+                    return nullptr;
+                }
+
+                return m_requests.take(key).first;
+            }
+
+            template<typename F>
+            auto forEach(F function) -> void {
+                QMutexLocker locker(&m_mutex);
+
+                auto keys = m_requests.keys();
+
+                locker.unlock();
+
+                for (auto key : keys) {
+                    function(key, 0);
+                }
+            }
+
+        private:
+            QMap<uint32_t, QPair<TestItem *, int64_t> > m_requests;
+            QMutex m_mutex;
+    };
+
+    /**
+     * @brief       Runs a transmitter, receiver and timeout thread against a request table.
+     *
+     * @details     The transmitter inserts requests, the receiver takes them as "replies" and the timeout
+     *              thread continually scans the table and claims every 8th request as a "timeout".
+     *
+     * @returns     the number of requests that were serviced.
+     */
+    template<typename Table>
+    auto runContention(Table &table, std::vector<TestItem> &items) -> int {
+        std::atomic<bool> transmitComplete(false);
+        std::atomic<int> serviced(0);
+        std::atomic<int> transmitted(0);
+
+        std::thread transmitter([&]() {
+            for (auto sequence = 0; sequence < static_cast<int>(items.size()); sequence++) {
+                auto key = Nedrysoft::Utils::fzMake32(BenchmarkTargetId, static_cast<uint16_t>(sequence));
+
+                items[sequence].id = key;
+
+                while (!table.insert(key, &items[sequence], sequence)) {
+                    std::this_thread::yield();
+                }
+
+                transmitted.store(sequence + 1, std::memory_order_release);
+            }
+
+            transmitComplete = true;
+        });
+
+        std::thread receiver([&]() {
+            auto sequence = 0;
+
+            while (sequence < static_cast<int>(items.size())) {
+                if (sequence >= transmitted.load(std::memory_order_acquire)) {
+                    std::this_thread::yield();
+
+                    continue;
+                }
+
+                if (sequence % 8) {
+                    auto key = Nedrysoft::Utils::fzMake32(BenchmarkTargetId, static_cast<uint16_t>(sequence));
+
+                    if (table.take(key)) {
+                        serviced++;
+                    }
+                }
+
+                sequence++;
+            }
+        });
+
+        std::thread timeout([&]() {
+            auto scan = [&]() {
+                table.forEach([&](uint32_t key, int64_t) {
+                    if (( key & 0xFFFF ) % 8 == 0) {
+                        if (table.take(key)) {
+                            serviced++;
+                        }
+                    }
+                });
+            };
+
+            while (!transmitComplete) {
+                scan();
+            }
+
+            scan();
+        });
+
+        transmitter.join();
+        receiver.join();
+        timeout.join();
+
+        return serviced;
+    }
+}
+
+TEST_CASE("ICMPPingRequestTable Tests", "[app][components][icmppingengine]") {
+    SECTION("inserted requests can be taken exactly once") {
+        Nedrysoft::ICMPPingEngine::ICMPPingRequestTable<TestItem, 64> table;
+        TestItem item = {};
+
+        REQUIRE_MESSAGE(table.insert(0x00010001, &item, 100), "Unable to insert a request.");
+        REQUIRE_MESSAGE(table.count() == 1, "Request count is incorrect after insert.");
+        REQUIRE_MESSAGE(table.take(0x00010002) == nullptr, "An unknown request was returned.");
+        REQUIRE_MESSAGE(table.take(0x00010001) == &item, "The inserted request was not returned.");
+        REQUIRE_MESSAGE(table.take(0x00010001) == nullptr, "A request was returned more than once.");
+        REQUIRE_MESSAGE(table.count() == 0, "Request count is incorrect after take.");
+    }
+
+    SECTION("forEach reports keys and deadlines") {
+        Nedrysoft::ICMPPingEngine::ICMPPingRequestTable<TestItem, 64> table;
+        TestItem items[3] = {};
+        int64_t deadlineTotal = 0;
+        auto visited = 0;
+
+        for (auto sequence = 0; sequence < 3; sequence++) {
+            table.insert(Nedrysoft::Utils::fzMake32(1, static_cast<uint16_t>(sequence)), &items[sequence], sequence);
+        }
+
+        table.forEach([&](uint32_t, int64_t deadline) {
+            deadlineTotal += deadline;
+            visited++;
+        });
+
+        REQUIRE_MESSAGE(visited == 3, "forEach did not visit every request.");
+        REQUIRE_MESSAGE(deadlineTotal == 3, "forEach returned incorrect deadlines.");
+    }
+
+    SECTION("insert fails when the table is full and slots are reused after take") {
+        Nedrysoft::ICMPPingEngine::ICMPPingRequestTable<TestItem, 16> table;
+        TestItem item = {};
+
+        for (auto sequence = 0; sequence < 16; sequence++) {
+            REQUIRE(table.insert(Nedrysoft::Utils::fzMake32(1, static_cast<uint16_t>(sequence)), &item, 0));
+        }
+
+        REQUIRE_MESSAGE(!table.insert(Nedrysoft::Utils::fzMake32(1, 16), &item, 0), "Insert into a full table succeeded.");
+
+        REQUIRE(table.take(Nedrysoft::Utils::fzMake32(1, 3)) == &item);
+
+        REQUIRE_MESSAGE(table.insert(Nedrysoft::Utils::fzMake32(1, 16), &item, 0), "Slot was not reused after take.");
+        REQUIRE(table.take(Nedrysoft::Utils::fzMake32(1, 16)) == &item);
+    }
+
+    SECTION("lookups of missing keys stay short after many inserts and takes") {
+        Nedrysoft::ICMPPingEngine::ICMPPingRequestTable<TestItem, 64> table;
+        TestItem item = {};
+        size_t probeTotal = 0;
+
+        // a few requests are kept in flight while every slot of the table is used many times over.
+
+        for (auto sequence = 0; sequence < 10000; sequence++) {
+            REQUIRE(table.insert(Nedrysoft::Utils::fzMake32(1, static_cast<uint16_t>(sequence)), &item, 0));
+
+            if (sequence >= 4) {
+                REQUIRE(table.take(Nedrysoft::Utils::fzMake32(1, static_cast<uint16_t>(sequence-4))) == &item);
+            }
+        }
+
+        for (auto sequence = 0; sequence < 64; sequence++) {
+            probeTotal += table.probeLength(Nedrysoft::Utils::fzMake32(2, static_cast<uint16_t>(sequence)));
+        }
+
+        REQUIRE_MESSAGE(probeTotal < 64*4, "Lookups of missing keys scan too many slots.");
+
+        for (auto sequence = 10000-4; sequence < 10000; sequence++) {
+            REQUIRE(table.take(Nedrysoft::Utils::fzMake32(1, static_cast<uint16_t>(sequence))) == &item);
+        }
+
+        REQUIRE_MESSAGE(
+            table.probeLength(Nedrysoft::Utils::fzMake32(2, 0)) == 1,
+            "Slots were not emptied once the table was empty." );
+    }
+
+    SECTION("requests are serviced exactly once under contention") {
+        auto table = std::make_unique<Nedrysoft::ICMPPingEngine::ICMPPingRequestTable<TestItem, TableCapacity> >();
+        std::vector<TestItem> items(BenchmarkRequestCount);
+
+        auto serviced = runContention(*table, items);
+
+        REQUIRE_MESSAGE(serviced == BenchmarkRequestCount, "Requests were lost or serviced more than once.");
+        REQUIRE_MESSAGE(table->count() == 0, "Requests remain in the table.");
+    }
+}
+
+TEST_CASE("ICMPPingRequestTable Benchmarks", "[!benchmark][components][icmppingengine]") {
+    std::vector<TestItem> items(BenchmarkRequestCount);
+
+    BENCHMARK("QMap + QMutex, 3 threads") {
+        MutexRequestMap table;
+
+        return runContention(table, items);
+    };
+
+    BENCHMARK("ICMPPingRequestTable, 3 threads") {
+        auto table = std::make_unique<Nedrysoft::ICMPPingEngine::ICMPPingRequestTable<TestItem, TableCapacity> >();
+
+        return runContention(*table, items);
+    };
+}
@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 18/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "catch.hpp"
+#include "ICMPPingEngine/ICMPPingTimeoutEstimator.h"
+
+#include <cstdint>
+
+constexpr auto Millisecond = INT64_C(1000000);
+constexpr auto MinimumTimeout = 100 * Millisecond;
+constexpr auto MaximumTimeout = 5000 * Millisecond;
+
+TEST_CASE("ICMPPingTimeoutEstimator Tests", "[app][components][icmppingengine]") {
+    using Nedrysoft::ICMPPingEngine::ICMPPingTimeoutEstimator;
+
+    SECTION("the maximum is used until a reply is received") {
+        ICMPPingTimeoutEstimator estimator;
+
+        REQUIRE(estimator.timeout(MinimumTimeout, MaximumTimeout) == MaximumTimeout);
+    }
+
+    SECTION("the first sample sets SRTT and RTTVAR") {
+        ICMPPingTimeoutEstimator estimator;
+
+        estimator.addSample(200 * Millisecond);
+
+        REQUIRE(estimator.smoothedRoundTripTime() == 200 * Millisecond);
+        REQUIRE(estimator.roundTripTimeVariation() == 100 * Millisecond);
+        REQUIRE(estimator.timeout(MinimumTimeout, MaximumTimeout) == 600 * Millisecond);
+    }
+
+    SECTION("a stable round trip time converges towards SRTT") {
+        ICMPPingTimeoutEstimator estimator;
+
+        for (auto sample = 0; sample < 100; sample++) {
+            estimator.addSample(300 * Millisecond);
+        }
+
+        auto timeout = estimator.timeout(0, MaximumTimeout);
+
+        REQUIRE(estimator.smoothedRoundTripTime() == 300 * Millisecond);
+        REQUIRE_MESSAGE((( timeout >= 300 * Millisecond ) && ( timeout <= 302 * Millisecond )), "Timeout did not converge.");
+    }
+
+    SECTION("the timeout is bounded by the minimum and maximum") {
+        ICMPPingTimeoutEstimator nearEstimator;
+        ICMPPingTimeoutEstimator farEstimator;
+
+        nearEstimator.addSample(Millisecond);
+        farEstimator.addSample(4000 * Millisecond);
+
+        REQUIRE(nearEstimator.timeout(MinimumTimeout, MaximumTimeout) == MinimumTimeout);
+        REQUIRE(farEstimator.timeout(MinimumTimeout, MaximumTimeout) == MaximumTimeout);
+    }
+
+    SECTION("losses back off the timeout until the next reply") {
+        ICMPPingTimeoutEstimator estimator;
+
+        estimator.addSample(200 * Millisecond);
+
+        estimator.addLoss();
+
+        REQUIRE(estimator.timeout(MinimumTimeout, MaximumTimeout) == 1200 * Millisecond);
+
+        estimator.addLoss();
+
+        REQUIRE(estimator.timeout(MinimumTimeout, MaximumTimeout) == 2400 * Millisecond);
+
+        for (auto loss = 0; loss < 100; loss++) {
+            estimator.addLoss();
+        }
+
+        REQUIRE(estimator.timeout(MinimumTimeout, MaximumTimeout) == MaximumTimeout);
+
+        estimator.addSample(200 * Millisecond);
+
+        REQUIRE(estimator.timeout(MinimumTimeout, MaximumTimeout) < 1200 * Millisecond);
+    }
+}
@@ -0,0 +1,208 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 18/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "catch.hpp"
+#include "ICMPPingEngine/ICMPPingTimingWheel.h"
+#include "ICMPPingEngine/Utils.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+    using Nedrysoft::ICMPPingEngine::ICMPPingTimingWheel;
+
+    /**
+     * @brief       Advances a wheel and returns the keys of the entries that expired.
+     */
+    auto expireKeys(ICMPPingTimingWheel &wheel, int64_t currentTime) -> std::vector<uint32_t> {
+        std::vector<ICMPPingTimingWheel::Entry> expired;
+        std::vector<uint32_t> keys;
+
+        wheel.expire(currentTime, expired);
+
+        for (const auto &entry : expired) {
+            keys.push_back(entry.key);
+        }
+
+        return keys;
+    }
+}
+
+TEST_CASE("ICMPPingTimingWheel Tests", "[app][components][icmppingengine]") {
+    // the wheels are created with an origin of 0 and a 1ns tick, so a deadline is also the tick that it expires at.
+
+    SECTION("deadlines on a 256 tick boundary expire at their deadline") {
+        ICMPPingTimingWheel wheel(1, 0);
+
+        wheel.schedule(1, 256);
+        wheel.schedule(2, 512);
+
+        REQUIRE(wheel.count() == 2);
+        REQUIRE(expireKeys(wheel, 255).empty());
+        REQUIRE(expireKeys(wheel, 256) == std::vector<uint32_t>{1});
+        REQUIRE(expireKeys(wheel, 511).empty());
+        REQUIRE(expireKeys(wheel, 512) == std::vector<uint32_t>{2});
+        REQUIRE(wheel.count() == 0);
+    }
+
+    SECTION("deadlines in level 1 and level 2 are cascaded and expire at their deadline") {
+        ICMPPingTimingWheel wheel(1, 0);
+        std::vector<int64_t> deadlines = {300, 65535, 65536, 65536+256*3+5, 70000, 16777216+17};
+
+        for (auto index = 0; index < static_cast<int>(deadlines.size()); index++) {
+            wheel.schedule(static_cast<uint32_t>(index), deadlines[index]);
+        }
+
+        for (auto index = 0; index < static_cast<int>(deadlines.size()); index++) {
+            REQUIRE(expireKeys(wheel, deadlines[index]-1).empty());
+            REQUIRE(expireKeys(wheel, deadlines[index]) == std::vector<uint32_t>{static_cast<uint32_t>(index)});
+        }
+
+        REQUIRE(wheel.count() == 0);
+    }
+
+    SECTION("random deadlines expire once and never early") {
+        ICMPPingTimingWheel wheel(1, 0);
+        std::mt19937_64 generator(1);
+        std::map<uint32_t, int64_t> pending;
+        int64_t currentTime = 0;
+        uint32_t key = 1;
+
+        for (auto step = 0; step < 2000; step++) {
+            for (auto entry = 0; entry < 4; entry++) {
+                auto deadline = currentTime + static_cast<int64_t>(generator() % 200000);
+
+                wheel.schedule(key, deadline);
+
+                pending[key++] = deadline;
+            }
+
+            auto previousTime = currentTime;
+
+            currentTime += static_cast<int64_t>(generator() % 1000);
+
+            std::vector<ICMPPingTimingWheel::Entry> expired;
+
+            wheel.expire(currentTime, expired);
+
+            for (const auto &entry : expired) {
+                REQUIRE(pending.count(entry.key) == 1);
+                REQUIRE(entry.deadline <= currentTime);
+
+                pending.erase(entry.key);
+            }
+
+            auto isOverdue = std::any_of(pending.begin(), pending.end(), [previousTime](const auto &request) {
+                return request.second <= previousTime;
+            });
+
+            REQUIRE_MESSAGE(!isOverdue, "An entry was not expired at its deadline.");
+        }
+
+        REQUIRE(wheel.count() == pending.size());
+    }
+
+    SECTION("entries beyond the range of the wheel do not expire early") {
+        ICMPPingTimingWheel wheel(1, 0);
+        auto deadline = ( static_cast<int64_t>(1) << 32 ) + 1000;
+
+        wheel.schedule(1, deadline);
+
+        REQUIRE(expireKeys(wheel, deadline / 2).empty());
+        REQUIRE(expireKeys(wheel, deadline-1).empty());
+        REQUIRE(expireKeys(wheel, deadline) == std::vector<uint32_t>{1});
+    }
+
+    SECTION("an entry due at or before the current tick expires on the next call") {
+        ICMPPingTimingWheel wheel(1, 0);
+
+        REQUIRE(expireKeys(wheel, 1000).empty());
+
+        wheel.schedule(1, 1000);
+        wheel.schedule(2, 500);
+        wheel.schedule(3, -5);
+
+        REQUIRE(wheel.count() == 3);
+        REQUIRE(wheel.nextTime() == 1000);
+        REQUIRE(expireKeys(wheel, 1000) == std::vector<uint32_t>{1, 2, 3});
+        REQUIRE(wheel.count() == 0);
+    }
+
+    SECTION("nextTime reports the next deadline or the next rotation") {
+        ICMPPingTimingWheel wheel(1, 0);
+
+        REQUIRE(wheel.nextTime() == -1);
+
+        wheel.schedule(1, 1000);
+
+        REQUIRE(wheel.nextTime() == 256);
+
+        wheel.schedule(2, 100);
+
+        REQUIRE(wheel.nextTime() == 100);
+    }
+
+    SECTION("stop clears the scheduled entries") {
+        ICMPPingTimingWheel wheel(1, 0);
+        std::vector<ICMPPingTimingWheel::Entry> expired;
+
+        wheel.schedule(1, 100);
+        wheel.schedule(2, 100000);
+        wheel.schedule(3, 0);
+
+        wheel.stop();
+
+        REQUIRE(wheel.count() == 0);
+        REQUIRE(wheel.nextTime() == -1);
+        REQUIRE(!wheel.wait(expired));
+        REQUIRE(expired.empty());
+    }
+
+    SECTION("schedule wakes a wait for an earlier deadline") {
+        ICMPPingTimingWheel wheel(1000000);
+        std::vector<ICMPPingTimingWheel::Entry> expired;
+
+        wheel.schedule(1, Nedrysoft::Utils::monotonicNanoseconds() + 60000000000);
+
+        std::thread scheduler([&wheel]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+            wheel.schedule(2, Nedrysoft::Utils::monotonicNanoseconds() + 10000000);
+        });
+
+        auto startTime = std::chrono::steady_clock::now();
+
+        REQUIRE(wheel.wait(expired));
+
+        scheduler.join();
+
+        REQUIRE(std::chrono::steady_clock::now() - startTime < std::chrono::seconds(10));
+        REQUIRE(expired.size() == 1);
+        REQUIRE(expired.at(0).key == 2);
+    }
+}
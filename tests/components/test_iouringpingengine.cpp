@@ -0,0 +1,296 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 18/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "catch.hpp"
+#include "ICMPPacket/ICMPPacket.h"
+#include "ICMPPacket/ICMPReplyView.h"
+#include "ICMPSocket/ICMPSocket.h"
+
+#include <QHostAddress>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#if defined(Q_OS_LINUX)
+#include "IOUringPingEngine/IOUring.h"
+#include "IOUringPingEngine/IOUringMessage.h"
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+constexpr auto ProbeCount = 64;
+constexpr auto PayloadLength = 52;
+constexpr auto ReceiveTimeout = INT64_C(1000000000);
+
+namespace {
+    using Nedrysoft::IOUringPingEngine::IOUring;
+    using Nedrysoft::IOUringPingEngine::IOUringMessage;
+
+    /**
+     * @brief       Creates a datagram socket if the host allows unprivileged ICMP sockets.
+     */
+    auto createSocket() -> std::unique_ptr<Nedrysoft::ICMPSocket::ICMPSocket> {
+        if (!Nedrysoft::ICMPSocket::ICMPSocket::isDatagramSupported(Nedrysoft::ICMPSocket::V4)) {
+            return nullptr;
+        }
+
+        return std::unique_ptr<Nedrysoft::ICMPSocket::ICMPSocket>(
+            Nedrysoft::ICMPSocket::ICMPSocket::createDatagramSocket(Nedrysoft::ICMPSocket::V4) );
+    }
+
+    /**
+     * @brief       Decodes a packet received on a datagram socket and checks that it is the expected echo reply.
+     */
+    auto isEchoReply(const Nedrysoft::ICMPSocket::ReceivedPacket &packet, uint16_t id) -> bool {
+        auto responsePacket = Nedrysoft::ICMPPacket::ICMPReplyView(
+            gsl::span<const uint8_t>(
+                reinterpret_cast<const uint8_t *>(packet.buffer.constData()),
+                packet.buffer.length() ),
+            Nedrysoft::ICMPPacket::V4,
+            Nedrysoft::ICMPPacket::PacketFormat::Datagram );
+
+        return ( responsePacket.resultCode() == Nedrysoft::ICMPPacket::EchoReply ) && ( responsePacket.id() == id );
+    }
+
+    /**
+     * @brief       Sends a batch of probes to the loopback address with ICMPSocket and reads the replies.
+     */
+    auto socketRoundTrip(Nedrysoft::ICMPSocket::ICMPSocket &socket, const QByteArray &probe) -> int {
+        QVector<Nedrysoft::ICMPSocket::ReceivedPacket> packets;
+        auto loopback = QHostAddress("127.0.0.1");
+        auto received = 0;
+
+        for (auto probeIndex = 0; probeIndex < ProbeCount; probeIndex++) {
+            socket.queue(probe, loopback);
+        }
+
+        socket.flush();
+
+        while (received < ProbeCount) {
+            auto count = socket.recvmmsg(packets, 1000);
+
+            if (count <= 0) {
+                break;
+            }
+
+            received += count;
+        }
+
+        return received;
+    }
+
+    /**
+     * @brief       Sends a batch of probes to the loopback address with io_uring and reads the replies.
+     */
+    auto ringRoundTrip(
+            IOUring &ring,
+            Nedrysoft::ICMPSocket::ICMPSocket &socket,
+            std::vector<IOUringMessage> &messages,
+            const QByteArray &probe) -> int {
+
+        sockaddr_storage address = {};
+
+        auto addressLength = socket.toSocketAddress(QHostAddress("127.0.0.1"), address);
+        auto received = 0;
+        auto transmitted = 0;
+
+        for (auto probeIndex = 0; probeIndex < ProbeCount; probeIndex++) {
+            auto &message = messages[static_cast<size_t>(ProbeCount + probeIndex)];
+
+            memcpy(message.buffer(), probe.constData(), static_cast<size_t>(probe.length()));
+
+            ring.sendMessage(
+                socket.descriptor(),
+                message.prepareSend(probe.length(), address, addressLength, 0, Nedrysoft::ICMPSocket::V4),
+                1 );
+        }
+
+        for (auto probeIndex = 0; probeIndex < ProbeCount; probeIndex++) {
+            ring.receiveMessage(socket.descriptor(), messages[static_cast<size_t>(probeIndex)].prepareReceive(), 0, 0);
+        }
+
+        while (( received < ProbeCount ) || ( transmitted < ProbeCount )) {
+            if (ring.submit(1) < 0) {
+                break;
+            }
+
+            ring.forEachCompletion([&](uint64_t userData, int result) {
+                if (userData) {
+                    transmitted++;
+                } else if (result > 0) {
+                    received++;
+                }
+            });
+        }
+
+        return received;
+    }
+}
+
+TEST_CASE("IOUringPingEngine Tests", "[app][components][iouringpingengine]") {
+    if (!IOUring::isSupported()) {
+        WARN("io_uring is not available, tests skipped.");
+
+        return;
+    }
+
+    SECTION("an absolute timeout completes at its deadline") {
+        IOUring ring(4);
+
+        auto deadline = IOUring::monotonicNanoseconds() + INT64_C(20000000);
+        auto timespec = IOUring::toTimespec(deadline);
+        auto completionResult = 0;
+
+        REQUIRE(ring.timeout(&timespec, 7));
+        REQUIRE(ring.submit(1) >= 0);
+
+        auto completions = ring.forEachCompletion([&](uint64_t userData, int result) {
+            REQUIRE(userData == 7);
+
+            completionResult = result;
+        });
+
+        REQUIRE(completions == 1);
+        REQUIRE(completionResult == -ETIME);
+        REQUIRE(IOUring::monotonicNanoseconds() >= deadline);
+    }
+
+    SECTION("a read of an eventfd completes when it is written") {
+        IOUring ring(4);
+        uint64_t value = 0;
+        uint64_t wake = 1;
+
+        auto descriptor = eventfd(0, EFD_CLOEXEC);
+
+        REQUIRE(descriptor >= 0);
+        REQUIRE(ring.read(descriptor, &value, sizeof(value), 3));
+        REQUIRE(ring.submit() >= 0);
+        REQUIRE(write(descriptor, &wake, sizeof(wake)) == sizeof(wake));
+        REQUIRE(ring.submit(1) >= 0);
+
+        auto completionResult = 0;
+
+        ring.forEachCompletion([&](uint64_t, int result) {
+            completionResult = result;
+        });
+
+        REQUIRE(completionResult == sizeof(value));
+        REQUIRE(value == 1);
+
+        close(descriptor);
+    }
+
+    SECTION("an echo request to the loopback address is answered") {
+        auto socket = createSocket();
+
+        if (!socket) {
+            WARN("ICMP datagram sockets are not available, test skipped.");
+
+            return;
+        }
+
+        IOUringMessage transmitMessage;
+        IOUringMessage receiveMessage;
+
+        IOUring ring(4);
+
+        auto loopback = QHostAddress("127.0.0.1");
+        auto probe = Nedrysoft::ICMPPacket::ICMPPacket::pingPacket(
+            socket->id(),
+            1,
+            PayloadLength,
+            loopback,
+            Nedrysoft::ICMPPacket::V4 );
+
+        sockaddr_storage address = {};
+
+        auto addressLength = socket->toSocketAddress(loopback, address);
+
+        memcpy(transmitMessage.buffer(), probe.constData(), static_cast<size_t>(probe.length()));
+
+        auto deadline = IOUring::toTimespec(IOUring::monotonicNanoseconds() + ReceiveTimeout);
+
+        REQUIRE(ring.sendMessage(
+            socket->descriptor(),
+            transmitMessage.prepareSend(probe.length(), address, addressLength, 64, Nedrysoft::ICMPSocket::V4),
+            1 ));
+
+        REQUIRE(ring.receiveMessage(socket->descriptor(), receiveMessage.prepareReceive(), 0, 2));
+        REQUIRE(ring.timeout(&deadline, 3));
+
+        auto receiveResult = -1;
+        auto isComplete = false;
+
+        while (!isComplete) {
+            REQUIRE(ring.submit(1) >= 0);
+
+            ring.forEachCompletion([&](uint64_t userData, int result) {
+                if (userData == 2) {
+                    receiveResult = result;
+                    isComplete = true;
+                } else if (userData == 3) {
+                    isComplete = true;
+                }
+            });
+        }
+
+        REQUIRE(receiveResult > 0);
+
+        auto packet = receiveMessage.receivedPacket(receiveResult);
+
+        REQUIRE(isEchoReply(packet, socket->id()));
+        REQUIRE(packet.receiveAddress == loopback);
+        REQUIRE(packet.timestampSource == Nedrysoft::ICMPSocket::TimestampSource::Kernel);
+        REQUIRE(packet.ttl > 0);
+    }
+}
+
+TEST_CASE("IOUringPingEngine Benchmarks", "[!benchmark][components][iouringpingengine]") {
+    auto socket = createSocket();
+
+    if (( !socket ) || ( !IOUring::isSupported() )) {
+        WARN("io_uring or ICMP datagram sockets are not available, benchmarks skipped.");
+
+        return;
+    }
+
+    auto probe = Nedrysoft::ICMPPacket::ICMPPacket::pingPacket(
+        socket->id(),
+        1,
+        PayloadLength,
+        QHostAddress("127.0.0.1"),
+        Nedrysoft::ICMPPacket::V4 );
+
+    std::vector<IOUringMessage> messages(ProbeCount * 2);
+
+    IOUring ring(ProbeCount * 2);
+
+    BENCHMARK("ICMPSocket sendmmsg + recvmmsg, 64 loopback probes") {
+        return socketRoundTrip(*socket, probe);
+    };
+
+    BENCHMARK("io_uring sendmsg + recvmsg, 64 loopback probes") {
+        return ringRoundTrip(ring, *socket, messages, probe);
+    };
+}
+#endif
@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 18/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "catch.hpp"
+#include "RouteAnalyser/PingEngineMetrics.h"
+
+#include <cstdint>
+
+TEST_CASE("PingEngineCounters Tests", "[app][components][routeanalyser]") {
+    using Nedrysoft::RouteAnalyser::PingEngineCounters;
+
+    SECTION("replies and timeouts remove requests from the in flight count") {
+        PingEngineCounters counters;
+
+        counters.addProbesSent(3);
+        counters.addRequest();
+        counters.addRequest();
+        counters.addRequest();
+        counters.addReply();
+        counters.addTimeout(0x10001);
+
+        auto metrics = counters.snapshot();
+
+        REQUIRE(metrics.probesSent == 3);
+        REQUIRE(metrics.repliesMatched == 1);
+        REQUIRE(metrics.timeouts == 1);
+        REQUIRE(metrics.inFlight == 1);
+
+        counters.cancelRequests(1);
+
+        REQUIRE(counters.snapshot().inFlight == 0);
+    }
+
+    SECTION("a reply to a timed out request is counted once as late") {
+        PingEngineCounters counters;
+
+        counters.addRequest();
+        counters.addTimeout(0x10001);
+        counters.addUnmatchedReply(0x10001);
+        counters.addUnmatchedReply(0x10001);
+        counters.addUnmatchedReply(0x10002);
+
+        auto metrics = counters.snapshot();
+
+        REQUIRE(metrics.lateReplies == 1);
+        REQUIRE(metrics.unmatchedPackets == 2);
+    }
+
+    SECTION("lateness percentiles are within a bucket of the recorded values") {
+        PingEngineCounters counters;
+
+        for (auto value = 1; value <= 1000; value++) {
+            counters.addLateness(static_cast<int64_t>(value) * 1000);
+        }
+
+        auto metrics = counters.snapshot();
+
+        REQUIRE(metrics.latenessMedian >= 500000);
+        REQUIRE(metrics.latenessMedian <= 500000 * 9 / 8);
+        REQUIRE(metrics.latenessP90 >= 900000);
+        REQUIRE(metrics.latenessP90 <= 900000 * 9 / 8);
+        REQUIRE(metrics.latenessP99 >= 990000);
+        REQUIRE(metrics.latenessP99 <= 1000000);
+        REQUIRE(metrics.latenessMaximum == 1000000);
+    }
+
+    SECTION("no lateness is reported before a probe is sent") {
+        PingEngineCounters counters;
+
+        auto metrics = counters.snapshot();
+
+        REQUIRE(metrics.latenessMedian == 0);
+        REQUIRE(metrics.latenessMaximum == 0);
+    }
+}
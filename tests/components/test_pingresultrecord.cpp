@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of Pingnoo (https://github.com/nedrysoft/pingnoo)
+ *
+ * An open-source cross-platform traceroute analyser.
+ *
+ * Created by Adrian Carpenter on 18/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "catch.hpp"
+#include "RouteAnalyser/PingResultRecord.h"
+
+#include <QHostAddress>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <type_traits>
+
+static_assert(
+    std::is_trivially_copyable<Nedrysoft::RouteAnalyser::PingResultRecord>::value,
+    "PingResultRecord must be trivially copyable"
+);
+
+constexpr int64_t ClockTolerance = 100000000;
+constexpr int64_t RequestAge = 5000000000;
+
+static auto wallClockNanoseconds() -> int64_t {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch() ).count();
+}
+
+TEST_CASE("PingResultRecord Tests", "[app][components][routeanalyser]") {
+    using Nedrysoft::RouteAnalyser::PingResult;
+    using Nedrysoft::RouteAnalyser::PingResultRecord;
+
+    SECTION("IPv4 addresses are packed in network byte order") {
+        PingResultRecord record = {};
+
+        record.setHostAddress(QHostAddress("192.0.2.1"));
+
+        REQUIRE(record.addressFamily == PingResultRecord::IPv4);
+        REQUIRE(record.address[0] == 192);
+        REQUIRE(record.address[1] == 0);
+        REQUIRE(record.address[2] == 2);
+        REQUIRE(record.address[3] == 1);
+
+        for (auto index = 4; index < 16; index++) {
+            REQUIRE(record.address[index] == 0);
+        }
+
+        REQUIRE(record.hostAddress() == QHostAddress("192.0.2.1"));
+    }
+
+    SECTION("IPv6 addresses are packed in network byte order") {
+        PingResultRecord record = {};
+
+        record.setHostAddress(QHostAddress("2001:db8::1"));
+
+        REQUIRE(record.addressFamily == PingResultRecord::IPv6);
+        REQUIRE(record.address[0] == 0x20);
+        REQUIRE(record.address[1] == 0x01);
+        REQUIRE(record.address[2] == 0x0d);
+        REQUIRE(record.address[3] == 0xb8);
+        REQUIRE(record.address[15] == 0x01);
+        REQUIRE(record.hostAddress() == QHostAddress("2001:db8::1"));
+    }
+
+    SECTION("a null address clears the address of the record") {
+        PingResultRecord record = {};
+
+        record.setHostAddress(QHostAddress("192.0.2.1"));
+        record.setHostAddress(QHostAddress());
+
+        REQUIRE(record.addressFamily == PingResultRecord::NoAddress);
+        REQUIRE(record.address[0] == 0);
+        REQUIRE(record.hostAddress().isNull());
+    }
+
+    SECTION("monotonic request times are converted to the wall clock") {
+        auto record = PingResultRecord::create(
+            1,
+            PingResult::ResultCode::Ok,
+            QHostAddress("192.0.2.1"),
+            PingResultRecord::monotonicNanoseconds() - RequestAge,
+            0,
+            0
+        );
+
+        auto expectedTime = wallClockNanoseconds() - RequestAge;
+
+        REQUIRE(std::llabs(record.requestTimeNanoseconds() - expectedTime) < ClockTolerance);
+        REQUIRE(record.requestDateTime().toMSecsSinceEpoch() <= ( expectedTime + ClockTolerance ) / 1000000);
+    }
+
+    SECTION("a result survives a round trip through a record") {
+        auto requestTime = wallClockNanoseconds() - RequestAge;
+
+        auto result = PingResult(
+            7,
+            PingResult::ResultCode::TimeExceeded,
+            QHostAddress("2001:db8::1"),
+            requestTime,
+            0.0125,
+            nullptr,
+            3,
+            PingResult::TimestampSource::Kernel
+        );
+
+        auto record = PingResultRecord::fromPingResult(result, 2);
+
+        REQUIRE(record.sampleNumber == 7);
+        REQUIRE(record.targetIndex == 2);
+        REQUIRE(record.roundTripTime == 12500000);
+        REQUIRE(std::llabs(( PingResultRecord::monotonicNanoseconds() - record.requestTime ) - RequestAge) <
+                ClockTolerance);
+
+        auto copy = PingResultRecord();
+
+        memcpy(&copy, &record, sizeof(record));
+
+        auto converted = copy.toPingResult(nullptr);
+
+        REQUIRE(converted.sampleNumber() == 7);
+        REQUIRE(converted.code() == PingResult::ResultCode::TimeExceeded);
+        REQUIRE(converted.hostAddress() == QHostAddress("2001:db8::1"));
+        REQUIRE(converted.roundTripTime() == Approx(0.0125));
+        REQUIRE(converted.target() == nullptr);
+        REQUIRE(converted.hops() == 3);
+        REQUIRE(converted.timestampSource() == PingResult::TimestampSource::Kernel);
+        REQUIRE(std::llabs(converted.requestTimeNanoseconds() - requestTime) < ClockTolerance);
+    }
+}
@@ -22,10 +22,78 @@
  */
 
 #include "catch.hpp"
+#include "ICMPPacket/ICMPChecksum.h"
 #include "ICMPPacket/ICMPPacket.h"
+#include "ICMPPacket/ICMPPacketTemplate.h"
+#include "ICMPPacket/ICMPReplyView.h"
 
 #include <QString>
 #include <QHostAddress>
+#include <cstring>
+#include <random>
+#include <vector>
+
+constexpr auto BenchmarkPacketLength = 1500;
+constexpr auto RandomBufferLength = 4096;
+constexpr auto FuzzIterations = 20000;
+
+namespace {
+    /**
+     * @brief       Reference implementation of the RFC 1071 checksum, summing one 16 bit word at a time.
+     */
+    auto referenceChecksum(const unsigned char *buffer, int length) -> uint16_t {
+        uint32_t sum = 0;
+
+        for (auto index = 0; index + 1 < length; index += 2) {
+            uint16_t word;
+
+            memcpy(&word, buffer + index, sizeof(word));
+
+            sum += word;
+        }
+
+        if (length & 1) {
+            uint16_t word = 0;
+
+            memcpy(&word, buffer + length - 1, 1);
+
+            sum += word;
+        }
+
+        while (sum >> 16) {
+            sum = ( sum >> 16 ) + ( sum & UINT16_MAX );
+        }
+
+        return static_cast<uint16_t>(~sum);
+    }
+
+    /**
+     * @brief       Creates an IPv4 time exceeded message for an echo request with id 0x1234 and sequence 0x5678.
+     */
+    auto timeExceededPacket() -> std::vector<uint8_t> {
+        std::vector<uint8_t> packet(56, 0);
+
+        packet[0] = 0x45;                   // outer IP header, version 4, 5 words.
+        packet[8] = 60;                     // ttl.
+        packet[9] = 1;                      // protocol ICMP.
+        packet[20] = 11;                    // ICMP time exceeded.
+        packet[28] = 0x45;                  // original IP header.
+        packet[37] = 1;                     // original protocol ICMP.
+        packet[48] = 8;                     // original ICMP echo request.
+        packet[52] = 0x12;
+        packet[53] = 0x34;
+        packet[54] = 0x56;
+        packet[55] = 0x78;
+
+        return packet;
+    }
+
+    const std::vector<Nedrysoft::ICMPPacket::ICMPChecksum::Implementation> ChecksumImplementations = {
+        Nedrysoft::ICMPPacket::ICMPChecksum::Implementation::Scalar,
+        Nedrysoft::ICMPPacket::ICMPChecksum::Implementation::SSE2,
+        Nedrysoft::ICMPPacket::ICMPChecksum::Implementation::AVX2
+    };
+}
 
 TEST_CASE("ICMPPacket Tests", "[app][libs][network]") {
     QByteArray testData = QString("This Is A Test Of The ICMP Checksum Routine").toLatin1();
@@ -33,6 +101,305 @@ TEST_CASE("ICMPPacket Tests", "[app][libs][network]") {
     SECTION("checksum produces correct result") {
         auto checksum = Nedrysoft::ICMPPacket::ICMPPacket::checksum(testData.data(), testData.length());
 
-        REQUIRE_MESSAGE(checksum==0x38D1, "ICMP checksum was calculated incorrectly.");
+        REQUIRE_MESSAGE(checksum==0x386C, "ICMP checksum was calculated incorrectly.");
+    }
+
+    SECTION("checksum implementations match the reference for all lengths and alignments") {
+        std::mt19937 generator(1071);
+        std::vector<unsigned char> buffer(RandomBufferLength);
+
+        for (auto &byte : buffer) {
+            byte = static_cast<unsigned char>(generator());
+        }
+
+        for (auto implementation : ChecksumImplementations) {
+            if (!Nedrysoft::ICMPPacket::ICMPChecksum::isSupported(implementation)) {
+                continue;
+            }
+
+            for (auto offset = 0; offset < 8; offset++) {
+                for (auto length = 0; length < 300; length++) {
+                    auto expected = referenceChecksum(buffer.data() + offset, length);
+
+                    REQUIRE(Nedrysoft::ICMPPacket::ICMPChecksum::checksum(
+                        buffer.data() + offset,
+                        length,
+                        implementation) == expected);
+                }
+            }
+        }
+    }
+
+    SECTION("checksum implementations handle carries from large buffers") {
+        std::vector<unsigned char> buffer(UINT16_MAX, 0xFF);
+
+        auto expected = referenceChecksum(buffer.data(), static_cast<int>(buffer.size()));
+
+        for (auto implementation : ChecksumImplementations) {
+            if (Nedrysoft::ICMPPacket::ICMPChecksum::isSupported(implementation)) {
+                REQUIRE(Nedrysoft::ICMPPacket::ICMPChecksum::checksum(
+                    buffer.data(),
+                    static_cast<int>(buffer.size()),
+                    implementation) == expected);
+            }
+        }
+    }
+
+    SECTION("received packets with a valid checksum are accepted") {
+        auto packet = Nedrysoft::ICMPPacket::ICMPPacket::pingPacket(
+            0x1234,
+            1,
+            52,
+            QHostAddress("127.0.0.1"),
+            Nedrysoft::ICMPPacket::V4 );
+
+        // prefix a minimal IPv4 header (version 4, header length 5 words).
+
+        auto receivedPacket = QByteArray(20, 0) + packet;
+
+        receivedPacket[0] = 0x45;
+
+        REQUIRE(Nedrysoft::ICMPPacket::ICMPPacket::isChecksumValid(receivedPacket, Nedrysoft::ICMPPacket::V4));
+
+        receivedPacket[30] = static_cast<char>(receivedPacket[30] ^ 0x01);
+
+        REQUIRE(!Nedrysoft::ICMPPacket::ICMPPacket::isChecksumValid(receivedPacket, Nedrysoft::ICMPPacket::V4));
+    }
+
+    SECTION("packet template matches a fully built packet") {
+        auto packetTemplate = Nedrysoft::ICMPPacket::ICMPPacketTemplate(
+            0x1234,
+            52,
+            QHostAddress("127.0.0.1"),
+            Nedrysoft::ICMPPacket::V4 );
+
+        QByteArray buffer(packetTemplate.length(), 0);
+
+        for (auto sequence : {0x0000, 0x0001, 0x7FFF, 0xFFFF}) {
+            auto length = packetTemplate.write(buffer.data(), buffer.length(), static_cast<uint16_t>(sequence));
+
+            auto packet = Nedrysoft::ICMPPacket::ICMPPacket::pingPacket(
+                0x1234,
+                static_cast<uint16_t>(sequence),
+                52,
+                QHostAddress("127.0.0.1"),
+                Nedrysoft::ICMPPacket::V4 );
+
+            REQUIRE_MESSAGE(length==packet.length(), "Template packet length is incorrect.");
+            REQUIRE_MESSAGE(buffer==packet, "Template packet does not match the built packet.");
+        }
+    }
+
+    SECTION("packet template checksum is valid with a timestamp") {
+        auto packetTemplate = Nedrysoft::ICMPPacket::ICMPPacketTemplate(
+            0x1234,
+            52,
+            QHostAddress("127.0.0.1"),
+            Nedrysoft::ICMPPacket::V4 );
+
+        QByteArray buffer(packetTemplate.length(), 0);
+
+        packetTemplate.write(buffer.data(), buffer.length(), 0xABCD, 0x0123456789ABCDEF);
+
+        auto checksum = Nedrysoft::ICMPPacket::ICMPPacket::checksum(buffer.data(), buffer.length());
+
+        REQUIRE_MESSAGE(checksum==0, "Incrementally updated checksum is incorrect.");
+        REQUIRE_MESSAGE(packetTemplate.write(buffer.data(), 8, 0) == 0, "Packet was written to a short buffer.");
+    }
+}
+
+TEST_CASE("ICMPPacket Checksum Benchmarks", "[!benchmark][libs][network]") {
+    std::vector<unsigned char> buffer(BenchmarkPacketLength, 0xA5);
+
+    BENCHMARK("reference 16 bit loop, 1500 bytes") {
+        return referenceChecksum(buffer.data(), BenchmarkPacketLength);
+    };
+
+    BENCHMARK("scalar, 1500 bytes") {
+        return Nedrysoft::ICMPPacket::ICMPChecksum::checksum(
+            buffer.data(),
+            BenchmarkPacketLength,
+            Nedrysoft::ICMPPacket::ICMPChecksum::Implementation::Scalar );
+    };
+
+    BENCHMARK("selected implementation, 1500 bytes") {
+        return Nedrysoft::ICMPPacket::ICMPChecksum::checksum(buffer.data(), BenchmarkPacketLength);
+    };
+}
+
+TEST_CASE("ICMPReplyView Tests", "[app][libs][network]") {
+    SECTION("time exceeded message is decoded from the embedded request") {
+        auto packet = timeExceededPacket();
+
+        auto replyView = Nedrysoft::ICMPPacket::ICMPReplyView(
+            gsl::span<const uint8_t>(packet.data(), static_cast<std::ptrdiff_t>(packet.size())),
+            Nedrysoft::ICMPPacket::V4 );
+
+        REQUIRE(replyView.resultCode() == Nedrysoft::ICMPPacket::TimeExceeded);
+        REQUIRE(replyView.type() == 11);
+        REQUIRE(replyView.code() == 0);
+        REQUIRE(replyView.id() == 0x1234);
+        REQUIRE(replyView.sequence() == 0x5678);
+        REQUIRE(replyView.ttl() == 60);
+        REQUIRE(replyView.originalHeader().size() == 28);
+    }
+
+    SECTION("truncated time exceeded messages are never decoded from data beyond the view") {
+        auto packet = timeExceededPacket();
+
+        // the complete packet remains in memory after the end of each truncated view, so reading beyond the
+        // view would decode the id and sequence of the embedded request.
+
+        for (size_t length = 0; length < packet.size(); length++) {
+            auto replyView = Nedrysoft::ICMPPacket::ICMPReplyView(
+                gsl::span<const uint8_t>(packet.data(), static_cast<std::ptrdiff_t>(length)),
+                Nedrysoft::ICMPPacket::V4 );
+
+            REQUIRE(!replyView.isValid());
+            REQUIRE(replyView.id() == 0);
+            REQUIRE(replyView.sequence() == 0);
+            REQUIRE(replyView.originalHeader().empty());
+            REQUIRE(replyView.message().size() <= static_cast<std::ptrdiff_t>(length));
+        }
+    }
+
+    SECTION("randomly corrupted and truncated messages stay within the view") {
+        std::mt19937 generator(792);
+
+        for (auto iteration = 0; iteration < FuzzIterations; iteration++) {
+            auto packet = timeExceededPacket();
+
+            // corrupt the header length, version and type fields as these control how far the parser reads.
+
+            for (auto offset : {0, 20, 28, 48}) {
+                if (generator() & 1) {
+                    packet[offset] = static_cast<uint8_t>(generator());
+                }
+            }
+
+            auto length = static_cast<std::ptrdiff_t>(generator() % ( packet.size() + 1 ));
+
+            for (auto version : {Nedrysoft::ICMPPacket::V4, Nedrysoft::ICMPPacket::V6}) {
+                auto replyView = Nedrysoft::ICMPPacket::ICMPReplyView(
+                    gsl::span<const uint8_t>(packet.data(), length),
+                    version );
+
+                auto message = replyView.message();
+                auto originalHeader = replyView.originalHeader();
+
+                REQUIRE(message.size() <= length);
+                REQUIRE(originalHeader.size() <= length);
+
+                if (!message.empty()) {
+                    REQUIRE(message.data() >= packet.data());
+                    REQUIRE(message.data() + message.size() <= packet.data() + length);
+                }
+
+                if (!originalHeader.empty()) {
+                    REQUIRE(originalHeader.data() >= packet.data());
+                    REQUIRE(originalHeader.data() + originalHeader.size() <= packet.data() + length);
+                }
+            }
+        }
+    }
+
+    SECTION("datagram socket replies are decoded without an IP header") {
+        auto packet = timeExceededPacket();
+
+        // an echo reply as returned by a datagram socket, starting at the ICMP header.
+
+        std::vector<uint8_t> reply = {0, 0, 0, 0, 0x12, 0x34, 0x56, 0x78, 1, 2, 3, 4};
+
+        auto replyView = Nedrysoft::ICMPPacket::ICMPReplyView(
+            gsl::span<const uint8_t>(reply.data(), static_cast<std::ptrdiff_t>(reply.size())),
+            Nedrysoft::ICMPPacket::V4,
+            Nedrysoft::ICMPPacket::PacketFormat::Datagram );
+
+        REQUIRE(replyView.resultCode() == Nedrysoft::ICMPPacket::EchoReply);
+        REQUIRE(replyView.id() == 0x1234);
+        REQUIRE(replyView.sequence() == 0x5678);
+        REQUIRE(replyView.ttl() == -1);
+
+        // the same data read as a raw packet does not start with an IPv4 header.
+
+        REQUIRE(!Nedrysoft::ICMPPacket::ICMPReplyView(
+            gsl::span<const uint8_t>(reply.data(), static_cast<std::ptrdiff_t>(reply.size())),
+            Nedrysoft::ICMPPacket::V4 ).isValid());
+
+        // a time exceeded message without its outer IP header.
+
+        auto message = gsl::span<const uint8_t>(packet.data(), static_cast<std::ptrdiff_t>(packet.size())).subspan(20);
+
+        auto timeExceededView = Nedrysoft::ICMPPacket::ICMPReplyView(
+            message,
+            Nedrysoft::ICMPPacket::V4,
+            Nedrysoft::ICMPPacket::PacketFormat::Datagram );
+
+        REQUIRE(timeExceededView.resultCode() == Nedrysoft::ICMPPacket::TimeExceeded);
+        REQUIRE(timeExceededView.id() == 0x1234);
+
+        auto decodedPacket = Nedrysoft::ICMPPacket::ICMPPacket::fromData(
+            QByteArray(reinterpret_cast<const char *>(reply.data()), static_cast<int>(reply.size())),
+            Nedrysoft::ICMPPacket::V4,
+            Nedrysoft::ICMPPacket::PacketFormat::Datagram );
+
+        REQUIRE(decodedPacket.resultCode() == Nedrysoft::ICMPPacket::EchoReply);
+        REQUIRE(decodedPacket.sequence() == 0x5678);
+    }
+
+    SECTION("errors reported by datagram sockets are decoded from the returned request") {
+        std::vector<uint8_t> request = {8, 0, 0, 0, 0x12, 0x34, 0x56, 0x78};
+        std::vector<uint8_t> request_v6 = {128, 0, 0, 0, 0x12, 0x34, 0x56, 0x78};
+
+        auto requestSpan = gsl::span<const uint8_t>(request.data(), static_cast<std::ptrdiff_t>(request.size()));
+
+        auto replyView = Nedrysoft::ICMPPacket::ICMPReplyView::fromError(requestSpan, Nedrysoft::ICMPPacket::V4, 11, 0);
+
+        REQUIRE(replyView.resultCode() == Nedrysoft::ICMPPacket::TimeExceeded);
+        REQUIRE(replyView.type() == 11);
+        REQUIRE(replyView.id() == 0x1234);
+        REQUIRE(replyView.sequence() == 0x5678);
+        REQUIRE(replyView.originalHeader().size() == 8);
+
+        auto replyView_v6 = Nedrysoft::ICMPPacket::ICMPReplyView::fromError(
+            gsl::span<const uint8_t>(request_v6.data(), static_cast<std::ptrdiff_t>(request_v6.size())),
+            Nedrysoft::ICMPPacket::V6,
+            3,
+            0 );
+
+        REQUIRE(replyView_v6.resultCode() == Nedrysoft::ICMPPacket::TimeExceeded);
+        REQUIRE(replyView_v6.sequence() == 0x5678);
+
+        // destination unreachable, fragment reassembly timeouts and truncated requests are not decoded.
+
+        REQUIRE(!Nedrysoft::ICMPPacket::ICMPReplyView::fromError(requestSpan, Nedrysoft::ICMPPacket::V4, 3, 0).isValid());
+        REQUIRE(!Nedrysoft::ICMPPacket::ICMPReplyView::fromError(requestSpan, Nedrysoft::ICMPPacket::V4, 11, 1).isValid());
+        REQUIRE(!Nedrysoft::ICMPPacket::ICMPReplyView::fromError(requestSpan, Nedrysoft::ICMPPacket::V6, 11, 0).isValid());
+
+        for (std::ptrdiff_t length = 0; length < static_cast<std::ptrdiff_t>(request.size()); length++) {
+            REQUIRE(!Nedrysoft::ICMPPacket::ICMPReplyView::fromError(
+                requestSpan.subspan(0, length),
+                Nedrysoft::ICMPPacket::V4,
+                11,
+                0 ).isValid());
+        }
+    }
+
+    SECTION("fromData decodes through the view") {
+        auto packet = timeExceededPacket();
+
+        auto decodedPacket = Nedrysoft::ICMPPacket::ICMPPacket::fromData(
+            QByteArray(reinterpret_cast<const char *>(packet.data()), static_cast<int>(packet.size())),
+            Nedrysoft::ICMPPacket::V4 );
+
+        REQUIRE(decodedPacket.resultCode() == Nedrysoft::ICMPPacket::TimeExceeded);
+        REQUIRE(decodedPacket.id() == 0x1234);
+        REQUIRE(decodedPacket.sequence() == 0x5678);
+
+        auto truncatedPacket = Nedrysoft::ICMPPacket::ICMPPacket::fromData(
+            QByteArray(reinterpret_cast<const char *>(packet.data()), 40),
+            Nedrysoft::ICMPPacket::V4 );
+
+        REQUIRE(truncatedPacket.resultCode() == Nedrysoft::ICMPPacket::Invalid);
     }
 }
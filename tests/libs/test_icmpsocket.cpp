@@ -23,8 +23,86 @@
 
 #include "catch.hpp"
 #include "ICMPSocket/ICMPSocket.h"
+#include "ICMPSocket/ICMPSocketFilter.h"
 
 #include <QString>
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+
+#if defined(Q_OS_LINUX)
+#include <linux/filter.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+    /**
+     * @brief       Runs a filter program in the kernel against a packet using a socket pair.
+     */
+    auto filterAccepts(
+            const QVector<Nedrysoft::ICMPSocket::ICMPSocketFilterInstruction> &program,
+            const std::vector<uint8_t> &packet) -> bool {
+
+        int sockets[2];
+
+        if (socketpair(AF_UNIX, SOCK_DGRAM, 0, sockets) < 0) {
+            return false;
+        }
+
+        struct sock_fprog filter = {};
+
+        filter.len = static_cast<unsigned short>(program.count());
+        filter.filter = reinterpret_cast<sock_filter *>(const_cast<Nedrysoft::ICMPSocket::ICMPSocketFilterInstruction *>(program.data()));
+
+        auto accepted = false;
+
+        if (setsockopt(sockets[1], SOL_SOCKET, SO_ATTACH_FILTER, &filter, sizeof(filter)) == 0) {
+            uint8_t buffer[512];
+
+            send(sockets[0], packet.data(), packet.size(), 0);
+
+            accepted = ( recv(sockets[1], buffer, sizeof(buffer), MSG_DONTWAIT) > 0 );
+        }
+
+        close(sockets[0]);
+        close(sockets[1]);
+
+        return accepted;
+    }
+
+    /**
+     * @brief       Creates an ICMP header followed by padding.
+     */
+    auto icmpHeader(uint8_t type, uint16_t id) -> std::vector<uint8_t> {
+        return std::vector<uint8_t>{type, 0, 0, 0, static_cast<uint8_t>(id >> 8), static_cast<uint8_t>(id), 0, 1};
+    }
+
+    /**
+     * @brief       Creates an IPv4 header of the given length in 32 bit words.
+     */
+    auto ipv4Header(uint8_t words) -> std::vector<uint8_t> {
+        std::vector<uint8_t> header(words * sizeof(uint32_t), 0);
+
+        header[0] = static_cast<uint8_t>(0x40 | words);
+        header[9] = 1;
+
+        return header;
+    }
+
+    /**
+     * @brief       Concatenates the parts of a packet.
+     */
+    auto packet(std::initializer_list<std::vector<uint8_t>> parts) -> std::vector<uint8_t> {
+        std::vector<uint8_t> data;
+
+        for (const auto &part : parts) {
+            data.insert(data.end(), part.begin(), part.end());
+        }
+
+        return data;
+    }
+}
+#endif
 
 TEST_CASE("ICMPSocket Tests", "[app][libs][network]") {
     Nedrysoft::ICMPSocket::ICMPSocket *readSocket;
@@ -42,3 +120,64 @@ TEST_CASE("ICMPSocket Tests", "[app][libs][network]") {
         REQUIRE_MESSAGE(writeSocket!=nullptr, "Unable to create a IPv4 ICMP write socket.");
     }
 }
+
+#if defined(Q_OS_LINUX)
+TEST_CASE("ICMPSocketFilter Tests", "[app][libs][network]") {
+    constexpr uint16_t RegisteredId = 0x1234;
+    constexpr uint16_t OtherId = 0x4321;
+
+    SECTION("IPv4 echo replies are filtered by id") {
+        auto program = Nedrysoft::ICMPSocket::ICMPSocketFilter::program(Nedrysoft::ICMPSocket::V4, {7, RegisteredId});
+
+        REQUIRE(filterAccepts(program, packet({ipv4Header(5), icmpHeader(0, RegisteredId)})));
+        REQUIRE(filterAccepts(program, packet({ipv4Header(6), icmpHeader(0, RegisteredId)})));
+        REQUIRE_FALSE(filterAccepts(program, packet({ipv4Header(5), icmpHeader(0, OtherId)})));
+        REQUIRE_FALSE(filterAccepts(program, packet({ipv4Header(5), icmpHeader(8, RegisteredId)})));
+    }
+
+    SECTION("IPv4 time exceeded messages are filtered by the embedded id") {
+        auto program = Nedrysoft::ICMPSocket::ICMPSocketFilter::program(Nedrysoft::ICMPSocket::V4, {RegisteredId});
+
+        REQUIRE(filterAccepts(program, packet({ipv4Header(5), icmpHeader(11, 0), ipv4Header(5), icmpHeader(8, RegisteredId)})));
+        REQUIRE(filterAccepts(program, packet({ipv4Header(6), icmpHeader(11, 0), ipv4Header(7), icmpHeader(8, RegisteredId)})));
+        REQUIRE_FALSE(filterAccepts(program, packet({ipv4Header(5), icmpHeader(11, 0), ipv4Header(5), icmpHeader(8, OtherId)})));
+        REQUIRE_FALSE(filterAccepts(program, packet({ipv4Header(5), icmpHeader(11, 0), ipv4Header(5)})));
+    }
+
+    SECTION("IPv6 replies are filtered by id") {
+        auto program = Nedrysoft::ICMPSocket::ICMPSocketFilter::program(Nedrysoft::ICMPSocket::V6, {RegisteredId});
+        auto ipv6Header = std::vector<uint8_t>(40, 0);
+
+        ipv6Header[0] = 0x60;
+        ipv6Header[6] = 58;
+
+        REQUIRE(filterAccepts(program, icmpHeader(129, RegisteredId)));
+        REQUIRE_FALSE(filterAccepts(program, icmpHeader(129, OtherId)));
+        REQUIRE_FALSE(filterAccepts(program, icmpHeader(128, RegisteredId)));
+        REQUIRE(filterAccepts(program, packet({icmpHeader(3, 0), ipv6Header, icmpHeader(128, RegisteredId)})));
+        REQUIRE_FALSE(filterAccepts(program, packet({icmpHeader(3, 0), ipv6Header, icmpHeader(128, OtherId)})));
+    }
+
+    SECTION("an empty set of ids rejects all packets") {
+        auto program = Nedrysoft::ICMPSocket::ICMPSocketFilter::program(Nedrysoft::ICMPSocket::V4, {});
+
+        REQUIRE_FALSE(filterAccepts(program, packet({ipv4Header(5), icmpHeader(0, RegisteredId)})));
+    }
+
+    SECTION("a large set of ids is matched as a range") {
+        QVector<uint16_t> ids;
+
+        for (auto id = 0; id <= Nedrysoft::ICMPSocket::ICMPSocketFilter::MaximumIds; id++) {
+            ids.append(static_cast<uint16_t>(1000 + id * 2));
+        }
+
+        auto program = Nedrysoft::ICMPSocket::ICMPSocketFilter::program(Nedrysoft::ICMPSocket::V4, ids);
+
+        REQUIRE(filterAccepts(program, packet({ipv4Header(5), icmpHeader(0, 1000)})));
+        REQUIRE(filterAccepts(program, packet({ipv4Header(5), icmpHeader(0, 1001)})));
+        REQUIRE(filterAccepts(program, packet({ipv4Header(5), icmpHeader(0, ids.last())})));
+        REQUIRE_FALSE(filterAccepts(program, packet({ipv4Header(5), icmpHeader(0, 999)})));
+        REQUIRE_FALSE(filterAccepts(program, packet({ipv4Header(5), icmpHeader(0, ids.last() + 1)})));
+    }
+}
+#endif